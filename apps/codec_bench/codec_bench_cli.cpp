@@ -0,0 +1,256 @@
+/**
+ * @file codec_bench_cli.cpp
+ * @brief Benchmarks the in-tree QOI codec against PNG compression levels
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Encodes and decodes each input with PNG levels 1-9 and QOI, in memory,
+ * and prints time per image, throughput, size relative to raw pixels and
+ * speedup over the PNG level the extractor uses by default (OpenCV: 1).
+ * Use it on real heatmaps / left_rgb frames to decide on the image format.
+ *
+ * Usage:
+ *   codec_bench_cli [image ...] [options]
+ *
+ * Options:
+ *   --iterations <n>   Encode/decode repetitions per codec (default: 10)
+ *   --synthetic        Add a generated 1280x720 heatmap-like image (default when no inputs)
+ *   --help             Show this help message
+ */
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <iostream>
+#include <string>
+#include <vector>
+#include <opencv2/opencv.hpp>
+
+// Our common utilities
+#include "../../common/error_handler.hpp"
+#include "../../common/qoi_codec.hpp"
+
+using namespace zed_tools;
+
+/**
+ * @brief Application configuration
+ */
+struct Config {
+    std::vector<std::string> inputs;
+    int iterations = 10;
+    bool synthetic = false;
+    bool showHelp = false;
+};
+
+/**
+ * @brief Timing of one codec on one image
+ */
+struct CodecResult {
+    std::string name;
+    double encodeMs = 0.0;
+    double decodeMs = 0.0;
+    size_t bytes = 0;
+    bool ok = false;
+};
+
+/**
+ * @brief Smooth depth-like gradient with sensor noise, colorized like our heatmaps
+ */
+cv::Mat makeSyntheticHeatmap() {
+    cv::Mat depth(720, 1280, CV_32F);
+    for (int y = 0; y < depth.rows; ++y) {
+        float* row = depth.ptr<float>(y);
+        for (int x = 0; x < depth.cols; ++x) {
+            // Ground plane receding towards the horizon plus a near obstacle
+            row[x] = 255.0f * y / depth.rows;
+            if (x > 500 && x < 640 && y > 200 && y < 600) row[x] = 60.0f;
+        }
+    }
+    cv::Mat noise(depth.size(), CV_32F);
+    cv::randn(noise, 0.0, 2.0);
+    depth += noise;
+    cv::Mat gray, color;
+    depth.convertTo(gray, CV_8U);
+    cv::applyColorMap(gray, color, cv::COLORMAP_TURBO);
+    // Invalid (no depth) pixels are black in our heatmaps
+    color(cv::Rect(0, 0, 1280, 60)).setTo(cv::Scalar::all(0));
+    return color;
+}
+
+template <typename Fn>
+double timeMs(int iterations, Fn&& fn) {
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < iterations; ++i) fn();
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(end - start).count() / iterations;
+}
+
+CodecResult benchPng(const cv::Mat& image, int level, int iterations) {
+    CodecResult r;
+    r.name = "PNG " + std::to_string(level);
+    std::vector<int> params = {cv::IMWRITE_PNG_COMPRESSION, level};
+    std::vector<uchar> encoded;
+    r.encodeMs = timeMs(iterations, [&] { r.ok = cv::imencode(".png", image, encoded, params); });
+    if (!r.ok) return r;
+    r.bytes = encoded.size();
+    cv::Mat decoded;
+    r.decodeMs = timeMs(iterations, [&] { decoded = cv::imdecode(encoded, cv::IMREAD_UNCHANGED); });
+    r.ok = !decoded.empty();
+    return r;
+}
+
+CodecResult benchQoi(const cv::Mat& image, int iterations) {
+    CodecResult r;
+    r.name = "QOI";
+    std::vector<uint8_t> encoded;
+    r.encodeMs = timeMs(iterations, [&] {
+        r.ok = qoiEncode(image.data, image.cols, image.rows, image.channels(), image.step[0], encoded);
+    });
+    if (!r.ok) return r;
+    r.bytes = encoded.size();
+    QoiImage decoded;
+    r.decodeMs = timeMs(iterations, [&] {
+        r.ok = qoiDecode(encoded.data(), encoded.size(), decoded, image.channels());
+    });
+    // Lossless check
+    if (r.ok) {
+        cv::Mat back(decoded.height, decoded.width, image.type(), decoded.pixels.data());
+        r.ok = cv::norm(back, image, cv::NORM_INF) == 0.0;
+    }
+    return r;
+}
+
+void printResults(const std::string& name, const cv::Mat& image, const std::vector<CodecResult>& results) {
+    const double rawMB = static_cast<double>(image.total() * image.elemSize()) / (1024.0 * 1024.0);
+    std::cout << name << " (" << image.cols << "x" << image.rows << "x" << image.channels() << ")\n";
+
+    // Speedups are relative to PNG level 1 (what cv::imwrite uses by default)
+    const CodecResult* reference = nullptr;
+    for (const auto& r : results) {
+        if (r.name == "PNG 1" && r.ok) reference = &r;
+    }
+
+    char line[160];
+    std::snprintf(line, sizeof(line), "  %-6s %10s %10s %10s %10s %8s %9s %9s\n",
+                  "codec", "enc ms", "dec ms", "enc MB/s", "dec MB/s", "size %", "enc x", "dec x");
+    std::cout << line;
+    for (const auto& r : results) {
+        if (!r.ok) {
+            std::cout << "  " << r.name << " failed\n";
+            continue;
+        }
+        const double sizePct = 100.0 * static_cast<double>(r.bytes) / (image.total() * image.elemSize());
+        const double encX = reference ? reference->encodeMs / std::max(r.encodeMs, 1e-6) : 0.0;
+        const double decX = reference ? reference->decodeMs / std::max(r.decodeMs, 1e-6) : 0.0;
+        std::snprintf(line, sizeof(line), "  %-6s %10.2f %10.2f %10.1f %10.1f %8.1f %9.1f %9.1f\n",
+                      r.name.c_str(), r.encodeMs, r.decodeMs,
+                      rawMB / (r.encodeMs / 1000.0), rawMB / (r.decodeMs / 1000.0),
+                      sizePct, encX, decX);
+        std::cout << line;
+    }
+    std::cout << std::endl;
+}
+
+/**
+ * @brief Parse command line arguments
+ */
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            config.showHelp = true;
+            return true;
+        }
+        else if (arg == "--iterations" && i + 1 < argc) {
+            config.iterations = std::stoi(argv[++i]);
+        }
+        else if (arg == "--synthetic") {
+            config.synthetic = true;
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+        else {
+            config.inputs.push_back(arg);
+        }
+    }
+
+    if (config.iterations < 1) {
+        std::cerr << "Error: --iterations must be at least 1" << std::endl;
+        return false;
+    }
+    if (config.inputs.empty()) config.synthetic = true;
+    return true;
+}
+
+/**
+ * @brief Print help message
+ */
+void printHelp() {
+    std::cout << "\n=== ZED Codec Benchmark ===\n\n";
+    std::cout << "Compare PNG levels 1-9 with the in-tree QOI codec on extraction products.\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  codec_bench_cli [image ...] [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --iterations <n>   Repetitions per codec (default: 10)\n";
+    std::cout << "  --synthetic        Add a generated heatmap-like image (default without inputs)\n";
+    std::cout << "  --help, -h         Show this help message\n\n";
+    std::cout << "Speedups (enc x / dec x) are relative to PNG level 1.\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  codec_bench_cli depth_heatmaps/heatmap_000100.png left_rgb/left_000100.png\n";
+    std::cout << "  codec_bench_cli --synthetic --iterations 20\n\n";
+}
+
+/**
+ * @brief Main entry point
+ */
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        printHelp();
+        return 1;
+    }
+
+    if (config.showHelp) {
+        printHelp();
+        return 0;
+    }
+
+    try {
+        Logger::getInstance().initialize("codec_bench.log", LogMode::BOTH, LogLevel::INFO);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to initialize logger: " << e.what() << std::endl;
+        std::cerr << "Continuing without file logging..." << std::endl;
+    }
+
+    std::cout << "\n=== ZED Codec Benchmark v0.1.0 ===\n" << std::endl;
+
+    std::vector<std::pair<std::string, cv::Mat>> images;
+    if (config.synthetic) images.emplace_back("synthetic heatmap", makeSyntheticHeatmap());
+    for (const auto& path : config.inputs) {
+        cv::Mat image = cv::imread(path, cv::IMREAD_UNCHANGED);
+        if (image.empty() || image.depth() != CV_8U || image.channels() == 2) {
+            LOG_WARNING("Skipping " + path + " (not an 8-bit gray/BGR/BGRA image)");
+            continue;
+        }
+        images.emplace_back(path, image);
+    }
+    if (images.empty()) {
+        std::cerr << "Error: No usable images" << std::endl;
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
+    for (const auto& entry : images) {
+        std::vector<CodecResult> results;
+        for (int level = 1; level <= 9; ++level) {
+            results.push_back(benchPng(entry.second, level, config.iterations));
+        }
+        results.push_back(benchQoi(entry.second, config.iterations));
+        printResults(entry.first, entry.second, results);
+    }
+
+    Logger::getInstance().shutdown();
+    return 0;
+}
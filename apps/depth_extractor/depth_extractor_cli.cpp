@@ -0,0 +1,1084 @@
+/**
+ * @file depth_extractor_cli.cpp
+ * @brief Headless depth extraction for one or many ZED SVO2 files
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Runs the GUI's depth extraction (ExtractionEngine::extractDepth) without a
+ * display, for scripted runs on render nodes. Every DepthExtractionConfig
+ * field has an option. Several SVOs (or folders of them) run as concurrent
+ * SDK sessions; the number of sessions follows the free GPU memory and the
+ * CPU thread budget.
+ *
+ * Progress goes to stdout as JSON lines (one object per line, "event" says
+ * what it is); the log goes to stderr and depth_extractor.log. Each file
+ * gets its own exit code in its "done" event.
+ *
+ * Usage:
+ *   depth_extractor_cli <svo_file|folder>... [options]
+ *
+ * Main options:
+ *   --base-output <path>    Base output directory
+ *   --fps <rate>            Depth maps per second of video (default: 1.0)
+ *   --depth-mode <mode>     PERFORMANCE, QUALITY, ULTRA, NEURAL, NEURAL_PLUS
+ *   --jobs <n|auto>         Concurrent SDK sessions (default: auto)
+ *   --threads <n>           CPU budget: shared worker threads for all sessions
+ *   --progress <json|text>  Progress format on stdout (default: json)
+ *   --estimate              Print the pre-run estimate per file instead of extracting
+ *   --help                  Show all options
+ */
+
+#include <iostream>
+#include <string>
+#include <vector>
+#include <memory>
+#include <thread>
+#include <mutex>
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <iomanip>
+#include <algorithm>
+#include <filesystem>
+
+// Our common utilities
+#include "../../common/error_handler.hpp"
+#include "../../common/file_utils.hpp"
+#include "../../common/extraction_engine.hpp"
+#include "../../common/sdk_backend.hpp"
+#include "../../common/thread_pool.hpp"
+
+using namespace zed_tools;
+namespace fs = std::filesystem;
+
+/**
+ * @brief Exit code of one file (reported in its "done" event)
+ */
+enum FileExitCode {
+    kFileOk = 0,            ///< Extracted (or estimated) successfully
+    kFileFailed = 1,        ///< Extraction failed
+    kFileNoSpace = 2,       ///< --estimate: output volume too small
+    kFileInvalid = 3,       ///< Not a readable SVO2 file
+    kFileCancelled = 4      ///< Interrupted (SIGINT/SIGTERM) or never started
+};
+
+// CPU threads one depth session keeps busy (SDK grab/depth threads + colorize/write tasks)
+static const int kCpuThreadsPerSession = 4;
+
+// Time after which a starting session no longer holds back the next one
+static const double kWarmupTimeoutSec = 60.0;
+
+/**
+ * @brief Application configuration
+ */
+struct Config {
+    std::vector<std::string> inputs;              // SVO2 files and folders
+    zed_extractor::DepthExtractionConfig depth;   // Settings for every file (svoFilePath is set per file)
+    bool recursive = true;                        // Scan folders recursively
+    int jobs = 0;                                 // Concurrent SDK sessions (0 = auto)
+    int gpuReserveMB = 1024;                      // GPU memory kept free for other processes
+    int sessionGpuMB = 0;                         // GPU memory per session (0 = per-mode default, measured on the first session)
+    std::string progressFormat = "json";          // json or text
+    float progressIntervalSec = 1.0f;             // Minimum time between progress lines of one file
+    bool estimateOnly = false;                    // Print the pre-run estimate instead of extracting
+    int estimateSamples = 8;
+    bool showHelp = false;
+
+    Config() {
+        depth.baseOutputPath = "E:/Turbulence Solutions/AeroLock/ZED_Recordings_Output";
+    }
+};
+
+static std::atomic<bool> g_cancelRequested{false};
+
+extern "C" void onTerminateSignal(int) {
+    g_cancelRequested = true;
+}
+
+/**
+ * @brief Escape a string for a JSON value
+ */
+static std::string jsonEscape(const std::string& value) {
+    std::string out;
+    out.reserve(value.size() + 8);
+    for (unsigned char c : value) {
+        switch (c) {
+            case '"':  out += "\\\""; break;
+            case '\\': out += "\\\\"; break;
+            case '\n': out += "\\n"; break;
+            case '\r': out += "\\r"; break;
+            case '\t': out += "\\t"; break;
+            default:
+                if (c < 0x20) {
+                    char buf[8];
+                    std::snprintf(buf, sizeof(buf), "\\u%04x", c);
+                    out += buf;
+                } else {
+                    out += static_cast<char>(c);
+                }
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Join JSONBuilder's indented output into a single line
+ */
+static std::string compactJson(const std::string& json) {
+    std::string out;
+    out.reserve(json.size());
+    bool inString = false;
+    bool escaped = false;
+    bool skipIndent = false;
+    for (char c : json) {
+        if (inString) {
+            out += c;
+            if (escaped) escaped = false;
+            else if (c == '\\') escaped = true;
+            else if (c == '"') inString = false;
+            continue;
+        }
+        if (c == '\n') {
+            skipIndent = true;
+            continue;
+        }
+        if (skipIndent && c == ' ') continue;
+        skipIndent = false;
+        if (c == '"') inString = true;
+        out += c;
+    }
+    return out;
+}
+
+/**
+ * @brief One JSON object on one line
+ */
+class JsonLine {
+public:
+    explicit JsonLine(const std::string& event) { add("event", event); }
+
+    JsonLine& add(const std::string& key, const std::string& value) {
+        return addRaw(key, "\"" + jsonEscape(value) + "\"");
+    }
+    JsonLine& add(const std::string& key, const char* value) { return add(key, std::string(value)); }
+    JsonLine& add(const std::string& key, int value) { return addRaw(key, std::to_string(value)); }
+    JsonLine& add(const std::string& key, bool value) { return addRaw(key, value ? "true" : "false"); }
+    JsonLine& add(const std::string& key, double value) {
+        std::ostringstream oss;
+        oss << std::fixed << std::setprecision(3) << value;
+        return addRaw(key, oss.str());
+    }
+
+    /**
+     * @brief Add an already serialized JSON value
+     */
+    JsonLine& addRaw(const std::string& key, const std::string& json) {
+        if (!body_.empty()) body_ += ",";
+        body_ += "\"" + jsonEscape(key) + "\":" + json;
+        return *this;
+    }
+
+    std::string str() const { return "{" + body_ + "}"; }
+
+private:
+    std::string body_;
+};
+
+/**
+ * @brief Serializes progress output of all sessions on stdout
+ */
+class ProgressReporter {
+public:
+    explicit ProgressReporter(bool json) : json_(json) {}
+
+    bool isJson() const { return json_; }
+
+    /**
+     * @brief Emit a JSON event (json mode) or the text line (text mode)
+     */
+    void emit(const JsonLine& event, const std::string& text) {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (json_) {
+            std::cout << event.str() << std::endl;
+        } else if (!text.empty()) {
+            std::cout << text << std::endl;
+        }
+    }
+
+private:
+    bool json_;
+    std::mutex mutex_;
+};
+
+/**
+ * @brief One input file and, once started, its SDK session
+ */
+struct Job {
+    int index = 0;
+    std::string path;
+    std::string label;                                  // Parent folder/file name for text output
+    std::unique_ptr<zed_extractor::ExtractionEngine> engine;
+    std::thread thread;
+    std::chrono::steady_clock::time_point started;
+    std::atomic<bool> warm{false};                      // Past SDK/model initialization
+    std::atomic<bool> done{false};
+    int exitCode = kFileCancelled;
+    // Progress throttling (touched by the job thread only)
+    std::chrono::steady_clock::time_point lastEmit;
+    int lastPercent = -1;
+};
+
+/**
+ * @brief Rough GPU memory of one depth session at HD1080 (the first session's measurement replaces it)
+ */
+static uint64_t defaultSessionGpuBytes(const std::string& depthMode) {
+    int mb = 1800;
+    if (depthMode == "PERFORMANCE") mb = 800;
+    else if (depthMode == "QUALITY") mb = 1000;
+    else if (depthMode == "ULTRA") mb = 1200;
+    else if (depthMode == "NEURAL_PLUS") mb = 2600;
+    return static_cast<uint64_t>(mb) << 20;
+}
+
+static int toMB(uint64_t bytes) {
+    return static_cast<int>(bytes >> 20);
+}
+
+/**
+ * @brief Parse command-line arguments
+ */
+bool parseArguments(int argc, char* argv[], Config& config) {
+    // Check for help flag first
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            config.showHelp = true;
+            return true;
+        }
+    }
+
+    zed_extractor::DepthExtractionConfig& d = config.depth;
+    try {
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            const bool hasValue = i + 1 < argc;
+
+            // Inputs
+            if (arg.rfind("--", 0) != 0) {
+                config.inputs.push_back(arg);
+            }
+            else if (arg == "--no-recursive") {
+                config.recursive = false;
+            }
+            // Output
+            else if (arg == "--base-output" && hasValue) {
+                d.baseOutputPath = argv[++i];
+            }
+            else if (arg == "--scratch" && hasValue) {
+                d.scratchPath = argv[++i];
+            }
+            else if (arg == "--scratch-limit-gb" && hasValue) {
+                d.scratchLimitGB = std::stof(argv[++i]);
+            }
+            else if (arg == "--upload-url" && hasValue) {
+                d.uploadUrl = argv[++i];
+            }
+            else if (arg == "--upload-no-local") {
+                d.uploadKeepLocal = false;
+            }
+            else if (arg == "--upload-workers" && hasValue) {
+                d.uploadWorkers = std::stoi(argv[++i]);
+            }
+            // Sampling and depth
+            else if (arg == "--fps" && hasValue) {
+                d.outputFps = std::stof(argv[++i]);
+            }
+            else if (arg == "--depth-mode" && hasValue) {
+                d.depthMode = argv[++i];
+                std::transform(d.depthMode.begin(), d.depthMode.end(), d.depthMode.begin(), ::toupper);
+            }
+            else if (arg == "--confidence" && hasValue) {
+                d.confidenceThreshold = std::stoi(argv[++i]);
+            }
+            else if (arg == "--min-depth" && hasValue) {
+                d.minDepth = std::stof(argv[++i]);
+            }
+            else if (arg == "--max-depth" && hasValue) {
+                d.maxDepth = std::stof(argv[++i]);
+            }
+            else if (arg == "--order" && hasValue) {
+                d.frameOrder = argv[++i];
+            }
+            else if (arg == "--time-budget" && hasValue) {
+                d.timeBudgetSec = std::stof(argv[++i]);
+            }
+            else if (arg == "--follow") {
+                d.followMode = true;
+            }
+            else if (arg == "--follow-poll-ms" && hasValue) {
+                d.followPollMs = std::stoi(argv[++i]);
+            }
+            else if (arg == "--follow-timeout" && hasValue) {
+                d.followIdleTimeoutSec = std::stof(argv[++i]);
+            }
+            // Products
+            else if (arg == "--raw") {
+                d.saveRawDepth = true;
+            }
+            else if (arg == "--raw-format" && hasValue) {
+                d.rawDepthFormat = argv[++i];
+            }
+            else if (arg == "--no-heatmaps") {
+                d.saveColorized = false;
+            }
+            else if (arg == "--lazy-heatmaps") {
+                d.lazyHeatmaps = true;
+            }
+            else if (arg == "--video") {
+                d.saveVideo = true;
+            }
+            else if (arg == "--rgb-frames") {
+                d.saveRgbFrames = true;
+            }
+            else if (arg == "--confidence-maps") {
+                d.saveConfidenceMaps = true;
+            }
+            else if (arg == "--image-format" && hasValue) {
+                d.imageFormat = argv[++i];
+            }
+            else if (arg == "--store-previews") {
+                d.storePreviews = true;
+            }
+            else if (arg == "--preview-width" && hasValue) {
+                d.previewMaxWidth = std::stoi(argv[++i]);
+            }
+            else if (arg == "--frame-stats") {
+                d.collectFrameStats = true;
+            }
+            // Heatmap rendering
+            else if (arg == "--colormap" && hasValue) {
+                d.colorMap = argv[++i];
+            }
+            else if (arg == "--no-overlay") {
+                d.overlayOnRgb = false;
+            }
+            else if (arg == "--overlay-strength" && hasValue) {
+                d.overlayStrength = std::stoi(argv[++i]);
+            }
+            else if (arg == "--no-auto-contrast") {
+                d.autoContrast = false;
+            }
+            else if (arg == "--log-scale") {
+                d.logScale = true;
+            }
+            else if (arg == "--edge-boost" && hasValue) {
+                d.useEdgeBoost = true;
+                d.edgeBoostFactor = std::stof(argv[++i]);
+            }
+            else if (arg == "--clahe") {
+                d.useClahe = true;
+            }
+            else if (arg == "--temporal-smooth" && hasValue) {
+                d.useTemporalSmooth = true;
+                d.temporalAlpha = std::stof(argv[++i]);
+            }
+            // Motion and objects
+            else if (arg == "--motion" && hasValue) {
+                d.highlightMotion = true;
+                d.motionGain = std::stof(argv[++i]);
+            }
+            else if (arg == "--background-model") {
+                d.useBackgroundModel = true;
+            }
+            else if (arg == "--bg-alpha" && hasValue) {
+                d.backgroundAlpha = std::stof(argv[++i]);
+            }
+            else if (arg == "--bg-k-sigma" && hasValue) {
+                d.backgroundKSigma = std::stof(argv[++i]);
+            }
+            else if (arg == "--save-bg-variance") {
+                d.saveBackgroundVariance = true;
+            }
+            else if (arg == "--track") {
+                d.enableTracking = true;
+            }
+            else if (arg == "--track-max-range" && hasValue) {
+                d.trackMaxRange = std::stof(argv[++i]);
+            }
+            else if (arg == "--track-min-blob" && hasValue) {
+                d.trackMinBlobPixels = std::stoi(argv[++i]);
+            }
+            else if (arg == "--no-track-boxes") {
+                d.drawTracks = false;
+            }
+            else if (arg == "--ground-plane") {
+                d.useGroundPlane = true;
+            }
+            else if (arg == "--object-min-height" && hasValue) {
+                d.objectMinHeight = std::stof(argv[++i]);
+            }
+            else if (arg == "--no-ground-mask") {
+                d.maskGroundInHeatmap = false;
+            }
+            else if (arg == "--sparse-flow") {
+                d.useSparseFlow = true;
+            }
+            else if (arg == "--flow-threshold" && hasValue) {
+                d.flowResidualThreshold = std::stof(argv[++i]);
+            }
+            // Occupancy grid
+            else if (arg == "--occupancy" && hasValue) {
+                d.saveOccupancyGrid = true;
+                d.occupancyMode = argv[++i];
+            }
+            else if (arg == "--occupancy-cell" && hasValue) {
+                d.occupancyCellSize = std::stof(argv[++i]);
+            }
+            else if (arg == "--occupancy-pose") {
+                d.occupancyUsePose = true;
+            }
+            else if (arg == "--occupancy-extent" && hasValue) {
+                d.occupancyWorldExtent = std::stof(argv[++i]);
+            }
+            // Resources
+            else if (arg == "--jobs" && hasValue) {
+                std::string value = argv[++i];
+                config.jobs = (value == "auto") ? 0 : std::stoi(value);
+            }
+            else if (arg == "--threads" && hasValue) {
+                d.workerThreads = std::stoi(argv[++i]);
+            }
+            else if (arg == "--gpu-reserve-mb" && hasValue) {
+                config.gpuReserveMB = std::stoi(argv[++i]);
+            }
+            else if (arg == "--session-gpu-mb" && hasValue) {
+                config.sessionGpuMB = std::stoi(argv[++i]);
+            }
+            else if (arg == "--background") {
+                d.lowPriority = true;
+            }
+            else if (arg == "--max-fps" && hasValue) {
+                d.maxProcessFps = std::stof(argv[++i]);
+            }
+            else if (arg == "--max-write-mbps" && hasValue) {
+                d.maxWriteMBps = std::stof(argv[++i]);
+            }
+            else if (arg == "--read-ahead" && hasValue) {
+                d.readAheadMB = std::stoi(argv[++i]);
+            }
+            // Reporting
+            else if (arg == "--progress" && hasValue) {
+                config.progressFormat = argv[++i];
+            }
+            else if (arg == "--progress-interval" && hasValue) {
+                config.progressIntervalSec = std::stof(argv[++i]);
+            }
+            else if (arg == "--estimate") {
+                config.estimateOnly = true;
+            }
+            else if (arg == "--estimate-samples" && hasValue) {
+                config.estimateSamples = std::stoi(argv[++i]);
+            }
+            else {
+                std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+            }
+        }
+    } catch (const std::exception&) {
+        std::cerr << "Error: Invalid numeric value in arguments" << std::endl;
+        return false;
+    }
+
+    // Require at least one input
+    if (config.inputs.empty()) {
+        std::cerr << "Error: SVO file or folder required" << std::endl;
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief Print help message
+ */
+void printHelp() {
+    std::cout << "\n=== ZED Depth Extractor CLI ===\n\n";
+    std::cout << "Extract depth maps from ZED SVO2 files without the GUI; several files run\n";
+    std::cout << "as concurrent SDK sessions.\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  depth_extractor_cli <svo_file|folder>... [options]\n\n";
+    std::cout << "Arguments:\n";
+    std::cout << "  <svo_file|folder>       SVO2 files and/or folders containing them\n";
+    std::cout << "  --no-recursive          Only scan the top level of folders\n\n";
+    std::cout << "Output:\n";
+    std::cout << "  --base-output <path>    Base output directory\n";
+    std::cout << "                          (default: E:/Turbulence Solutions/AeroLock/ZED_Recordings_Output)\n";
+    std::cout << "  --scratch <path>        Write to this fast tier, move to the base output when done\n";
+    std::cout << "  --scratch-limit-gb <n>  Staged data before new files wait (default: 50)\n";
+    std::cout << "  --upload-url <url>      Stream outputs to http://host[:port]/bucket[/prefix]\n";
+    std::cout << "                          (AWS_ACCESS_KEY_ID / AWS_SECRET_ACCESS_KEY)\n";
+    std::cout << "  --upload-no-local       With --upload-url: keep no local copies\n";
+    std::cout << "  --upload-workers <n>    Concurrent uploads (default: 4)\n\n";
+    std::cout << "Sampling and depth:\n";
+    std::cout << "  --fps <rate>            Depth maps per second of video (default: 1.0)\n";
+    std::cout << "  --depth-mode <mode>     PERFORMANCE, QUALITY, ULTRA, NEURAL, NEURAL_PLUS (default: NEURAL)\n";
+    std::cout << "  --confidence <0-100>    SDK confidence threshold (default: 60)\n";
+    std::cout << "  --min-depth <m>         Colorization range start (default: 10)\n";
+    std::cout << "  --max-depth <m>         Colorization range end (default: 40)\n";
+    std::cout << "  --order <order>         sequential or coarse_to_fine (default: sequential)\n";
+    std::cout << "  --time-budget <sec>     Stop each file after this long (default: no limit)\n";
+    std::cout << "  --follow                At the end wait for the SVO to grow (still recording)\n";
+    std::cout << "  --follow-poll-ms <n>    Growth check interval (default: 500)\n";
+    std::cout << "  --follow-timeout <sec>  Stop following after this long without growth (default: 30)\n\n";
+    std::cout << "Products:\n";
+    std::cout << "  --raw                   Save raw float depth\n";
+    std::cout << "  --raw-format <fmt>      tiff32f, pfm, exr, bin (default: tiff32f)\n";
+    std::cout << "  --no-heatmaps           Do not save colorized heatmaps\n";
+    std::cout << "  --lazy-heatmaps         Store raw inputs only; heatmap_renderer_cli renders on demand\n";
+    std::cout << "  --video                 Heatmap video\n";
+    std::cout << "  --rgb-frames            Save left RGB frames (for re-rendering overlays)\n";
+    std::cout << "  --confidence-maps       Save 8-bit confidence maps\n";
+    std::cout << "  --image-format <fmt>    png or qoi (default: png)\n";
+    std::cout << "  --store-previews        Keep per-frame previews in memory (GUI navigation; off here)\n";
+    std::cout << "  --preview-width <px>    Preview downscale width (default: 960)\n";
+    std::cout << "  --frame-stats           Per-frame nearest distance, valid pixels, detections to frame_stats.csv\n\n";
+    std::cout << "Heatmap rendering:\n";
+    std::cout << "  --colormap <name>       turbo, viridis, plasma, jet (default: turbo)\n";
+    std::cout << "  --no-overlay            Heatmap only, no blend over the left image\n";
+    std::cout << "  --overlay-strength <n>  0 = only RGB, 100 = only heatmap (default: 100)\n";
+    std::cout << "  --no-auto-contrast      Fixed range instead of per-frame percentile stretch\n";
+    std::cout << "  --log-scale             Logarithmic depth scale\n";
+    std::cout << "  --edge-boost <factor>   Gradient edge boost (0-2)\n";
+    std::cout << "  --clahe                 CLAHE local contrast\n";
+    std::cout << "  --temporal-smooth <a>   EMA smoothing with this alpha (0.1-0.5)\n\n";
+    std::cout << "Motion and objects:\n";
+    std::cout << "  --motion <gain>         Highlight moving objects (0-1)\n";
+    std::cout << "  --background-model      Per-pixel background model for the motion highlight\n";
+    std::cout << "  --bg-alpha <a>          Background adaptation rate (default: 0.02)\n";
+    std::cout << "  --bg-k-sigma <k>        Foreground threshold in standard deviations (default: 3)\n";
+    std::cout << "  --save-bg-variance      Write background_variance.tiff at the end\n";
+    std::cout << "  --track                 Detect and track near-range depth blobs\n";
+    std::cout << "  --track-max-range <m>   Detection range (default: 40)\n";
+    std::cout << "  --track-min-blob <px>   Minimum blob area at 1/4 resolution (default: 12)\n";
+    std::cout << "  --no-track-boxes        Do not draw track boxes on heatmaps\n";
+    std::cout << "  --ground-plane          RANSAC ground plane; detector only sees objects above it\n";
+    std::cout << "  --object-min-height <m> Height above ground that counts as an object (default: 1)\n";
+    std::cout << "  --no-ground-mask        Keep ground and sky in heatmap contrast\n";
+    std::cout << "  --sparse-flow           Flag independent motion with ego-compensated LK flow\n";
+    std::cout << "  --flow-threshold <px>   Residual flow that counts as motion (default: 1.5)\n\n";
+    std::cout << "Occupancy grid:\n";
+    std::cout << "  --occupancy <mode>      Save bird's-eye grids: occupancy or height\n";
+    std::cout << "  --occupancy-cell <m>    Cell edge (default: 0.25)\n";
+    std::cout << "  --occupancy-pose        World-aligned grid from positional tracking\n";
+    std::cout << "  --occupancy-extent <m>  Half-size of the world grid (default: 150)\n\n";
+    std::cout << "Resources:\n";
+    std::cout << "  --jobs <n|auto>         Concurrent SDK sessions (default: auto = CPU budget / 4,\n";
+    std::cout << "                          started while the GPU has room for another session)\n";
+    std::cout << "  --threads <n>           CPU budget: worker threads shared by all sessions\n";
+    std::cout << "                          (default: ZED_EXTRACTOR_THREADS or all hardware threads)\n";
+    std::cout << "  --gpu-reserve-mb <n>    GPU memory left free for other processes (default: 1024)\n";
+    std::cout << "  --session-gpu-mb <n>    GPU memory per session (default: measured on the first one)\n";
+    std::cout << "  --background            Low priority: idle CPU/IO, backs off while the system is busy\n";
+    std::cout << "  --max-fps <rate>        With --background: processed frames per second cap\n";
+    std::cout << "  --max-write-mbps <n>    With --background: output write cap in MiB/s\n";
+    std::cout << "  --read-ahead <MB>       Prefetch this much of each SVO ahead of decode\n\n";
+    std::cout << "Reporting:\n";
+    std::cout << "  --progress <fmt>        json (JSON lines on stdout, log on stderr) or text (default: json)\n";
+    std::cout << "  --progress-interval <s> Minimum time between progress lines of one file (default: 1)\n";
+    std::cout << "  --estimate              Print the expected runtime, output size and memory per file\n";
+    std::cout << "  --estimate-samples <n>  Frames sampled for --estimate (default: 8)\n";
+    std::cout << "  --help, -h              Show this help message\n\n";
+    std::cout << "JSON events:\n";
+    std::cout << "  batch     files, sessions and GPU/CPU sizing\n";
+    std::cout << "  start     index, file\n";
+    std::cout << "  progress  index, file, progress (0-1), message\n";
+    std::cout << "  estimate  index, file, estimate (with --estimate)\n";
+    std::cout << "  done      index, file, exit_code, frames, output, seconds, error\n";
+    std::cout << "  summary   files, succeeded, failed, seconds, exit_code\n\n";
+    std::cout << "Exit codes (per file in \"done\"; the process returns the first nonzero one):\n";
+    std::cout << "  0 ok, 1 extraction failed, 2 not enough free space (--estimate),\n";
+    std::cout << "  3 not a readable SVO2 file, 4 cancelled or not started\n\n";
+    std::cout << "Output Structure:\n";
+    std::cout << "  <base>/Extractions/flight_XXX/extraction_NNN/ (one folder per file)\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  depth_extractor_cli flight.svo2 --fps 2 --raw\n";
+    std::cout << "  depth_extractor_cli D:/Flights --depth-mode NEURAL --jobs auto --threads 16\n";
+    std::cout << "  depth_extractor_cli a.svo2 b.svo2 --jobs 2 --progress text\n";
+    std::cout << "  depth_extractor_cli D:/Flights --estimate\n\n";
+}
+
+/**
+ * @brief Validate configuration
+ */
+ErrorResult validateConfig(const Config& config) {
+    const zed_extractor::DepthExtractionConfig& d = config.depth;
+
+    if (d.outputFps <= 0) {
+        return ErrorResult::failure("FPS must be positive: " + std::to_string(d.outputFps));
+    }
+
+    const std::vector<std::string> modes = { "PERFORMANCE", "QUALITY", "ULTRA", "NEURAL", "NEURAL_PLUS" };
+    if (std::find(modes.begin(), modes.end(), d.depthMode) == modes.end()) {
+        return ErrorResult::failure("Invalid depth mode: " + d.depthMode);
+    }
+
+    if (d.minDepth < 0 || d.maxDepth <= d.minDepth) {
+        return ErrorResult::failure("Depth range must satisfy 0 <= min < max");
+    }
+
+    if (d.confidenceThreshold < 0 || d.confidenceThreshold > 100) {
+        return ErrorResult::failure("Confidence threshold must be 0-100");
+    }
+
+    if (d.overlayStrength < 0 || d.overlayStrength > 100) {
+        return ErrorResult::failure("Overlay strength must be 0-100");
+    }
+
+    if (d.rawDepthFormat != "tiff32f" && d.rawDepthFormat != "pfm" &&
+        d.rawDepthFormat != "exr" && d.rawDepthFormat != "bin") {
+        return ErrorResult::failure("Invalid raw depth format: " + d.rawDepthFormat);
+    }
+
+    if (d.imageFormat != "png" && d.imageFormat != "qoi") {
+        return ErrorResult::failure("Invalid image format: " + d.imageFormat);
+    }
+
+    if (d.colorMap != "turbo" && d.colorMap != "viridis" && d.colorMap != "plasma" && d.colorMap != "jet") {
+        return ErrorResult::failure("Invalid color map: " + d.colorMap);
+    }
+
+    if (d.frameOrder != "sequential" && d.frameOrder != "coarse_to_fine") {
+        return ErrorResult::failure("Invalid frame order: " + d.frameOrder);
+    }
+
+    if (d.occupancyMode != "occupancy" && d.occupancyMode != "height") {
+        return ErrorResult::failure("Invalid occupancy mode: " + d.occupancyMode);
+    }
+
+    if (!d.saveColorized && !d.saveRawDepth && !d.lazyHeatmaps && !d.saveVideo && !d.saveOccupancyGrid) {
+        return ErrorResult::failure("Nothing to save: enable heatmaps, --raw, --lazy-heatmaps, --video or --occupancy");
+    }
+
+    if (config.jobs < 0 || d.workerThreads < 0 || d.readAheadMB < 0 || d.uploadWorkers < 1) {
+        return ErrorResult::failure("Jobs, threads, read-ahead must not be negative; upload workers at least 1");
+    }
+
+    if (config.gpuReserveMB < 0 || config.sessionGpuMB < 0) {
+        return ErrorResult::failure("GPU memory sizes must not be negative");
+    }
+
+    if (config.progressFormat != "json" && config.progressFormat != "text") {
+        return ErrorResult::failure("Invalid progress format: " + config.progressFormat);
+    }
+
+    if (config.estimateSamples < 1) {
+        return ErrorResult::failure("Estimate samples must be at least 1");
+    }
+
+    return ErrorResult::success();
+}
+
+/**
+ * @brief Expand files and folders into the list of SVOs (input order, folders sorted)
+ */
+std::vector<std::string> collectInputFiles(const Config& config) {
+    std::vector<std::string> files;
+    for (const std::string& input : config.inputs) {
+        std::error_code ec;
+        if (fs::is_directory(input, ec)) {
+            std::vector<std::string> found;
+            try {
+                for (const auto& info : FileUtils::scanForSVO2Files(input, config.recursive)) {
+                    found.push_back(info.filePath.string());
+                }
+            } catch (const std::exception& e) {
+                LOG_WARNING("Cannot scan " + input + ": " + e.what());
+            }
+            if (found.empty()) LOG_WARNING("No SVO2 files in " + input);
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        } else {
+            files.push_back(input);   // Checked per file; unreadable ones fail with their own exit code
+        }
+    }
+
+    // A file named twice (or found in two scanned folders) runs once
+    std::vector<std::string> unique;
+    for (const std::string& file : files) {
+        if (std::find(unique.begin(), unique.end(), file) == unique.end()) unique.push_back(file);
+    }
+    return unique;
+}
+
+/**
+ * @brief Runs the files as concurrent SDK sessions
+ */
+class DepthBatchRunner {
+public:
+    DepthBatchRunner(const Config& config, ProgressReporter& reporter)
+        : config_(config), reporter_(reporter) {}
+
+    /**
+     * @return Process exit code (first nonzero file exit code)
+     */
+    int run(const std::vector<std::string>& files) {
+        const auto batchStart = std::chrono::steady_clock::now();
+        for (size_t i = 0; i < files.size(); ++i) {
+            auto job = std::make_unique<Job>();
+            job->index = static_cast<int>(i);
+            job->path = files[i];
+            fs::path p(files[i]);
+            job->label = p.parent_path().filename().string() + "/" + p.filename().string();
+            jobs_.push_back(std::move(job));
+        }
+
+        planSessions();
+
+        size_t next = 0;
+        std::vector<Job*> running;
+        Job* starting = nullptr;   // Admitted, still initializing: the next session waits for it
+        uint64_t freeBeforeFirst = 0;
+        bool measuring = false;
+
+        while (next < jobs_.size() || !running.empty()) {
+            if (g_cancelRequested && !cancelled_) {
+                cancelled_ = true;
+                LOG_WARNING("Cancel requested; stopping " + std::to_string(running.size()) + " running session(s)");
+                for (Job* job : running) job->engine->cancel();
+            }
+
+            // Reap finished sessions
+            for (auto it = running.begin(); it != running.end();) {
+                if ((*it)->done) {
+                    if ((*it)->thread.joinable()) (*it)->thread.join();
+                    (*it)->engine.reset();   // Release the SDK session's GPU memory now
+                    it = running.erase(it);
+                } else {
+                    ++it;
+                }
+            }
+
+            // The starting session has allocated its GPU memory: measure it if it ran alone
+            if (starting) {
+                const double waited = std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - starting->started).count();
+                if (starting->warm || starting->done || waited > kWarmupTimeoutSec) {
+                    uint64_t freeNow = 0, total = 0;
+                    if (measuring && starting->warm && !starting->done && backend_->getGpuMemory(freeNow, total) &&
+                        freeBeforeFirst > freeNow) {
+                        const uint64_t measured = freeBeforeFirst - freeNow;
+                        if (measured > (64ull << 20)) {
+                            sessionBytes_ = measured + measured / 4;   // Headroom for buffers allocated later
+                            LOG_INFO("Measured GPU memory per session: " + std::to_string(toMB(measured)) +
+                                     " MB (planning with " + std::to_string(toMB(sessionBytes_)) + " MB)");
+                        }
+                    }
+                    measuring = false;
+                    starting = nullptr;
+                }
+            }
+
+            // Not started: invalid files fail right away, the rest wait for a session slot
+            while (next < jobs_.size() && !FileUtils::validateSVO2File(jobs_[next]->path)) {
+                finishInvalid(*jobs_[next++]);
+            }
+            if (cancelled_) {
+                next = jobs_.size();   // Remaining files keep kFileCancelled
+            }
+
+            if (next < jobs_.size() && !starting && static_cast<int>(running.size()) < maxSessions_ &&
+                gpuHasRoom(running.empty())) {
+                Job& job = *jobs_[next++];
+                uint64_t total = 0;
+                if (running.empty() && gpuKnown_ && config_.sessionGpuMB == 0 && !measured_ &&
+                    backend_->getGpuMemory(freeBeforeFirst, total)) {
+                    measuring = true;
+                    measured_ = true;
+                }
+                start(job);
+                running.push_back(&job);
+                starting = &job;
+            }
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(100));
+        }
+
+        return summarize(std::chrono::duration<double>(std::chrono::steady_clock::now() - batchStart).count());
+    }
+
+private:
+    const Config& config_;
+    ProgressReporter& reporter_;
+    std::vector<std::unique_ptr<Job>> jobs_;
+    zed_extractor::SdkBackend* backend_ = nullptr;
+    int maxSessions_ = 1;
+    bool gpuKnown_ = false;
+    uint64_t sessionBytes_ = 0;
+    bool measured_ = false;
+    bool cancelled_ = false;
+
+    /**
+     * @brief Size the session count from the CPU budget and the GPU
+     */
+    void planSessions() {
+        // One shared pool for all sessions; its size is the CPU budget
+        if (config_.depth.workerThreads > 0 && !ThreadPool::configureGlobal(config_.depth.workerThreads)) {
+            LOG_INFO("Worker thread count is fixed by ZED_EXTRACTOR_THREADS");
+        }
+        const int cpuThreads = ThreadPool::global().getConcurrency();
+        const int cpuSessions = std::max(1, cpuThreads / kCpuThreadsPerSession);
+        maxSessions_ = config_.jobs > 0 ? config_.jobs : cpuSessions;
+        maxSessions_ = std::max(1, std::min<int>(maxSessions_, static_cast<int>(jobs_.size())));
+
+        backend_ = zed_extractor::getSdkBackend();
+        uint64_t freeBytes = 0, totalBytes = 0;
+        gpuKnown_ = backend_ && backend_->getGpuMemory(freeBytes, totalBytes);
+        sessionBytes_ = config_.sessionGpuMB > 0 ? (static_cast<uint64_t>(config_.sessionGpuMB) << 20)
+                                                 : defaultSessionGpuBytes(config_.depth.depthMode);
+
+        JsonLine event("batch");
+        event.add("files", static_cast<int>(jobs_.size()))
+             .add("max_sessions", maxSessions_)
+             .add("cpu_threads", cpuThreads)
+             .add("gpu_known", gpuKnown_);
+        std::ostringstream text;
+        text << "Batch: " << jobs_.size() << " file(s), up to " << maxSessions_ << " concurrent session(s), "
+             << cpuThreads << " worker threads";
+        if (gpuKnown_) {
+            const int gpuSessions = static_cast<int>(std::max<int64_t>(1,
+                (static_cast<int64_t>(totalBytes) - (static_cast<int64_t>(config_.gpuReserveMB) << 20)) /
+                static_cast<int64_t>(sessionBytes_)));
+            event.add("gpu_total_mb", toMB(totalBytes))
+                 .add("gpu_free_mb", toMB(freeBytes))
+                 .add("session_gpu_mb", toMB(sessionBytes_))
+                 .add("gpu_sessions", gpuSessions);
+            text << "; GPU " << toMB(freeBytes) << "/" << toMB(totalBytes) << " MB free, ~"
+                 << toMB(sessionBytes_) << " MB per session (room for " << gpuSessions << ")";
+        } else {
+            text << "; GPU memory unknown, sessions limited by --jobs/CPU only";
+        }
+        reporter_.emit(event, text.str());
+        LOG_INFO(text.str());
+    }
+
+    /**
+     * @brief Whether free GPU memory covers another session (the first one always starts)
+     */
+    bool gpuHasRoom(bool noneRunning) const {
+        if (noneRunning || !gpuKnown_) return true;
+        uint64_t freeBytes = 0, totalBytes = 0;
+        if (!backend_->getGpuMemory(freeBytes, totalBytes)) return true;
+        return freeBytes >= sessionBytes_ + (static_cast<uint64_t>(config_.gpuReserveMB) << 20);
+    }
+
+    void start(Job& job) {
+        job.engine = std::make_unique<zed_extractor::ExtractionEngine>();
+        job.started = std::chrono::steady_clock::now();
+
+        JsonLine event("start");
+        event.add("index", job.index).add("file", job.path);
+        reporter_.emit(event, prefix(job) + "started");
+
+        job.thread = std::thread([this, &job]() { runJob(job); });
+    }
+
+    void runJob(Job& job) {
+        zed_extractor::DepthExtractionConfig cfg = config_.depth;
+        cfg.svoFilePath = job.path;
+        cfg.workerThreads = 0;   // Shared pool already sized in planSessions()
+
+        // Depth extraction reports 0.15 once the SDK and outputs are set up; estimates after the first sample
+        const float warmProgress = config_.estimateOnly ? 0.0f : 0.15f;
+        auto callback = [this, &job, warmProgress](float progress, const std::string& message) {
+            if (progress > warmProgress) job.warm = true;
+            onProgress(job, progress, message);
+        };
+
+        zed_extractor::ExtractionResult result;
+        int exitCode = kFileOk;
+        std::string output;
+        if (config_.estimateOnly) {
+            zed_extractor::ExtractionEstimate estimate;
+            result = job.engine->estimateDepth(cfg, estimate, config_.estimateSamples, callback);
+            if (result.success) {
+                output = estimate.outputPath;
+                JsonLine event("estimate");
+                event.add("index", job.index).add("file", job.path)
+                     .addRaw("estimate", compactJson(zed_extractor::estimateToJson(estimate)));
+                reporter_.emit(event, prefix(job) + "estimate\n" + zed_extractor::formatEstimate(estimate));
+                if (estimate.space == zed_extractor::SpaceVerdict::Insufficient) {
+                    exitCode = kFileNoSpace;
+                    result.errorMessage = "Not enough free space in " + cfg.baseOutputPath;
+                }
+            }
+        } else {
+            result = job.engine->extractDepth(cfg, callback);
+            output = result.outputPath;
+        }
+        if (!result.success) {
+            exitCode = g_cancelRequested ? kFileCancelled : kFileFailed;
+        }
+
+        job.exitCode = exitCode;
+        const double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - job.started).count();
+        JsonLine event("done");
+        event.add("index", job.index).add("file", job.path)
+             .add("exit_code", exitCode)
+             .add("frames", result.framesProcessed)
+             .add("output", output)
+             .add("seconds", seconds)
+             .add("error", exitCode == kFileOk ? std::string() : result.errorMessage);
+        std::ostringstream text;
+        text << prefix(job);
+        if (exitCode == kFileOk) text << "done, " << result.framesProcessed << " depth maps in " << std::fixed
+                                      << std::setprecision(1) << seconds << "s -> " << output;
+        else text << "failed (exit code " << exitCode << "): " << result.errorMessage;
+        reporter_.emit(event, text.str());
+        if (exitCode == kFileOk) LOG_INFO(text.str());
+        else LOG_ERROR(text.str());
+
+        job.done = true;
+    }
+
+    void onProgress(Job& job, float progress, const std::string& message) {
+        // Setup phases always; per-frame updates at most once per interval and per percent
+        const auto now = std::chrono::steady_clock::now();
+        const int percent = static_cast<int>(progress * 100.0f);
+        const bool setup = progress <= 0.15f || progress >= 1.0f;
+        if (!setup) {
+            const double sinceLast = std::chrono::duration<double>(now - job.lastEmit).count();
+            if (percent == job.lastPercent || sinceLast < config_.progressIntervalSec) return;
+        }
+        job.lastEmit = now;
+        job.lastPercent = percent;
+
+        JsonLine event("progress");
+        event.add("index", job.index).add("file", job.path)
+             .add("progress", static_cast<double>(progress))
+             .add("message", message);
+        reporter_.emit(event, prefix(job) + std::to_string(percent) + "% " + message);
+    }
+
+    void finishInvalid(Job& job) {
+        job.exitCode = kFileInvalid;
+        job.done = true;
+        JsonLine event("done");
+        event.add("index", job.index).add("file", job.path)
+             .add("exit_code", static_cast<int>(kFileInvalid))
+             .add("frames", 0)
+             .add("output", "")
+             .add("seconds", 0.0)
+             .add("error", "Invalid SVO2 file");
+        reporter_.emit(event, prefix(job) + "failed (exit code 3): invalid SVO2 file");
+        LOG_ERROR("Invalid SVO2 file: " + job.path);
+    }
+
+    int summarize(double seconds) {
+        int succeeded = 0;
+        int exitCode = 0;
+        for (const auto& job : jobs_) {
+            if (!job->done) {
+                // Never started (cancelled batch): report it like the others
+                JsonLine event("done");
+                event.add("index", job->index).add("file", job->path)
+                     .add("exit_code", static_cast<int>(kFileCancelled))
+                     .add("frames", 0)
+                     .add("output", "")
+                     .add("seconds", 0.0)
+                     .add("error", "Not started (cancelled)");
+                reporter_.emit(event, prefix(*job) + "not started (cancelled)");
+            }
+            if (job->exitCode == kFileOk) ++succeeded;
+            else if (exitCode == 0) exitCode = job->exitCode;
+        }
+        const int failed = static_cast<int>(jobs_.size()) - succeeded;
+
+        JsonLine event("summary");
+        event.add("files", static_cast<int>(jobs_.size()))
+             .add("succeeded", succeeded)
+             .add("failed", failed)
+             .add("seconds", seconds)
+             .add("exit_code", exitCode);
+        std::ostringstream text;
+        text << "Batch finished: " << succeeded << "/" << jobs_.size() << " file(s) succeeded in "
+             << std::fixed << std::setprecision(1) << seconds << "s";
+        reporter_.emit(event, text.str());
+        LOG_INFO(text.str());
+        return exitCode;
+    }
+
+    std::string prefix(const Job& job) const {
+        return "[" + std::to_string(job.index + 1) + "/" + std::to_string(jobs_.size()) + "] " + job.label + ": ";
+    }
+};
+
+/**
+ * @brief Main entry point
+ */
+int main(int argc, char* argv[]) {
+    // Parse arguments first (before logger initialization)
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        printHelp();
+        return 1;
+    }
+
+    if (config.showHelp) {
+        printHelp();
+        return 0;
+    }
+
+    // Initialize logger; in JSON mode stdout carries only the progress events
+    const bool json = (config.progressFormat == "json");
+    std::ostream& console = json ? std::cerr : std::cout;
+    Logger::getInstance().setConsoleToStderr(json);
+    try {
+        Logger::getInstance().initialize("depth_extractor.log", LogMode::BOTH, LogLevel::INFO);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to initialize logger: " << e.what() << std::endl;
+        std::cerr << "Continuing without file logging..." << std::endl;
+    }
+
+    console << "\n=== ZED Depth Extractor CLI v0.1.0 ===\n" << std::endl;
+    LOG_INFO("ZED Depth Extractor CLI v0.1.0 started");
+
+    // Validate configuration
+    auto validationResult = validateConfig(config);
+    if (validationResult.isFailure()) {
+        LOG_ERROR(validationResult.getMessage());
+        std::cerr << "Error: " << validationResult.getMessage() << std::endl;
+        return 1;
+    }
+
+    std::vector<std::string> files = collectInputFiles(config);
+    if (files.empty()) {
+        LOG_ERROR("No SVO2 files to process");
+        std::cerr << "Error: No SVO2 files to process" << std::endl;
+        return 1;
+    }
+
+    // Fail once here instead of once per file
+    std::string backendError;
+    if (!zed_extractor::getSdkBackend(&backendError)) {
+        std::cerr << "Error: " << backendError << std::endl;
+        return 1;
+    }
+
+    // Ctrl+C / SIGTERM cancel running sessions; they still write their metadata
+    std::signal(SIGINT, onTerminateSignal);
+    std::signal(SIGTERM, onTerminateSignal);
+
+    ProgressReporter reporter(json);
+    DepthBatchRunner runner(config, reporter);
+    int exitCode = runner.run(files);
+
+    if (exitCode == 0) {
+        console << "\n✓ Depth extraction complete!\n" << std::endl;
+        LOG_INFO("Application finished successfully");
+    }
+    Logger::getInstance().shutdown();
+
+    return exitCode;
+}
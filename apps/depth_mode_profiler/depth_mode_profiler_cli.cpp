@@ -0,0 +1,305 @@
+/**
+ * @file depth_mode_profiler_cli.cpp
+ * @brief Compares ZED depth modes on a short SVO segment and recommends one
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Runs the same sampled segment through each depth mode and reports
+ * grab+depth time per frame, valid-pixel fraction, temporal depth noise on
+ * static regions and thin-object coverage inside a user ROI. The cheapest
+ * mode meeting the given requirements is recommended.
+ *
+ * Usage:
+ *   depth_mode_profiler_cli <svo_file> [options]
+ *   depth_mode_profiler_cli --synthetic [options]
+ *
+ * Options:
+ *   --start <frame>         First frame of the segment (default: 0)
+ *   --frames <n>            Frames per mode, including warm-up (default: 60)
+ *   --warmup <n>            Frames excluded from measurements (default: 3)
+ *   --modes <a,b,...>       Modes to compare (default: all five)
+ *   --roi <x,y,w,h>         Thin-object region in pixels
+ *   --roi-max-depth <m>     ROI pixels closer than this count as object
+ *   --max-depth <m>         Valid depth range upper bound (default: 40)
+ *   --min-valid <0-1>       Requirement: valid-pixel fraction
+ *   --min-roi-coverage <0-1> Requirement: object pixels / ROI pixels
+ *   --max-noise <pct>       Requirement: static-region noise in percent of depth
+ *   --json <path>           Report path (default: depth_mode_profile.json)
+ *   --synthetic             Use the built-in stand-in scene instead of an SVO
+ *   --help                  Show this help message
+ */
+
+#include <chrono>
+#include <fstream>
+#include <iostream>
+#include <memory>
+#include <sstream>
+#include <string>
+#include <sl/Camera.hpp>
+
+// Our common utilities
+#include "../../common/error_handler.hpp"
+#include "../../common/file_utils.hpp"
+#include "../../common/depth_mode_profiler.hpp"
+
+using namespace zed_tools;
+using namespace zed_extractor;
+
+/**
+ * @brief Application configuration
+ */
+struct Config {
+    std::string svoFilePath;
+    bool synthetic = false;
+    int startFrame = 0;
+    int frames = 60;
+    std::string jsonPath = "depth_mode_profile.json";
+    DepthModeProfileConfig profile;
+    bool showHelp = false;
+};
+
+/**
+ * @brief SVO segment replayed through sl::Camera with a given depth mode
+ */
+class SvoDepthSource : public DepthFrameSource {
+public:
+    SvoDepthSource(const std::string& path, int startFrame, int frames)
+        : path_(path), startFrame_(startFrame), frames_(frames) {}
+
+    ~SvoDepthSource() override { close(); }
+
+    bool open(const std::string& mode, std::string& error) override {
+        close();
+        sl::InitParameters initParams;
+        initParams.input.setFromSVOFile(path_.c_str());
+        if (mode == "PERFORMANCE") initParams.depth_mode = sl::DEPTH_MODE::PERFORMANCE;
+        else if (mode == "QUALITY") initParams.depth_mode = sl::DEPTH_MODE::QUALITY;
+        else if (mode == "ULTRA") initParams.depth_mode = sl::DEPTH_MODE::ULTRA;
+        else if (mode == "NEURAL") initParams.depth_mode = sl::DEPTH_MODE::NEURAL;
+        else if (mode == "NEURAL_PLUS") initParams.depth_mode = sl::DEPTH_MODE::NEURAL_PLUS;
+        else {
+            error = "unknown depth mode: " + mode;
+            return false;
+        }
+        // Same settings as the depth extraction, so the numbers carry over
+        initParams.coordinate_units = sl::UNIT::METER;
+        initParams.depth_stabilization = true;
+        initParams.svo_real_time_mode = false;
+
+        sl::ERROR_CODE err = camera_.open(initParams);
+        if (err != sl::ERROR_CODE::SUCCESS) {
+            error = std::string("camera open failed: ") + sl::toString(err).c_str();
+            return false;
+        }
+        isOpen_ = true;
+        if (startFrame_ > 0) camera_.setSVOPosition(startFrame_);
+        produced_ = 0;
+        return true;
+    }
+
+    bool next(DepthSample& sample) override {
+        if (!isOpen_ || produced_ >= frames_) return false;
+        auto t0 = std::chrono::steady_clock::now();
+        if (camera_.grab() != sl::ERROR_CODE::SUCCESS) return false;
+        camera_.retrieveMeasure(depth_, sl::MEASURE::DEPTH);
+        auto t1 = std::chrono::steady_clock::now();
+        camera_.retrieveImage(gray_, sl::VIEW::LEFT_GRAY);
+
+        sample.depth = cv::Mat(depth_.getHeight(), depth_.getWidth(), CV_32FC1,
+                               depth_.getPtr<sl::uchar1>(sl::MEM::CPU), depth_.getStepBytes(sl::MEM::CPU)).clone();
+        sample.gray = cv::Mat(gray_.getHeight(), gray_.getWidth(), CV_8UC1,
+                              gray_.getPtr<sl::uchar1>(sl::MEM::CPU), gray_.getStepBytes(sl::MEM::CPU)).clone();
+        sample.processMs = std::chrono::duration<double, std::milli>(t1 - t0).count();
+        ++produced_;
+        return true;
+    }
+
+    void close() override {
+        if (isOpen_) camera_.close();
+        isOpen_ = false;
+    }
+
+private:
+    std::string path_;
+    int startFrame_;
+    int frames_;
+    int produced_ = 0;
+    bool isOpen_ = false;
+    sl::Camera camera_;
+    sl::Mat depth_;
+    sl::Mat gray_;
+};
+
+/**
+ * @brief Parse command-line arguments
+ */
+bool parseArguments(int argc, char* argv[], Config& config) {
+    // Check for help flag first
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            config.showHelp = true;
+            return true;
+        }
+    }
+
+    if (argc < 2) {
+        std::cerr << "Error: SVO file path or --synthetic required" << std::endl;
+        config.showHelp = true;
+        return false;
+    }
+
+    int first = 1;
+    if (std::string(argv[1]).rfind("--", 0) != 0) {
+        config.svoFilePath = argv[1];
+        first = 2;
+    }
+
+    for (int i = first; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--synthetic") {
+            config.synthetic = true;
+        }
+        else if (arg == "--start" && i + 1 < argc) {
+            config.startFrame = std::stoi(argv[++i]);
+        }
+        else if (arg == "--frames" && i + 1 < argc) {
+            config.frames = std::stoi(argv[++i]);
+        }
+        else if (arg == "--warmup" && i + 1 < argc) {
+            config.profile.warmupFrames = std::stoi(argv[++i]);
+        }
+        else if (arg == "--modes" && i + 1 < argc) {
+            config.profile.modes.clear();
+            std::stringstream ss(argv[++i]);
+            std::string mode;
+            while (std::getline(ss, mode, ',')) {
+                if (!mode.empty()) config.profile.modes.push_back(mode);
+            }
+        }
+        else if (arg == "--roi" && i + 1 < argc) {
+            int x, y, w, h;
+            char c1, c2, c3;
+            std::stringstream ss(argv[++i]);
+            if (!(ss >> x >> c1 >> y >> c2 >> w >> c3 >> h)) {
+                std::cerr << "Error: --roi expects x,y,w,h" << std::endl;
+                return false;
+            }
+            config.profile.roi = cv::Rect(x, y, w, h);
+        }
+        else if (arg == "--roi-max-depth" && i + 1 < argc) {
+            config.profile.roiMaxDepth = std::stof(argv[++i]);
+        }
+        else if (arg == "--max-depth" && i + 1 < argc) {
+            config.profile.maxDepth = std::stof(argv[++i]);
+        }
+        else if (arg == "--min-valid" && i + 1 < argc) {
+            config.profile.minValidFraction = std::stof(argv[++i]);
+        }
+        else if (arg == "--min-roi-coverage" && i + 1 < argc) {
+            config.profile.minRoiCoverage = std::stof(argv[++i]);
+        }
+        else if (arg == "--max-noise" && i + 1 < argc) {
+            config.profile.maxNoisePct = std::stof(argv[++i]);
+        }
+        else if (arg == "--json" && i + 1 < argc) {
+            config.jsonPath = argv[++i];
+        }
+        else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Print help message
+ */
+void printHelp() {
+    std::cout << "\n=== ZED Depth Mode Profiler ===\n\n";
+    std::cout << "Compare depth modes on a short SVO segment and pick the cheapest that is good enough.\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  depth_mode_profiler_cli <svo_file> [options]\n";
+    std::cout << "  depth_mode_profiler_cli --synthetic [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --start <frame>          First frame of the segment (default: 0)\n";
+    std::cout << "  --frames <n>             Frames per mode, including warm-up (default: 60)\n";
+    std::cout << "  --warmup <n>             Frames excluded from measurements (default: 3)\n";
+    std::cout << "  --modes <a,b,...>        PERFORMANCE,QUALITY,ULTRA,NEURAL,NEURAL_PLUS (default: all)\n";
+    std::cout << "  --roi <x,y,w,h>          Thin-object region (e.g. a wire or pole) in pixels\n";
+    std::cout << "  --roi-max-depth <m>      ROI pixels closer than this count as object (default: max depth)\n";
+    std::cout << "  --max-depth <m>          Valid depth upper bound (default: 40)\n";
+    std::cout << "  --min-valid <0-1>        Requirement: valid-pixel fraction\n";
+    std::cout << "  --min-roi-coverage <0-1> Requirement: object pixels / ROI pixels\n";
+    std::cout << "  --max-noise <pct>        Requirement: static-region noise, percent of depth\n";
+    std::cout << "  --json <path>            Report path (default: depth_mode_profile.json)\n";
+    std::cout << "  --synthetic              Built-in stand-in scene (no SVO or GPU needed)\n";
+    std::cout << "  --help, -h               Show this help message\n\n";
+    std::cout << "Noise is measured on pixels whose image stays unchanged over the segment,\n";
+    std::cout << "so pick a segment where the camera is still (e.g. before take-off).\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  depth_mode_profiler_cli flight.svo2 --start 300 --frames 40\n";
+    std::cout << "  depth_mode_profiler_cli flight.svo2 --roi 900,200,12,400 --roi-max-depth 15 --min-roi-coverage 0.6\n\n";
+}
+
+/**
+ * @brief Main entry point
+ */
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        printHelp();
+        return 1;
+    }
+
+    if (config.showHelp) {
+        printHelp();
+        return 0;
+    }
+
+    try {
+        Logger::getInstance().initialize("depth_mode_profiler.log", LogMode::BOTH, LogLevel::INFO);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to initialize logger: " << e.what() << std::endl;
+        std::cerr << "Continuing without file logging..." << std::endl;
+    }
+
+    std::cout << "\n=== ZED Depth Mode Profiler v0.1.0 ===\n" << std::endl;
+
+    std::unique_ptr<DepthFrameSource> source;
+    std::string sourceName;
+    if (config.synthetic) {
+        auto synthetic = std::make_unique<SyntheticDepthSource>(config.frames);
+        if (config.profile.roi.area() <= 0) {
+            config.profile.roi = synthetic->getPoleRoi();
+            config.profile.roiMaxDepth = SyntheticDepthSource::kPoleDepth * 1.5f;
+        }
+        source = std::move(synthetic);
+        sourceName = "synthetic";
+    } else {
+        if (!FileUtils::validateSVO2File(config.svoFilePath)) {
+            std::cerr << "Error: Invalid SVO2 file: " << config.svoFilePath << std::endl;
+            return 1;
+        }
+        source = std::make_unique<SvoDepthSource>(config.svoFilePath, config.startFrame, config.frames);
+        sourceName = config.svoFilePath;
+    }
+
+    DepthModeProfiler profiler(config.profile);
+    DepthModeReport report = profiler.run(*source);
+
+    std::cout << "\n" << profiler.formatTable(report) << std::endl;
+
+    std::ofstream json(config.jsonPath);
+    json << profiler.toJson(report, sourceName);
+    if (!json) {
+        std::cerr << "Error: Failed to write " << config.jsonPath << std::endl;
+        return 1;
+    }
+    LOG_INFO("Report: " + config.jsonPath);
+    Logger::getInstance().shutdown();
+
+    return report.recommended.empty() ? 2 : 0;
+}
@@ -15,14 +15,25 @@
  *   --fps <rate>            Extraction frame rate (default: 1.0)
  *   --camera <mode>         Camera mode: left, right, both (default: left)
  *   --format <ext>          Output format: png, jpg (default: png)
+ *   --background            Idle CPU/IO priority, back off while the system is busy
+ *   --max-fps <rate>        Background mode: processed frames per second cap
+ *   --max-write-mbps <n>    Background mode: output write cap in MiB/s
+ *   --keyframe-tolerance <n> Seek to each sample, moving it up to +-n frames to a cheap-to-decode frame
+ *   --read-ahead <MB>       Keep this much of the SVO ahead of decode in the page cache (slow media)
+ *   --estimate              Sample a few frames and print expected runtime, output size and
+ *                           memory; exits with 2 if the output volume is too small
  *   --help                  Show this help message
  */
 
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <cstdlib>
+#include <vector>
 #include <iomanip>
 #include <sstream>
+#include <memory>
+#include <fstream>
 #include <sl/Camera.hpp>
 
 // Our common utilities
@@ -31,6 +42,10 @@
 #include "../../common/svo_handler.hpp"
 #include "../../common/metadata.hpp"
 #include "../../common/output_manager.hpp"
+#include "../../common/background_priority.hpp"
+#include "../../common/keyframe_index.hpp"
+#include "../../common/extraction_engine.hpp"
+#include "../../common/read_ahead_prefetcher.hpp"
 
 using namespace zed_tools;
 
@@ -43,6 +58,14 @@ struct Config {
     float extractionFps = 1.0f;
     std::string cameraMode = "left";  // left, right, both
     std::string outputFormat = "png";
+    bool background = false;
+    double maxFps = 0.0;              // Background mode caps (0 = unlimited)
+    double maxWriteMBps = 0.0;
+    int keyframeTolerance = 0;        // 0 = decode every frame, take exact grid positions
+    int readAheadMB = 0;              // SVO prefetch window (0 = off)
+    bool estimateOnly = false;        // Print the pre-run estimate instead of extracting
+    int estimateSamples = 8;
+    std::string estimateJsonPath;     // Also write the estimate as JSON
     bool showHelp = false;
 };
 
@@ -84,6 +107,31 @@ bool parseArguments(int argc, char* argv[], Config& config) {
         else if (arg == "--format" && i + 1 < argc) {
             config.outputFormat = argv[++i];
         }
+        else if (arg == "--background") {
+            config.background = true;
+        }
+        else if (arg == "--max-fps" && i + 1 < argc) {
+            config.maxFps = std::stod(argv[++i]);
+        }
+        else if (arg == "--max-write-mbps" && i + 1 < argc) {
+            config.maxWriteMBps = std::stod(argv[++i]);
+        }
+        else if (arg == "--keyframe-tolerance" && i + 1 < argc) {
+            config.keyframeTolerance = std::stoi(argv[++i]);
+        }
+        else if (arg == "--read-ahead" && i + 1 < argc) {
+            config.readAheadMB = std::stoi(argv[++i]);
+        }
+        else if (arg == "--estimate") {
+            config.estimateOnly = true;
+        }
+        else if (arg == "--estimate-samples" && i + 1 < argc) {
+            config.estimateSamples = std::stoi(argv[++i]);
+        }
+        else if (arg == "--estimate-json" && i + 1 < argc) {
+            config.estimateOnly = true;
+            config.estimateJsonPath = argv[++i];
+        }
         else {
             std::cerr << "Warning: Unknown argument: " << arg << std::endl;
         }
@@ -108,6 +156,17 @@ void printHelp() {
     std::cout << "  --fps <rate>            Extraction frame rate (default: 1.0)\n";
     std::cout << "  --camera <mode>         Camera: left, right, both (default: left)\n";
     std::cout << "  --format <ext>          Format: png, jpg (default: png)\n";
+    std::cout << "  --background            Low priority: idle CPU/IO, backs off while the system is busy\n";
+    std::cout << "  --max-fps <rate>        With --background: processed frames per second cap\n";
+    std::cout << "  --max-write-mbps <n>    With --background: output write cap in MiB/s\n";
+    std::cout << "  --keyframe-tolerance <n> Seek to each sample and move it up to +-n frames to the\n";
+    std::cout << "                          cheapest frame to decode (actual frames go to the metadata)\n";
+    std::cout << "  --read-ahead <MB>       Prefetch this much of the SVO ahead of decode; for USB drives\n";
+    std::cout << "                          and network mounts (reports how often decode waited on I/O)\n";
+    std::cout << "  --estimate              Time a few sampled frames and print expected runtime, output\n";
+    std::cout << "                          size and peak memory; exit code 2 if free space is insufficient\n";
+    std::cout << "  --estimate-samples <n>  Frames sampled for --estimate (default: 8)\n";
+    std::cout << "  --estimate-json <path>  Also write the estimate as JSON (implies --estimate)\n";
     std::cout << "  --help, -h              Show this help message\n\n";
     std::cout << "Output Structure:\n";
     std::cout << "  Frames saved to: <base>/Yolo_Training/Unfiltered_Images/flight_XXX/\n";
@@ -115,6 +174,9 @@ void printHelp() {
     std::cout << "Examples:\n";
     std::cout << "  frame_extractor_cli flight.svo2\n";
     std::cout << "  frame_extractor_cli flight.svo2 --fps 2.0 --camera both\n";
+    std::cout << "  frame_extractor_cli flight.svo2 --fps 1.0 --keyframe-tolerance 3\n";
+    std::cout << "  frame_extractor_cli flight.svo2 --fps 5.0 --camera both --estimate\n";
+    std::cout << "  frame_extractor_cli //nas/flights/flight.svo2 --read-ahead 512\n";
     std::cout << "  frame_extractor_cli flight.svo2 --base-output D:/MyOutput\n\n";
 }
 
@@ -132,6 +194,18 @@ ErrorResult validateConfig(const Config& config) {
         return ErrorResult::failure("FPS must be positive: " + std::to_string(config.extractionFps));
     }
     
+    if (config.keyframeTolerance < 0) {
+        return ErrorResult::failure("Keyframe tolerance must not be negative");
+    }
+
+    if (config.readAheadMB < 0) {
+        return ErrorResult::failure("Read-ahead must not be negative");
+    }
+
+    if (config.estimateSamples < 1) {
+        return ErrorResult::failure("Estimate samples must be at least 1");
+    }
+    
     // Check camera mode
     if (config.cameraMode != "left" && config.cameraMode != "right" && config.cameraMode != "both") {
         return ErrorResult::failure("Invalid camera mode: " + config.cameraMode);
@@ -163,6 +237,19 @@ ErrorResult extractFrames(const Config& config) {
         return validateResult;
     }
     
+    // Background mode goes first so the SDK's threads inherit the lowered priority
+    std::unique_ptr<BackgroundThrottle> throttle;
+    if (config.background) {
+        BackgroundPriorityConfig bg;
+        bg.maxFps = config.maxFps;
+        bg.maxWriteMBps = config.maxWriteMBps;
+        auto applied = applyBackgroundPriority(bg);
+        if (applied.isFailure()) {
+            LOG_WARNING("Background mode: " + applied.message + " (rate limits and back-off still apply)");
+        }
+        throttle = std::make_unique<BackgroundThrottle>(bg);
+    }
+
     // Open SVO file
     SVOHandler svo(config.svoFilePath);
     if (!svo.open()) {
@@ -228,19 +315,51 @@ ErrorResult extractFrames(const Config& config) {
         }
     }
     
+    // Keyframe-aware plan: seek to each sample instead of decoding every frame (empty = sequential)
+    std::vector<KeyframeSample> plan;
+    KeyframeIndex keyframes;
+    if (config.keyframeTolerance > 0 && frameSkip > 1) {
+        if (!keyframes.build(config.svoFilePath)) {
+            LOG_WARNING("Keyframe index unavailable (" + keyframes.getLastError() + "); decoding every frame");
+        } else if (std::abs(keyframes.getFrameCount() - props.totalFrames) > 1) {
+            LOG_WARNING("Keyframe index has " + std::to_string(keyframes.getFrameCount()) +
+                        " video messages but the SVO has " + std::to_string(props.totalFrames) +
+                        " frames; decoding every frame");
+        } else {
+            LOG_INFO("Keyframes: " + std::to_string(keyframes.getKeyframeCount()) + " (" +
+                     keyframeSourceName(keyframes.getSource()) + "), mean GOP " +
+                     std::to_string(keyframes.getMeanGop()) + " frames");
+            plan = keyframes.planSamples(0, props.totalFrames, frameSkip, config.keyframeTolerance);
+            frameMeta.keyframeTolerance = config.keyframeTolerance;
+            frameMeta.keyframeSource = keyframeSourceName(keyframes.getSource());
+        }
+    }
+    
+    // Prefetch the SVO ahead of decode; keyframe sampling only needs each sample's GOP
+    std::unique_ptr<ReadAheadPrefetcher> readAhead;
+    if (config.readAheadMB > 0) {
+        ReadAheadConfig raConfig;
+        raConfig.windowBytes = static_cast<uint64_t>(config.readAheadMB) << 20;
+        readAhead = std::make_unique<ReadAheadPrefetcher>(raConfig);
+        if (!readAhead->start(config.svoFilePath, props.totalFrames)) {
+            LOG_WARNING(readAhead->getLastError() + "; reading without prefetch");
+            readAhead.reset();
+        } else if (!plan.empty()) {
+            readAhead->setFrameOffsets(keyframes.getFrameOffsets());
+            std::vector<std::pair<int, int>> ranges;
+            for (const auto& sample : plan) ranges.emplace_back(sample.actualFrame - sample.decodeDistance, sample.actualFrame);
+            readAhead->setRandomPlan(ranges);
+        }
+    }
+    
     // Extraction loop
     sl::Mat leftImage, rightImage;
     int sourceFrameCount = 0;
     int extractedCount = 0;
     int currentFrameNum = startingFrameNum;
     
-    while (svo.grab()) {
-        // Check if we should extract this frame
-        if (sourceFrameCount % frameSkip != 0) {
-            sourceFrameCount++;
-            continue;
-        }
-        
+    // Saves the requested views of the grabbed frame
+    auto saveCurrentFrame = [&](int svoFrame) {
         // Extract left camera
         if (config.cameraMode == "left" || config.cameraMode == "both") {
             sl::ERROR_CODE err = svo.retrieveImage(leftImage, sl::VIEW::LEFT);
@@ -258,6 +377,8 @@ ErrorResult extractFrames(const Config& config) {
                     LOG_WARNING("Failed to save frame " + std::to_string(currentFrameNum) + " (left)");
                 } else {
                     LOG_DEBUG("Saved: " + filename);
+                    if (throttle) throttle->onFileWritten(filepath);
+                    if (!plan.empty()) frameMeta.sourceFrames.push_back(svoFrame);
                     extractedCount++;
                     currentFrameNum++;
                 }
@@ -281,11 +402,61 @@ ErrorResult extractFrames(const Config& config) {
                     LOG_WARNING("Failed to save frame " + std::to_string(currentFrameNum) + " (right)");
                 } else {
                     LOG_DEBUG("Saved: " + filename);
+                    if (throttle) throttle->onFileWritten(filepath);
+                    if (!plan.empty()) frameMeta.sourceFrames.push_back(svoFrame);
                     extractedCount++;
                     currentFrameNum++;
                 }
             }
         }
+    };
+    
+    if (!plan.empty()) {
+        int lastGrabbed = -1;
+        long long decodedFrames = 0;
+        for (const KeyframeSample& sample : plan) {
+            if (throttle) throttle->beforeFrame();
+            
+            // Ahead of the decoder in the same GOP: decode forward; otherwise seek
+            bool grabbed = true;
+            if (lastGrabbed >= 0 && sample.actualFrame > lastGrabbed &&
+                keyframes.previousKeyframe(sample.actualFrame) <= lastGrabbed) {
+                for (int f = lastGrabbed + 1; f <= sample.actualFrame && grabbed; ++f) grabbed = svo.grab();
+            } else {
+                grabbed = svo.setFramePosition(sample.actualFrame) && svo.grab();
+            }
+            if (!grabbed) {
+                LOG_WARNING("Failed to read SVO frame " + std::to_string(sample.actualFrame));
+                break;
+            }
+            lastGrabbed = sample.actualFrame;
+            if (readAhead) readAhead->notifyFrame(sample.actualFrame);
+            decodedFrames += sample.decodeDistance + 1;
+            sourceFrameCount = sample.actualFrame + 1;
+            
+            saveCurrentFrame(sample.actualFrame);
+            
+            if (extractedCount % 10 == 0 && extractedCount > 0) {
+                float progress = (sourceFrameCount * 100.0f) / props.totalFrames;
+                LOG_INFO("Progress: " + std::to_string(static_cast<int>(progress)) + 
+                        "% (" + std::to_string(extractedCount) + " frames extracted)");
+            }
+        }
+        LOG_INFO("Keyframe sampling decoded " + std::to_string(decodedFrames) + " of " +
+                 std::to_string(props.totalFrames) + " frames");
+    }
+    
+    while (plan.empty() && svo.grab()) {
+        if (readAhead) readAhead->notifyFrame(sourceFrameCount);
+        if (throttle) throttle->beforeFrame();
+
+        // Check if we should extract this frame
+        if (sourceFrameCount % frameSkip != 0) {
+            sourceFrameCount++;
+            continue;
+        }
+        
+        saveCurrentFrame(sourceFrameCount);
         
         sourceFrameCount++;
         
@@ -318,10 +489,49 @@ ErrorResult extractFrames(const Config& config) {
     LOG_INFO("Frames extracted: " + std::to_string(extractedCount));
     LOG_INFO("Frame range: " + std::to_string(startingFrameNum) + " - " + std::to_string(currentFrameNum - 1));
     LOG_INFO("Output directory: " + outputDir);
+    if (readAhead) LOG_INFO(readAhead->describeStats());
     
     return ErrorResult::success();
 }
 
+/**
+ * @brief Print the pre-run estimate
+ * @return Process exit code (2 = not enough free space)
+ */
+int runEstimate(const Config& config) {
+    zed_extractor::FrameExtractionConfig engineConfig;
+    engineConfig.svoFilePath = config.svoFilePath;
+    engineConfig.baseOutputPath = config.baseOutputPath;
+    engineConfig.fps = config.extractionFps;
+    engineConfig.cameraMode = config.cameraMode;
+    engineConfig.format = (config.outputFormat == "jpeg") ? "jpg" : config.outputFormat;
+    engineConfig.keyframeTolerance = config.keyframeTolerance;
+
+    zed_extractor::ExtractionEngine engine;
+    zed_extractor::ExtractionEstimate estimate;
+    auto result = engine.estimateFrames(engineConfig, estimate, config.estimateSamples);
+    if (!result.success) {
+        LOG_ERROR("Estimate failed: " + result.errorMessage);
+        return 1;
+    }
+    std::cout << zed_extractor::formatEstimate(estimate) << std::endl;
+
+    if (!config.estimateJsonPath.empty()) {
+        std::ofstream json(config.estimateJsonPath);
+        json << zed_extractor::estimateToJson(estimate);
+        if (!json) LOG_WARNING("Failed to write " + config.estimateJsonPath);
+    }
+
+    if (estimate.space == zed_extractor::SpaceVerdict::Insufficient) {
+        LOG_ERROR("Not enough free space in " + config.baseOutputPath + " for the expected output");
+        return 2;
+    }
+    if (estimate.space == zed_extractor::SpaceVerdict::Tight) {
+        LOG_WARNING("Free space in " + config.baseOutputPath + " may not cover the upper bound of the output");
+    }
+    return 0;
+}
+
 /**
  * @brief Main entry point
  */
@@ -357,6 +567,12 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
+    if (config.estimateOnly) {
+        int code = runEstimate(config);
+        Logger::getInstance().shutdown();
+        return code;
+    }
+
     // Extract frames
     auto result = extractFrames(config);
     if (result.isFailure()) {
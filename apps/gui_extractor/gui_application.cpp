@@ -13,6 +13,7 @@
 #endif
 
 #include "gui_application.hpp"
+#include "../../common/depth_colorizer.hpp"
 #include "imgui.h"
 #include "imgui_impl_glfw.h"
 #include "imgui_impl_opengl3.h"
@@ -21,8 +22,10 @@
 #include <GLFW/glfw3.h>
 #include <iostream>
 #include <sstream>
+#include <functional>
 #include <algorithm>
 #include <cstring>
+#include <cstdio>
 #include <cmath>
 #include <opencv2/imgproc.hpp>
 
@@ -56,6 +59,45 @@
 
 namespace zed_gui {
 
+namespace {
+
+/**
+ * @brief Hash of every listed setting, so an estimate only answers for exactly those settings
+ */
+template <typename... Fields>
+std::string settingsHash(const Fields&... fields) {
+    std::ostringstream joined;
+    ((joined << fields << '\x1f'), ...);
+    return std::to_string(std::hash<std::string>{}(joined.str()));
+}
+
+std::string estimateKeyFor(const zed_extractor::FrameExtractionConfig& c) {
+    return "frames|" + settingsHash(
+        c.svoFilePath, c.baseOutputPath, c.fps, c.cameraMode, c.format, c.eventTrigger, c.triggerMode,
+        c.triggerDistance, c.triggerMinPixels, c.eventFps, c.preEventSec, c.postEventSec, c.followMode,
+        c.followPollMs, c.followIdleTimeoutSec, c.keyframeTolerance, c.lowPriority, c.maxProcessFps,
+        c.maxWriteMBps, c.readAheadMB);
+}
+
+std::string estimateKeyFor(const zed_extractor::DepthExtractionConfig& c) {
+    return "depth|" + settingsHash(
+        c.svoFilePath, c.baseOutputPath, c.outputFps, c.minDepth, c.maxDepth, c.saveRawDepth,
+        c.rawDepthFormat, c.saveColorized, c.lazyHeatmaps, c.saveVideo, c.saveRgbFrames,
+        c.saveConfidenceMaps, c.imageFormat, c.depthMode, c.overlayOnRgb, c.overlayStrength,
+        c.autoContrast, c.confidenceThreshold, c.useEdgeBoost, c.edgeBoostFactor, c.useClahe,
+        c.useTemporalSmooth, c.temporalAlpha, c.logScale, c.colorMap, c.highlightMotion, c.motionGain,
+        c.useBackgroundModel, c.backgroundAlpha, c.backgroundKSigma, c.saveBackgroundVariance,
+        c.enableTracking, c.trackMaxRange, c.trackMinBlobPixels, c.drawTracks, c.useGroundPlane,
+        c.objectMinHeight, c.maskGroundInHeatmap, c.useSparseFlow, c.flowResidualThreshold,
+        c.saveOccupancyGrid, c.occupancyMode, c.occupancyCellSize, c.occupancyUsePose,
+        c.occupancyWorldExtent, c.storePreviews, c.previewMaxWidth, c.collectFrameStats, c.followMode,
+        c.followPollMs, c.followIdleTimeoutSec, c.frameOrder, c.timeBudgetSec, c.uploadUrl,
+        c.uploadKeepLocal, c.uploadWorkers, c.scratchPath, c.scratchLimitGB, c.workerThreads,
+        c.lowPriority, c.maxProcessFps, c.maxWriteMBps, c.readAheadMB);
+}
+
+} // namespace
+
 GUIApplication::GUIApplication()
     : window_(nullptr)
     , initialized_(false)
@@ -69,6 +111,7 @@ GUIApplication::GUIApplication()
     , videoCodec_(0)
     , videoFps_(0.0f)
     , videoQuality_(100)  // Default to maximum quality
+    , videoSegmentSec_(0.0f)
     , depthMode_(0)
     , depthOutputFps_(5.0f)
     , depthMinMeters_(10.0f)
@@ -98,6 +141,10 @@ GUIApplication::GUIApplication()
     , lastResultSuccess_(false)
 {
     engine_ = std::make_unique<zed_extractor::ExtractionEngine>();
+    // The preview panel cannot show more than the display refresh rate
+    zed_extractor::ExtractionEngine::PreviewSubscription previewRequest;
+    previewRequest.maxFps = 60.0f;
+    depthPreviewSubscription_ = engine_->subscribeDepthPreview(previewRequest);
     depthPreviewVersion_ = -1;
     depthPreviewTexture_ = 0;
     depthPreviewWidth_ = 0;
@@ -113,6 +160,7 @@ GUIApplication::~GUIApplication() {
         engine_->cancel();
         extractionThread_->join();
     }
+    engine_->unsubscribeDepthPreview(depthPreviewSubscription_);
     if (depthPreviewTexture_ != 0) {
         glDeleteTextures(1, &depthPreviewTexture_);
         depthPreviewTexture_ = 0;
@@ -326,6 +374,24 @@ void GUIApplication::renderMainContent() {
         selectOutputPath();
     }
 
+    ImGui::Text("Scratch Path:");
+    ImGui::SameLine();
+    // Optional fast local tier; video/depth extraction folders move to the output path when done
+    ImGui::InputText("##scratchpath", scratchPathBuf_, sizeof(scratchPathBuf_));
+    if (scratchPathBuf_[0] != '\0') {
+        ImGui::SliderFloat("Scratch Limit (GB)", &scratchLimitGB_, 1.0f, 500.0f, "%.0f");
+    }
+
+    // Idle CPU/IO priority plus optional caps; backs off further while the machine is busy
+    ImGui::Checkbox("Background mode (low priority)", &lowPriority_);
+    if (lowPriority_) {
+        ImGui::SliderFloat("Max Frames/s (0 = unlimited)", &maxProcessFps_, 0.0f, 60.0f, "%.1f");
+        ImGui::SliderFloat("Max Write MB/s (0 = unlimited)", &maxWriteMBps_, 0.0f, 500.0f, "%.0f");
+    }
+
+    // Keeps the SVO ahead of decode in the page cache (USB drives, network mounts)
+    ImGui::SliderInt("Read-ahead MB (0 = off)", &readAheadMB_, 0, 2048);
+
     ImGui::Separator();
 
     // Tabs for different extraction modes
@@ -357,8 +423,25 @@ void GUIApplication::renderFrameExtractorTab() {
     const char* cameras[] = { "Left", "Right", "Both" };
     ImGui::Combo("Camera", &frameCamera_, cameras, IM_ARRAYSIZE(cameras));
     
-    const char* formats[] = { "PNG", "JPG" };
+    const char* formats[] = { "PNG", "JPG", "QOI (fast lossless)" };
     ImGui::Combo("Format", &frameFormat_, formats, IM_ARRAYSIZE(formats));
+    ImGui::SliderInt("Keyframe Snap (+-frames, 0=off)", &frameKeyframeTolerance_, 0, 15);
+
+    ImGui::Checkbox("Dense sampling around depth events", &frameEventTrigger_);
+    if (frameEventTrigger_) {
+        const char* triggers[] = { "Near pixels (N closer than D)", "Depth blob detector" };
+        ImGui::Combo("Trigger", &frameTriggerModeIndex_, triggers, IM_ARRAYSIZE(triggers));
+        ImGui::SliderFloat("Trigger Distance D (m)", &frameTriggerDistance_, 2.0f, 60.0f, "%.0f");
+        ImGui::SliderInt("Trigger Pixels N", &frameTriggerMinPixels_, 100, 50000);
+        ImGui::SliderFloat("Event FPS (0=source)", &frameEventFps_, 0.0f, 60.0f, "%.0f");
+        ImGui::SliderFloat("Pre-roll (s)", &framePreEventSec_, 0.0f, 5.0f, "%.1f");
+        ImGui::SliderFloat("Post-roll (s)", &framePostEventSec_, 0.0f, 10.0f, "%.1f");
+    }
+
+    ImGui::Checkbox("Follow recording (file still being written)", &frameFollowMode_);
+    if (frameFollowMode_) {
+        ImGui::SliderFloat("Idle Timeout (s)", &followIdleTimeoutSec_, 5.0f, 600.0f, "%.0f");
+    }
 
     ImGui::Separator();
     
@@ -372,6 +455,10 @@ void GUIApplication::renderFrameExtractorTab() {
         if (ImGui::Button("Start Frame Extraction", ImVec2(-1, 40))) {
             startFrameExtraction();
         }
+        if (ImGui::Button("Estimate Runtime && Size", ImVec2(-1, 0))) {
+            startEstimate(false);
+        }
+        renderEstimate(false);
     }
 }
 
@@ -387,6 +474,11 @@ void GUIApplication::renderVideoExtractorTab() {
     
     ImGui::SliderFloat("FPS (0=source)", &videoFps_, 0.0f, 100.0f, "%.0f");
     ImGui::SliderInt("Quality", &videoQuality_, 50, 100, "%d%%");
+    ImGui::SliderFloat("Segment length (s, 0=single file)", &videoSegmentSec_, 0.0f, 600.0f, "%.0f");
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Roll each stream into segments; finished segments are listed in\n"
+                          "<stream>_segments.json and <stream>.ffconcat while extraction runs");
+    }
 
     ImGui::Separator();
     
@@ -410,6 +502,7 @@ void GUIApplication::renderDepthExtractorTab() {
     // Live preview pane
     renderDepthPreviewPane();
     renderDepthNavigator();
+    renderTimelinePlots();
 
     const char* modes[] = { "NEURAL", "NEURAL_PLUS", "PERFORMANCE", "QUALITY", "ULTRA" };
     ImGui::Combo("Depth Mode", &depthMode_, modes, IM_ARRAYSIZE(modes));
@@ -426,7 +519,13 @@ void GUIApplication::renderDepthExtractorTab() {
     }
     ImGui::Checkbox("Cache left RGB frames", &depthSaveRgbFrames_);
     ImGui::Checkbox("Save confidence maps", &depthSaveConfidence_);
-    ImGui::Checkbox("Save colorized heatmaps (.png)", &depthSaveColorized_);
+    ImGui::Checkbox("Save colorized heatmaps", &depthSaveColorized_);
+    ImGui::Checkbox("Render heatmaps on demand", &depthLazyHeatmaps_);
+    if (ImGui::IsItemHovered()) {
+        ImGui::SetTooltip("Store raw depth + visualization settings; heatmaps and video are rendered on first access (heatmap_renderer_cli)");
+    }
+    const char* imageFmt[] = { "PNG (.png)", "QOI (.qoi, fast lossless)" };
+    ImGui::Combo("Image Format", &depthImageFormatIndex_, imageFmt, IM_ARRAYSIZE(imageFmt));
     ImGui::Checkbox("Create heatmap video (.avi)", &depthSaveVideo_);
     ImGui::Checkbox("Overlay on RGB", &depthOverlayEnabled_);
     ImGui::SliderInt("Overlay Strength (%)", &depthOverlayStrength_, 0, 100);
@@ -444,6 +543,40 @@ void GUIApplication::renderDepthExtractorTab() {
         ImGui::Combo("Colormap", &depthColorMapIndex_, cmap, IM_ARRAYSIZE(cmap));
         ImGui::Checkbox("Highlight Motion", &depthHighlightMotion_);
         ImGui::SliderFloat("Motion Gain", &depthMotionGain_, 0.0f, 1.0f, "%.2f");
+        ImGui::Checkbox("Sparse Flow Motion (ego-motion compensated)", &depthSparseFlow_);
+        ImGui::Checkbox("Background Model (k-sigma foreground)", &depthBackgroundModel_);
+        if (depthBackgroundModel_) {
+            ImGui::SliderFloat("Background Alpha", &depthBackgroundAlpha_, 0.005f, 0.2f, "%.3f");
+            ImGui::SliderFloat("Foreground k-sigma", &depthBackgroundKSigma_, 1.5f, 6.0f, "%.1f");
+            ImGui::Checkbox("Save background variance map", &depthSaveBgVariance_);
+        }
+        ImGui::Checkbox("Track Objects (every frame)", &depthTracking_);
+        if (depthTracking_) {
+            ImGui::SliderFloat("Track Range (m)", &depthTrackMaxRange_, 5.0f, 100.0f, "%.0f");
+        }
+        ImGui::Checkbox("Ground Plane (mask ground/sky)", &depthGroundPlane_);
+        if (depthGroundPlane_) {
+            ImGui::SliderFloat("Object Min Height (m)", &depthObjectMinHeight_, 0.2f, 5.0f, "%.1f");
+        }
+        ImGui::Checkbox("Bird's-eye Grid (16-bit PNG)", &depthOccupancyGrid_);
+        if (depthOccupancyGrid_) {
+            const char* gridModes[] = { "Occupancy (point count)", "Height (max, mm)" };
+            ImGui::Combo("Grid Mode", &depthOccupancyModeIndex_, gridModes, IM_ARRAYSIZE(gridModes));
+            ImGui::Checkbox("World-aligned (positional tracking)", &depthOccupancyUsePose_);
+        }
+    }
+    const char* orders[] = { "Sequential", "Coarse-to-fine (overview first)" };
+    ImGui::Combo("Frame Order", &depthFrameOrderIndex_, orders, IM_ARRAYSIZE(orders));
+    ImGui::SliderFloat("Time Budget (s, 0=off)", &depthTimeBudgetSec_, 0.0f, 3600.0f, "%.0f");
+    ImGui::Checkbox("Follow recording (file still being written)", &depthFollowMode_);
+    if (depthFollowMode_) {
+        ImGui::SliderFloat("Follow Idle Timeout (s)", &followIdleTimeoutSec_, 5.0f, 600.0f, "%.0f");
+        ImGui::TextDisabled("Cancel stops following and keeps extracted frames");
+    }
+    ImGui::InputText("Upload URL (S3, optional)", depthUploadUrlBuf_, sizeof(depthUploadUrlBuf_));
+    if (depthUploadUrlBuf_[0] != '\0') {
+        ImGui::Checkbox("Keep local copies", &depthUploadKeepLocal_);
+        ImGui::TextDisabled("http://host:port/bucket/prefix; credentials from AWS_ACCESS_KEY_ID/AWS_SECRET_ACCESS_KEY");
     }
 
     ImGui::Separator();
@@ -458,6 +591,10 @@ void GUIApplication::renderDepthExtractorTab() {
         if (ImGui::Button("Start Depth Extraction", ImVec2(-1, 40))) {
             startDepthExtraction();
         }
+        if (ImGui::Button("Estimate Runtime && Size", ImVec2(-1, 0))) {
+            startEstimate(true);
+        }
+        renderEstimate(true);
         ImGui::Separator();
         if (ImGui::Button("Open Raw Depth Viewer")) {
             showRawDepthWindow_ = true;
@@ -489,7 +626,12 @@ void GUIApplication::renderStatusBar() {
                  ImGuiWindowFlags_NoTitleBar | ImGuiWindowFlags_NoResize | 
                  ImGuiWindowFlags_NoMove | ImGuiWindowFlags_NoScrollbar);
     
-    ImGui::Text("ZED SVO2 Extractor v0.1.0 | Ready");
+    int pendingArchive = engine_ ? engine_->getPendingArchiveJobs() : 0;
+    if (pendingArchive > 0) {
+        ImGui::Text("ZED SVO2 Extractor v0.1.0 | Archiving %d extraction(s)", pendingArchive);
+    } else {
+        ImGui::Text("ZED SVO2 Extractor v0.1.0 | Ready");
+    }
     
     ImGui::End();
 }
@@ -570,21 +712,12 @@ void GUIApplication::startFrameExtraction() {
         extractionThread_->join();
     }
     
+    zed_extractor::FrameExtractionConfig config = buildFrameConfig();
+    if (estimateRefusesStart(estimateKeyFor(config))) return;
+
     isProcessing_ = true;
     updateProgress(0.0f, "Starting frame extraction...");
     
-    // Build extraction configuration
-    zed_extractor::FrameExtractionConfig config;
-    config.svoFilePath = svoFilePath_;
-    config.baseOutputPath = outputPath_;
-    config.fps = frameFps_;
-    
-    const char* cameras[] = { "left", "right", "both" };
-    config.cameraMode = cameras[frameCamera_];
-    
-    const char* formats[] = { "png", "jpg" };
-    config.format = formats[frameFormat_];
-    
     // Start extraction in background thread
     extractionThread_ = std::make_unique<std::thread>([this, config]() {
         auto result = engine_->extractFrames(config, 
@@ -603,6 +736,34 @@ void GUIApplication::startFrameExtraction() {
     });
 }
 
+zed_extractor::FrameExtractionConfig GUIApplication::buildFrameConfig() const {
+    zed_extractor::FrameExtractionConfig config;
+    config.svoFilePath = svoFilePath_;
+    config.baseOutputPath = outputPath_;
+    config.fps = frameFps_;
+    
+    const char* cameras[] = { "left", "right", "both" };
+    config.cameraMode = cameras[frameCamera_];
+    
+    const char* formats[] = { "png", "jpg", "qoi" };
+    config.format = formats[frameFormat_];
+    config.eventTrigger = frameEventTrigger_;
+    config.triggerMode = (frameTriggerModeIndex_ == 1) ? "blob" : "pixels";
+    config.triggerDistance = frameTriggerDistance_;
+    config.triggerMinPixels = frameTriggerMinPixels_;
+    config.eventFps = frameEventFps_;
+    config.preEventSec = framePreEventSec_;
+    config.postEventSec = framePostEventSec_;
+    config.followMode = frameFollowMode_;
+    config.followIdleTimeoutSec = followIdleTimeoutSec_;
+    config.keyframeTolerance = frameKeyframeTolerance_;
+    config.lowPriority = lowPriority_;
+    config.maxProcessFps = maxProcessFps_;
+    config.maxWriteMBps = maxWriteMBps_;
+    config.readAheadMB = readAheadMB_;
+    return config;
+}
+
 void GUIApplication::startVideoExtraction() {
     if (svoFilePath_.empty()) {
         std::cerr << "No SVO file selected" << std::endl;
@@ -631,6 +792,12 @@ void GUIApplication::startVideoExtraction() {
     zed_extractor::VideoExtractionConfig config;
     config.svoFilePath = svoFilePath_;
     config.baseOutputPath = outputPath_;
+    config.scratchPath = scratchPathBuf_;
+    config.scratchLimitGB = scratchLimitGB_;
+    config.lowPriority = lowPriority_;
+    config.maxProcessFps = maxProcessFps_;
+    config.maxWriteMBps = maxWriteMBps_;
+    config.readAheadMB = readAheadMB_;
     
     const char* cameras[] = { "left", "right", "both_separate", "side_by_side" };
     config.cameraMode = cameras[videoCamera_];
@@ -640,6 +807,7 @@ void GUIApplication::startVideoExtraction() {
     
     config.outputFps = videoFps_;
     config.quality = videoQuality_;
+    config.segmentSec = videoSegmentSec_;
     
     // Start extraction in background thread
     extractionThread_ = std::make_unique<std::thread>([this, config]() {
@@ -679,13 +847,38 @@ void GUIApplication::startDepthExtraction() {
         extractionThread_->join();
     }
 
+    zed_extractor::DepthExtractionConfig config = buildDepthConfig();
+    if (estimateRefusesStart(estimateKeyFor(config))) return;
+
     isProcessing_ = true;
     updateProgress(0.0f, "Starting depth extraction...");
 
-    // Build extraction configuration
+    extractionThread_ = std::make_unique<std::thread>([this, config]() {
+        auto result = engine_->extractDepth(config,
+            [this](float progress, const std::string& message) {
+                this->updateProgress(progress, message);
+            });
+
+        lastResultSuccess_ = result.success;
+        if (result.success) {
+            lastResultMessage_ = "Depth extraction completed: " +
+                                 std::to_string(result.framesProcessed) + " maps saved";
+        } else {
+            lastResultMessage_ = "Error: " + result.errorMessage;
+        }
+    });
+}
+
+zed_extractor::DepthExtractionConfig GUIApplication::buildDepthConfig() const {
     zed_extractor::DepthExtractionConfig config;
     config.svoFilePath = svoFilePath_;
     config.baseOutputPath = outputPath_;
+    config.scratchPath = scratchPathBuf_;
+    config.scratchLimitGB = scratchLimitGB_;
+    config.lowPriority = lowPriority_;
+    config.maxProcessFps = maxProcessFps_;
+    config.maxWriteMBps = maxWriteMBps_;
+    config.readAheadMB = readAheadMB_;
     config.outputFps = depthOutputFps_;
     config.minDepth = depthMinMeters_;
     config.maxDepth = depthMaxMeters_;
@@ -694,6 +887,10 @@ void GUIApplication::startDepthExtraction() {
     config.saveVideo = depthSaveVideo_;
     config.saveRgbFrames = depthSaveRgbFrames_ && config.overlayOnRgb; // only meaningful if overlay requested
     config.saveConfidenceMaps = depthSaveConfidence_;
+    config.lazyHeatmaps = depthLazyHeatmaps_;
+    config.storePreviews = true;   // Frame navigator after the run
+    config.collectFrameStats = true; // Flight timeline plots
+    config.imageFormat = (depthImageFormatIndex_ == 1) ? "qoi" : "png";
     // Raw depth format mapping
     switch (depthRawFormatIndex_) {
         case 0: config.rawDepthFormat = "tiff32f"; break;
@@ -718,23 +915,95 @@ void GUIApplication::startDepthExtraction() {
     config.colorMap = cmaps[depthColorMapIndex_];
     config.highlightMotion = depthHighlightMotion_;
     config.motionGain = depthMotionGain_;
+    config.useBackgroundModel = depthBackgroundModel_;
+    config.backgroundAlpha = depthBackgroundAlpha_;
+    config.backgroundKSigma = depthBackgroundKSigma_;
+    config.saveBackgroundVariance = depthSaveBgVariance_;
+    config.enableTracking = depthTracking_;
+    config.trackMaxRange = depthTrackMaxRange_;
+    config.useSparseFlow = depthSparseFlow_;
+    config.useGroundPlane = depthGroundPlane_;
+    config.objectMinHeight = depthObjectMinHeight_;
+    config.saveOccupancyGrid = depthOccupancyGrid_;
+    config.occupancyMode = (depthOccupancyModeIndex_ == 1) ? "height" : "occupancy";
+    config.occupancyUsePose = depthOccupancyUsePose_;
+    config.frameOrder = (depthFrameOrderIndex_ == 1) ? "coarse_to_fine" : "sequential";
+    config.timeBudgetSec = depthTimeBudgetSec_;
+    config.followMode = depthFollowMode_;
+    config.uploadUrl = depthUploadUrlBuf_;
+    config.uploadKeepLocal = depthUploadKeepLocal_;
+    config.followIdleTimeoutSec = followIdleTimeoutSec_;
+    return config;
+}
 
-    extractionThread_ = std::make_unique<std::thread>([this, config]() {
-        auto result = engine_->extractDepth(config,
-            [this](float progress, const std::string& message) {
-                this->updateProgress(progress, message);
-            });
+bool GUIApplication::estimateRefusesStart(const std::string& key) {
+    std::lock_guard<std::mutex> lock(progressMutex_);
+    if (estimateSpace_ != zed_extractor::SpaceVerdict::Insufficient || estimateKey_ != key) {
+        return false;
+    }
+    progressValue_ = 0.0f;
+    progressMessage_ = "Error: Not enough free space in the output folder (see estimate)";
+    return true;
+}
 
+void GUIApplication::startEstimate(bool depth) {
+    if (svoFilePath_.empty()) {
+        updateProgress(0.0f, "Error: No SVO file selected!");
+        return;
+    }
+    if (outPathBuf_[0] != '\0') {
+        outputPath_ = outPathBuf_;
+    }
+    if (isProcessing_) {
+        return;
+    }
+    if (extractionThread_ && extractionThread_->joinable()) {
+        extractionThread_->join();
+    }
+
+    isProcessing_ = true;
+    updateProgress(0.0f, "Sampling frames for estimate...");
+    zed_extractor::FrameExtractionConfig frameConfig;
+    zed_extractor::DepthExtractionConfig depthConfig;
+    if (depth) depthConfig = buildDepthConfig();
+    else frameConfig = buildFrameConfig();
+    const std::string key = depth ? estimateKeyFor(depthConfig) : estimateKeyFor(frameConfig);
+
+    extractionThread_ = std::make_unique<std::thread>([this, depth, key, frameConfig, depthConfig]() {
+        auto progress = [this](float value, const std::string& message) { this->updateProgress(value, message); };
+        zed_extractor::ExtractionEstimate estimate;
+        auto result = depth ? engine_->estimateDepth(depthConfig, estimate, 8, progress)
+                            : engine_->estimateFrames(frameConfig, estimate, 8, progress);
         lastResultSuccess_ = result.success;
-        if (result.success) {
-            lastResultMessage_ = "Depth extraction completed: " +
-                                 std::to_string(result.framesProcessed) + " maps saved";
-        } else {
+        if (!result.success) {
             lastResultMessage_ = "Error: " + result.errorMessage;
+            updateProgress(0.0f, lastResultMessage_);
+            return;
         }
+        lastResultMessage_ = std::string("Estimate ready (free space: ") +
+                             zed_extractor::spaceVerdictName(estimate.space) + ")";
+        std::lock_guard<std::mutex> lock(progressMutex_);
+        estimateReport_ = zed_extractor::formatEstimate(estimate);
+        estimateKey_ = key;
+        estimateSpace_ = estimate.space;
     });
 }
 
+void GUIApplication::renderEstimate(bool depth) {
+    std::lock_guard<std::mutex> lock(progressMutex_);
+    if (estimateReport_.empty() || estimateKey_.rfind(depth ? "depth|" : "frames|", 0) != 0) return;
+    // The verdict only holds for the settings it was made with
+    const std::string currentKey = depth ? estimateKeyFor(buildDepthConfig()) : estimateKeyFor(buildFrameConfig());
+    if (estimateKey_ != currentKey) {
+        ImGui::TextDisabled("Settings changed since the last estimate; estimate again to check free space");
+    } else if (estimateSpace_ == zed_extractor::SpaceVerdict::Insufficient) {
+        ImGui::TextColored(ImVec4(1.0f, 0.3f, 0.3f, 1.0f), "Not enough free space: extraction will be refused");
+    } else if (estimateSpace_ == zed_extractor::SpaceVerdict::Tight) {
+        ImGui::TextColored(ImVec4(1.0f, 0.8f, 0.2f, 1.0f), "Free space may not cover the upper bound");
+    }
+    ImGui::TextUnformatted(estimateReport_.c_str());
+}
+
 void GUIApplication::cancelExtraction() {
     if (engine_ && isProcessing_) {
         engine_->cancel();
@@ -1015,7 +1284,7 @@ void GUIApplication::renderRawDepthWindow() {
         cv::Mat depthForViz = depth32;
         if (rawViewerUseConfMask_ && !confCache8_.empty()) {
             // Set low-confidence pixels to NaN to be blacked out
-            cv::Mat mask = confCache8_ >= rawViewerConfThresh_;
+            cv::Mat mask = confCache8_ >= rawViewerConfThresh_ * zed_extractor::kStoredConfidenceScale;
             depthForViz = depth32.clone();
             for (int y = 0; y < depthForViz.rows; ++y) {
                 float* d = depthForViz.ptr<float>(y);
@@ -1238,6 +1507,7 @@ void GUIApplication::renderDepthNavigator() {
     // If navigating a stored frame, override displayed preview texture with that frame on demand
     if (navIndex_ >= 0) {
         cv::Mat selected;
+        engine_->loadLazyPreviewAt(navIndex_);
         if (engine_->getStoredPreviewAt(navIndex_, selected) && !selected.empty()) {
             // Upload to a temp texture (reuse depthPreviewTexture_ for simplicity)
             std::lock_guard<std::mutex> lk2(depthPreviewMutex_);
@@ -1272,6 +1542,120 @@ void GUIApplication::renderDepthNavigator() {
     }
 }
 
+void GUIApplication::renderTimelinePlots() {
+    if (!engine_) return;
+    const zed_extractor::FlightTimeline& timeline = engine_->getFlightTimeline();
+    double dataMin = 0.0, dataMax = 0.0;
+    // Every recorded frame has a valid-pixel sample, so its range is the flight's
+    if (!timeline.validFraction.getRange(dataMin, dataMax)) return;
+    dataMax = (std::max)(dataMax, dataMin + 1.0);
+
+    ImGui::Separator();
+    if (!ImGui::CollapsingHeader("Flight Timeline", ImGuiTreeNodeFlags_DefaultOpen)) return;
+    ImGui::TextDisabled("Wheel: zoom | Drag: pan | Click: jump to frame | Double-click: whole flight");
+
+    if (!timelineZoomed_) {
+        timelineViewMin_ = dataMin;
+        timelineViewMax_ = dataMax;
+    }
+    const double viewMin = timelineViewMin_;
+    const double viewMax = timelineViewMax_;
+    const int navFrame = (navIndex_ >= 0) ? engine_->getStoredFrameIndexAt(navIndex_) : -1;
+
+    const zed_tools::TimelineSeries* series[] = {
+        &timeline.nearestDistance, &timeline.validFraction, &timeline.detectionCount
+    };
+    const ImU32 colors[] = { IM_COL32(255, 140, 60, 255), IM_COL32(90, 200, 255, 255), IM_COL32(140, 230, 110, 255) };
+    ImGuiIO& io = ImGui::GetIO();
+    for (int s = 0; s < IM_ARRAYSIZE(series); ++s) {
+        if (series[s]->empty()) continue;
+        ImGui::PushID(s);
+        const ImVec2 size((std::max)(ImGui::GetContentRegionAvail().x, 50.0f), 80.0f);
+        const ImVec2 p0 = ImGui::GetCursorScreenPos();
+        const ImVec2 p1(p0.x + size.x, p0.y + size.y);
+        ImGui::InvisibleButton("plot", size);
+        const bool hovered = ImGui::IsItemHovered();
+
+        // One point per pixel column; the series picks the cache level for the visible range
+        series[s]->decimate(viewMin, viewMax, static_cast<int>(size.x), timelineXs_, timelineYs_);
+        double yMin = 0.0, yMax = 1.0;
+        if (!timelineYs_.empty()) {
+            auto mm = std::minmax_element(timelineYs_.begin(), timelineYs_.end());
+            yMin = *mm.first;
+            yMax = *mm.second;
+        }
+        if (yMax - yMin < 1e-6) { yMin -= 1.0; yMax += 1.0; }
+        const double pad = 0.05 * (yMax - yMin);
+        yMin -= pad;
+        yMax += pad;
+        auto toScreenX = [&](double x) { return p0.x + static_cast<float>((x - viewMin) / (viewMax - viewMin)) * size.x; };
+        auto toScreenY = [&](double y) { return p1.y - static_cast<float>((y - yMin) / (yMax - yMin)) * size.y; };
+
+        ImDrawList* draw = ImGui::GetWindowDrawList();
+        draw->AddRectFilled(p0, p1, IM_COL32(25, 25, 30, 255));
+        draw->PushClipRect(p0, p1, true);
+        timelinePoints_.clear();
+        for (size_t i = 0; i < timelineXs_.size(); ++i) {
+            timelinePoints_.push_back(ImVec2(toScreenX(timelineXs_[i]), toScreenY(timelineYs_[i])));
+        }
+        if (timelinePoints_.size() >= 2) {
+            draw->AddPolyline(timelinePoints_.data(), static_cast<int>(timelinePoints_.size()), colors[s], ImDrawFlags_None, 1.5f);
+        }
+        if (navFrame >= 0) {
+            const float nx = toScreenX(navFrame);
+            draw->AddLine(ImVec2(nx, p0.y), ImVec2(nx, p1.y), IM_COL32(255, 255, 255, 160), 1.0f);
+        }
+        const std::string& unit = series[s]->getUnit();
+        char label[128];
+        std::snprintf(label, sizeof(label), "%s%s%s%s  (%.1f .. %.1f)", series[s]->getName().c_str(),
+                 unit.empty() ? "" : " [", unit.c_str(), unit.empty() ? "" : "]", yMin + pad, yMax - pad);
+        draw->AddText(ImVec2(p0.x + 4.0f, p0.y + 2.0f), IM_COL32(220, 220, 220, 255), label);
+
+        const double mouseFrame = viewMin + (io.MousePos.x - p0.x) / size.x * (viewMax - viewMin);
+        if (hovered) {
+            double sampleX = 0.0;
+            float sampleY = 0.0f;
+            if (series[s]->nearestSample(mouseFrame, sampleX, sampleY)) {
+                const float sx = toScreenX(sampleX);
+                draw->AddLine(ImVec2(sx, p0.y), ImVec2(sx, p1.y), IM_COL32(255, 255, 255, 60), 1.0f);
+                draw->AddCircleFilled(ImVec2(sx, toScreenY(sampleY)), 3.0f, colors[s]);
+                ImGui::SetTooltip("Frame %d: %.2f %s%s", static_cast<int>(sampleX), sampleY, unit.c_str(),
+                                  isProcessing_ ? "\n(jump to frame after the run)" : "");
+            }
+        }
+        draw->PopClipRect();
+        draw->AddRect(p0, p1, IM_COL32(80, 80, 90, 255));
+
+        // Zoom around the cursor, pan by dragging; the range stays inside the flight
+        double newMin = viewMin, newMax = viewMax;
+        if (hovered && io.MouseWheel != 0.0f) {
+            const double factor = std::pow(0.8, io.MouseWheel);
+            newMin = mouseFrame - (mouseFrame - viewMin) * factor;
+            newMax = mouseFrame + (viewMax - mouseFrame) * factor;
+        }
+        if (ImGui::IsItemActive() && ImGui::IsMouseDragging(ImGuiMouseButton_Left)) {
+            const double shift = -io.MouseDelta.x / size.x * (viewMax - viewMin);
+            newMin += shift;
+            newMax += shift;
+        }
+        if (newMin != viewMin || newMax != viewMax) {
+            const double width = (std::min)((std::max)(newMax - newMin, 10.0), dataMax - dataMin);
+            newMin = (std::max)(dataMin, (std::min)(newMin, dataMax - width));
+            timelineViewMin_ = newMin;
+            timelineViewMax_ = newMin + width;
+            timelineZoomed_ = true;
+        }
+        if (hovered && ImGui::IsMouseDoubleClicked(ImGuiMouseButton_Left)) {
+            timelineZoomed_ = false;
+        } else if (ImGui::IsItemDeactivated() && io.MouseDragMaxDistanceSqr[ImGuiMouseButton_Left] < 16.0f && !isProcessing_) {
+            // Click: show the stored preview closest to that frame in the navigator
+            const int stored = engine_->findStoredPreviewNear(static_cast<int>(std::lround(mouseFrame)));
+            if (stored >= 0) navIndex_ = stored;
+        }
+        ImGui::PopID();
+    }
+}
+
 void GUIApplication::triggerRerenderSelected() {
     if (!engine_ || navIndex_ < 0) return;
     // Build config from current UI state
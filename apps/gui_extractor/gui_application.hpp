@@ -65,17 +65,33 @@ private:
     // Safe UI buffers for ImGui text inputs
     char svoPathBuf_[512]{};
     char outPathBuf_[512]{};
+    char scratchPathBuf_[512]{};     // Optional local staging tier (empty = write to output path)
+    float scratchLimitGB_ = 50.0f;   // Staged data awaiting archive before new jobs wait
+    bool lowPriority_ = false;       // Background mode for all extraction types
+    float maxProcessFps_ = 0.0f;     // 0 = unlimited
+    float maxWriteMBps_ = 0.0f;      // 0 = unlimited
+    int readAheadMB_ = 0;            // SVO prefetch window for slow media (0 = off)
     
     // Frame extractor settings
     float frameFps_;
     int frameCamera_;
     int frameFormat_;
+    bool frameEventTrigger_ = false;      // Full rate around depth events
+    int frameTriggerModeIndex_ = 0;       // 0: Near pixels, 1: Blob detector
+    float frameTriggerDistance_ = 15.0f;  // Trigger distance D (m)
+    int frameTriggerMinPixels_ = 2000;    // Trigger pixel count N
+    float frameEventFps_ = 0.0f;          // Rate inside events (0 = source)
+    float framePreEventSec_ = 1.0f;       // Pre-roll from ring buffer (s)
+    float framePostEventSec_ = 2.0f;      // Post-roll after last trigger (s)
+    bool frameFollowMode_ = false; // Keep extracting while the SVO is still being recorded
+    int frameKeyframeTolerance_ = 0; // Snap samples to cheap-to-decode frames within +-N (0 = exact)
     
     // Video extractor settings
     int videoCamera_;
     int videoCodec_;
     float videoFps_;
     int videoQuality_;
+    float videoSegmentSec_;    // 0 = one file per stream
     
     // Depth extractor settings
     int depthMode_;            // 0: NEURAL, 1: NEURAL_PLUS, 2: PERFORMANCE, 3: QUALITY, 4: ULTRA
@@ -84,7 +100,9 @@ private:
     float depthMaxMeters_;     // e.g., 1 - 100m
     bool depthSaveRaw_;        // Save EXR
     int  depthRawFormatIndex_; // 0: TIFF 32F, 1: PFM, 2: EXR, 3: BIN
-    bool depthSaveColorized_;  // Save PNG heatmaps
+    bool depthSaveColorized_;  // Save heatmaps (PNG or QOI)
+    int  depthImageFormatIndex_ = 0; // Heatmaps/RGB cache/confidence: 0: PNG, 1: QOI
+    bool depthLazyHeatmaps_ = false; // Raw depth only; heatmaps rendered on first access
     bool depthSaveVideo_;      // Create AVI from heatmaps
     bool depthOverlayEnabled_; // Blend heatmap over RGB
     int  depthOverlayStrength_; // 0..100 (% heatmap)
@@ -101,6 +119,24 @@ private:
     int depthColorMapIndex_;     // Selected colormap
     bool depthHighlightMotion_;  // Motion emphasis
     float depthMotionGain_;      // Motion highlight strength
+    bool depthSparseFlow_ = false;        // LK flow motion cue
+    bool depthBackgroundModel_ = false;   // Per-pixel background model for motion
+    float depthBackgroundAlpha_ = 0.02f;  // Background adaptation rate
+    float depthBackgroundKSigma_ = 3.0f;  // Foreground threshold (sigma)
+    bool depthSaveBgVariance_ = false;    // Export background variance map
+    bool depthTracking_ = false;          // Blob detection + multi-object tracking
+    float depthTrackMaxRange_ = 40.0f;    // Detection range (m)
+    bool depthGroundPlane_ = false;       // RANSAC ground plane; mask ground/sky
+    float depthObjectMinHeight_ = 1.0f;   // Above-ground object threshold (m)
+    bool depthOccupancyGrid_ = false;     // Bird's-eye grid output
+    int depthOccupancyModeIndex_ = 0;     // 0: Occupancy, 1: Height
+    bool depthOccupancyUsePose_ = false;  // World-aligned grid
+    int depthFrameOrderIndex_ = 0;   // 0: Sequential, 1: Coarse-to-fine
+    float depthTimeBudgetSec_ = 0.0f; // Stop after this many seconds (0 = no limit)
+    bool depthFollowMode_ = false;   // Keep extracting while the SVO is still being recorded
+    char depthUploadUrlBuf_[256]{};  // S3-compatible upload target (empty = local only)
+    bool depthUploadKeepLocal_ = true; // Keep local copies of uploaded outputs
+    float followIdleTimeoutSec_ = 30.0f; // Shared follow-mode idle timeout (frames + depth)
     
     // Progress tracking
     std::atomic<bool> isProcessing_;
@@ -135,6 +171,7 @@ private:
     
     // Extraction engine and threading
     std::unique_ptr<zed_extractor::ExtractionEngine> engine_;
+    int depthPreviewSubscription_ = 0;  // Live preview subscription on engine_
     std::unique_ptr<std::thread> extractionThread_;
     
     // Result storage
@@ -155,6 +192,18 @@ private:
     void startFrameExtraction();
     void startVideoExtraction();
     void startDepthExtraction();
+
+    // Settings of the frame/depth tabs as engine configs (shared by start and estimate)
+    zed_extractor::FrameExtractionConfig buildFrameConfig() const;
+    zed_extractor::DepthExtractionConfig buildDepthConfig() const;
+
+    // Pre-run estimate of the current frame or depth settings
+    void startEstimate(bool depth);
+    void renderEstimate(bool depth);
+    bool estimateRefusesStart(const std::string& key);
+    std::string estimateReport_;     // Guarded by progressMutex_
+    std::string estimateKey_;        // kind|hash of every setting of the last estimate
+    zed_extractor::SpaceVerdict estimateSpace_ = zed_extractor::SpaceVerdict::Unknown;
     
     void cancelExtraction();
     void checkExtractionComplete();
@@ -166,6 +215,14 @@ private:
     void renderDepthPreviewPane();
     void uploadLegendTexture(const cv::Mat& legendBgr);
     void renderDepthNavigator();
+    void renderTimelinePlots();
+    // Flight timeline (per-frame statistics of the depth run)
+    bool timelineZoomed_ = false;        // false: view follows the whole (growing) flight
+    double timelineViewMin_ = 0.0;       // Visible frame range while zoomed
+    double timelineViewMax_ = 0.0;
+    std::vector<double> timelineXs_;     // Decimated points, reused every frame
+    std::vector<double> timelineYs_;
+    std::vector<ImVec2> timelinePoints_;
     void triggerRerenderSelected();
     void renderRawDepthWindow();
     bool showRawDepthWindow_ = false;
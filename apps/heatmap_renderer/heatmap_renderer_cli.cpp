@@ -0,0 +1,188 @@
+/**
+ * @file heatmap_renderer_cli.cpp
+ * @brief Renders heatmaps and the heatmap video of a lazy depth extraction
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ *
+ * A depth extraction run with lazyHeatmaps stores raw depth and
+ * depth_visualization.json only. This tool renders the heatmaps that are
+ * actually needed (single frames, all frames, or the video); results are
+ * kept in depth_heatmaps/ so each frame is rendered once.
+ *
+ * Usage:
+ *   heatmap_renderer_cli <extraction_dir> [options]
+ *
+ * Options:
+ *   --frames <a,b,c>   Render these output indices and print their paths
+ *   --all              Render every missing heatmap
+ *   --video            Write depth_heatmap.avi (renders missing frames)
+ *   --help             Show this help message
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// Our common utilities
+#include "../../common/error_handler.hpp"
+#include "../../common/depth_colorizer.hpp"
+
+using namespace zed_tools;
+using zed_extractor::LazyHeatmapRenderer;
+
+/**
+ * @brief Application configuration
+ */
+struct Config {
+    std::string extractionPath;
+    std::vector<int> frames;
+    bool renderAll = false;
+    bool renderVideo = false;
+    bool showHelp = false;
+};
+
+/**
+ * @brief Parse command line arguments
+ */
+bool parseArguments(int argc, char* argv[], Config& config) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--help" || arg == "-h") {
+            config.showHelp = true;
+            return true;
+        }
+        else if (arg == "--frames" && i + 1 < argc) {
+            std::stringstream list(argv[++i]);
+            std::string item;
+            while (std::getline(list, item, ',')) {
+                try {
+                    config.frames.push_back(std::stoi(item));
+                } catch (...) {
+                    std::cerr << "Error: Invalid frame index: " << item << std::endl;
+                    return false;
+                }
+            }
+        }
+        else if (arg == "--all") {
+            config.renderAll = true;
+        }
+        else if (arg == "--video") {
+            config.renderVideo = true;
+        }
+        else if (arg.rfind("--", 0) == 0) {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+        else if (config.extractionPath.empty()) {
+            config.extractionPath = arg;
+        }
+    }
+    return true;
+}
+
+/**
+ * @brief Validate configuration
+ */
+bool validateConfig(const Config& config) {
+    if (config.extractionPath.empty()) {
+        std::cerr << "Error: No extraction directory specified" << std::endl;
+        return false;
+    }
+    if (config.frames.empty() && !config.renderAll && !config.renderVideo) {
+        std::cerr << "Error: Nothing to do (use --frames, --all or --video)" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * @brief Print help message
+ */
+void printHelp() {
+    std::cout << "\n=== ZED Heatmap Renderer ===\n\n";
+    std::cout << "Render heatmaps of a lazy depth extraction on demand.\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  heatmap_renderer_cli <extraction_dir> [options]\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --frames <a,b,c>   Render these output indices and print their paths\n";
+    std::cout << "  --all              Render every missing heatmap\n";
+    std::cout << "  --video            Write depth_heatmap.avi\n";
+    std::cout << "  --help, -h         Show this help message\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  heatmap_renderer_cli E:/out/depth_analysis/flight_x/extraction_001 --frames 0,10,20\n";
+    std::cout << "  heatmap_renderer_cli E:/out/depth_analysis/flight_x/extraction_001 --video\n\n";
+}
+
+/**
+ * @brief Main entry point
+ */
+int main(int argc, char* argv[]) {
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        printHelp();
+        return 1;
+    }
+
+    if (config.showHelp) {
+        printHelp();
+        return 0;
+    }
+
+    if (!validateConfig(config)) {
+        printHelp();
+        return 1;
+    }
+
+    try {
+        Logger::getInstance().initialize("heatmap_renderer.log", LogMode::BOTH, LogLevel::INFO);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to initialize logger: " << e.what() << std::endl;
+        std::cerr << "Continuing without file logging..." << std::endl;
+    }
+
+    std::cout << "\n=== ZED Heatmap Renderer v0.1.0 ===\n" << std::endl;
+
+    LazyHeatmapRenderer renderer(config.extractionPath);
+    if (!renderer.open()) {
+        LOG_ERROR(renderer.getLastError());
+        Logger::getInstance().shutdown();
+        return 1;
+    }
+
+    int exitCode = 0;
+    for (int index : config.frames) {
+        std::string path = renderer.getHeatmapPath(index);
+        if (path.empty()) {
+            LOG_WARNING("No raw depth for output index " + std::to_string(index));
+            exitCode = 1;
+        } else {
+            std::cout << path << std::endl;
+        }
+    }
+
+    if (config.renderAll) {
+        int lastPercent = -1;
+        int rendered = renderer.materializeAll([&](int done, int total) {
+            int percent = total > 0 ? (100 * done) / total : 100;
+            if (percent / 10 != lastPercent / 10) {
+                lastPercent = percent;
+                std::cout << "Rendering heatmaps: " << percent << "%" << std::endl;
+            }
+            return true;
+        });
+        LOG_INFO("Rendered " + std::to_string(rendered) + " heatmaps");
+    }
+
+    if (config.renderVideo) {
+        if (renderer.renderVideo()) {
+            LOG_INFO("Wrote " + config.extractionPath + "/depth_heatmap.avi");
+        } else {
+            LOG_ERROR(renderer.getLastError());
+            exitCode = 1;
+        }
+    }
+
+    Logger::getInstance().shutdown();
+    return exitCode;
+}
@@ -0,0 +1,245 @@
+/**
+ * @file telemetry_exporter_cli.cpp
+ * @brief Command-line telemetry exporter for ZED SVO2 files
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Exports IMU, magnetometer, barometer, temperature, pose and timestamp
+ * channels from SVO2 files without opening a camera or decoding images.
+ *
+ * Usage:
+ *   telemetry_exporter_cli <svo_file> [options]
+ *
+ * Options:
+ *   --base-output <path>    Base output directory
+ *   --topics <a,b,...>      Topic substrings to export (default: sensor topics)
+ *   --all-topics            Export every channel that can be decoded
+ *   --csv                   Also write one CSV per channel
+ *   --help                  Show this help message
+ */
+
+#include <iostream>
+#include <sstream>
+#include <string>
+
+// Our common utilities
+#include "../../common/error_handler.hpp"
+#include "../../common/file_utils.hpp"
+#include "../../common/output_manager.hpp"
+#include "../../common/telemetry_exporter.hpp"
+
+using namespace zed_tools;
+
+/**
+ * @brief Application configuration
+ */
+struct Config {
+    std::string svoFilePath;
+    std::string baseOutputPath = "E:/Turbulence Solutions/AeroLock/ZED_Recordings_Output";
+    std::string topics;               // Comma-separated; empty = defaults
+    bool allTopics = false;
+    bool writeCsv = false;
+    bool showHelp = false;
+};
+
+/**
+ * @brief Parse command-line arguments
+ */
+bool parseArguments(int argc, char* argv[], Config& config) {
+    // Check for help flag first
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--help" || arg == "-h") {
+            config.showHelp = true;
+            return true;
+        }
+    }
+
+    // Require SVO file path
+    if (argc < 2) {
+        std::cerr << "Error: SVO file path required" << std::endl;
+        config.showHelp = true;
+        return false;
+    }
+
+    config.svoFilePath = argv[1];
+
+    // Parse optional arguments
+    for (int i = 2; i < argc; i++) {
+        std::string arg = argv[i];
+
+        if (arg == "--base-output" && i + 1 < argc) {
+            config.baseOutputPath = argv[++i];
+        }
+        else if (arg == "--topics" && i + 1 < argc) {
+            config.topics = argv[++i];
+        }
+        else if (arg == "--all-topics") {
+            config.allTopics = true;
+        }
+        else if (arg == "--csv") {
+            config.writeCsv = true;
+        }
+        else {
+            std::cerr << "Warning: Unknown argument: " << arg << std::endl;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief Print help message
+ */
+void printHelp() {
+    std::cout << "\n=== ZED Telemetry Exporter CLI ===\n\n";
+    std::cout << "Export IMU/sensor/pose channels from ZED SVO2 files (no image decoding).\n\n";
+    std::cout << "Usage:\n";
+    std::cout << "  telemetry_exporter_cli <svo_file> [options]\n\n";
+    std::cout << "Arguments:\n";
+    std::cout << "  <svo_file>              Path to SVO2 file\n\n";
+    std::cout << "Options:\n";
+    std::cout << "  --base-output <path>    Base output directory\n";
+    std::cout << "                          (default: E:/Turbulence Solutions/AeroLock/ZED_Recordings_Output)\n";
+    std::cout << "  --topics <a,b,...>      Case-insensitive topic substrings to export\n";
+    std::cout << "                          (default: imu,sensor,magnetometer,barometer,temperature,pose,timestamp)\n";
+    std::cout << "  --all-topics            Export every channel that can be decoded\n";
+    std::cout << "  --csv                   Also write telemetry_<topic>.csv per channel\n";
+    std::cout << "  --help, -h              Show this help message\n\n";
+    std::cout << "Output Structure:\n";
+    std::cout << "  <base>/Extractions/flight_XXX/extraction_NNN/telemetry.ztlm\n";
+    std::cout << "  Columnar binary file; see common/telemetry_exporter.hpp for the layout\n\n";
+    std::cout << "Examples:\n";
+    std::cout << "  telemetry_exporter_cli flight.svo2\n";
+    std::cout << "  telemetry_exporter_cli flight.svo2 --topics imu,barometer --csv\n\n";
+}
+
+/**
+ * @brief Validate configuration
+ */
+ErrorResult validateConfig(const Config& config) {
+    // Check SVO file exists
+    if (!FileUtils::validateSVO2File(config.svoFilePath)) {
+        return ErrorResult::failure("Invalid SVO2 file: " + config.svoFilePath);
+    }
+
+    if (config.allTopics && !config.topics.empty()) {
+        return ErrorResult::failure("--topics and --all-topics are mutually exclusive");
+    }
+
+    return ErrorResult::success();
+}
+
+/**
+ * @brief Export telemetry from SVO file
+ */
+ErrorResult exportFromSvo(const Config& config) {
+    LOG_INFO("Starting telemetry export...");
+    LOG_INFO("Input: " + config.svoFilePath);
+    LOG_INFO("Base output: " + config.baseOutputPath);
+
+    // Initialize OutputManager
+    OutputManager outputMgr(config.baseOutputPath);
+    auto validateResult = outputMgr.validateBaseOutputPath();
+    if (validateResult.isFailure()) {
+        return validateResult;
+    }
+
+    // Parse flight info
+    std::filesystem::path svoPath(config.svoFilePath);
+    std::string flightFolderName = svoPath.parent_path().filename().string();
+    if (!FileUtils::isFlightFolder(flightFolderName)) {
+        LOG_WARNING("SVO file not in flight folder format. Using filename as identifier.");
+        flightFolderName = svoPath.stem().string();
+    }
+
+    std::string extractionPath = outputMgr.getExtractionPath(flightFolderName, OutputType::TELEMETRY);
+    if (extractionPath.empty()) {
+        return ErrorResult::failure("Failed to create extraction directory");
+    }
+    LOG_INFO("Extraction path: " + extractionPath);
+
+    TelemetryExportConfig exportConfig;
+    exportConfig.svoFilePath = config.svoFilePath;
+    exportConfig.outputDirectory = extractionPath;
+    exportConfig.writeCsv = config.writeCsv;
+    if (config.allTopics) {
+        exportConfig.topicFilters.clear();
+    } else if (!config.topics.empty()) {
+        exportConfig.topicFilters.clear();
+        std::stringstream ss(config.topics);
+        std::string topic;
+        while (std::getline(ss, topic, ',')) {
+            if (!topic.empty()) exportConfig.topicFilters.push_back(topic);
+        }
+    }
+
+    TelemetryExportStats stats;
+    auto result = exportTelemetry(exportConfig, stats);
+    if (result.isFailure()) {
+        return result;
+    }
+
+    double mb = stats.bytesRead / (1024.0 * 1024.0);
+    LOG_INFO("Channels exported: " + std::to_string(stats.channelsExported));
+    LOG_INFO("Rows exported: " + std::to_string(stats.rowsExported));
+    if (stats.messagesSkipped > 0) {
+        LOG_WARNING("Undecodable messages skipped: " + std::to_string(stats.messagesSkipped));
+    }
+    LOG_INFO("Read " + std::to_string(mb) + " MB in " + std::to_string(stats.seconds) + "s");
+    LOG_INFO("Output: " + stats.outputFile);
+    for (const auto& csv : stats.csvFiles) {
+        LOG_INFO("CSV: " + csv);
+    }
+
+    return ErrorResult::success();
+}
+
+/**
+ * @brief Main entry point
+ */
+int main(int argc, char* argv[]) {
+    // Parse arguments first
+    Config config;
+    if (!parseArguments(argc, argv, config)) {
+        printHelp();
+        return 1;
+    }
+
+    if (config.showHelp) {
+        printHelp();
+        return 0;
+    }
+
+    // Initialize logger
+    try {
+        Logger::getInstance().initialize("telemetry_exporter.log", LogMode::BOTH, LogLevel::INFO);
+    } catch (const std::exception& e) {
+        std::cerr << "Warning: Failed to initialize logger: " << e.what() << std::endl;
+        std::cerr << "Continuing without file logging..." << std::endl;
+    }
+
+    std::cout << "\n=== ZED Telemetry Exporter CLI v0.1.0 ===\n" << std::endl;
+    LOG_INFO("ZED Telemetry Exporter CLI v0.1.0 started");
+
+    // Validate configuration
+    auto validationResult = validateConfig(config);
+    if (validationResult.isFailure()) {
+        LOG_ERROR(validationResult.getMessage());
+        std::cerr << "Error: " << validationResult.getMessage() << std::endl;
+        return 1;
+    }
+
+    auto result = exportFromSvo(config);
+    if (result.isFailure()) {
+        LOG_ERROR(result.getMessage());
+        std::cerr << "Error: " << result.getMessage() << std::endl;
+        return 1;
+    }
+
+    std::cout << "\n✓ Telemetry export complete!\n" << std::endl;
+    LOG_INFO("Application finished successfully");
+    Logger::getInstance().shutdown();
+
+    return 0;
+}
@@ -19,12 +19,16 @@
  *   --codec <codec>         Codec: h264, h265 (default: h264)
  *   --fps <rate>            Output FPS (default: source FPS)
  *   --quality <0-100>       Video quality (default: 90)
+ *   --pipe <target>         Stream raw frames to stdout ("-") or a named pipe instead of a file
+ *   --pipe-format <fmt>     Pipe format: y4m, bgr24, nv12 (default: y4m)
+ *   --segment-sec <sec>     Roll into segments of this length with a manifest (default: one file)
  *   --help                  Show this help message
  */
 
 #include <iostream>
 #include <string>
 #include <cmath>
+#include <algorithm>
 #include <sl/Camera.hpp>
 #include <opencv2/opencv.hpp>
 
@@ -34,6 +38,8 @@
 #include "../../common/svo_handler.hpp"
 #include "../../common/metadata.hpp"
 #include "../../common/output_manager.hpp"
+#include "../../common/frame_pipe_writer.hpp"
+#include "../../common/segmented_video_writer.hpp"
 
 using namespace zed_tools;
 
@@ -47,6 +53,9 @@ struct Config {
     std::string codec = "mjpeg";      // mjpeg (default), h264, h265
     float outputFps = -1.0f;          // -1 = use source FPS
     int quality = 90;                 // 0-100
+    std::string pipeTarget;           // Non-empty: stream frames here ("-" = stdout) instead of a file
+    std::string pipeFormat = "y4m";   // y4m, bgr24, nv12
+    float segmentSec = 0.0f;          // >0: rolling segments + <stream>_segments.json / .ffconcat
     bool showHelp = false;
 };
 
@@ -91,6 +100,15 @@ bool parseArguments(int argc, char* argv[], Config& config) {
         else if (arg == "--quality" && i + 1 < argc) {
             config.quality = std::stoi(argv[++i]);
         }
+        else if (arg == "--pipe" && i + 1 < argc) {
+            config.pipeTarget = argv[++i];
+        }
+        else if (arg == "--pipe-format" && i + 1 < argc) {
+            config.pipeFormat = argv[++i];
+        }
+        else if (arg == "--segment-sec" && i + 1 < argc) {
+            config.segmentSec = std::stof(argv[++i]);
+        }
         else {
             std::cerr << "Warning: Unknown argument: " << arg << std::endl;
         }
@@ -121,6 +139,14 @@ void printHelp() {
     std::cout << "  --codec <codec>         Video codec: mjpeg, h264, h265 (default: mjpeg)\n";
     std::cout << "  --fps <rate>            Output FPS (default: source FPS)\n";
     std::cout << "  --quality <0-100>       Video quality (default: 90)\n";
+    std::cout << "  --pipe <target>         Stream raw frames instead of writing a file:\n";
+    std::cout << "                            -                 stdout (logs go to stderr)\n";
+    std::cout << "                            <path>            FIFO (created if missing)\n";
+    std::cout << "                            \\\\.\\pipe\\<name>  Windows named pipe\n";
+    std::cout << "  --pipe-format <fmt>     y4m, bgr24, nv12 (default: y4m)\n";
+    std::cout << "  --segment-sec <sec>     Roll output into segments of this length; finished segments\n";
+    std::cout << "                          are listed in <stream>_segments.json and <stream>.ffconcat\n";
+    std::cout << "                          while the extraction continues (default: one file per stream)\n";
     std::cout << "  --help, -h              Show this help message\n\n";
     std::cout << "Output Structure:\n";
     std::cout << "  Videos saved to: <base>/Extractions/flight_XXX/extraction_NNN/\n";
@@ -128,7 +154,8 @@ void printHelp() {
     std::cout << "Examples:\n";
     std::cout << "  video_extractor_cli flight.svo2  # creates AVI (MJPEG) by default\n";
     std::cout << "  video_extractor_cli flight.svo2 --camera side_by_side --codec h265\n";
-    std::cout << "  video_extractor_cli flight.svo2 --fps 30 --quality 95\n\n";
+    std::cout << "  video_extractor_cli flight.svo2 --fps 30 --quality 95\n";
+    std::cout << "  video_extractor_cli flight.svo2 --pipe - | ffmpeg -i - -c:v libx265 -crf 22 out.mkv\n\n";
 }
 
 /**
@@ -161,6 +188,24 @@ ErrorResult validateConfig(const Config& config) {
         return ErrorResult::failure("Quality must be 0-100: " + std::to_string(config.quality));
     }
     
+    if (config.segmentSec < 0) {
+        return ErrorResult::failure("Segment length must not be negative");
+    }
+    
+    // Pipe mode carries a single stream
+    if (!config.pipeTarget.empty()) {
+        PipeFormat format;
+        if (!FramePipeWriter::parseFormat(config.pipeFormat, format)) {
+            return ErrorResult::failure("Invalid pipe format: " + config.pipeFormat);
+        }
+        if (config.cameraMode == "both_separate") {
+            return ErrorResult::failure("Pipe mode carries one stream; use left, right or side_by_side");
+        }
+        if (config.segmentSec > 0) {
+            return ErrorResult::failure("--segment-sec writes files; it cannot be combined with --pipe");
+        }
+    }
+    
     return ErrorResult::success();
 }
 
@@ -206,6 +251,72 @@ static std::string getContainerExtension(const std::string& codec) {
     return ".mp4"; // h264/h265
 }
 
+/**
+ * @brief Stream frames to a pipe for an external encoder (no file, no re-encode)
+ */
+ErrorResult pipeVideo(const Config& config, SVOHandler& svo, const SVOProperties& props, float outputFps) {
+    PipeFormat format = PipeFormat::Y4M;
+    FramePipeWriter::parseFormat(config.pipeFormat, format);
+    
+    const bool needLeft = (config.cameraMode == "left" || config.cameraMode == "side_by_side");
+    const bool needRight = (config.cameraMode == "right" || config.cameraMode == "side_by_side");
+    int width = (config.cameraMode == "side_by_side") ? props.width * 2 : props.width;
+    
+    FramePipeWriter pipe;
+    auto openResult = pipe.open(config.pipeTarget, format, width, props.height, outputFps);
+    if (openResult.isFailure()) {
+        return openResult;
+    }
+    LOG_INFO("Streaming " + config.pipeFormat + " frames to " + config.pipeTarget);
+    
+    sl::Mat leftImage, rightImage;
+    cv::Mat stereoFrame;
+    int frameCount = 0;
+    int progressInterval = std::max(1, props.totalFrames / 20);
+    
+    while (svo.grab()) {
+        cv::Mat frame;
+        if (needLeft) {
+            if (svo.retrieveImage(leftImage, sl::VIEW::LEFT) != sl::ERROR_CODE::SUCCESS) {
+                LOG_WARNING("Failed to retrieve left image at frame " + std::to_string(frameCount));
+                frameCount++;
+                continue;
+            }
+            frame = slMat2cvMat(leftImage);
+        }
+        if (needRight) {
+            if (svo.retrieveImage(rightImage, sl::VIEW::RIGHT) != sl::ERROR_CODE::SUCCESS) {
+                LOG_WARNING("Failed to retrieve right image at frame " + std::to_string(frameCount));
+                frameCount++;
+                continue;
+            }
+            frame = slMat2cvMat(rightImage);
+        }
+        if (config.cameraMode == "side_by_side") {
+            // BGRA halves; the pipe writer drops alpha while copying
+            cv::hconcat(slMat2cvMat(leftImage), slMat2cvMat(rightImage), stereoFrame);
+            frame = stereoFrame;
+        }
+        
+        if (!pipe.write(frame)) {
+            LOG_WARNING("Pipe closed by consumer at frame " + std::to_string(frameCount));
+            break;
+        }
+        frameCount++;
+        
+        if (frameCount % progressInterval == 0) {
+            float progress = (frameCount * 100.0f) / props.totalFrames;
+            LOG_INFO("Progress: " + std::to_string(static_cast<int>(progress)) + 
+                    "% (" + std::to_string(frameCount) + "/" + std::to_string(props.totalFrames) + " frames)");
+        }
+    }
+    
+    auto closeResult = pipe.close();
+    LOG_INFO("Frames piped: " + std::to_string(pipe.getFramesWritten()) + " (" +
+             std::to_string(pipe.getBytesWritten() / (1024 * 1024)) + " MB)");
+    return closeResult;
+}
+
 /**
  * @brief Extract video from SVO file
  */
@@ -217,11 +328,13 @@ ErrorResult extractVideo(const Config& config) {
     LOG_INFO("Codec: " + config.codec);
     LOG_INFO("Quality: " + std::to_string(config.quality));
     
-    // Initialize OutputManager
+    // Initialize OutputManager (pipe mode writes nothing below the base path)
     OutputManager outputMgr(config.baseOutputPath);
-    auto validateResult = outputMgr.validateBaseOutputPath();
-    if (validateResult.isFailure()) {
-        return validateResult;
+    if (config.pipeTarget.empty()) {
+        auto validateResult = outputMgr.validateBaseOutputPath();
+        if (validateResult.isFailure()) {
+            return validateResult;
+        }
     }
     
     // Open SVO file
@@ -249,14 +362,6 @@ ErrorResult extractVideo(const Config& config) {
         flightFolderName = svoPath.stem().string();
     }
     
-    // Get extraction output path
-    std::string extractionPath = outputMgr.getExtractionPath(flightFolderName, OutputType::VIDEO);
-    if (extractionPath.empty()) {
-        return ErrorResult::failure("Failed to create extraction directory");
-    }
-    
-    LOG_INFO("Extraction path: " + extractionPath);
-    
     // Determine output FPS with validation
     float outputFps;
     if (config.outputFps > 0) {
@@ -273,6 +378,18 @@ ErrorResult extractVideo(const Config& config) {
     }
     LOG_INFO("Output FPS: " + std::to_string(outputFps));
     
+    if (!config.pipeTarget.empty()) {
+        return pipeVideo(config, svo, props, outputFps);
+    }
+    
+    // Get extraction output path
+    std::string extractionPath = outputMgr.getExtractionPath(flightFolderName, OutputType::VIDEO);
+    if (extractionPath.empty()) {
+        return ErrorResult::failure("Failed to create extraction directory");
+    }
+    
+    LOG_INFO("Extraction path: " + extractionPath);
+    
     // Prepare metadata
     VideoMetadata videoMeta;
     videoMeta.extractionDateTime = getCurrentDateTime();
@@ -301,40 +418,53 @@ ErrorResult extractVideo(const Config& config) {
         frameSize.width *= 2;
     }
     
-    // Create video writers
-    cv::VideoWriter leftWriter, rightWriter, stereoWriter;
+    // Create video writers (one file per stream, or rolling segments with a manifest)
+    VideoStreamWriter leftWriter, rightWriter, stereoWriter;
     std::string baseFilename = "video";
     
-    std::string extension = getContainerExtension(config.codec);
+    SegmentedVideoConfig streamConfig;
+    streamConfig.directory = extractionPath;
+    streamConfig.extension = getContainerExtension(config.codec);
+    streamConfig.fourcc = fourcc;
+    streamConfig.fps = outputFps;
+    streamConfig.frameSize = cv::Size(props.width, props.height);
+    streamConfig.segmentSec = config.segmentSec;
+    videoMeta.segmentSeconds = config.segmentSec;
+    auto onSegment = [](const VideoSegment& segment) {
+        if (segment.state == SegmentState::Complete) {
+            LOG_INFO("Segment ready: " + segment.fileName + " (" + std::to_string(segment.frameCount) + " frames)");
+        }
+    };
 
     if (config.cameraMode == "left" || config.cameraMode == "both_separate") {
-        std::string leftPath = extractionPath + "/" + baseFilename + "_left" + extension;
-        leftWriter.open(leftPath, fourcc, outputFps, cv::Size(props.width, props.height), true);
-        if (!leftWriter.isOpened()) {
-            return ErrorResult::failure("Failed to create left video writer: " + leftPath);
+        streamConfig.stem = baseFilename + "_left";
+        auto opened = leftWriter.open(streamConfig, onSegment);
+        if (opened.isFailure()) {
+            return opened;
         }
-        videoMeta.outputFiles.push_back(leftPath);
-        LOG_INFO("Created left video: " + leftPath);
+        videoMeta.outputFiles.push_back(leftWriter.getOutputPath());
+        LOG_INFO("Created left video: " + leftWriter.getOutputPath());
     }
     
     if (config.cameraMode == "right" || config.cameraMode == "both_separate") {
-        std::string rightPath = extractionPath + "/" + baseFilename + "_right" + extension;
-        rightWriter.open(rightPath, fourcc, outputFps, cv::Size(props.width, props.height), true);
-        if (!rightWriter.isOpened()) {
-            return ErrorResult::failure("Failed to create right video writer: " + rightPath);
+        streamConfig.stem = baseFilename + "_right";
+        auto opened = rightWriter.open(streamConfig, onSegment);
+        if (opened.isFailure()) {
+            return opened;
         }
-        videoMeta.outputFiles.push_back(rightPath);
-        LOG_INFO("Created right video: " + rightPath);
+        videoMeta.outputFiles.push_back(rightWriter.getOutputPath());
+        LOG_INFO("Created right video: " + rightWriter.getOutputPath());
     }
     
     if (config.cameraMode == "side_by_side") {
-        std::string stereoPath = extractionPath + "/" + baseFilename + "_stereo" + extension;
-        stereoWriter.open(stereoPath, fourcc, outputFps, frameSize, true);
-        if (!stereoWriter.isOpened()) {
-            return ErrorResult::failure("Failed to create stereo video writer: " + stereoPath);
+        streamConfig.stem = baseFilename + "_stereo";
+        streamConfig.frameSize = frameSize;
+        auto opened = stereoWriter.open(streamConfig, onSegment);
+        if (opened.isFailure()) {
+            return opened;
         }
-        videoMeta.outputFiles.push_back(stereoPath);
-        LOG_INFO("Created stereo video: " + stereoPath);
+        videoMeta.outputFiles.push_back(stereoWriter.getOutputPath());
+        LOG_INFO("Created stereo video: " + stereoWriter.getOutputPath());
     }
     
     // Extraction loop
@@ -378,22 +508,30 @@ ErrorResult extractVideo(const Config& config) {
         }
         
         // Write frames
+        bool written = true;
         if (config.cameraMode == "left") {
-            leftWriter.write(cvLeft);
+            written = leftWriter.write(cvLeft);
         }
         else if (config.cameraMode == "right") {
-            rightWriter.write(cvRight);
+            written = rightWriter.write(cvRight);
         }
         else if (config.cameraMode == "both_separate") {
-            leftWriter.write(cvLeft);
-            rightWriter.write(cvRight);
+            written = leftWriter.write(cvLeft);
+            written = rightWriter.write(cvRight) && written;
         }
         else if (config.cameraMode == "side_by_side") {
             // Create side-by-side frame
             cv::Mat stereoFrame(props.height, props.width * 2, CV_8UC3);
             cvLeft.copyTo(stereoFrame(cv::Rect(0, 0, props.width, props.height)));
             cvRight.copyTo(stereoFrame(cv::Rect(props.width, 0, props.width, props.height)));
-            stereoWriter.write(stereoFrame);
+            written = stereoWriter.write(stereoFrame);
+        }
+        if (!written) {
+            // Later frames would be dropped silently; keep what was finished and fail
+            leftWriter.release();
+            rightWriter.release();
+            stereoWriter.release();
+            return ErrorResult::failure("Video writer stopped accepting frames at frame " + std::to_string(frameCount));
         }
         
         frameCount++;
@@ -406,10 +544,16 @@ ErrorResult extractVideo(const Config& config) {
         }
     }
     
-    // Release video writers
-    if (leftWriter.isOpened()) leftWriter.release();
-    if (rightWriter.isOpened()) rightWriter.release();
-    if (stereoWriter.isOpened()) stereoWriter.release();
+    // Release video writers (segmented output: waits for the last segments to be finalised).
+    // Every writer is released; the first failure fails the extraction
+    std::string releaseError;
+    for (VideoStreamWriter* writer : { &leftWriter, &rightWriter, &stereoWriter }) {
+        auto released = writer->release();
+        if (released.isFailure() && releaseError.empty()) releaseError = released.getMessage();
+    }
+    if (!releaseError.empty()) {
+        return ErrorResult::failure("Failed to finalise video output: " + releaseError);
+    }
     
     // Save metadata
     std::string metadataPath = OutputManager::getMetadataPath(extractionPath);
@@ -442,7 +586,10 @@ int main(int argc, char* argv[]) {
         return 0;
     }
     
-    // Initialize logger
+    // Initialize logger; when frames go to stdout, everything else goes to stderr
+    const bool pipeToStdout = (config.pipeTarget == "-");
+    std::ostream& console = pipeToStdout ? std::cerr : std::cout;
+    Logger::getInstance().setConsoleToStderr(pipeToStdout);
     try {
         Logger::getInstance().initialize("video_extractor.log", LogMode::BOTH, LogLevel::INFO);
     } catch (const std::exception& e) {
@@ -450,7 +597,7 @@ int main(int argc, char* argv[]) {
         std::cerr << "Continuing without file logging..." << std::endl;
     }
     
-    std::cout << "\n=== ZED Video Extractor CLI v0.1.0 ===\n" << std::endl;
+    console << "\n=== ZED Video Extractor CLI v0.1.0 ===\n" << std::endl;
     LOG_INFO("ZED Video Extractor CLI v0.1.0 started");
     
     // Validate configuration
@@ -469,7 +616,7 @@ int main(int argc, char* argv[]) {
         return 1;
     }
     
-    std::cout << "\n✓ Video extraction complete!\n" << std::endl;
+    console << "\n✓ Video extraction complete!\n" << std::endl;
     LOG_INFO("Application finished successfully");
     Logger::getInstance().shutdown();
     
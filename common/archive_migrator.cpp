@@ -0,0 +1,258 @@
+/**
+ * @file archive_migrator.cpp
+ * @brief Implementation of the scratch-to-archive migrator
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "archive_migrator.hpp"
+#include "hash_utils.hpp"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace zed_tools {
+
+namespace {
+
+uint64_t folderSize(const fs::path& folder) {
+    uint64_t total = 0;
+    std::error_code ec;
+    for (fs::recursive_directory_iterator it(folder, ec), end; !ec && it != end; it.increment(ec)) {
+        if (it->is_regular_file(ec)) total += it->file_size(ec);
+    }
+    return total;
+}
+
+} // namespace
+
+ArchiveMigrator::ArchiveMigrator(const ArchiveMigratorConfig& config)
+    : config_(config)
+{
+    worker_ = std::thread(&ArchiveMigrator::workerLoop, this);
+}
+
+ArchiveMigrator::~ArchiveMigrator() {
+    if (pendingJobs_ > 0) {
+        LOG_INFO("Waiting for " + std::to_string(pendingJobs_.load()) + " archive migration(s)");
+    }
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (worker_.joinable()) worker_.join();
+}
+
+void ArchiveMigrator::setScratchLimit(uint64_t bytes) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        config_.scratchLimitBytes = bytes;
+    }
+    cv_.notify_all();
+}
+
+ErrorResult ArchiveMigrator::submit(const std::string& stagedPath, const std::string& archivePath) {
+    std::error_code ec;
+    if (!fs::is_directory(stagedPath, ec)) {
+        return ErrorResult::failure("Staged folder not found: " + stagedPath);
+    }
+    std::ofstream marker(stagedPath + "/" + kCompleteMarker);
+    marker << archivePath << "\n";
+    if (!marker) return ErrorResult::failure("Failed to mark staged folder complete: " + stagedPath);
+    marker.close();
+
+    enqueue({stagedPath, archivePath, folderSize(stagedPath)});
+    return ErrorResult::success();
+}
+
+int ArchiveMigrator::recover(const std::string& scratchRoot, const std::string& archiveRoot) {
+    int queued = 0;
+    std::error_code ec;
+    for (fs::directory_iterator flight(scratchRoot, ec), end; !ec && flight != end; flight.increment(ec)) {
+        if (!flight->is_directory(ec)) continue;
+        std::error_code inner;
+        for (fs::directory_iterator job(flight->path(), inner), jobEnd; !inner && job != jobEnd; job.increment(inner)) {
+            if (!fs::exists(job->path() / kCompleteMarker)) continue;
+            const std::string archivePath = archiveRoot + "/" + flight->path().filename().string() +
+                                            "/" + job->path().filename().string();
+            enqueue({job->path().generic_string(), archivePath, folderSize(job->path())});
+            ++queued;
+        }
+    }
+    if (queued > 0) LOG_INFO("Resuming " + std::to_string(queued) + " staged extraction(s) left on scratch");
+    return queued;
+}
+
+void ArchiveMigrator::enqueue(Job job) {
+    stagedBytes_ += job.bytes;
+    ++pendingJobs_;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        // A failed folder queued again by recover() is counted as staged from now on
+        auto it = retained_.find(job.stagedPath);
+        if (it != retained_.end()) {
+            retainedBytes_ -= it->second;
+            retained_.erase(it);
+        }
+        queue_.push_back(std::move(job));
+    }
+    cv_.notify_all();
+}
+
+bool ArchiveMigrator::waitForCapacity(const std::function<bool()>& cancelled) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Failed folders still fill scratch; only a pending migration can free space, so wait on those
+    while (stagedBytes_ + retainedBytes_ >= config_.scratchLimitBytes && pendingJobs_ > 0) {
+        if (cancelled && cancelled()) return false;
+        cv_.wait_for(lock, std::chrono::milliseconds(250));
+    }
+    return true;
+}
+
+void ArchiveMigrator::waitIdle() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return pendingJobs_ == 0; });
+}
+
+void ArchiveMigrator::workerLoop() {
+    for (;;) {
+        Job job;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !queue_.empty() || stopping_; });
+            if (queue_.empty()) return;   // stopping and drained
+            job = std::move(queue_.front());
+            queue_.pop_front();
+        }
+
+        auto start = std::chrono::steady_clock::now();
+        std::string error;
+        const bool migrated = migrate(job, error);
+        if (migrated) {
+            ++migratedJobs_;
+            double sec = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            std::ostringstream msg;
+            msg << "Archived " << job.archivePath << " (" << (job.bytes / (1024 * 1024)) << " MiB in "
+                << static_cast<int>(sec) << " s)";
+            LOG_INFO(msg.str());
+        } else {
+            // The staged copy and its marker stay on scratch; recover() retries on the next run
+            ++failedJobs_;
+            LOG_ERROR("Archive migration failed for " + job.stagedPath + ": " + error);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stagedBytes_ -= job.bytes;
+            if (!migrated) {
+                // Still on disk: keep counting it against the scratch limit
+                retained_[job.stagedPath] = job.bytes;
+                retainedBytes_ += job.bytes;
+            }
+            --pendingJobs_;
+        }
+        cv_.notify_all();
+    }
+}
+
+bool ArchiveMigrator::copyFile(const std::string& from, const std::string& to, std::string& sha256,
+                               std::string& error) {
+    std::ifstream in(from, std::ios::binary);
+    std::ofstream out(to, std::ios::binary | std::ios::trunc);
+    if (!in || !out) {
+        error = "cannot open " + (in ? to : from);
+        return false;
+    }
+    std::vector<char> buffer(config_.copyBufferSize);
+    Sha256 hash;
+    while (in) {
+        in.read(buffer.data(), static_cast<std::streamsize>(buffer.size()));
+        std::streamsize n = in.gcount();
+        if (n <= 0) break;
+        hash.update(buffer.data(), static_cast<size_t>(n));
+        out.write(buffer.data(), n);
+        if (!out) {
+            error = "write failed: " + to;
+            return false;
+        }
+    }
+    if (in.bad()) {
+        error = "read failed: " + from;
+        return false;
+    }
+    out.close();
+    if (!out) {
+        error = "close failed: " + to;
+        return false;
+    }
+    Sha256::Digest d = hash.finish();
+    sha256 = toHex(d.data(), d.size());
+    return true;
+}
+
+bool ArchiveMigrator::migrate(const Job& job, std::string& error) {
+    const fs::path src(job.stagedPath);
+    const fs::path dst(job.archivePath);
+    const fs::path partial(job.archivePath + ".partial");
+    std::error_code ec;
+
+    if (fs::exists(dst, ec)) {
+        error = "archive folder already exists: " + job.archivePath;
+        return false;
+    }
+    fs::remove_all(partial, ec);   // Leftover from an interrupted attempt
+    if (!fs::create_directories(partial, ec) && ec) {
+        error = "cannot create " + partial.string() + " (" + ec.message() + ")";
+        return false;
+    }
+
+    std::ostringstream sums;
+    for (fs::recursive_directory_iterator it(src, ec), end; it != end; it.increment(ec)) {
+        if (ec) break;
+        const fs::path rel = it->path().lexically_relative(src);
+        if (rel == kCompleteMarker) continue;
+        if (it->is_directory()) {
+            fs::create_directories(partial / rel, ec);
+            if (ec) break;
+            continue;
+        }
+        std::string digest;
+        const std::string target = (partial / rel).string();
+        if (!copyFile(it->path().string(), target, digest, error)) return false;
+        if (config_.verify && sha256FileHex(target) != digest) {
+            error = "checksum mismatch after copy: " + rel.generic_string();
+            return false;
+        }
+        sums << digest << "  " << rel.generic_string() << "\n";
+    }
+    if (ec) {
+        error = "cannot walk " + job.stagedPath + " (" + ec.message() + ")";
+        return false;
+    }
+
+    std::ofstream sumsFile(partial / "SHA256SUMS");
+    sumsFile << sums.str();
+    sumsFile.close();
+    if (!sumsFile) {
+        error = "cannot write SHA256SUMS";
+        return false;
+    }
+
+    // Publish: a same-directory rename is atomic, readers see all or nothing
+    fs::rename(partial, dst, ec);
+    if (ec) {
+        error = "publish rename failed (" + ec.message() + ")";
+        return false;
+    }
+    fs::remove_all(src, ec);
+    if (ec) LOG_WARNING("Archived, but could not remove scratch copy " + job.stagedPath);
+    return true;
+}
+
+} // namespace zed_tools
@@ -0,0 +1,127 @@
+/**
+ * @file archive_migrator.hpp
+ * @brief Background migration of staged extraction folders to the archive
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Extractions write to a fast local scratch tier (see OutputManager::setScratchPath);
+ * once a job completes its folder is handed to the migrator, which:
+ * - copies every file with large sequential reads/writes into
+ *   <archive>/.../extraction_NNN.partial (one copy at a time; the NAS sees
+ *   streaming writes instead of thousands of small interleaved ones)
+ * - re-reads each archive copy and compares its SHA-256 with the source
+ * - writes SHA256SUMS and publishes by renaming the .partial folder
+ *   (readers never see a half-copied extraction)
+ * - removes the scratch copy
+ *
+ * Staged bytes are bounded: waitForCapacity() blocks new jobs while the
+ * folders waiting for migration, plus folders whose migration failed and
+ * that still occupy scratch, exceed the scratch limit. Folders carry a
+ * completion marker, so failed work and work left over after a crash is
+ * picked up again by recover().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include "error_handler.hpp"
+
+namespace zed_tools {
+
+/**
+ * @brief Migration tuning
+ */
+struct ArchiveMigratorConfig {
+    uint64_t scratchLimitBytes = 50ull * 1024 * 1024 * 1024; ///< Staged data before new jobs wait
+    size_t copyBufferSize = 8 * 1024 * 1024;   ///< Sequential copy block
+    bool verify = true;                         ///< Re-read archive copies and compare SHA-256
+};
+
+/**
+ * @brief Single-threaded scratch-to-archive mover
+ */
+class ArchiveMigrator {
+public:
+    /// Marker written into a staged folder when its job is complete
+    static constexpr const char* kCompleteMarker = ".staged_complete";
+
+    explicit ArchiveMigrator(const ArchiveMigratorConfig& config = ArchiveMigratorConfig());
+
+    /**
+     * @brief Drains all queued migrations before returning
+     */
+    ~ArchiveMigrator();
+
+    ArchiveMigrator(const ArchiveMigrator&) = delete;
+    ArchiveMigrator& operator=(const ArchiveMigrator&) = delete;
+
+    void setScratchLimit(uint64_t bytes);
+
+    /**
+     * @brief Mark a finished staged folder complete and queue it for migration
+     * @param stagedPath Folder on the scratch tier
+     * @param archivePath Final location (must not exist yet)
+     */
+    ErrorResult submit(const std::string& stagedPath, const std::string& archivePath);
+
+    /**
+     * @brief Re-queue completed folders left on scratch by an earlier run
+     * @param scratchRoot Scratch "Extractions" folder
+     * @param archiveRoot Archive "Extractions" folder
+     * @return Number of folders queued
+     */
+    int recover(const std::string& scratchRoot, const std::string& archiveRoot);
+
+    /**
+     * @brief Block while queued staged data exceeds the scratch limit
+     * @param cancelled Polled while waiting; returning true aborts the wait
+     * @return false if cancelled
+     */
+    bool waitForCapacity(const std::function<bool()>& cancelled);
+
+    /**
+     * @brief Block until every queued migration has finished
+     */
+    void waitIdle();
+
+    uint64_t getStagedBytes() const { return stagedBytes_; }
+    uint64_t getRetainedBytes() const { return retainedBytes_; }  ///< Failed migrations still on scratch
+    int getPendingJobs() const { return pendingJobs_; }
+    int getMigratedJobs() const { return migratedJobs_; }
+    int getFailedJobs() const { return failedJobs_; }
+
+private:
+    struct Job {
+        std::string stagedPath;
+        std::string archivePath;
+        uint64_t bytes = 0;
+    };
+
+    ArchiveMigratorConfig config_;
+    std::thread worker_;
+    mutable std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Job> queue_;
+    bool stopping_ = false;
+    std::atomic<uint64_t> stagedBytes_{0};
+    std::atomic<uint64_t> retainedBytes_{0};
+    std::map<std::string, uint64_t> retained_;   // Failed staged folders -> bytes (guarded by mutex_)
+    std::atomic<int> pendingJobs_{0};
+    std::atomic<int> migratedJobs_{0};
+    std::atomic<int> failedJobs_{0};
+
+    void workerLoop();
+    void enqueue(Job job);
+    bool migrate(const Job& job, std::string& error);
+    bool copyFile(const std::string& from, const std::string& to, std::string& sha256, std::string& error);
+};
+
+} // namespace zed_tools
@@ -0,0 +1,300 @@
+/**
+ * @file background_priority.cpp
+ * @brief Implementation of the background priority mode
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "background_priority.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <thread>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#elif defined(__linux__)
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+namespace zed_tools {
+
+namespace {
+
+constexpr double kSampleIntervalSec = 1.0;   // Pressure sampling period
+constexpr double kMinDutyFactor = 0.1;       // Never stall completely
+constexpr double kMaxSleepSliceSec = 0.1;    // Cancellation latency during long sleeps
+
+#ifdef __linux__
+constexpr int kIoprioWhoProcess = 1;          // Per-thread when given a TID
+constexpr int kIoprioClassIdle = 3;
+constexpr int kIoprioClassShift = 13;
+
+/**
+ * @brief "some avg10" of a PSI file, or -1 if unavailable
+ */
+double readPsiSomeAvg10(const char* path) {
+    std::ifstream in(path);
+    std::string line;
+    while (std::getline(in, line)) {
+        if (line.compare(0, 5, "some ") != 0) continue;
+        size_t pos = line.find("avg10=");
+        if (pos != std::string::npos) return std::atof(line.c_str() + pos + 6);
+    }
+    return -1.0;
+}
+#endif
+
+} // namespace
+
+namespace {
+
+/**
+ * @brief Lower the calling thread's priority without logging
+ * @param applied Receives what was changed (empty if nothing)
+ */
+void lowerThreadPriority(const BackgroundPriorityConfig& config, ThreadPriorityState* previous, std::string& applied) {
+    applied.clear();
+#ifdef _WIN32
+    (void)config;
+    if (previous) previous->valid = false;
+    // Lowers CPU scheduling, IO and memory priority of this thread
+    if (SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_BEGIN)) {
+        applied = " background processing mode";
+        if (previous) previous->valid = true;
+    }
+#elif defined(__linux__)
+    const pid_t tid = static_cast<pid_t>(::syscall(SYS_gettid));
+    if (previous) {
+        errno = 0;
+        const int nice = ::getpriority(PRIO_PROCESS, static_cast<id_t>(tid));
+        previous->nice = (errno == 0) ? nice : 0;
+        previous->ioPriority = static_cast<int>(::syscall(SYS_ioprio_get, kIoprioWhoProcess, tid));
+        previous->schedPolicy = ::sched_getscheduler(tid);
+        sched_param param{};
+        previous->schedPriority = (::sched_getparam(tid, &param) == 0) ? param.sched_priority : 0;
+        previous->valid = true;
+    }
+
+    // Linux nice values are per thread; new threads inherit them
+    if (::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), 19) == 0) applied += " nice=19";
+    if (::syscall(SYS_ioprio_set, kIoprioWhoProcess, tid, kIoprioClassIdle << kIoprioClassShift) == 0) {
+        applied += " io=idle";
+    }
+    if (config.useSchedIdle) {
+        sched_param param{};
+        param.sched_priority = 0;
+        if (::sched_setscheduler(tid, SCHED_IDLE, &param) == 0) applied += " sched=idle";
+    }
+#else
+    (void)config;
+    if (previous) previous->valid = false;
+#endif
+}
+
+} // namespace
+
+ErrorResult applyBackgroundPriority(const BackgroundPriorityConfig& config, ThreadPriorityState* previous) {
+#if defined(_WIN32) || defined(__linux__)
+    std::string applied;
+    lowerThreadPriority(config, previous, applied);
+    if (applied.empty()) return ErrorResult::failure("Could not lower thread priority");
+    LOG_INFO("Background mode:" + applied);
+    return ErrorResult::success();
+#else
+    (void)config;
+    if (previous) previous->valid = false;
+    return ErrorResult::failure("Background priority is not supported on this platform");
+#endif
+}
+
+void restoreThreadPriority(const ThreadPriorityState& previous) {
+    if (!previous.valid) return;
+#ifdef _WIN32
+    if (!SetThreadPriority(GetCurrentThread(), THREAD_MODE_BACKGROUND_END)) {
+        LOG_WARNING("Background mode: could not leave background processing mode");
+    }
+#elif defined(__linux__)
+    const pid_t tid = static_cast<pid_t>(::syscall(SYS_gettid));
+    std::string failed;
+    if (previous.schedPolicy >= 0 && ::sched_getscheduler(tid) != previous.schedPolicy) {
+        sched_param param{};
+        param.sched_priority = previous.schedPriority;
+        if (::sched_setscheduler(tid, previous.schedPolicy, &param) != 0) failed += " sched";
+    }
+    // Lowering nice again needs RLIMIT_NICE (or CAP_SYS_NICE); without it the thread stays at 19
+    if (::setpriority(PRIO_PROCESS, static_cast<id_t>(tid), previous.nice) != 0) failed += " nice";
+    if (previous.ioPriority >= 0 &&
+        ::syscall(SYS_ioprio_set, kIoprioWhoProcess, tid, previous.ioPriority) != 0) {
+        failed += " io";
+    }
+    if (!failed.empty()) {
+        LOG_WARNING("Background mode: could not restore thread priority (" + failed.substr(1) +
+                    "); raise RLIMIT_NICE or run jobs on their own thread");
+    }
+#endif
+}
+
+ThreadPool& backgroundThreadPool() {
+    // Never destroyed, like the global pool
+    static ThreadPool* pool = [] {
+        const int concurrency = std::max(1, ThreadPool::global().getConcurrency() / 4);
+        return new ThreadPool(concurrency, [] {
+            std::string applied;
+            lowerThreadPriority(BackgroundPriorityConfig(), nullptr, applied);
+        });
+    }();
+    return *pool;
+}
+
+// ============================================================================
+// BackgroundPriorityScope
+// ============================================================================
+
+BackgroundPriorityScope::BackgroundPriorityScope(const BackgroundPriorityConfig& config)
+    : result_(applyBackgroundPriority(config, &previous_))
+{
+    // Pool work of this job (row bands, segment finalisation, ...) runs at background priority too
+    ThreadPool::setThreadDefault(&backgroundThreadPool());
+}
+
+BackgroundPriorityScope::~BackgroundPriorityScope() {
+    ThreadPool::setThreadDefault(nullptr);
+    restoreThreadPriority(previous_);
+}
+
+// ============================================================================
+// TokenBucket
+// ============================================================================
+
+TokenBucket::TokenBucket(double ratePerSec, double burst)
+    : rate_(ratePerSec)
+    , burst_(std::max(burst, ratePerSec > 0.0 ? 1.0 : 0.0))
+    , tokens_(burst_)
+    , last_(std::chrono::steady_clock::now())
+{
+}
+
+void TokenBucket::acquire(double tokens, const std::function<bool()>& cancelled) {
+    if (rate_ <= 0.0) return;
+    auto now = std::chrono::steady_clock::now();
+    tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_).count() * rate_);
+    last_ = now;
+    tokens_ -= tokens;
+    if (tokens_ >= 0.0) return;
+
+    // Sleep off the debt in slices so cancellation stays responsive
+    double wait = -tokens_ / rate_;
+    while (wait > 0.0) {
+        if (cancelled && cancelled()) break;
+        double slice = std::min(wait, kMaxSleepSliceSec);
+        std::this_thread::sleep_for(std::chrono::duration<double>(slice));
+        wait -= slice;
+    }
+    now = std::chrono::steady_clock::now();
+    tokens_ = std::min(burst_, tokens_ + std::chrono::duration<double>(now - last_).count() * rate_);
+    last_ = now;
+}
+
+// ============================================================================
+// BackgroundThrottle
+// ============================================================================
+
+BackgroundThrottle::BackgroundThrottle(const BackgroundPriorityConfig& config, std::function<bool()> cancelled,
+                                       std::unique_ptr<BackgroundPriorityScope> priority)
+    : config_(config)
+    , cancelled_(std::move(cancelled))
+    , priority_(std::move(priority))
+    , frameBucket_(config.maxFps, 1.0)
+    , byteBucket_(config.maxWriteMBps * 1024.0 * 1024.0, config.maxWriteMBps * 1024.0 * 1024.0)
+    , lastSample_(std::chrono::steady_clock::now())
+{
+}
+
+void BackgroundThrottle::sleepFor(double seconds) {
+    while (seconds > 0.0) {
+        if (cancelled_ && cancelled_()) return;
+        double slice = std::min(seconds, kMaxSleepSliceSec);
+        std::this_thread::sleep_for(std::chrono::duration<double>(slice));
+        seconds -= slice;
+    }
+}
+
+bool BackgroundThrottle::underPressure() {
+#ifdef _WIN32
+    FILETIME idle, kernel, user;
+    if (!GetSystemTimes(&idle, &kernel, &user)) return false;
+    auto toU64 = [](const FILETIME& ft) {
+        return (static_cast<uint64_t>(ft.dwHighDateTime) << 32) | ft.dwLowDateTime;
+    };
+    uint64_t idleNow = toU64(idle);
+    uint64_t totalNow = toU64(kernel) + toU64(user);   // Kernel time includes idle time
+    bool busy = false;
+    if (prevTotal_ > 0 && totalNow > prevTotal_) {
+        double busyFraction = 1.0 - static_cast<double>(idleNow - prevIdle_) / static_cast<double>(totalNow - prevTotal_);
+        busy = busyFraction > config_.cpuBusyThreshold;
+    }
+    prevIdle_ = idleNow;
+    prevTotal_ = totalNow;
+    return busy;
+#elif defined(__linux__)
+    std::ifstream loadavg("/proc/loadavg");
+    double load1 = 0.0;
+    loadavg >> load1;
+    const double cores = std::max(1u, std::thread::hardware_concurrency());
+    if (load1 / cores > config_.loadPerCoreThreshold) return true;
+    double ioSome = readPsiSomeAvg10("/proc/pressure/io");   // -1 on kernels without PSI
+    return ioSome > config_.ioPressureThreshold;
+#else
+    return false;
+#endif
+}
+
+void BackgroundThrottle::beforeFrame() {
+    auto now = std::chrono::steady_clock::now();
+
+    if (config_.adaptive && std::chrono::duration<double>(now - lastSample_).count() >= kSampleIntervalSec) {
+        lastSample_ = now;
+        double previous = dutyFactor_;
+        // AIMD: halve quickly under pressure, recover gradually
+        dutyFactor_ = underPressure() ? std::max(kMinDutyFactor, dutyFactor_ * 0.5)
+                                      : std::min(1.0, dutyFactor_ + 0.1);
+        if ((previous == 1.0) != (dutyFactor_ == 1.0)) {
+            LOG_INFO(std::string(dutyFactor_ < 1.0 ? "Background mode: system busy, backing off"
+                                                   : "Background mode: system idle again, full speed"));
+        }
+    }
+
+    // Stretch the previous frame's work so it only occupies dutyFactor of wall time
+    if (haveResume_ && dutyFactor_ < 1.0) {
+        double work = std::chrono::duration<double>(now - resumedAt_).count();
+        sleepFor(work * (1.0 / dutyFactor_ - 1.0));
+    }
+
+    frameBucket_.acquire(1.0, cancelled_);
+    resumedAt_ = std::chrono::steady_clock::now();
+    haveResume_ = true;
+}
+
+void BackgroundThrottle::onBytesWritten(uint64_t bytes) {
+    byteBucket_.acquire(static_cast<double>(bytes), cancelled_);
+}
+
+void BackgroundThrottle::onFileWritten(const std::string& path) {
+    if (!byteBucket_.isEnabled()) return;
+    std::error_code ec;
+    uint64_t size = std::filesystem::file_size(path, ec);
+    if (!ec) onBytesWritten(size);
+}
+
+} // namespace zed_tools
@@ -0,0 +1,184 @@
+/**
+ * @file background_priority.hpp
+ * @brief Low-priority run mode: idle CPU/IO scheduling, rate limits, load back-off
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Lets long batch extractions share a workstation with interactive users:
+ * - applyBackgroundPriority() drops the calling thread to nice 19 and the
+ *   idle IO class (optionally SCHED_IDLE) on Linux, or to background mode
+ *   (CPU, IO and memory priority) on Windows. Threads created afterwards
+ *   by the calling thread (e.g., ZED SDK workers on Linux) inherit it, so
+ *   call it before opening the camera. An unprivileged Linux process can
+ *   only raise its nice value back as far as RLIMIT_NICE allows, so the
+ *   restore is best effort there; prefer a dedicated worker thread.
+ * - BackgroundPriorityScope applies it for one job and also sends the job's
+ *   thread pool work (parallelFor, TaskGroup) to backgroundThreadPool(),
+ *   whose workers run at background priority too; both are undone when the
+ *   scope ends.
+ * - BackgroundThrottle caps processed frames/s and written bytes/s with
+ *   token buckets, and adds a duty-cycle pause that grows while the load
+ *   average or IO pressure (PSI) is high and shrinks once it settles.
+ */
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <string>
+#include <memory>
+#include "error_handler.hpp"
+#include "thread_pool.hpp"
+
+namespace zed_tools {
+
+/**
+ * @brief Background mode settings
+ */
+struct BackgroundPriorityConfig {
+    bool useSchedIdle = false;        ///< Linux: SCHED_IDLE (runs only on otherwise idle CPUs)
+    double maxFps = 0.0;              ///< Processed frames per second (0 = unlimited)
+    double maxWriteMBps = 0.0;        ///< Output bytes per second in MiB (0 = unlimited)
+    bool adaptive = true;             ///< Back off while the system is under pressure
+    // Thresholds include this process; they sit above what a lone extraction produces
+    double loadPerCoreThreshold = 1.5; ///< 1-minute load average per core
+    double ioPressureThreshold = 20.0; ///< PSI io "some" avg10 (% of time stalled)
+    double cpuBusyThreshold = 0.85;   ///< Windows: system CPU busy fraction (no PSI)
+};
+
+/**
+ * @brief A thread's scheduling settings before applyBackgroundPriority()
+ */
+struct ThreadPriorityState {
+    bool valid = false;
+    int nice = 0;                     ///< Linux
+    int ioPriority = -1;              ///< Linux ioprio value (-1 = unknown)
+    int schedPolicy = 0;              ///< Linux
+    int schedPriority = 0;            ///< Linux
+};
+
+/**
+ * @brief Lower the calling thread's CPU and IO priority
+ * @param previous Receives the settings to hand to restoreThreadPriority()
+ * @return Failure if no priority change could be applied (the run continues normally)
+ */
+ErrorResult applyBackgroundPriority(const BackgroundPriorityConfig& config,
+                                    ThreadPriorityState* previous = nullptr);
+
+/**
+ * @brief Undo applyBackgroundPriority() on the same thread (logs what could not be restored)
+ */
+void restoreThreadPriority(const ThreadPriorityState& previous);
+
+/**
+ * @brief Process-wide pool for work of background jobs; its workers run at background priority
+ *
+ * A quarter of the ThreadPool::global() budget (at least one worker), so a
+ * background job running next to foreground work adds only a few threads on
+ * top of the budget; created on first use.
+ */
+ThreadPool& backgroundThreadPool();
+
+/**
+ * @brief Background priority for the calling thread and its pool work, for one job
+ *
+ * Must be destroyed on the thread that created it.
+ */
+class BackgroundPriorityScope {
+public:
+    explicit BackgroundPriorityScope(const BackgroundPriorityConfig& config);
+
+    /**
+     * @brief Restores the thread's priority and its default pool
+     */
+    ~BackgroundPriorityScope();
+
+    BackgroundPriorityScope(const BackgroundPriorityScope&) = delete;
+    BackgroundPriorityScope& operator=(const BackgroundPriorityScope&) = delete;
+
+    /// Outcome of lowering the thread's priority
+    const ErrorResult& getResult() const { return result_; }
+
+private:
+    ThreadPriorityState previous_;
+    ErrorResult result_;
+};
+
+/**
+ * @brief Debt-based token bucket: acquire() always succeeds and sleeps off any deficit
+ */
+class TokenBucket {
+public:
+    /**
+     * @param ratePerSec Refill rate (<= 0 disables the bucket)
+     * @param burst Tokens that may accumulate while idle
+     */
+    TokenBucket(double ratePerSec = 0.0, double burst = 0.0);
+
+    /**
+     * @brief Take tokens, sleeping until the bucket is no longer in debt
+     * @param cancelled Polled during long sleeps; returning true ends the wait early
+     */
+    void acquire(double tokens, const std::function<bool()>& cancelled = nullptr);
+
+    bool isEnabled() const { return rate_ > 0.0; }
+
+private:
+    double rate_;
+    double burst_;
+    double tokens_;
+    std::chrono::steady_clock::time_point last_;
+};
+
+/**
+ * @brief Per-frame pacing for background mode
+ */
+class BackgroundThrottle {
+public:
+    /**
+     * @param priority Lowered priority held for as long as the throttle lives (optional)
+     */
+    explicit BackgroundThrottle(const BackgroundPriorityConfig& config,
+                                std::function<bool()> cancelled = nullptr,
+                                std::unique_ptr<BackgroundPriorityScope> priority = nullptr);
+
+    /**
+     * @brief Call once per processed frame before the work starts
+     *
+     * Sleeps for the frame-rate cap and, under pressure, for a share of the
+     * previous frame's work time so that only getDutyFactor() of wall time is busy.
+     */
+    void beforeFrame();
+
+    /**
+     * @brief Account bytes written (sleeps when over the write cap)
+     */
+    void onBytesWritten(uint64_t bytes);
+
+    /**
+     * @brief Account a file that was just written
+     */
+    void onFileWritten(const std::string& path);
+
+    /// Fraction of wall time allowed to work (1 = no back-off)
+    double getDutyFactor() const { return dutyFactor_; }
+
+private:
+    BackgroundPriorityConfig config_;
+    std::function<bool()> cancelled_;
+    std::unique_ptr<BackgroundPriorityScope> priority_;
+    TokenBucket frameBucket_;
+    TokenBucket byteBucket_;
+    double dutyFactor_ = 1.0;
+    bool haveResume_ = false;
+    std::chrono::steady_clock::time_point resumedAt_;
+    std::chrono::steady_clock::time_point lastSample_;
+    uint64_t prevIdle_ = 0;           ///< Windows CPU sampling state
+    uint64_t prevTotal_ = 0;
+
+    bool underPressure();
+    void sleepFor(double seconds);
+};
+
+} // namespace zed_tools
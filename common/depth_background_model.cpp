@@ -0,0 +1,87 @@
+/**
+ * @file depth_background_model.cpp
+ * @brief Implementation of the depth background model
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "depth_background_model.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace zed_extractor {
+
+DepthBackgroundModel::DepthBackgroundModel(const BackgroundModelConfig& config)
+    : config_(config)
+{
+}
+
+void DepthBackgroundModel::reset() {
+    size_ = cv::Size();
+    mean_.clear();
+    var_.clear();
+    updates_ = 0;
+}
+
+void DepthBackgroundModel::update(const cv::Mat& depth, cv::Mat& foregroundMask) {
+    CV_Assert(depth.type() == CV_32FC1);
+    if (depth.size() != size_) {
+        reset();
+        size_ = depth.size();
+        mean_.assign(static_cast<size_t>(size_.area()), 0.0f);
+        var_.assign(static_cast<size_t>(size_.area()), 0.0f);
+    }
+    foregroundMask.create(size_, CV_8UC1);
+
+    const float alpha = config_.alpha;
+    const float alphaFg = config_.alpha * config_.foregroundAlphaScale;
+    const float k2 = config_.kSigma * config_.kSigma;
+    const float minVar = config_.minSigma * config_.minSigma;
+    const float noise1m = config_.noiseAtOneMeter;
+    const bool report = isWarm();
+    const int cols = size_.width;
+    float* meanBase = mean_.data();
+    float* varBase = var_.data();
+
+    zed_tools::parallelFor(0, size_.height, [&](int rowBegin, int rowEnd) {
+        for (int y = rowBegin; y < rowEnd; ++y) {
+            const float* d = depth.ptr<float>(y);
+            float* m = meanBase + static_cast<size_t>(y) * cols;
+            float* v = varBase + static_cast<size_t>(y) * cols;
+            uchar* fg = foregroundMask.ptr<uchar>(y);
+            // Branch-free body: selects instead of ifs so the loop vectorizes
+            for (int x = 0; x < cols; ++x) {
+                float z = d[x];
+                bool valid = (z > 0.0f) && (z < 1e30f);           // rejects NaN, +inf and <= 0
+                float zs = valid ? z : 0.0f;
+                bool fresh = valid && (m[x] == 0.0f);
+                float mean = fresh ? zs : m[x];
+                float noise = noise1m * zs * zs;
+                float floorVar = std::max(minVar, noise * noise);
+                float var = fresh ? floorVar : v[x];
+                float diff = zs - mean;
+                bool isFg = valid && !fresh && (diff * diff > k2 * std::max(var, floorVar));
+                float a = valid ? (isFg ? alphaFg : alpha) : 0.0f;
+                float incr = a * diff;
+                m[x] = mean + incr;
+                v[x] = valid ? (1.0f - a) * (var + diff * incr) : v[x];
+                fg[x] = (report && isFg) ? 255 : 0;
+            }
+        }
+    }, 16);
+    ++updates_;
+}
+
+cv::Mat DepthBackgroundModel::getMeanMap() const {
+    if (mean_.empty()) return cv::Mat();
+    return cv::Mat(size_, CV_32FC1, const_cast<float*>(mean_.data())).clone();
+}
+
+cv::Mat DepthBackgroundModel::getVarianceMap() const {
+    if (var_.empty()) return cv::Mat();
+    return cv::Mat(size_, CV_32FC1, const_cast<float*>(var_.data())).clone();
+}
+
+} // namespace zed_extractor
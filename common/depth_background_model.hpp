@@ -0,0 +1,77 @@
+/**
+ * @file depth_background_model.hpp
+ * @brief Streaming per-pixel background model over depth frames
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace zed_extractor {
+
+/**
+ * @brief Background model parameters
+ */
+struct BackgroundModelConfig {
+    float alpha = 0.02f;              // Adaptation rate of the exponentially weighted mean/variance
+    float foregroundAlphaScale = 0.0f; // Alpha multiplier for pixels classified foreground (0 = do not absorb)
+    float kSigma = 3.0f;              // Foreground if |depth - mean| > kSigma * sigma
+    float minSigma = 0.05f;           // Noise floor in meters
+    float noiseAtOneMeter = 0.002f;   // Stereo noise grows ~z^2: sigma floor = max(minSigma, this * z^2)
+    int warmupFrames = 5;             // No foreground is reported before this many updates
+};
+
+/**
+ * @brief Per-pixel exponentially weighted Welford mean/variance of depth
+ *
+ * Mean and variance are kept in separate contiguous float planes (SoA) and
+ * updated row-parallel with branch-free inner loops that the compiler can
+ * vectorize. One update classifies and learns in a single pass over the frame.
+ * Invalid depth (<= 0, NaN, inf) neither updates the model nor becomes foreground.
+ */
+class DepthBackgroundModel {
+public:
+    explicit DepthBackgroundModel(const BackgroundModelConfig& config = BackgroundModelConfig());
+
+    /**
+     * @brief Forget all history (also happens automatically on a resolution change)
+     */
+    void reset();
+
+    /**
+     * @brief Classify a depth frame against the model, then learn from it
+     * @param depth CV_32FC1 depth in meters
+     * @param foregroundMask Output CV_8UC1 mask (255 = foreground)
+     */
+    void update(const cv::Mat& depth, cv::Mat& foregroundMask);
+
+    /**
+     * @brief Whether the warm-up period has passed
+     */
+    bool isWarm() const { return updates_ >= config_.warmupFrames; }
+
+    int getUpdateCount() const { return updates_; }
+    cv::Size getSize() const { return size_; }
+
+    /**
+     * @brief Copy of the per-pixel mean (CV_32FC1, 0 where never observed)
+     */
+    cv::Mat getMeanMap() const;
+
+    /**
+     * @brief Copy of the per-pixel variance (CV_32FC1, m^2)
+     */
+    cv::Mat getVarianceMap() const;
+
+private:
+    BackgroundModelConfig config_;
+    cv::Size size_;
+    std::vector<float> mean_;         // Row-major plane, 0 = uninitialized
+    std::vector<float> var_;          // Row-major plane
+    int updates_ = 0;
+};
+
+} // namespace zed_extractor
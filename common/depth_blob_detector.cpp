@@ -0,0 +1,91 @@
+/**
+ * @file depth_blob_detector.cpp
+ * @brief Implementation of the depth blob detector
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "depth_blob_detector.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <limits>
+
+namespace zed_extractor {
+
+DepthBlobDetector::DepthBlobDetector(const BlobDetectorConfig& config)
+    : config_(config)
+{
+    config_.downscale = std::max(1, config_.downscale);
+}
+
+void DepthBlobDetector::detect(const cv::Mat& depth, const cv::Mat& mask, std::vector<DepthDetection>& out) {
+    out.clear();
+    if (depth.empty() || depth.type() != CV_32FC1) return;
+    const bool useMask = !mask.empty() && mask.size() == depth.size() && mask.type() == CV_8UC1;
+
+    const int step = config_.downscale;
+    const int sw = depth.cols / step;
+    const int sh = depth.rows / step;
+    if (sw <= 0 || sh <= 0) return;
+    small_.create(sh, sw, CV_32FC1);
+    binary_.create(sh, sw, CV_8UC1);
+
+    // Strided subsample + range/mask threshold in one pass
+    const float lo = config_.minRange;
+    const float hi = config_.maxRange;
+    for (int y = 0; y < sh; ++y) {
+        const float* src = depth.ptr<float>(y * step);
+        const uchar* m = useMask ? mask.ptr<uchar>(y * step) : nullptr;
+        float* dst = small_.ptr<float>(y);
+        uchar* bin = binary_.ptr<uchar>(y);
+        for (int x = 0; x < sw; ++x) {
+            float z = src[x * step];
+            bool in = (z >= lo) && (z <= hi) && (!m || m[x * step] != 0);
+            dst[x] = z;
+            bin[x] = in ? 255 : 0;
+        }
+    }
+    cv::morphologyEx(binary_, binary_, cv::MORPH_OPEN, cv::Mat());
+
+    int n = cv::connectedComponentsWithStats(binary_, labels_, stats_, centroids_, 8, CV_32S);
+    if (n <= 1) return;
+
+    // Per-label depth mean/min in one pass over the labels
+    depthSum_.assign(n, 0.0);
+    depthMin_.assign(n, std::numeric_limits<float>::max());
+    for (int y = 0; y < sh; ++y) {
+        const int* lab = labels_.ptr<int>(y);
+        const float* z = small_.ptr<float>(y);
+        for (int x = 0; x < sw; ++x) {
+            int l = lab[x];
+            if (l == 0) continue;
+            depthSum_[l] += z[x];
+            depthMin_[l] = std::min(depthMin_[l], z[x]);
+        }
+    }
+
+    for (int l = 1; l < n; ++l) {
+        int area = stats_.at<int>(l, cv::CC_STAT_AREA);
+        if (area < config_.minPixels) continue;
+        DepthDetection d;
+        d.bbox = cv::Rect(stats_.at<int>(l, cv::CC_STAT_LEFT) * step,
+                          stats_.at<int>(l, cv::CC_STAT_TOP) * step,
+                          stats_.at<int>(l, cv::CC_STAT_WIDTH) * step,
+                          stats_.at<int>(l, cv::CC_STAT_HEIGHT) * step);
+        d.centroid = cv::Point2f(static_cast<float>(centroids_.at<double>(l, 0) * step),
+                                 static_cast<float>(centroids_.at<double>(l, 1) * step));
+        d.distance = static_cast<float>(depthSum_[l] / area);
+        d.minDistance = depthMin_[l];
+        d.pixels = area;
+        out.push_back(d);
+    }
+    std::sort(out.begin(), out.end(), [](const DepthDetection& a, const DepthDetection& b) {
+        return a.pixels > b.pixels;
+    });
+    if (static_cast<int>(out.size()) > config_.maxDetections) {
+        out.resize(config_.maxDetections);
+    }
+}
+
+} // namespace zed_extractor
@@ -0,0 +1,439 @@
+/**
+ * @file depth_colorizer.cpp
+ * @brief Implementation of heatmap rendering and lazy heatmap materialization
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "depth_colorizer.hpp"
+#include "image_io.hpp"
+#include "metadata.hpp"
+#include "thread_pool.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/imgcodecs.hpp>
+#include <opencv2/videoio.hpp>
+
+#include <algorithm>
+#include <atomic>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <mutex>
+#include <sstream>
+#include <thread>
+
+namespace fs = std::filesystem;
+
+namespace zed_extractor {
+
+int resolveColorMap(const std::string& name) {
+    std::string n = name;
+    std::transform(n.begin(), n.end(), n.begin(), ::tolower);
+#ifdef CV_COLORMAP_TURBO
+    if (n == "turbo") return CV_COLORMAP_TURBO;
+#endif
+    if (n == "viridis") return cv::COLORMAP_VIRIDIS;
+    if (n == "plasma") return cv::COLORMAP_PLASMA;
+    if (n == "jet") return cv::COLORMAP_JET;
+#ifdef CV_COLORMAP_TURBO
+    return CV_COLORMAP_TURBO;
+#else
+    return cv::COLORMAP_JET;
+#endif
+}
+
+cv::Mat applyDepthHeatmap(const cv::Mat& depthFloat,
+                          float minDepth,
+                          float maxDepth,
+                          bool autoContrast,
+                          const cv::Mat& confidence,
+                          int confidenceThreshold,
+                          bool logScale,
+                          bool useEdgeBoost,
+                          float edgeBoostFactor,
+                          bool useClahe,
+                          const std::string& colorMapName,
+                          double* outA,
+                          double* outB,
+                          const cv::Mat& excludeMask) {
+    cv::Mat heatmap;
+    cv::Mat normalized;
+    cv::Mat maskValidBase = (depthFloat >= minDepth) & (depthFloat <= maxDepth) & (depthFloat == depthFloat) & (depthFloat > 0);
+    // Masked pixels (e.g. ground/sky) count as invalid: no contrast statistics, drawn black
+    if (!excludeMask.empty() && excludeMask.size() == depthFloat.size()) {
+        maskValidBase.setTo(0, excludeMask);
+    }
+    cv::Mat maskValid = maskValidBase.clone();
+    if (!confidence.empty()) {
+        // ZED confidence: 0 = best, 100 = worst; keep pixels with confidence <= threshold
+        cv::Mat confMask = confidence <= confidenceThreshold;
+        maskValid = maskValid & confMask;
+        // Fallback: if too few valid pixels after confidence filtering, ignore confidence mask
+        int validCount = cv::countNonZero(maskValid);
+        int minValid = std::max(1000, (depthFloat.rows * depthFloat.cols) / 1000); // ~0.1% or 1000 px
+        if (validCount < minValid) {
+            maskValid = maskValidBase; // relax to base validity
+        }
+    }
+    // Extract valid depths into vector if autoContrast enabled
+    double a = minDepth;
+    double b = maxDepth;
+    if (autoContrast) {
+        std::vector<float> vals;
+        vals.reserve(depthFloat.rows * depthFloat.cols / 4);
+        for (int y = 0; y < depthFloat.rows; ++y) {
+            const float* row = depthFloat.ptr<float>(y);
+            const uchar* mrow = maskValid.ptr<uchar>(y);
+            for (int x = 0; x < depthFloat.cols; ++x) {
+                if (mrow[x]) vals.push_back(row[x]);
+            }
+        }
+        if (vals.size() > 100) { // need enough samples
+            auto nth_pct = [&](double pct) -> float {
+                size_t idx = static_cast<size_t>(pct * (vals.size() - 1));
+                std::nth_element(vals.begin(), vals.begin() + idx, vals.end());
+                return vals[idx];
+            };
+            float p2 = nth_pct(0.02);
+            float p98 = nth_pct(0.98);
+            if (p98 - p2 > 0.5f) { a = p2; b = p98; }
+        }
+    }
+    // Optionally report chosen bounds
+    if (outA) *outA = a;
+    if (outB) *outB = b;
+
+    // Scale (linear or log), invert (near-hot), and apply mask
+    cv::Mat scaled;
+    if (logScale) {
+        cv::Mat logd;
+        cv::log(depthFloat + 1e-3f, logd);
+        double logA = std::log(a + 1e-3);
+        double logB = std::log(b + 1e-3);
+        scaled = (logd - logA) / (logB - logA);
+    } else {
+        scaled = (depthFloat - a) / (b - a);
+    }
+    scaled.setTo(0, depthFloat < a);
+    scaled.setTo(1, depthFloat > b);
+    scaled = 1.0 - scaled;
+    scaled.setTo(0, ~maskValid);
+
+    // Optional edge boost on gradient magnitude
+    if (useEdgeBoost) {
+        cv::Mat gx, gy, grad;
+        cv::Sobel(depthFloat, gx, CV_32F, 1, 0, 3);
+        cv::Sobel(depthFloat, gy, CV_32F, 0, 1, 3);
+        cv::magnitude(gx, gy, grad);
+        cv::Mat gradNorm;
+        cv::normalize(grad, gradNorm, 0, 1, cv::NORM_MINMAX);
+        cv::Mat boosted = scaled + edgeBoostFactor * gradNorm;
+        cv::min(boosted, 1.0, scaled);
+        scaled.setTo(0, ~maskValid);
+    }
+
+    cv::Mat scaled8;
+    scaled.convertTo(scaled8, CV_8UC1, 255.0);
+
+    if (useClahe) {
+        cv::Ptr<cv::CLAHE> clahe = cv::createCLAHE(2.0, cv::Size(8,8));
+        clahe->apply(scaled8, scaled8);
+    }
+
+    int cmap = resolveColorMap(colorMapName);
+    cv::applyColorMap(scaled8, heatmap, cmap);
+    heatmap.setTo(cv::Scalar(0,0,0), ~maskValid);
+
+    return heatmap;
+}
+
+cv::Mat buildColorLegend(const std::string& colorMapName) {
+    cv::Mat grad(1, 256, CV_8UC1);
+    for (int x = 0; x < 256; ++x) grad.at<uchar>(0, x) = static_cast<uchar>(x);
+    cv::Mat bar, legend;
+    cv::applyColorMap(grad, bar, resolveColorMap(colorMapName));
+    cv::resize(bar, legend, cv::Size(256, 16), 0, 0, cv::INTER_NEAREST);
+    return legend;
+}
+
+// Helper: write PFM (Portable Float Map) grayscale from CV_32FC1
+bool writePFM(const std::string& path, const cv::Mat& depth)
+{
+    if (depth.empty() || depth.type() != CV_32FC1) return false;
+#ifdef _WIN32
+    FILE* f = nullptr;
+    fopen_s(&f, path.c_str(), "wb");
+#else
+    FILE* f = fopen(path.c_str(), "wb");
+#endif
+    if (!f) return false;
+    // PFM header: Pf (gray), width height, negative scale for little-endian
+    fprintf(f, "Pf\n%d %d\n-1.0\n", depth.cols, depth.rows);
+    size_t wrote = fwrite(depth.ptr<float>(0), sizeof(float), (size_t)depth.total(), f);
+    fclose(f);
+    return wrote == (size_t)depth.total();
+}
+
+// Helper: read PFM (Portable Float Map) grayscale into CV_32FC1
+cv::Mat readPFM(const std::string& path)
+{
+#ifdef _WIN32
+    FILE* f = nullptr;
+    fopen_s(&f, path.c_str(), "rb");
+#else
+    FILE* f = fopen(path.c_str(), "rb");
+#endif
+    if (!f) return cv::Mat();
+    char header[3] = {0};
+    if (fread(header, 1, 2, f) != 2) { fclose(f); return cv::Mat(); }
+    if (!(header[0] == 'P' && header[1] == 'f')) { fclose(f); return cv::Mat(); }
+    int width = 0, height = 0;
+    float scale = 0.0f;
+    if (fscanf(f, "%d %d\n", &width, &height) != 2) { fclose(f); return cv::Mat(); }
+    if (fscanf(f, "%f\n", &scale) != 1) { fclose(f); return cv::Mat(); }
+    // Negative scale indicates little-endian floats; absolute value is pixel scale (unused here)
+    size_t count = static_cast<size_t>(width) * static_cast<size_t>(height);
+    cv::Mat depth(height, width, CV_32FC1);
+    size_t read = fread(depth.ptr<float>(0), sizeof(float), count, f);
+    fclose(f);
+    if (read != count) return cv::Mat();
+    return depth;
+}
+
+cv::Mat readRawDepthFile(const std::string& path) {
+    const std::string ext = fs::path(path).extension().string();
+    if (ext == ".pfm") return readPFM(path);
+    cv::Mat m = cv::imread(path, cv::IMREAD_UNCHANGED);
+    if (m.empty() || m.channels() != 1) return cv::Mat();
+    if (m.type() == CV_32FC1) return m;
+    cv::Mat depth;
+    m.convertTo(depth, CV_32FC1);
+    return depth;
+}
+
+// ============================================================================
+// DepthVisualizationConfig
+// ============================================================================
+
+bool DepthVisualizationConfig::saveToJSON(const std::string& path) const {
+    zed_tools::JSONBuilder json;
+    json.beginObject();
+    json.addString("type", "depth_visualization");
+    json.addNumber("min_depth", static_cast<double>(minDepth));
+    json.addNumber("max_depth", static_cast<double>(maxDepth));
+    json.addBool("auto_contrast", autoContrast);
+    json.addNumber("confidence_threshold", confidenceThreshold);
+    json.addBool("log_scale", logScale);
+    json.addBool("edge_boost", useEdgeBoost);
+    json.addNumber("edge_boost_factor", static_cast<double>(edgeBoostFactor));
+    json.addBool("clahe", useClahe);
+    json.addString("color_map", colorMap);
+    json.addBool("overlay_on_rgb", overlayOnRgb);
+    json.addNumber("overlay_strength", overlayStrength);
+    json.addString("image_format", imageFormat);
+    json.addNumber("video_fps", static_cast<double>(videoFps));
+    json.endObject();
+
+    std::ofstream file(path);
+    if (!file.is_open()) return false;
+    file << json.toString();
+    return static_cast<bool>(file);
+}
+
+bool DepthVisualizationConfig::loadFromJSON(const std::string& path) {
+    std::ifstream file(path);
+    if (!file.is_open()) return false;
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    const std::string text = buffer.str();
+    if (text.find("\"depth_visualization\"") == std::string::npos) return false;
+
+    // Flat object written by saveToJSON: "key": value
+    auto raw = [&](const char* key, std::string& value) {
+        const std::string token = std::string("\"") + key + "\":";
+        size_t pos = text.find(token);
+        if (pos == std::string::npos) return false;
+        pos = text.find_first_not_of(" \t", pos + token.size());
+        if (pos == std::string::npos) return false;
+        if (text[pos] == '"') {
+            size_t end = text.find('"', pos + 1);
+            if (end == std::string::npos) return false;
+            value = text.substr(pos + 1, end - pos - 1);
+        } else {
+            size_t end = text.find_first_of(",\n}", pos);
+            value = text.substr(pos, end - pos);
+        }
+        return true;
+    };
+    std::string v;
+    if (raw("min_depth", v)) minDepth = std::stof(v);
+    if (raw("max_depth", v)) maxDepth = std::stof(v);
+    if (raw("auto_contrast", v)) autoContrast = (v == "true");
+    if (raw("confidence_threshold", v)) confidenceThreshold = std::stoi(v);
+    if (raw("log_scale", v)) logScale = (v == "true");
+    if (raw("edge_boost", v)) useEdgeBoost = (v == "true");
+    if (raw("edge_boost_factor", v)) edgeBoostFactor = std::stof(v);
+    if (raw("clahe", v)) useClahe = (v == "true");
+    if (raw("color_map", v)) colorMap = v;
+    if (raw("overlay_on_rgb", v)) overlayOnRgb = (v == "true");
+    if (raw("overlay_strength", v)) overlayStrength = std::stoi(v);
+    if (raw("image_format", v)) imageFormat = v;
+    if (raw("video_fps", v)) videoFps = std::stof(v);
+    return true;
+}
+
+// ============================================================================
+// LazyHeatmapRenderer
+// ============================================================================
+
+LazyHeatmapRenderer::LazyHeatmapRenderer(const std::string& extractionPath)
+    : root_(extractionPath)
+{
+}
+
+bool LazyHeatmapRenderer::open() {
+    const std::string path = root_ + "/depth_visualization.json";
+    if (!config_.loadFromJSON(path)) {
+        lastError_ = "No visualization config: " + path;
+        return false;
+    }
+    std::error_code ec;
+    fs::create_directories(root_ + "/depth_heatmaps", ec);
+    return true;
+}
+
+std::vector<int> LazyHeatmapRenderer::listFrames() const {
+    std::vector<int> frames;
+    std::error_code ec;
+    for (fs::directory_iterator it(root_ + "/depth_maps", ec), end; !ec && it != end; it.increment(ec)) {
+        const std::string name = it->path().stem().string();   // depth_NNNNNN
+        if (name.rfind("depth_", 0) != 0) continue;
+        try {
+            frames.push_back(std::stoi(name.substr(6)));
+        } catch (...) {}
+    }
+    std::sort(frames.begin(), frames.end());
+    frames.erase(std::unique(frames.begin(), frames.end()), frames.end());
+    return frames;
+}
+
+std::string LazyHeatmapRenderer::stem(const char* dir, const char* prefix, int outputIndex) const {
+    std::ostringstream p;
+    p << root_ << "/" << dir << "/" << prefix << std::setw(6) << std::setfill('0') << outputIndex;
+    return p.str();
+}
+
+cv::Mat LazyHeatmapRenderer::render(int outputIndex) const {
+    cv::Mat depth;
+    const std::string depthStem = stem("depth_maps", "depth_", outputIndex);
+    for (const char* ext : {".tiff", ".pfm", ".exr"}) {
+        if (fs::exists(depthStem + ext)) {
+            depth = readRawDepthFile(depthStem + ext);
+            break;
+        }
+    }
+    if (depth.empty()) return cv::Mat();
+
+    // Stored confidence is 8-bit with a fixed scale; map back to the 0-100 scale
+    cv::Mat confidence;
+    const std::string confPath = zed_tools::findImageFile(stem("confidence_maps", "conf_", outputIndex));
+    if (!confPath.empty()) {
+        cv::Mat conf8 = zed_tools::readImageFile(confPath, cv::IMREAD_GRAYSCALE);
+        if (!conf8.empty() && conf8.size() == depth.size()) conf8.convertTo(confidence, CV_32F, 1.0 / kStoredConfidenceScale);
+    }
+
+    const DepthVisualizationConfig& c = config_;
+    cv::Mat heatmap = applyDepthHeatmap(depth, c.minDepth, c.maxDepth, c.autoContrast, confidence,
+                                        c.confidenceThreshold, c.logScale, c.useEdgeBoost,
+                                        c.edgeBoostFactor, c.useClahe, c.colorMap);
+    if (c.overlayOnRgb) {
+        const std::string rgbPath = zed_tools::findImageFile(stem("left_rgb", "left_", outputIndex));
+        cv::Mat rgb = rgbPath.empty() ? cv::Mat() : zed_tools::readImageFile(rgbPath, cv::IMREAD_COLOR);
+        if (!rgb.empty() && rgb.size() == heatmap.size()) {
+            double alpha = c.overlayStrength / 100.0;
+            cv::Mat blended;
+            cv::addWeighted(heatmap, alpha, rgb, 1.0 - alpha, 0.0, blended);
+            heatmap = blended;
+        }
+    }
+    return heatmap;
+}
+
+std::string LazyHeatmapRenderer::getHeatmapPath(int outputIndex) {
+    const std::string heatmapStem = stem("depth_heatmaps", "heatmap_", outputIndex);
+    std::string existing = zed_tools::findImageFile(heatmapStem);
+    if (!existing.empty()) return existing;
+
+    cv::Mat heatmap = render(outputIndex);
+    if (heatmap.empty()) return "";
+
+    // Write under a per-thread name, then rename into place
+    const std::string ext = zed_tools::imageExtension(config_.imageFormat);
+    const std::string finalPath = heatmapStem + ext;
+    std::ostringstream partial;
+    partial << heatmapStem << ".partial" << std::hash<std::thread::id>()(std::this_thread::get_id()) << ext;
+    if (!zed_tools::writeImageFile(partial.str(), heatmap)) return "";
+    std::error_code ec;
+    fs::rename(partial.str(), finalPath, ec);
+    if (ec) {
+        fs::remove(partial.str(), ec);
+        return zed_tools::findImageFile(heatmapStem);
+    }
+    return finalPath;
+}
+
+cv::Mat LazyHeatmapRenderer::getHeatmap(int outputIndex) {
+    const std::string path = getHeatmapPath(outputIndex);
+    return path.empty() ? cv::Mat() : zed_tools::readImageFile(path, cv::IMREAD_COLOR);
+}
+
+int LazyHeatmapRenderer::materializeAll(const std::function<bool(int, int)>& progress) {
+    const std::vector<int> frames = listFrames();
+    const int total = static_cast<int>(frames.size());
+    std::atomic<int> done{0};
+    std::atomic<int> rendered{0};
+    std::atomic<bool> stop{false};
+    std::mutex progressMutex;   // progress is called from pool threads, one at a time
+    zed_tools::parallelFor(0, total, [&](int begin, int end) {
+        for (int i = begin; i < end && !stop; ++i) {
+            const std::string heatmapStem = stem("depth_heatmaps", "heatmap_", frames[i]);
+            if (zed_tools::findImageFile(heatmapStem).empty() && !getHeatmapPath(frames[i]).empty()) ++rendered;
+            const int n = ++done;
+            if (progress) {
+                std::lock_guard<std::mutex> lock(progressMutex);
+                if (!progress(n, total)) stop = true;
+            }
+        }
+    });
+    return rendered.load();
+}
+
+bool LazyHeatmapRenderer::renderVideo(const std::string& outputPath) {
+    const std::string path = outputPath.empty() ? root_ + "/depth_heatmap.avi" : outputPath;
+    cv::VideoWriter writer;
+    for (int index : listFrames()) {
+        cv::Mat frame = getHeatmap(index);
+        if (frame.empty()) continue;
+        if (!writer.isOpened()) {
+            writer.open(path, cv::VideoWriter::fourcc('M', 'J', 'P', 'G'),
+                        std::max(1.0, static_cast<double>(config_.videoFps)), frame.size(), true);
+            if (!writer.isOpened()) {
+                lastError_ = "Failed to open video writer: " + path;
+                return false;
+            }
+        }
+        writer.write(frame);
+    }
+    if (!writer.isOpened()) {
+        lastError_ = "No frames with raw depth";
+        return false;
+    }
+    writer.release();
+    return true;
+}
+
+} // namespace zed_extractor
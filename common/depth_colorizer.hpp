@@ -0,0 +1,164 @@
+/**
+ * @file depth_colorizer.hpp
+ * @brief Depth heatmap rendering and on-demand (lazy) heatmaps from stored raw depth
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ *
+ * The heatmap renderer used during extraction lives here so that the same
+ * images can be produced later from raw depth on disk. In lazy mode an
+ * extraction writes raw depth (plus optional confidence and RGB) and a
+ * depth_visualization.json; LazyHeatmapRenderer then renders heatmaps,
+ * overlays and the heatmap video on first access and keeps them on disk.
+ *
+ * Per-frame state (temporal smoothing, motion highlight, track boxes) is not
+ * reproduced by lazy rendering.
+ */
+
+#pragma once
+
+#include <functional>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace zed_extractor {
+
+/// Stored confidence maps are 8-bit with a fixed scale (ZED 0-100 -> 0-255) so any frame can be read back
+constexpr double kStoredConfidenceScale = 255.0 / 100.0;
+
+/**
+ * @brief Resolve a colormap name (turbo, viridis, plasma, jet) to an OpenCV colormap
+ */
+int resolveColorMap(const std::string& name);
+
+/**
+ * @brief Colorize a CV_32FC1 depth map (near = hot, invalid = black)
+ * @param confidence Optional ZED confidence (0 best .. 100 worst); pixels above the threshold are invalid
+ * @param outA,outB Receive the depth range actually used (after auto contrast)
+ * @param excludeMask Optional CV_8UC1 mask of pixels drawn black and left out of statistics
+ */
+cv::Mat applyDepthHeatmap(const cv::Mat& depthFloat,
+                          float minDepth,
+                          float maxDepth,
+                          bool autoContrast,
+                          const cv::Mat& confidence,
+                          int confidenceThreshold,
+                          bool logScale,
+                          bool useEdgeBoost,
+                          float edgeBoostFactor,
+                          bool useClahe,
+                          const std::string& colorMapName,
+                          double* outA = nullptr,
+                          double* outB = nullptr,
+                          const cv::Mat& excludeMask = cv::Mat());
+
+/**
+ * @brief 256x16 BGR colorbar of a colormap (near on the right, as in the heatmaps)
+ */
+cv::Mat buildColorLegend(const std::string& colorMapName);
+
+/**
+ * @brief Write / read a Portable Float Map (grayscale, little-endian)
+ */
+bool writePFM(const std::string& path, const cv::Mat& depth);
+cv::Mat readPFM(const std::string& path);
+
+/**
+ * @brief Read a stored raw depth file (.tiff, .exr, .pfm) as CV_32FC1 (empty on failure)
+ */
+cv::Mat readRawDepthFile(const std::string& path);
+
+/**
+ * @brief Everything needed to render a heatmap from stored raw depth
+ */
+struct DepthVisualizationConfig {
+    float minDepth = 10.0f;
+    float maxDepth = 40.0f;
+    bool autoContrast = true;
+    int confidenceThreshold = 60;
+    bool logScale = false;
+    bool useEdgeBoost = false;
+    float edgeBoostFactor = 0.7f;
+    bool useClahe = false;
+    std::string colorMap = "turbo";
+    bool overlayOnRgb = false;        // Needs the left_rgb cache
+    int overlayStrength = 100;        // 0 = only RGB, 100 = only heatmap
+    std::string imageFormat = "png";  // Format of materialized heatmaps (png, qoi)
+    float videoFps = 1.0f;            // Heatmap video rate (the extraction output FPS)
+
+    /**
+     * @brief Save as JSON (depth_visualization.json in the extraction folder)
+     */
+    bool saveToJSON(const std::string& path) const;
+
+    /**
+     * @brief Load from JSON; missing keys keep their defaults
+     */
+    bool loadFromJSON(const std::string& path);
+};
+
+/**
+ * @brief Renders heatmaps of a lazy extraction on first access and memoizes them to disk
+ *
+ * Thread-safe: concurrent requests for the same frame may both render it, but
+ * files are replaced atomically, so readers never see a partial image.
+ *
+ * Example usage:
+ * @code
+ * LazyHeatmapRenderer renderer("E:/out/depth_analysis/flight_x/extraction_001");
+ * if (renderer.open()) {
+ *     std::string path = renderer.getHeatmapPath(42);   // renders heatmap_000042 if missing
+ * }
+ * @endcode
+ */
+class LazyHeatmapRenderer {
+public:
+    explicit LazyHeatmapRenderer(const std::string& extractionPath);
+
+    /**
+     * @brief Load depth_visualization.json
+     * @return false if the folder is not a lazy extraction
+     */
+    bool open();
+
+    /**
+     * @brief Output indices that have raw depth (sorted)
+     */
+    std::vector<int> listFrames() const;
+
+    /**
+     * @brief Path of the heatmap for an output index, rendering it if needed
+     * @return Empty string if the raw depth is missing or unreadable
+     */
+    std::string getHeatmapPath(int outputIndex);
+
+    /**
+     * @brief Heatmap image for an output index (memoized like getHeatmapPath)
+     */
+    cv::Mat getHeatmap(int outputIndex);
+
+    /**
+     * @brief Render every missing heatmap on the shared thread pool
+     * @param progress Called with (done, total) from pool threads, never concurrently; return false to stop
+     * @return Number of heatmaps rendered (existing ones are skipped)
+     */
+    int materializeAll(const std::function<bool(int, int)>& progress = nullptr);
+
+    /**
+     * @brief Write depth_heatmap.avi (MJPEG) from all frames, materializing as needed
+     */
+    bool renderVideo(const std::string& outputPath = "");
+
+    const DepthVisualizationConfig& getConfig() const { return config_; }
+    std::string getLastError() const { return lastError_; }
+
+private:
+    std::string root_;
+    DepthVisualizationConfig config_;
+    std::string lastError_;
+
+    std::string stem(const char* dir, const char* prefix, int outputIndex) const;
+    cv::Mat render(int outputIndex) const;
+};
+
+} // namespace zed_extractor
@@ -0,0 +1,342 @@
+/**
+ * @file depth_mode_profiler.cpp
+ * @brief Implementation of the depth-mode profiler and its synthetic stand-in source
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "depth_mode_profiler.hpp"
+#include "error_handler.hpp"
+#include "metadata.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace zed_extractor {
+
+using namespace zed_tools;
+
+namespace {
+
+std::string formatRoi(const cv::Rect& roi) {
+    if (roi.area() <= 0) return "";
+    std::ostringstream oss;
+    oss << roi.x << "," << roi.y << "," << roi.width << "," << roi.height;
+    return oss.str();
+}
+
+} // namespace
+
+// ============================================================================
+// DepthModeProfiler
+// ============================================================================
+
+DepthModeProfiler::DepthModeProfiler(const DepthModeProfileConfig& config)
+    : config_(config)
+{
+}
+
+DepthModeProfile DepthModeProfiler::profileMode(DepthFrameSource& source, const std::string& mode) const {
+    DepthModeProfile profile;
+    profile.mode = mode;
+    std::string error;
+    if (!source.open(mode, error)) {
+        profile.error = error.empty() ? "failed to open source" : error;
+        return profile;
+    }
+
+    const float roiMax = (config_.roiMaxDepth > 0.0f) ? config_.roiMaxDepth : config_.maxDepth;
+    std::vector<double> times;
+    cv::Mat sum, sumSq, count, staticAll, prevGray;
+    double validSum = 0.0, roiSum = 0.0;
+    int roiFrames = 0;
+    int index = 0;
+
+    DepthSample sample;
+    while (source.next(sample)) {
+        const bool warm = (index++ >= config_.warmupFrames);
+        if (!warm || sample.depth.empty() || sample.depth.type() != CV_32FC1) {
+            if (!sample.gray.empty()) prevGray = sample.gray.clone();
+            continue;
+        }
+        const cv::Mat& depth = sample.depth;
+        if (sum.empty() || sum.size() != depth.size()) {
+            sum = cv::Mat::zeros(depth.size(), CV_64FC1);
+            sumSq = cv::Mat::zeros(depth.size(), CV_64FC1);
+            count = cv::Mat::zeros(depth.size(), CV_32SC1);
+            staticAll = cv::Mat(depth.size(), CV_8UC1, cv::Scalar(255));
+            prevGray.release();
+        }
+
+        // NaN and inf fail both comparisons
+        cv::Mat valid = (depth >= config_.minDepth) & (depth <= config_.maxDepth);
+        validSum += static_cast<double>(cv::countNonZero(valid)) / depth.total();
+
+        // Per-pixel temporal moments for the noise estimate
+        cv::Mat d64;
+        depth.convertTo(d64, CV_64FC1);
+        d64.setTo(0.0, ~valid);
+        sum += d64;
+        sumSq += d64.mul(d64);
+        cv::Mat one;
+        valid.convertTo(one, CV_32SC1, 1.0 / 255.0);
+        count += one;
+
+        // Static = image unchanged since the previous frame (camera and scene still)
+        if (!sample.gray.empty() && sample.gray.size() == depth.size()) {
+            if (!prevGray.empty() && prevGray.size() == depth.size()) {
+                cv::Mat diff;
+                cv::absdiff(sample.gray, prevGray, diff);
+                staticAll &= (diff <= config_.staticThreshold);
+            }
+            prevGray = sample.gray.clone();
+        } else {
+            staticAll.setTo(0);   // No image, no static regions
+        }
+
+        const cv::Rect roi = config_.roi & cv::Rect(0, 0, depth.cols, depth.rows);
+        if (roi.area() > 0) {
+            cv::Mat r = depth(roi);
+            cv::Mat object = (r >= config_.minDepth) & (r <= roiMax);
+            roiSum += static_cast<double>(cv::countNonZero(object)) / roi.area();
+            ++roiFrames;
+        }
+
+        times.push_back(sample.processMs);
+    }
+    source.close();
+
+    profile.frames = static_cast<int>(times.size());
+    if (profile.frames == 0) {
+        profile.error = "no frames after warm-up";
+        return profile;
+    }
+
+    double total = 0.0;
+    for (double t : times) total += t;
+    profile.meanMs = total / times.size();
+    std::sort(times.begin(), times.end());
+    profile.p95Ms = times[std::min(times.size() - 1, static_cast<size_t>(std::ceil(0.95 * times.size())) - 1)];
+    profile.validFraction = static_cast<float>(validSum / profile.frames);
+    if (roiFrames > 0) profile.roiCoverage = static_cast<float>(roiSum / roiFrames);
+
+    // Median relative temporal std over pixels that were static and mostly valid throughout
+    const int minCount = std::max(3, static_cast<int>(profile.frames * 0.8));
+    std::vector<float> rel;
+    for (int y = 0; y < sum.rows; ++y) {
+        const double* s = sum.ptr<double>(y);
+        const double* s2 = sumSq.ptr<double>(y);
+        const int* n = count.ptr<int>(y);
+        const uchar* st = staticAll.ptr<uchar>(y);
+        for (int x = 0; x < sum.cols; ++x) {
+            if (!st[x] || n[x] < minCount) continue;
+            double mean = s[x] / n[x];
+            double var = std::max(0.0, s2[x] / n[x] - mean * mean);
+            rel.push_back(static_cast<float>(std::sqrt(var) / mean));
+        }
+    }
+    profile.staticFraction = static_cast<float>(cv::countNonZero(staticAll)) / staticAll.total();
+    if (rel.size() >= std::max<size_t>(100, sum.total() / 100)) {
+        auto mid = rel.begin() + rel.size() / 2;
+        std::nth_element(rel.begin(), mid, rel.end());
+        profile.noisePct = *mid * 100.0f;
+    }
+
+    profile.meetsRequirements =
+        (config_.minValidFraction <= 0.0f || profile.validFraction >= config_.minValidFraction) &&
+        (config_.minRoiCoverage <= 0.0f || profile.roiCoverage >= config_.minRoiCoverage) &&
+        (config_.maxNoisePct <= 0.0f || (profile.noisePct >= 0.0f && profile.noisePct <= config_.maxNoisePct));
+    return profile;
+}
+
+DepthModeReport DepthModeProfiler::run(DepthFrameSource& source) const {
+    DepthModeReport report;
+    for (const auto& mode : config_.modes) {
+        LOG_INFO("Profiling depth mode " + mode + "...");
+        DepthModeProfile profile = profileMode(source, mode);
+        if (!profile.error.empty()) {
+            LOG_WARNING("Depth mode " + mode + " failed: " + profile.error);
+        }
+        report.profiles.push_back(profile);
+    }
+
+    const DepthModeProfile* best = nullptr;
+    for (const auto& p : report.profiles) {
+        if (p.meetsRequirements && (!best || p.meanMs < best->meanMs)) best = &p;
+    }
+    const bool anyRequirement = config_.minValidFraction > 0.0f || config_.minRoiCoverage > 0.0f ||
+                                config_.maxNoisePct > 0.0f;
+    if (best) {
+        report.recommended = best->mode;
+        std::ostringstream reason;
+        reason << std::fixed << std::setprecision(1)
+               << (anyRequirement ? "cheapest mode meeting the requirements"
+                                  : "cheapest mode (no requirements given)")
+               << " at " << best->meanMs << " ms/frame";
+        for (const auto& p : report.profiles) {
+            if (p.mode == "NEURAL" && p.error.empty() && p.meanMs > best->meanMs && best->meanMs > 0.0) {
+                reason << " (" << (p.meanMs / best->meanMs) << "x faster than NEURAL)";
+            }
+        }
+        report.reason = reason.str();
+    } else {
+        report.reason = "no mode meets the requirements; relax them or choose from the table";
+    }
+    return report;
+}
+
+std::string DepthModeProfiler::formatTable(const DepthModeReport& report) const {
+    std::ostringstream out;
+    out << std::left << std::setw(13) << "Mode" << std::right
+        << std::setw(10) << "ms/frame" << std::setw(9) << "p95 ms" << std::setw(8) << "FPS"
+        << std::setw(9) << "Valid%" << std::setw(9) << "Noise%" << std::setw(9) << "ROI%"
+        << "  Meets\n";
+    out << std::string(78, '-') << "\n";
+    out << std::fixed;
+    for (const auto& p : report.profiles) {
+        out << std::left << std::setw(13) << p.mode << std::right;
+        if (!p.error.empty()) {
+            out << "  error: " << p.error << "\n";
+            continue;
+        }
+        out << std::setprecision(1) << std::setw(10) << p.meanMs << std::setw(9) << p.p95Ms
+            << std::setw(8) << (p.meanMs > 0.0 ? 1000.0 / p.meanMs : 0.0)
+            << std::setw(9) << p.validFraction * 100.0f;
+        out << std::setprecision(2) << std::setw(9);
+        if (p.noisePct >= 0.0f) out << p.noisePct; else out << "n/a";
+        out << std::setprecision(1) << std::setw(9);
+        if (p.roiCoverage >= 0.0f) out << p.roiCoverage * 100.0f; else out << "-";
+        out << "  " << (p.meetsRequirements ? "yes" : "no") << (p.mode == report.recommended ? "  <==" : "")
+            << "\n";
+    }
+    out << "\nRecommended: " << (report.recommended.empty() ? "none" : report.recommended)
+        << " - " << report.reason << "\n";
+    return out.str();
+}
+
+std::string DepthModeProfiler::toJson(const DepthModeReport& report, const std::string& sourceName) const {
+    JSONBuilder json;
+    json.beginObject();
+    json.addString("type", "depth_mode_profile");
+    json.addString("created", getCurrentDateTime());
+    json.addString("source", sourceName);
+    json.addNumber("warmup_frames", config_.warmupFrames);
+    json.addNumber("min_depth_m", static_cast<double>(config_.minDepth));
+    json.addNumber("max_depth_m", static_cast<double>(config_.maxDepth));
+    json.addString("roi", formatRoi(config_.roi));
+    json.addNumber("roi_max_depth_m", static_cast<double>(config_.roiMaxDepth));
+    json.addNumber("req_min_valid_fraction", static_cast<double>(config_.minValidFraction));
+    json.addNumber("req_min_roi_coverage", static_cast<double>(config_.minRoiCoverage));
+    json.addNumber("req_max_noise_pct", static_cast<double>(config_.maxNoisePct));
+    json.beginArray("modes");
+    for (const auto& p : report.profiles) {
+        json.beginObject();
+        json.addString("mode", p.mode);
+        if (!p.error.empty()) {
+            json.addString("error", p.error);
+        } else {
+            json.addNumber("frames", p.frames);
+            json.addNumber("mean_ms", p.meanMs);
+            json.addNumber("p95_ms", p.p95Ms);
+            json.addNumber("valid_fraction", static_cast<double>(p.validFraction));
+            json.addNumber("noise_pct", static_cast<double>(p.noisePct));
+            json.addNumber("static_fraction", static_cast<double>(p.staticFraction));
+            json.addNumber("roi_coverage", static_cast<double>(p.roiCoverage));
+        }
+        json.addBool("meets_requirements", p.meetsRequirements);
+        json.endObject();
+    }
+    json.endArray();
+    json.addString("recommended", report.recommended);
+    json.addString("reason", report.reason);
+    json.endObject();
+    return json.toString();
+}
+
+// ============================================================================
+// SyntheticDepthSource
+// ============================================================================
+
+SyntheticDepthSource::SyntheticDepthSource(int frames, cv::Size size)
+    : frames_(frames)
+    , size_(size)
+{
+    const int W = size_.width, H = size_.height;
+    const int horizon = H / 2;
+    const float fy = W * 0.8f;
+
+    // Wall at 25 m above the horizon, ground plane (camera 1.5 m high) below it
+    truth_.create(size_, CV_32FC1);
+    for (int y = 0; y < H; ++y) {
+        float z = (y <= horizon) ? 25.0f : std::min(25.0f, 1.5f * fy / (y - horizon));
+        truth_.row(y).setTo(z);
+    }
+    texture_.create(size_, CV_8UC1);
+    cv::RNG rng(12345);
+    rng.fill(texture_, cv::RNG::UNIFORM, 0, 256);
+}
+
+cv::Rect SyntheticDepthSource::getPoleRoi() const {
+    return cv::Rect(size_.width * 3 / 5, size_.height / 5, 3, size_.height * 3 / 5);
+}
+
+bool SyntheticDepthSource::open(const std::string& mode, std::string& error) {
+    // Relative ordering follows the real modes: cost up, noise/holes down, thin structures kept
+    if (mode == "PERFORMANCE")      model_ = {8.0, 0.030f, 0.12f, 0.15f};
+    else if (mode == "QUALITY")     model_ = {14.0, 0.020f, 0.08f, 0.35f};
+    else if (mode == "ULTRA")       model_ = {25.0, 0.012f, 0.05f, 0.60f};
+    else if (mode == "NEURAL")      model_ = {45.0, 0.006f, 0.02f, 0.85f};
+    else if (mode == "NEURAL_PLUS") model_ = {90.0, 0.004f, 0.01f, 0.95f};
+    else {
+        error = "unknown depth mode: " + mode;
+        return false;
+    }
+    seed_ = static_cast<unsigned>(std::hash<std::string>()(mode));
+    frame_ = 0;
+    return true;
+}
+
+bool SyntheticDepthSource::next(DepthSample& sample) {
+    if (frame_ >= frames_) return false;
+    cv::RNG rng(seed_ + static_cast<unsigned>(frame_) * 7919u);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+
+    cv::Mat depth = truth_.clone();
+    cv::Mat gray = texture_.clone();
+
+    // Thin pole: resolved pixels keep its depth, the rest are smoothed into the wall
+    const cv::Rect pole = getPoleRoi();
+    for (int y = pole.y; y < pole.y + pole.height; ++y) {
+        float* d = depth.ptr<float>(y);
+        for (int x = pole.x; x < pole.x + pole.width; ++x) {
+            if (rng.uniform(0.0f, 1.0f) < model_.poleSurvival) d[x] = kPoleDepth;
+        }
+    }
+
+    // Moving box: non-static region
+    const int box = std::min(60, size_.height / 4);
+    cv::Rect moving((frame_ * 8) % std::max(1, size_.width / 2 - box), size_.height * 3 / 5, box, box);
+    moving &= cv::Rect(0, 0, size_.width, size_.height);
+    depth(moving).setTo(5.0f);
+    gray(moving).setTo(240);
+
+    cv::Mat noise(size_, CV_32FC1);
+    rng.fill(noise, cv::RNG::NORMAL, 0.0, model_.noise);
+    depth = depth.mul(1.0f + noise);
+
+    cv::Mat dropout(size_, CV_32FC1);
+    rng.fill(dropout, cv::RNG::UNIFORM, 0.0, 1.0);
+    depth.setTo(nan, dropout < model_.holes);
+
+    sample.depth = depth;
+    sample.gray = gray;
+    sample.processMs = model_.ms * (1.0 + 0.05 * rng.gaussian(1.0));
+    ++frame_;
+    return true;
+}
+
+} // namespace zed_extractor
@@ -0,0 +1,161 @@
+/**
+ * @file depth_mode_profiler.hpp
+ * @brief Throughput/quality comparison of ZED depth modes on a sampled segment
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace zed_extractor {
+
+/**
+ * @brief One frame from a depth source
+ */
+struct DepthSample {
+    cv::Mat depth;                    // CV_32FC1 meters; NaN/inf/<= 0 = no measurement
+    cv::Mat gray;                     // CV_8UC1 left image (static-region detection)
+    double processMs = 0.0;           // grab + depth retrieval time of this frame
+};
+
+/**
+ * @brief Replays the same segment once per depth mode
+ *
+ * The SVO implementation lives in the profiler app (it needs the ZED SDK);
+ * SyntheticDepthSource is an SDK-free stand-in with known ground truth.
+ */
+class DepthFrameSource {
+public:
+    virtual ~DepthFrameSource() = default;
+
+    /**
+     * @brief (Re)start the segment with the given depth mode
+     * @param mode PERFORMANCE, QUALITY, ULTRA, NEURAL or NEURAL_PLUS
+     */
+    virtual bool open(const std::string& mode, std::string& error) = 0;
+
+    /**
+     * @brief Next frame of the segment
+     * @return false at the end of the segment
+     */
+    virtual bool next(DepthSample& sample) = 0;
+
+    virtual void close() = 0;
+};
+
+/**
+ * @brief Profiling parameters and the detection requirements a mode must meet
+ */
+struct DepthModeProfileConfig {
+    std::vector<std::string> modes{"PERFORMANCE", "QUALITY", "ULTRA", "NEURAL", "NEURAL_PLUS"};
+    int warmupFrames = 3;             // Frames excluded from timing/quality (model warm-up, stabilization)
+    float minDepth = 0.3f;            // Valid depth range (meters)
+    float maxDepth = 40.0f;
+    int staticThreshold = 6;          // Max gray-level change for a pixel to count as static
+    cv::Rect roi;                     // Thin-object region (empty = not measured)
+    float roiMaxDepth = 0.0f;         // Only ROI pixels closer than this count as object (0 = maxDepth)
+    // Requirements (0 = not required)
+    float minValidFraction = 0.0f;    // Valid pixels / all pixels
+    float minRoiCoverage = 0.0f;      // Object pixels / ROI pixels
+    float maxNoisePct = 0.0f;         // Median temporal std / mean on static pixels, in percent
+};
+
+/**
+ * @brief Measurements of one depth mode
+ */
+struct DepthModeProfile {
+    std::string mode;
+    int frames = 0;                   // Frames measured (after warm-up)
+    double meanMs = 0.0;              // grab + depth per frame
+    double p95Ms = 0.0;
+    float validFraction = 0.0f;
+    float noisePct = -1.0f;           // -1 = too few static pixels to measure
+    float staticFraction = 0.0f;      // Pixels that stayed static over the segment
+    float roiCoverage = -1.0f;        // -1 = no ROI
+    bool meetsRequirements = false;
+    std::string error;                // Non-empty if the mode could not be run
+};
+
+/**
+ * @brief Result of a profiling run
+ */
+struct DepthModeReport {
+    std::vector<DepthModeProfile> profiles;
+    std::string recommended;          // Cheapest mode meeting the requirements (empty = none)
+    std::string reason;
+};
+
+/**
+ * @brief Runs every configured mode through a source and recommends one
+ */
+class DepthModeProfiler {
+public:
+    explicit DepthModeProfiler(const DepthModeProfileConfig& config = DepthModeProfileConfig());
+
+    /**
+     * @brief Profile one mode over the source's segment
+     */
+    DepthModeProfile profileMode(DepthFrameSource& source, const std::string& mode) const;
+
+    /**
+     * @brief Profile all configured modes and pick the cheapest one that meets the requirements
+     */
+    DepthModeReport run(DepthFrameSource& source) const;
+
+    /**
+     * @brief Fixed-width recommendation table
+     */
+    std::string formatTable(const DepthModeReport& report) const;
+
+    /**
+     * @brief Report and configuration as JSON
+     */
+    std::string toJson(const DepthModeReport& report, const std::string& sourceName) const;
+
+private:
+    DepthModeProfileConfig config_;
+};
+
+/**
+ * @brief Deterministic stand-in: static scene, a moving box and a thin pole
+ *
+ * Each mode gets its own cost, relative noise, hole rate and probability of
+ * resolving the pole, ordered like the real modes, so the profiler's metrics
+ * and recommendation can be checked without an SVO or a GPU.
+ */
+class SyntheticDepthSource : public DepthFrameSource {
+public:
+    SyntheticDepthSource(int frames = 30, cv::Size size = cv::Size(640, 360));
+
+    bool open(const std::string& mode, std::string& error) override;
+    bool next(DepthSample& sample) override;
+    void close() override {}
+
+    /// Tight box around the pole, for DepthModeProfileConfig::roi
+    cv::Rect getPoleRoi() const;
+
+    static constexpr float kPoleDepth = 8.0f;
+
+private:
+    struct ModeModel {
+        double ms;
+        float noise;                  // Relative 1-sigma
+        float holes;                  // Fraction of dropped pixels
+        float poleSurvival;           // Fraction of pole pixels resolved
+    };
+
+    int frames_;
+    cv::Size size_;
+    int frame_ = 0;
+    ModeModel model_{};
+    unsigned seed_ = 0;
+    cv::Mat truth_;                   // Static scene depth
+    cv::Mat texture_;                 // Static scene image
+};
+
+} // namespace zed_extractor
@@ -144,6 +144,11 @@ LogLevel Logger::getMinLevel() const {
     return minLevel_;
 }
 
+void Logger::setConsoleToStderr(bool useStderr) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    consoleToStderr_ = useStderr;
+}
+
 bool Logger::isInitialized() const {
     std::lock_guard<std::mutex> lock(mutex_);
     return initialized_;
@@ -223,7 +228,7 @@ std::string Logger::formatMessage(
 void Logger::writeToConsole(const std::string& formattedMessage, LogLevel level) const {
 #ifdef ENABLE_COLOR_OUTPUT
     // Windows console color support
-    HANDLE hConsole = GetStdHandle(STD_OUTPUT_HANDLE);
+    HANDLE hConsole = GetStdHandle(consoleToStderr_ ? STD_ERROR_HANDLE : STD_OUTPUT_HANDLE);
     WORD originalAttributes;
     CONSOLE_SCREEN_BUFFER_INFO csbi;
     GetConsoleScreenBufferInfo(hConsole, &csbi);
@@ -248,13 +253,13 @@ void Logger::writeToConsole(const std::string& formattedMessage, LogLevel level)
             break;
     }
     
-    std::cout << formattedMessage << std::endl;
+    (consoleToStderr_ ? std::cerr : std::cout) << formattedMessage << std::endl;
     
     // Restore original color
     SetConsoleTextAttribute(hConsole, originalAttributes);
 #else
     // No color support - just print
-    std::cout << formattedMessage << std::endl;
+    (consoleToStderr_ ? std::cerr : std::cout) << formattedMessage << std::endl;
 #endif
 }
 
@@ -121,6 +121,12 @@ public:
      */
     LogLevel getMinLevel() const;
     
+    /**
+     * @brief Route console output to stderr instead of stdout
+     * @param useStderr true while stdout carries data (e.g., piped video frames)
+     */
+    void setConsoleToStderr(bool useStderr);
+    
     /**
      * @brief Check if logger is initialized
      * @return true if initialized
@@ -141,6 +147,7 @@ private:
     LogMode mode_;                      ///< Output mode
     LogLevel minLevel_;                 ///< Minimum log level
     bool initialized_;                  ///< Initialization state
+    bool consoleToStderr_ = false;      ///< Console output goes to stderr
     
     /**
      * @brief Get current timestamp string
@@ -12,7 +12,13 @@
 #include <memory>
 #include <atomic>
 #include <mutex>
+#include <map>
+#include <chrono>
 #include <opencv2/core.hpp>
+#include "extraction_estimator.hpp"
+#include "timeline_series.hpp"
+
+namespace zed_tools { class FileGrowthWatcher; class ArchiveMigrator; class OutputManager; }
 
 namespace zed_extractor {
 
@@ -31,7 +37,24 @@ struct FrameExtractionConfig {
     std::string baseOutputPath;
     float fps = 1.0f;
     std::string cameraMode = "left";  // left, right, both
-    std::string format = "png";       // png, jpg
+    std::string format = "png";       // png, jpg, qoi (fast lossless; needs a QOI-aware reader)
+    // Event-triggered sampling: a cheap per-frame depth trigger switches from `fps`
+    // to `eventFps` for a window around the event; the pre-roll comes from a ring buffer.
+    bool eventTrigger = false;
+    std::string triggerMode = "pixels"; // "pixels" (N valid pixels closer than D) or "blob" (detector hit)
+    float triggerDistance = 15.0f;    // D (meters)
+    int triggerMinPixels = 2000;      // N (full-resolution pixels; blob mode: min blob area)
+    float eventFps = 0.0f;            // Rate inside event windows (0 = source FPS)
+    float preEventSec = 1.0f;         // Pre-roll kept in the ring buffer (positions only, re-decoded on an event)
+    float postEventSec = 2.0f;        // Full rate continues this long after the last trigger
+    bool followMode = false;          // At EOF wait for the file to grow (SVO still being recorded)
+    int followPollMs = 500;           // Growth check interval while following
+    float followIdleTimeoutSec = 30.0f; // Stop following after this long without growth (<=0 = never)
+    int keyframeTolerance = 0;        // >0: seek to each sample and move it up to +-N frames to the cheapest frame to decode
+    bool lowPriority = false;         // Background mode: idle CPU/IO priority, backs off while the system is busy
+    float maxProcessFps = 0.0f;       // Background mode: processed-frame cap (0 = unlimited)
+    float maxWriteMBps = 0.0f;        // Background mode: output write cap in MiB/s (0 = unlimited)
+    int readAheadMB = 0;              // Keep this much of the SVO ahead of decode in the page cache (slow media; 0 = off)
 };
 
 /**
@@ -44,6 +67,13 @@ struct VideoExtractionConfig {
     std::string codec = "h264";       // h264, h265, mjpeg
     float outputFps = 0.0f;           // 0 = use source FPS
     int quality = 100;                // 50-100
+    float segmentSec = 0.0f;          // Roll into segments of this many seconds + <stream>_segments.json / .ffconcat (0 = one file per stream)
+    std::string scratchPath;          // Fast local tier; the extraction folder moves to baseOutputPath when done (empty = write directly)
+    float scratchLimitGB = 50.0f;     // Staged data awaiting migration before new jobs wait
+    bool lowPriority = false;         // Background mode: idle CPU/IO priority, backs off while the system is busy
+    float maxProcessFps = 0.0f;       // Background mode: processed-frame cap (0 = unlimited)
+    float maxWriteMBps = 0.0f;        // Background mode: output write cap in MiB/s (0 = unlimited)
+    int readAheadMB = 0;              // Keep this much of the SVO ahead of decode in the page cache (slow media; 0 = off)
 };
 
 /**
@@ -62,9 +92,13 @@ struct DepthExtractionConfig {
     // Default uses tiff32f for broad compatibility.
     std::string rawDepthFormat = "tiff32f";
     bool saveColorized = true;        // Save colorized heatmap (PNG)
+    // Persist raw depth (+ confidence/RGB when enabled) and depth_visualization.json instead of
+    // heatmaps; LazyHeatmapRenderer renders them on first access (forces saveRawDepth, no heatmap video)
+    bool lazyHeatmaps = false;
     bool saveVideo = false;           // Create video from depth maps
     bool saveRgbFrames = false;       // Save left RGB frames for fast re-render overlay
     bool saveConfidenceMaps = false;  // Save confidence maps (8-bit) for debugging/masking
+    std::string imageFormat = "png";  // Heatmaps, RGB cache, confidence maps: png or qoi (lossless, ~10x faster, read back by our tools)
     std::string depthMode = "NEURAL"; // PERFORMANCE, QUALITY, ULTRA, NEURAL, NEURAL_PLUS
     bool overlayOnRgb = true;         // Blend heatmap over left RGB image
     int overlayStrength = 100;        // 0 = only RGB, 100 = only heatmap
@@ -79,8 +113,75 @@ struct DepthExtractionConfig {
     std::string colorMap = "turbo";   // turbo, viridis, plasma, jet
     bool highlightMotion = false;     // Emphasize moving objects via depth difference
     float motionGain = 0.6f;          // Strength of motion highlight (0-1)
-    bool storePreviews = true;        // Keep per-frame preview images for navigation
+    bool useBackgroundModel = false;  // Per-pixel depth background model; motion highlight shows its foreground
+    float backgroundAlpha = 0.02f;    // Background adaptation rate (exponentially weighted mean/variance)
+    float backgroundKSigma = 3.0f;    // Foreground threshold in standard deviations
+    bool saveBackgroundVariance = false; // Write background_variance.tiff (CV_32F, m^2) at end of run
+    bool enableTracking = false;      // Detect near-range depth blobs and track them on every grabbed frame
+    float trackMaxRange = 40.0f;      // Blobs closer than this are detected (meters)
+    int trackMinBlobPixels = 12;      // Minimum blob area at 1/4 resolution
+    bool drawTracks = true;           // Draw track boxes/IDs on heatmaps when tracking
+    bool useGroundPlane = false;      // Per-frame RANSAC ground plane; detector only sees above-ground objects
+    float objectMinHeight = 1.0f;     // Height above the ground plane that counts as an object (meters)
+    bool maskGroundInHeatmap = true;  // Ground and sky are left out of auto-contrast and drawn black
+    bool useSparseFlow = false;       // LK flow on the downscaled left image with ego-motion compensation; flags independent motion
+    float flowResidualThreshold = 1.5f; // Residual flow that counts as independent motion (px at 1/4 scale)
+    bool saveOccupancyGrid = false;   // Bird's-eye grid per exported frame (16-bit PNG) + flight_grid.png
+    std::string occupancyMode = "occupancy"; // "occupancy" (point count) or "height" (max height, mm above -50 m)
+    float occupancyCellSize = 0.25f;  // Grid cell edge (meters)
+    bool occupancyUsePose = false;    // World-aligned grid from positional tracking (camera frame otherwise)
+    float occupancyWorldExtent = 150.0f; // Half-size of the world-aligned grid (meters)
+    bool storePreviews = false;       // Keep per-frame preview images for navigation (the GUI turns this on)
     int previewMaxWidth = 960;        // Downscale previews to this width (preserve aspect); <=0 = no downscale
+    bool collectFrameStats = false;   // Per-frame nearest distance / valid pixels / detections for timeline plots (the GUI turns this on; the CLI writes frame_stats.csv)
+    bool followMode = false;          // At EOF wait for the file to grow (SVO still being recorded)
+    int followPollMs = 500;           // Growth check interval while following
+    float followIdleTimeoutSec = 30.0f; // Stop following after this long without growth (<=0 = never)
+    // Processing order of the selected frames. "sequential" visits them in SVO order;
+    // "coarse_to_fine" visits every 256th selected frame, then every 128th, ... so an
+    // evenly spread overview exists early. Outputs keep their sequential file index.
+    std::string frameOrder = "sequential";
+    float timeBudgetSec = 0.0f;       // Stop after this many seconds (<=0 = no limit)
+    // Stream outputs to S3-compatible storage while extracting: "http://host[:port]/bucket[/prefix]".
+    // Credentials come from AWS_ACCESS_KEY_ID / AWS_SECRET_ACCESS_KEY. Empty = local output only.
+    std::string uploadUrl;
+    bool uploadKeepLocal = true;      // Keep local copies (false: images are encoded in memory and never touch disk)
+    int uploadWorkers = 4;            // Concurrent upload requests
+    std::string scratchPath;          // Fast local tier; the extraction folder moves to baseOutputPath when done (empty = write directly)
+    float scratchLimitGB = 50.0f;     // Staged data awaiting migration before new jobs wait
+    int workerThreads = 0;            // Shared CPU pool size (0 = ZED_EXTRACTOR_THREADS or all hardware threads; fixed once started)
+    bool lowPriority = false;         // Background mode: idle CPU/IO priority, backs off while the system is busy
+    float maxProcessFps = 0.0f;       // Background mode: processed-frame cap (0 = unlimited)
+    float maxWriteMBps = 0.0f;        // Background mode: output write cap in MiB/s (0 = unlimited)
+    int readAheadMB = 0;              // Keep this much of the SVO ahead of decode in the page cache (slow media; 0 = off)
+};
+
+/**
+ * @brief Per-frame signals of the last depth extraction, x = SVO frame index
+ *
+ * Filled while the extraction runs (DepthExtractionConfig::collectFrameStats).
+ * Frames that are only analysed (tracking, background model, ground plane)
+ * contribute as well as exported ones; detections exist only with tracking.
+ */
+struct FlightTimeline {
+    zed_tools::TimelineSeries nearestDistance{ "Nearest distance", "m" };
+    zed_tools::TimelineSeries validFraction{ "Valid pixels", "%" };
+    zed_tools::TimelineSeries detectionCount{ "Detections", "" };
+
+    void clear() {
+        nearestDistance.clear();
+        validFraction.clear();
+        detectionCount.clear();
+    }
+
+    /**
+     * @brief Write all samples as CSV (frame,nearest_m,valid_pct,detections)
+     *
+     * One row per frame present in any series; fields a frame has no sample
+     * for stay empty.
+     * @return false if the file could not be written
+     */
+    bool writeCsv(const std::string& path) const;
 };
 
 /**
@@ -149,6 +250,29 @@ public:
         const DepthExtractionConfig& config,
         ProgressCallback progressCallback = nullptr
     );
+
+    /**
+     * @brief Estimate runtime, output size and peak memory of extractFrames
+     * @param samples Frames timed through grab/retrieve/encode/write, spread across the SVO
+     * @return Failure if the SVO cannot be sampled; nothing is written except a
+     *         short write-speed probe in the output volume
+     */
+    ExtractionResult estimateFrames(
+        const FrameExtractionConfig& config,
+        ExtractionEstimate& estimate,
+        int samples = 8,
+        ProgressCallback progressCallback = nullptr
+    );
+
+    /**
+     * @brief Estimate runtime, output size and peak memory of extractDepth (see estimateFrames)
+     */
+    ExtractionResult estimateDepth(
+        const DepthExtractionConfig& config,
+        ExtractionEstimate& estimate,
+        int samples = 8,
+        ProgressCallback progressCallback = nullptr
+    );
     
     /**
      * @brief Cancel ongoing extraction
@@ -160,6 +284,23 @@ public:
      */
     bool isRunning() const;
 
+    /**
+     * @brief Live preview request; live previews are only rendered while someone subscribes
+     */
+    struct PreviewSubscription {
+        float maxFps = 0.0f;      // Upper bound on preview updates per second (0 = every exported frame)
+        int maxWidth = 0;         // Downscale live previews to this width (0 = full resolution)
+    };
+
+    /**
+     * @brief Start receiving live depth previews
+     * @return Subscription id for unsubscribeDepthPreview()
+     *
+     * With several subscribers the highest rate and largest width win.
+     */
+    int subscribeDepthPreview(const PreviewSubscription& request);
+    void unsubscribeDepthPreview(int id);
+
     /**
      * @brief Retrieve latest preview image (heatmap or overlay) produced during depth extraction.
      * @param out Destination cv::Mat (BGR) clone of latest preview.
@@ -195,6 +336,11 @@ public:
     bool getStoredPreviewAt(int index, cv::Mat& out) const;
     bool setStoredPreviewAt(int index, const cv::Mat& img);
     int getStoredFrameIndexAt(int index) const; // original SVO frame index
+    int getStoredOutputIndexAt(int index) const; // file index (NNNNNN) of the saved outputs
+    int findStoredPreviewNear(int frameIndex) const; // stored index closest to an SVO frame, -1 if none
+    // Lazy-heatmap runs store frames without images; render (or reuse) the memoized heatmap of one.
+    // Returns true once the stored preview holds an image.
+    bool loadLazyPreviewAt(int index);
 
     // Single-frame re-render using current or new parameters.
     // If overwriteSaved is true and a prior heatmap exists, it will be overwritten.
@@ -211,6 +357,14 @@ public:
     // Load saved left RGB frame (BGR8) for a stored frame if available
     bool getRgbForStored(int storedIndex, cv::Mat& outBgr) const;
 
+    // Per-frame statistics for timeline plots (safe to query while an extraction runs)
+    const FlightTimeline& getFlightTimeline() const;
+
+    // Scratch-tier staging: extraction folders still waiting to move to the archive
+    int getPendingArchiveJobs() const;
+    // Block until all staged extraction folders are archived
+    void waitForArchive();
+
 private:
     std::atomic<bool> cancelRequested_;
     std::atomic<bool> isRunning_;
@@ -220,16 +374,58 @@ private:
     std::atomic<int> previewVersion_{0};
     DepthPreviewInfo latestPreviewInfo_;
     cv::Mat latestLegend_;
+    std::string latestLegendColorMap_;        // Colormap latestLegend_ was built for
+    std::map<int, PreviewSubscription> previewSubscribers_;
+    int nextPreviewSubscriber_ = 1;
+    std::chrono::steady_clock::time_point lastLivePreview_;
     // Stored previews for navigation
     std::vector<cv::Mat> storedPreviews_;     // BGR8, possibly downscaled
     std::vector<int> storedFrameIndices_;     // Original frame indices in SVO
+    std::vector<int> storedOutputIndices_;    // Output file index of each stored preview
+    bool lazyPreviews_ = false;               // Stored previews are filled on demand from LazyHeatmapRenderer
+    int storedPreviewMaxWidth_ = 0;           // previewMaxWidth of the run that stored the previews
+    FlightTimeline timeline_;                 // Per-frame statistics (series lock themselves)
     std::string lastExtractionPath_;          // Path of the last depth extraction output
+    std::string lastArchivePath_;             // Archive location when that output was staged on scratch
+    mutable std::mutex archiveMutex_;
+    std::unique_ptr<zed_tools::ArchiveMigrator> archiveMigrator_; // Created on first staged job
     
     // Internal helper to check cancellation
     bool shouldCancel() const;
+
+    /**
+     * @brief Whether a live preview should be rendered now (subscribers present and rate allows)
+     * @param effective Combined request of all subscribers
+     */
+    bool livePreviewDue(PreviewSubscription& effective);
     
     // Internal helper to report progress
     void reportProgress(float progress, const std::string& message, ProgressCallback callback);
+
+    // Scratch staging: wait for scratch capacity, then point the manager at the scratch tier.
+    // Returns false if cancelled while waiting.
+    bool prepareStaging(zed_tools::OutputManager& outputMgr, const std::string& scratchPath,
+                        float scratchLimitGB, ProgressCallback callback);
+    // Hand a finished staged folder to the migrator (no-op when not staging)
+    void archiveExtraction(const zed_tools::OutputManager& outputMgr, const std::string& extractionPath);
+    // Where the last depth outputs currently live (scratch until migrated, then the archive)
+    std::string depthOutputRoot() const;
+
+    // Follow mode: block at EOF until the SVO grows. Returns false on idle timeout,
+    // cancellation or if the file disappears (caller then finishes normally).
+    bool waitForSvoGrowth(zed_tools::FileGrowthWatcher& watcher, float idleTimeoutSec,
+                          float progress, ProgressCallback callback);
+
+    // SDK implementations of the public extraction calls, defined in extraction_engine_sdk.cpp
+    // (zed_sdk_backend plugin) and reached through SdkBackend
+    friend class ZedSdkBackend;
+    ExtractionResult runExtractFrames(const FrameExtractionConfig& config, ProgressCallback progressCallback);
+    ExtractionResult runExtractVideo(const VideoExtractionConfig& config, ProgressCallback progressCallback);
+    ExtractionResult runExtractDepth(const DepthExtractionConfig& config, ProgressCallback progressCallback);
+    ExtractionResult runEstimateFrames(const FrameExtractionConfig& config, ExtractionEstimate& estimate,
+                                       int samples, ProgressCallback progressCallback);
+    ExtractionResult runEstimateDepth(const DepthExtractionConfig& config, ExtractionEstimate& estimate,
+                                      int samples, ProgressCallback progressCallback);
 };
 
 } // namespace zed_extractor
@@ -0,0 +1,2271 @@
+/**
+ * @file extraction_engine_sdk.cpp
+ * @brief ZED SDK side of the extraction engine (built into the zed_sdk_backend plugin)
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ *
+ * Everything here decodes the SVO through sl::Camera. The plugin exports
+ * ZedSdkBackend; ExtractionEngine in zed_common_core loads it on first use
+ * and forwards its extraction calls to the run* members defined below.
+ */
+
+#include "extraction_engine.hpp"
+#include "sdk_backend.hpp"
+#include "error_handler.hpp"
+#include "file_utils.hpp"
+#include "svo_handler.hpp"
+#include "metadata.hpp"
+#include "output_manager.hpp"
+#include "file_growth_watcher.hpp"
+#include "depth_background_model.hpp"
+#include "depth_blob_detector.hpp"
+#include "object_tracker.hpp"
+#include "ground_plane_estimator.hpp"
+#include "occupancy_grid.hpp"
+#include "sparse_motion_flow.hpp"
+#include "object_store_sink.hpp"
+#include "archive_migrator.hpp"
+#include "background_priority.hpp"
+#include "thread_pool.hpp"
+#include "image_io.hpp"
+#include "keyframe_index.hpp"
+#include "depth_colorizer.hpp"
+#include "read_ahead_prefetcher.hpp"
+#include "segmented_video_writer.hpp"
+
+#include <sl/Camera.hpp>
+#include <opencv2/opencv.hpp>
+#ifdef ZED_BACKEND_HAS_CUDART
+#include <cuda_runtime_api.h>
+#endif
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <cmath>
+#include <cstdlib>
+#include <algorithm>
+#include <vector>
+#include <chrono>
+#include <fstream>
+#include <limits>
+#include <mutex>
+#include <cstdio>
+
+namespace zed_extractor {
+
+using namespace zed_tools;
+
+// Defined with the depth helpers below
+static sl::DEPTH_MODE getDepthMode(const std::string& mode);
+
+/**
+ * @brief Convert sl::Mat to cv::Mat
+ */
+static cv::Mat slMat2cvMat(sl::Mat& input) {
+    int cvType = CV_8UC4;
+    switch (input.getDataType()) {
+        case sl::MAT_TYPE::F32_C1: cvType = CV_32FC1; break;
+        case sl::MAT_TYPE::F32_C2: cvType = CV_32FC2; break;
+        case sl::MAT_TYPE::F32_C3: cvType = CV_32FC3; break;
+        case sl::MAT_TYPE::F32_C4: cvType = CV_32FC4; break;
+        case sl::MAT_TYPE::U8_C1: cvType = CV_8UC1; break;
+        case sl::MAT_TYPE::U8_C2: cvType = CV_8UC2; break;
+        case sl::MAT_TYPE::U8_C3: cvType = CV_8UC3; break;
+        case sl::MAT_TYPE::U8_C4: cvType = CV_8UC4; break;
+        default: break;
+    }
+    return cv::Mat(input.getHeight(), input.getWidth(), cvType, input.getPtr<sl::uchar1>());
+}
+
+/**
+ * @brief Runs a callback when the enclosing scope is left, including error returns and exceptions
+ */
+class ScopeExit {
+public:
+    explicit ScopeExit(std::function<void()> onExit) : onExit_(std::move(onExit)) {}
+    ~ScopeExit() {
+        try {
+            onExit_();
+        } catch (const std::exception& e) {
+            LOG_ERROR(std::string("Cleanup failed: ") + e.what());
+        } catch (...) {}
+    }
+    ScopeExit(const ScopeExit&) = delete;
+    ScopeExit& operator=(const ScopeExit&) = delete;
+
+private:
+    std::function<void()> onExit_;
+};
+
+/**
+ * @brief Enter background mode on the calling thread (nullptr when disabled)
+ *
+ * Called before the SVO is opened so the SDK's worker threads inherit the
+ * lowered priority. The job's pool work goes to the low-priority background
+ * pool; the thread's priority and pool are restored when the throttle is destroyed.
+ */
+static std::unique_ptr<BackgroundThrottle> makeBackgroundThrottle(bool enabled, float maxFps, float maxWriteMBps,
+                                                                  std::function<bool()> cancelled) {
+    if (!enabled) return nullptr;
+    BackgroundPriorityConfig bg;
+    bg.maxFps = maxFps;
+    bg.maxWriteMBps = maxWriteMBps;
+    auto priority = std::make_unique<BackgroundPriorityScope>(bg);
+    if (!priority->getResult().isSuccessful) {
+        LOG_WARNING("Background mode: " + priority->getResult().message + " (rate limits and back-off still apply)");
+    }
+    return std::make_unique<BackgroundThrottle>(bg, std::move(cancelled), std::move(priority));
+}
+
+/**
+ * @brief Start prefetching the SVO ahead of decode (nullptr when disabled or unavailable)
+ *
+ * The prefetcher reads on its own thread and stops when the returned object is destroyed.
+ */
+static std::unique_ptr<ReadAheadPrefetcher> makeReadAhead(const std::string& svoPath, int readAheadMB, int totalFrames) {
+    if (readAheadMB <= 0) return nullptr;
+    ReadAheadConfig raConfig;
+    raConfig.windowBytes = static_cast<uint64_t>(readAheadMB) << 20;
+    auto prefetcher = std::make_unique<ReadAheadPrefetcher>(raConfig);
+    if (!prefetcher->start(svoPath, totalFrames)) {
+        LOG_WARNING(prefetcher->getLastError() + "; reading without prefetch");
+        return nullptr;
+    }
+    LOG_INFO("Read-ahead enabled: " + std::to_string(readAheadMB) + " MB window");
+    return prefetcher;
+}
+
+// Frames before a seek target assumed to be decoded when no keyframe index is available
+static const int kReadAheadLookbehindFrames = 30;
+
+ExtractionResult ExtractionEngine::runExtractFrames(
+    const FrameExtractionConfig& config,
+    ProgressCallback progressCallback
+) {
+    if (isRunning_) {
+        return ExtractionResult::Failure("Extraction already in progress");
+    }
+    
+    isRunning_ = true;
+    cancelRequested_ = false;
+    auto throttle = makeBackgroundThrottle(config.lowPriority, config.maxProcessFps, config.maxWriteMBps,
+                                           [this] { return shouldCancel(); });
+    
+    try {
+        reportProgress(0.0f, "Opening SVO file...", progressCallback);
+        
+        // Open SVO file using SVOHandler
+        SVOHandler svo(config.svoFilePath);
+        if (!svo.open()) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to open SVO file");
+        }
+        
+        // Get SVO properties
+        SVOProperties props = svo.getProperties();
+        reportProgress(0.05f, "SVO file opened successfully", progressCallback);
+        // In follow mode the window ends at the size seen here; appended data is fresh in the cache anyway
+        auto readAhead = makeReadAhead(config.svoFilePath, config.readAheadMB, props.totalFrames);
+        
+        // Get flight folder name from SVO path
+        std::string svoPath = config.svoFilePath;
+        std::replace(svoPath.begin(), svoPath.end(), '\\', '/');
+        
+        // Get the parent directory of the SVO file
+        size_t lastSlash = svoPath.find_last_of('/');
+        std::string parentFolder = (lastSlash != std::string::npos) ? svoPath.substr(0, lastSlash) : "";
+        
+        std::string flightFolderName = "unknown_flight";
+        
+        if (!parentFolder.empty()) {
+            // Extract just the folder name (last component of path)
+            size_t folderNameStart = parentFolder.find_last_of('/');
+            std::string folderName = (folderNameStart != std::string::npos) 
+                ? parentFolder.substr(folderNameStart + 1) 
+                : parentFolder;
+            
+            // Check if it matches flight folder pattern
+            if (FileUtils::isFlightFolder(folderName)) {
+                flightFolderName = folderName;
+            }
+        }
+        
+        reportProgress(0.08f, "Detected flight: " + flightFolderName, progressCallback);
+        
+        // Setup output manager
+        OutputManager outputMgr(config.baseOutputPath);
+        std::string outputPath = outputMgr.getYoloFramesPath(flightFolderName);
+        
+        if (outputPath.empty()) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to create output directory");
+        }
+        
+        reportProgress(0.1f, "Output directory created", progressCallback);
+        
+        // Calculate frame interval
+        int frameInterval = std::max(1, static_cast<int>(std::round(props.fps / config.fps)));
+        int svoPosition = 0;
+        int frameCount = 0;
+        
+        sl::Mat image_zed;
+        std::ofstream samplingLog;        // Event mode: which tier produced each file
+
+        // Writes one view of the current frame under the global YOLO numbering
+        auto saveView = [&](sl::Mat& image, const char* prefix, int position, const char* tier) -> std::string {
+            int frameNum = outputMgr.getNextGlobalFrameNumber();
+            std::ostringstream filename;
+            filename << prefix << "_frame_" << std::setw(6) << std::setfill('0') << frameNum
+                    << "." << config.format;
+            std::string filepath = outputPath + "/" + filename.str();
+            
+            if (config.format == "qoi") {
+                // sl::Mat::write has no QOI; views are BGRA
+                cv::Mat bgr;
+                cv::cvtColor(slMat2cvMat(image), bgr, cv::COLOR_BGRA2BGR);
+                writeImageFile(filepath, bgr);
+            } else {
+                image.write(filepath.c_str());
+            }
+            if (throttle) throttle->onFileWritten(filepath);
+            outputMgr.updateGlobalFrameCounter(frameNum);
+            frameCount++;
+            if (tier) samplingLog << filename.str() << ',' << position << ',' << tier << '\n';
+            return filename.str();
+        };
+        const bool wantLeft = (config.cameraMode == "left" || config.cameraMode == "both");
+        const bool wantRight = (config.cameraMode == "right" || config.cameraMode == "both");
+
+        // Event-triggered sampling: trigger state and pre-roll ring buffer
+        int eventInterval = 1;
+        int preFrames = 0;
+        int postFrames = 0;
+        int eventUntil = -1;              // Last SVO position inside the current event window
+        int eventCount = 0;
+        // The ring holds SVO positions only; an event re-decodes them from the SVO
+        std::vector<int> ring;
+        size_t ringHead = 0, ringSize = 0;
+        sl::Mat depthZed;
+        std::unique_ptr<DepthBlobDetector> triggerDetector;
+        std::vector<DepthDetection> triggerDetections;
+        if (config.eventTrigger) {
+            float eventFps = config.eventFps > 0.0f ? config.eventFps : props.fps;
+            eventInterval = std::max(1, static_cast<int>(std::round(props.fps / eventFps)));
+            preFrames = static_cast<int>(std::round(config.preEventSec * props.fps));
+            postFrames = static_cast<int>(std::round(config.postEventSec * props.fps));
+            ring.resize(std::max(0, preFrames / eventInterval));
+            if (config.triggerMode == "blob") {
+                BlobDetectorConfig detConfig;
+                detConfig.maxRange = config.triggerDistance;
+                detConfig.minPixels = std::max(1, config.triggerMinPixels / (detConfig.downscale * detConfig.downscale));
+                detConfig.maxDetections = 1;
+                triggerDetector = std::make_unique<DepthBlobDetector>(detConfig);
+            }
+            std::string logPath = outputPath + "/frame_sampling_" + FileUtils::getStem(config.svoFilePath) + ".csv";
+            samplingLog.open(logPath, std::ios::app);
+            if (samplingLog.is_open() && samplingLog.tellp() == 0) samplingLog << "file,svo_frame,tier\n";
+        }
+
+        // Cheap depth trigger on the current frame
+        auto depthTriggered = [&]() -> bool {
+            if (svo.retrieveMeasure(depthZed, sl::MEASURE::DEPTH) != sl::ERROR_CODE::SUCCESS) return false;
+            cv::Mat depth = slMat2cvMat(depthZed);
+            if (depth.empty()) return false;
+            if (triggerDetector) {
+                triggerDetector->detect(depth, cv::Mat(), triggerDetections);
+                return !triggerDetections.empty();
+            }
+            // Strided count, scaled back to full-resolution pixels
+            const int step = 4;
+            int count = 0;
+            for (int y = 0; y < depth.rows; y += step) {
+                const float* row = depth.ptr<float>(y);
+                for (int x = 0; x < depth.cols; x += step) {
+                    float z = row[x];
+                    count += (z > 0.0f && z < config.triggerDistance) ? 1 : 0;
+                }
+            }
+            return count * step * step >= config.triggerMinPixels;
+        };
+
+        // Follow mode: keep extracting while the recorder appends to the file
+        std::unique_ptr<FileGrowthWatcher> followWatcher;
+        if (config.followMode) {
+            followWatcher = std::make_unique<FileGrowthWatcher>(config.svoFilePath, config.followPollMs);
+        }
+        
+        // Keyframe-aware sparse sampling: seek to each sample instead of decoding every
+        // frame, moving it by up to +-keyframeTolerance to the cheapest frame to reach
+        if (config.keyframeTolerance > 0 && frameInterval > 1) {
+            KeyframeIndex keyframes;
+            if (config.eventTrigger || config.followMode) {
+                LOG_WARNING("Keyframe snapping needs plain interval sampling; ignored with event trigger or follow mode");
+            } else if (!keyframes.build(config.svoFilePath)) {
+                LOG_WARNING("Keyframe index unavailable (" + keyframes.getLastError() + "); sampling sequentially");
+            } else if (std::abs(keyframes.getFrameCount() - props.totalFrames) > 1) {
+                LOG_WARNING("Keyframe index has " + std::to_string(keyframes.getFrameCount()) + " video messages but the SVO has " +
+                            std::to_string(props.totalFrames) + " frames; sampling sequentially");
+            } else {
+                std::ostringstream gop;
+                gop << std::fixed << std::setprecision(1) << keyframes.getMeanGop();
+                LOG_INFO("Keyframe index (" + std::string(keyframeSourceName(keyframes.getSource())) + "): " +
+                         std::to_string(keyframes.getKeyframeCount()) + " keyframes, mean GOP " + gop.str() + " frames");
+
+                std::vector<KeyframeSample> plan =
+                    keyframes.planSamples(0, props.totalFrames, frameInterval, config.keyframeTolerance);
+                // Metadata: the SVO frame each file actually came from
+                std::string snapPath = outputPath + "/frame_keyframes_" + FileUtils::getStem(config.svoFilePath) + ".csv";
+                std::ofstream snapLog(snapPath, std::ios::app);
+                if (snapLog.is_open() && snapLog.tellp() == 0) snapLog << "file,requested_frame,svo_frame,decoded_before\n";
+
+                // Prefetch only the frames each sample decodes, at their exact offsets
+                if (readAhead) {
+                    readAhead->setFrameOffsets(keyframes.getFrameOffsets());
+                    std::vector<std::pair<int, int>> ranges;
+                    ranges.reserve(plan.size());
+                    for (const auto& sample : plan) ranges.emplace_back(sample.actualFrame - sample.decodeDistance, sample.actualFrame);
+                    readAhead->setRandomPlan(ranges);
+                }
+
+                int lastGrabbed = -1;
+                int64_t decodedFrames = 0;
+                int snapped = 0;
+                for (size_t k = 0; k < plan.size(); ++k) {
+                    const KeyframeSample& sample = plan[k];
+                    if (shouldCancel()) {
+                        isRunning_ = false;
+                        return ExtractionResult::Failure("Extraction cancelled by user");
+                    }
+                    if (throttle) throttle->beforeFrame();
+
+                    // Ahead of the decoder in the same GOP: decode forward; otherwise seek
+                    bool grabbed = true;
+                    if (lastGrabbed >= 0 && sample.actualFrame > lastGrabbed &&
+                        keyframes.previousKeyframe(sample.actualFrame) <= lastGrabbed) {
+                        for (int f = lastGrabbed + 1; f <= sample.actualFrame && grabbed; ++f) grabbed = svo.grab();
+                    } else {
+                        grabbed = svo.setFramePosition(sample.actualFrame) && svo.grab();
+                    }
+                    if (!grabbed) {
+                        LOG_WARNING("Failed to read SVO frame " + std::to_string(sample.actualFrame));
+                        break;
+                    }
+                    lastGrabbed = sample.actualFrame;
+                    if (readAhead) readAhead->notifyFrame(sample.actualFrame);
+                    decodedFrames += sample.decodeDistance + 1;
+                    if (sample.actualFrame != sample.requestedFrame) ++snapped;
+
+                    for (int view = 0; view < 2; ++view) {
+                        if (!(view == 0 ? wantLeft : wantRight)) continue;
+                        if (svo.retrieveImage(image_zed, view == 0 ? sl::VIEW::LEFT : sl::VIEW::RIGHT) != sl::ERROR_CODE::SUCCESS) continue;
+                        std::string name = saveView(image_zed, view == 0 ? "L" : "R", sample.actualFrame, nullptr);
+                        snapLog << name << ',' << sample.requestedFrame << ',' << sample.actualFrame << ','
+                                << sample.decodeDistance << '\n';
+                    }
+
+                    float progress = 0.1f + 0.9f * (static_cast<float>(k + 1) / plan.size());
+                    if (k % 10 == 0) {
+                        reportProgress(progress, "Extracting frames: " + std::to_string(frameCount) + " extracted (keyframe-aware)",
+                                       progressCallback);
+                    }
+                }
+                LOG_INFO("Keyframe sampling: " + std::to_string(plan.size()) + " samples (" + std::to_string(snapped) +
+                         " snapped), " + std::to_string(decodedFrames) + " frames decoded instead of " +
+                         std::to_string(props.totalFrames));
+                if (readAhead) LOG_INFO(readAhead->describeStats());
+
+                isRunning_ = false;
+                reportProgress(1.0f, "Frame extraction completed", progressCallback);
+                return ExtractionResult::Success(outputPath, frameCount);
+            }
+        }
+
+        // Main extraction loop (re-entered after each growth in follow mode)
+        for (;;) {
+            while (svo.grab()) {
+                if (readAhead) readAhead->notifyFrame(svoPosition);
+                if (shouldCancel()) {
+                    isRunning_ = false;
+                    return ExtractionResult::Failure("Extraction cancelled by user");
+                }
+                if (throttle) throttle->beforeFrame();
+
+                const char* tier = nullptr;
+                bool extract = (svoPosition % frameInterval == 0);
+                if (config.eventTrigger) {
+                    tier = "base";
+                    if (depthTriggered()) {
+                        if (svoPosition > eventUntil) {
+                            ++eventCount;
+                            LOG_INFO("Depth event at SVO frame " + std::to_string(svoPosition));
+                            // Flush the pre-roll, oldest first (slots may predate an earlier event):
+                            // seek to the oldest kept position and decode forward back to this frame
+                            std::vector<int> preroll;
+                            for (size_t k = 0; k < ringSize; ++k) {
+                                int position = ring[(ringHead + ring.size() - ringSize + k) % ring.size()];
+                                if (position >= svoPosition - preFrames) preroll.push_back(position);
+                            }
+                            ringSize = 0;
+                            if (!preroll.empty()) {
+                                bool grabbed = svo.setFramePosition(preroll.front()) && svo.grab();
+                                int decoded = preroll.front();
+                                for (size_t k = 0; grabbed && k < preroll.size(); ++k) {
+                                    while (grabbed && decoded < preroll[k]) { grabbed = svo.grab(); ++decoded; }
+                                    if (!grabbed) break;
+                                    if (wantLeft && svo.retrieveImage(image_zed, sl::VIEW::LEFT) == sl::ERROR_CODE::SUCCESS) {
+                                        saveView(image_zed, "L", preroll[k], "preroll");
+                                    }
+                                    if (wantRight && svo.retrieveImage(image_zed, sl::VIEW::RIGHT) == sl::ERROR_CODE::SUCCESS) {
+                                        saveView(image_zed, "R", preroll[k], "preroll");
+                                    }
+                                }
+                                while (grabbed && decoded < svoPosition) { grabbed = svo.grab(); ++decoded; }
+                                if (!grabbed) {
+                                    // Pre-roll incomplete; get the decoder back onto the current frame
+                                    LOG_WARNING("Failed to re-read pre-roll frames before SVO frame " + std::to_string(svoPosition));
+                                    if (!svo.setFramePosition(svoPosition) || !svo.grab()) {
+                                        isRunning_ = false;
+                                        return ExtractionResult::Failure("Failed to resume at SVO frame " + std::to_string(svoPosition) +
+                                                                         " after the pre-roll: " + svo.getLastError());
+                                    }
+                                }
+                            }
+                        }
+                        eventUntil = svoPosition + postFrames;
+                    }
+                    const bool eventSlot = (svoPosition % eventInterval == 0);
+                    if (svoPosition <= eventUntil && eventSlot && !extract) {
+                        extract = true;
+                        tier = "event";
+                    } else if (!extract && eventSlot && !ring.empty()) {
+                        // Not exported now; remember it in case an event follows
+                        ring[ringHead] = svoPosition;
+                        ringHead = (ringHead + 1) % ring.size();
+                        ringSize = std::min(ringSize + 1, ring.size());
+                    }
+                }
+            
+                // Only extract frames at specified interval (or inside an event window)
+                if (!extract) {
+                    svoPosition++;
+                    continue;
+                }
+            
+                // Extract left camera
+                if (wantLeft) {
+                    sl::ERROR_CODE err = svo.retrieveImage(image_zed, sl::VIEW::LEFT);
+                    if (err == sl::ERROR_CODE::SUCCESS) {
+                        saveView(image_zed, "L", svoPosition, tier);
+                    }
+                }
+            
+                // Extract right camera
+                if (wantRight) {
+                    sl::ERROR_CODE err = svo.retrieveImage(image_zed, sl::VIEW::RIGHT);
+                    if (err == sl::ERROR_CODE::SUCCESS) {
+                        saveView(image_zed, "R", svoPosition, tier);
+                    }
+                }
+            
+                svoPosition++;
+            
+                // Report progress
+                float progress = 0.1f + (0.9f * (svoPosition / static_cast<float>(props.totalFrames)));
+                if (frameCount % 10 == 0 || svoPosition % 100 == 0) {
+                    std::ostringstream msg;
+                    msg << "Extracting frames: " << frameCount << " extracted";
+                    if (config.eventTrigger) msg << " (" << eventCount << " events)";
+                    reportProgress(progress, msg.str(), progressCallback);
+                }
+            }
+
+            // EOF: in follow mode wait for new data, then reopen and resume after the last frame
+            if (!followWatcher) break;
+            float followProgress = std::min(1.0f, 0.1f + (0.9f * (svoPosition / static_cast<float>(std::max(1, props.totalFrames)))));
+            if (!waitForSvoGrowth(*followWatcher, config.followIdleTimeoutSec, followProgress, progressCallback)) break;
+            svo.close();
+            if (!svo.open()) {
+                LOG_WARNING("Follow mode: failed to reopen SVO: " + svo.getLastError());
+                break;
+            }
+            props = svo.getProperties();
+            svo.setFramePosition(svoPosition);
+        }
+        if (readAhead) LOG_INFO(readAhead->describeStats());
+        
+        isRunning_ = false;
+        reportProgress(1.0f, "Frame extraction completed", progressCallback);
+        
+        return ExtractionResult::Success(outputPath, frameCount);
+        
+    } catch (const std::exception& e) {
+        isRunning_ = false;
+        return ExtractionResult::Failure(std::string("Exception: ") + e.what());
+    }
+}
+
+ExtractionResult ExtractionEngine::runExtractVideo(
+    const VideoExtractionConfig& config,
+    ProgressCallback progressCallback
+) {
+    if (isRunning_) {
+        return ExtractionResult::Failure("Extraction already in progress");
+    }
+    
+    isRunning_ = true;
+    cancelRequested_ = false;
+    auto throttle = makeBackgroundThrottle(config.lowPriority, config.maxProcessFps, config.maxWriteMBps,
+                                           [this] { return shouldCancel(); });
+    
+    try {
+        reportProgress(0.0f, "Opening SVO file...", progressCallback);
+        
+        // Open SVO file using SVOHandler
+        SVOHandler svo(config.svoFilePath);
+        if (!svo.open()) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to open SVO file");
+        }
+        
+        // Get SVO properties
+        SVOProperties props = svo.getProperties();
+        reportProgress(0.05f, "SVO file opened successfully", progressCallback);
+        auto readAhead = makeReadAhead(config.svoFilePath, config.readAheadMB, props.totalFrames);
+        
+        // Get flight folder name from SVO path
+        std::string svoPath = config.svoFilePath;
+        std::replace(svoPath.begin(), svoPath.end(), '\\', '/');
+        
+        // Get the parent directory of the SVO file
+        size_t lastSlash = svoPath.find_last_of('/');
+        std::string parentFolder = (lastSlash != std::string::npos) ? svoPath.substr(0, lastSlash) : "";
+        
+        std::string flightFolderName = "unknown_flight";
+        
+        if (!parentFolder.empty()) {
+            // Extract just the folder name (last component of path)
+            size_t folderNameStart = parentFolder.find_last_of('/');
+            std::string folderName = (folderNameStart != std::string::npos) 
+                ? parentFolder.substr(folderNameStart + 1) 
+                : parentFolder;
+            
+            // Check if it matches flight folder pattern
+            if (FileUtils::isFlightFolder(folderName)) {
+                flightFolderName = folderName;
+            }
+        }
+        
+        reportProgress(0.08f, "Detected flight: " + flightFolderName, progressCallback);
+        
+        // Setup output manager
+        OutputManager outputMgr(config.baseOutputPath);
+        if (!prepareStaging(outputMgr, config.scratchPath, config.scratchLimitGB, progressCallback)) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Extraction cancelled by user");
+        }
+        std::string extractionPath = outputMgr.getExtractionPath(flightFolderName, OutputType::VIDEO);
+        
+        if (extractionPath.empty()) {
+            // SVOHandler auto-closes;
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to create extraction directory");
+        }
+        // A staged folder is handed to the migrator exactly once, also on exceptions, so it
+        // is archived and stops counting against the scratch limit
+        bool archived = false;
+        auto archive = [&]() {
+            if (archived) return;
+            archived = true;
+            archiveExtraction(outputMgr, extractionPath);
+        };
+        ScopeExit archiveOnExit(archive);
+        
+        reportProgress(0.1f, "Output directory created", progressCallback);
+        
+        // Determine output FPS with validation
+        float outputFps;
+        if (config.outputFps > 0) {
+            outputFps = config.outputFps;
+            if (outputFps > props.fps) {
+                std::ostringstream msg;
+                msg << "Requested FPS (" << outputFps << ") exceeds source FPS (" 
+                    << props.fps << "), using source FPS";
+                reportProgress(0.12f, msg.str(), progressCallback);
+                outputFps = props.fps;
+            }
+        } else {
+            outputFps = props.fps;
+        }
+        
+        // Use MJPEG codec which is universally supported
+        // MJPEG doesn't require external codecs and always works with OpenCV
+        // Files will be larger but 100% compatible
+        int fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+        std::string extension = ".avi";
+        
+        // Create video writers (one file per stream, or rolling segments with a manifest)
+        VideoStreamWriter leftWriter, rightWriter, sideBySideWriter;
+        bool writeLeft = (config.cameraMode == "left" || config.cameraMode == "both_separate");
+        bool writeRight = (config.cameraMode == "right" || config.cameraMode == "both_separate");
+        bool writeSideBySide = (config.cameraMode == "side_by_side");
+        
+        SegmentedVideoConfig streamConfig;
+        streamConfig.directory = extractionPath;
+        streamConfig.extension = extension;
+        streamConfig.fourcc = fourcc;
+        streamConfig.fps = outputFps;
+        streamConfig.frameSize = cv::Size(props.width, props.height);
+        streamConfig.segmentSec = config.segmentSec;
+        auto onSegment = [](const VideoSegment& segment) {
+            if (segment.state == SegmentState::Complete) {
+                LOG_INFO("Video segment ready: " + segment.fileName + " (" + std::to_string(segment.frameCount) + " frames)");
+            }
+        };
+        
+        if (writeLeft) {
+            streamConfig.stem = "video_left";
+            if (leftWriter.open(streamConfig, onSegment).isFailure()) {
+                // SVOHandler auto-closes;
+                isRunning_ = false;
+                return ExtractionResult::Failure("Failed to create left video writer");
+            }
+        }
+        
+        if (writeRight) {
+            streamConfig.stem = "video_right";
+            if (rightWriter.open(streamConfig, onSegment).isFailure()) {
+                // SVOHandler auto-closes;
+                isRunning_ = false;
+                return ExtractionResult::Failure("Failed to create right video writer");
+            }
+        }
+        
+        if (writeSideBySide) {
+            streamConfig.stem = "video_side_by_side";
+            streamConfig.frameSize = cv::Size(props.width * 2, props.height);
+            if (sideBySideWriter.open(streamConfig, onSegment).isFailure()) {
+                // SVOHandler auto-closes;
+                isRunning_ = false;
+                return ExtractionResult::Failure("Failed to create side-by-side video writer");
+            }
+        }
+        
+        reportProgress(0.15f, "Video writers initialized", progressCallback);
+        
+        // Main extraction loop
+        sl::Mat image_zed_left, image_zed_right;
+        cv::Mat image_cv_left, image_cv_right, sideBySide;
+        int frameCount = 0;
+        
+        while (frameCount < props.totalFrames) {
+            if (shouldCancel()) {
+                leftWriter.release();
+                rightWriter.release();
+                sideBySideWriter.release();
+                // SVOHandler auto-closes;
+                archive();
+                isRunning_ = false;
+                return ExtractionResult::Failure("Extraction cancelled by user");
+            }
+            if (throttle) throttle->beforeFrame();
+            
+            if (!svo.grab()) {
+                // End of file reached
+                break;
+            }
+            if (readAhead) readAhead->notifyFrame(frameCount);
+            
+            // Retrieve left image
+            svo.retrieveImage(image_zed_left, sl::VIEW::LEFT);
+            cv::Mat image_cv_left_raw = slMat2cvMat(image_zed_left);
+            
+            // Convert BGRA to BGR if necessary (VideoWriter expects 3-channel BGR)
+            if (image_cv_left_raw.channels() == 4) {
+                cv::cvtColor(image_cv_left_raw, image_cv_left, cv::COLOR_BGRA2BGR);
+            } else {
+                image_cv_left = image_cv_left_raw;
+            }
+            
+            bool written = true;
+            if (writeLeft) {
+                written = leftWriter.write(image_cv_left) && written;
+            }
+            
+            if (writeRight || writeSideBySide) {
+                svo.retrieveImage(image_zed_right, sl::VIEW::RIGHT);
+                cv::Mat image_cv_right_raw = slMat2cvMat(image_zed_right);
+                
+                // Convert BGRA to BGR if necessary
+                if (image_cv_right_raw.channels() == 4) {
+                    cv::cvtColor(image_cv_right_raw, image_cv_right, cv::COLOR_BGRA2BGR);
+                } else {
+                    image_cv_right = image_cv_right_raw;
+                }
+                
+                if (writeRight) {
+                    written = rightWriter.write(image_cv_right) && written;
+                }
+                
+                if (writeSideBySide) {
+                    cv::hconcat(image_cv_left, image_cv_right, sideBySide);
+                    written = sideBySideWriter.write(sideBySide) && written;
+                }
+            }
+            
+            if (!written) {
+                // Later frames would be dropped silently; keep the finished part and fail the run
+                leftWriter.release();
+                rightWriter.release();
+                sideBySideWriter.release();
+                archive();
+                isRunning_ = false;
+                return ExtractionResult::Failure("Video writer stopped accepting frames at frame " +
+                                                 std::to_string(frameCount) + " (see log)");
+            }
+            
+            frameCount++;
+            
+            // Report progress every 10 frames
+            if (frameCount % 10 == 0) {
+                float progress = 0.15f + (0.85f * (frameCount / static_cast<float>(props.totalFrames)));
+                std::ostringstream msg;
+                msg << "Processing: " << frameCount << "/" << props.totalFrames << " frames";
+                reportProgress(progress, msg.str(), progressCallback);
+            }
+        }
+        
+        // Release resources (segmented output: waits for the last segments to be finalised).
+        // Every writer is released; the first failure fails the extraction
+        std::string releaseError;
+        for (VideoStreamWriter* writer : { &leftWriter, &rightWriter, &sideBySideWriter }) {
+            ErrorResult released = writer->release();
+            if (released.isFailure() && releaseError.empty()) releaseError = released.getMessage();
+        }
+        // SVOHandler auto-closes;
+        archive();
+        if (!releaseError.empty()) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to finalise video output: " + releaseError);
+        }
+        if (readAhead) LOG_INFO(readAhead->describeStats());
+        
+        isRunning_ = false;
+        reportProgress(1.0f, "Video extraction completed", progressCallback);
+        
+        return ExtractionResult::Success(outputMgr.getArchivePath(extractionPath), frameCount);
+        
+    } catch (const std::exception& e) {
+        isRunning_ = false;
+        return ExtractionResult::Failure(std::string("Exception: ") + e.what());
+    }
+}
+
+/**
+ * @brief Legacy motion mask: thresholded, dilated difference to the previous depth frame
+ * @return CV_8UC1 mask, or empty if there is no comparable previous frame
+ */
+static cv::Mat frameDifferenceMask(const cv::Mat& depth, const cv::Mat& prevDepth) {
+    if (prevDepth.empty() || prevDepth.size() != depth.size()) return cv::Mat();
+    cv::Mat diff;
+    cv::absdiff(depth, prevDepth, diff);
+    // Normalize diff within valid mask region
+    double maxDiff = 0.0; cv::minMaxLoc(diff, nullptr, &maxDiff);
+    if (maxDiff <= 1e-3) return cv::Mat();
+    cv::Mat diffNorm = diff / maxDiff; // 0..1
+    // Threshold and dilate to create salient region mask
+    cv::Mat motionMask;
+    cv::threshold(diffNorm, motionMask, 0.15, 1.0, cv::THRESH_BINARY);
+    motionMask.convertTo(motionMask, CV_8UC1, 255.0);
+    cv::dilate(motionMask, motionMask, cv::Mat(), cv::Point(-1,-1), 1);
+    return motionMask;
+}
+
+/**
+ * @brief Add nearest valid depth and valid-pixel share of a frame to the flight timeline
+ *
+ * A frame without valid pixels leaves a gap in the nearest-distance series.
+ */
+static void recordDepthFrameStats(FlightTimeline& timeline, int frame, const cv::Mat& depth) {
+    if (depth.type() != CV_32FC1 || depth.empty()) return;
+    const float inf = std::numeric_limits<float>::infinity();
+    const float maxZ = std::numeric_limits<float>::max();
+    float nearest = inf;
+    size_t valid = 0;
+    std::mutex merge;
+    // Row bands reduce locally; the comparison also rejects NaN and inf, so the inner loop stays branch-free
+    zed_tools::parallelFor(0, depth.rows, [&](int rowBegin, int rowEnd) {
+        float bandNearest = inf;
+        size_t bandValid = 0;
+        for (int r = rowBegin; r < rowEnd; ++r) {
+            const float* row = depth.ptr<float>(r);
+            for (int c = 0; c < depth.cols; ++c) {
+                const float z = row[c];
+                const bool ok = (z > 0.0f) & (z <= maxZ);
+                bandValid += ok;
+                bandNearest = std::min(bandNearest, ok ? z : inf);
+            }
+        }
+        std::lock_guard<std::mutex> lock(merge);
+        valid += bandValid;
+        nearest = std::min(nearest, bandNearest);
+    }, 32);
+    timeline.validFraction.append(frame, 100.0f * static_cast<float>(valid) / static_cast<float>(depth.total()));
+    if (valid > 0) timeline.nearestDistance.append(frame, nearest);
+}
+
+/**
+ * @brief Blend masked heatmap pixels toward white
+ */
+static void applyMotionHighlight(cv::Mat& heatmap, const cv::Mat& motionMask, float gain) {
+    if (motionMask.empty() || cv::countNonZero(motionMask) == 0) return;
+    cv::Mat white(heatmap.size(), heatmap.type(), cv::Scalar(255, 255, 255));
+    cv::Mat blended;
+    cv::addWeighted(heatmap, 1.0f - gain, white, gain, 0.0, blended);
+    blended.copyTo(heatmap, motionMask);
+}
+
+/**
+ * @brief Draw confirmed track boxes with ID, distance and closing speed
+ */
+static void drawTrackOverlay(cv::Mat& image, const std::vector<TrackState>& tracks) {
+    for (const auto& t : tracks) {
+        cv::Rect box(t.box.x, t.box.y, t.box.width, t.box.height);
+        cv::rectangle(image, box, cv::Scalar(255, 255, 255), 2);
+        char label[64];
+        std::snprintf(label, sizeof(label), "#%d %.1fm %+.1fm/s", t.id, t.z, t.closingSpeed());
+        cv::putText(image, label, cv::Point(box.x, std::max(12, box.y - 4)),
+                    cv::FONT_HERSHEY_SIMPLEX, 0.5, cv::Scalar(255, 255, 255), 1, cv::LINE_AA);
+    }
+}
+
+/**
+ * @brief Hierarchical (coarse-to-fine) visiting order for count selected frames
+ *
+ * Visits 0, then multiples of the largest power-of-two stride, then the
+ * multiples of each halved stride not yet visited (every 256th, every 128th, ...).
+ * Any prefix of the order is spread evenly over the whole range.
+ */
+static std::vector<int> buildCoarseToFineOrder(int count) {
+    std::vector<int> order;
+    if (count <= 0) return order;
+    order.reserve(count);
+    int stride = 1;
+    while (stride * 2 < count) stride *= 2;
+    for (int i = 0; i < count; i += stride) order.push_back(i);
+    for (; stride > 1; stride /= 2) {
+        // Odd multiples of stride/2 are exactly the frames new at this level
+        int half = stride / 2;
+        for (int i = half; i < count; i += stride) order.push_back(i);
+    }
+    return order;
+}
+
+/**
+ * @brief Get ZED depth mode from string
+ */
+static sl::DEPTH_MODE getDepthMode(const std::string& mode) {
+    if (mode == "PERFORMANCE") return sl::DEPTH_MODE::PERFORMANCE;
+    if (mode == "QUALITY") return sl::DEPTH_MODE::QUALITY;
+    if (mode == "ULTRA") return sl::DEPTH_MODE::ULTRA;
+    if (mode == "NEURAL") return sl::DEPTH_MODE::NEURAL;
+    if (mode == "NEURAL_PLUS") return sl::DEPTH_MODE::NEURAL_PLUS;
+    return sl::DEPTH_MODE::NEURAL;  // Default to NEURAL
+}
+
+ExtractionResult ExtractionEngine::runExtractDepth(
+    const DepthExtractionConfig& requestedConfig,
+    ProgressCallback progressCallback
+) {
+    if (isRunning_) {
+        return ExtractionResult::Failure("Extraction already in progress");
+    }
+
+    // Lazy heatmaps: store what LazyHeatmapRenderer needs, render nothing to disk now
+    DepthExtractionConfig config = requestedConfig;
+    if (config.lazyHeatmaps) {
+        config.saveRawDepth = true;
+        config.saveColorized = false;
+        config.saveVideo = false;
+        if (config.overlayOnRgb) config.saveRgbFrames = true;
+        // The confidence threshold is applied at render time, so the maps must be on disk
+        if (config.confidenceThreshold < 100) config.saveConfidenceMaps = true;
+        std::string fmt = config.rawDepthFormat;
+        std::transform(fmt.begin(), fmt.end(), fmt.begin(), ::tolower);
+        if (fmt == "bin") {
+            LOG_WARNING("Lazy heatmaps need a readable raw depth format; writing tiff32f instead of bin");
+            config.rawDepthFormat = "tiff32f";
+        }
+        if (config.useTemporalSmooth || config.highlightMotion || config.enableTracking || config.useGroundPlane) {
+            LOG_WARNING("Lazy heatmaps are rendered per frame: temporal smoothing, motion highlight, track boxes and ground masking are not reproduced");
+        }
+    }
+    
+    isRunning_ = true;
+    cancelRequested_ = false;
+    if (config.workerThreads > 0 && !ThreadPool::configureGlobal(config.workerThreads)) {
+        LOG_INFO("Worker thread count is fixed once the shared pool runs (or by ZED_EXTRACTOR_THREADS); keeping " +
+                 std::to_string(ThreadPool::global().getConcurrency()));
+    }
+    auto throttle = makeBackgroundThrottle(config.lowPriority, config.maxProcessFps, config.maxWriteMBps,
+                                           [this] { return shouldCancel(); });
+    
+    try {
+        reportProgress(0.0f, "Initializing depth extraction...", progressCallback);
+        
+    // Configure camera with depth mode
+        sl::InitParameters initParams;
+        initParams.input.setFromSVOFile(config.svoFilePath.c_str());
+        initParams.depth_mode = getDepthMode(config.depthMode);
+        initParams.coordinate_units = sl::UNIT::METER;
+        initParams.depth_stabilization = true;
+    // Ensure offline playback processes every frame without real-time dropping
+    initParams.svo_real_time_mode = false;
+        
+    sl::Camera camera;
+        sl::ERROR_CODE err = camera.open(initParams);
+        if (err != sl::ERROR_CODE::SUCCESS) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to open SVO file with depth mode: " + 
+                                           std::string(sl::toString(err).c_str()));
+        }
+        
+        reportProgress(0.05f, "SVO file opened with depth mode: " + config.depthMode, progressCallback);
+        
+    // Get SVO properties
+    int totalFrames = camera.getSVONumberOfFrames(); // May return 0/1 early; loop will rely on END_OF_SVOFILE_REACHED
+        sl::CameraInformation camInfo = camera.getCameraInformation();
+        int width = camInfo.camera_configuration.resolution.width;
+        int height = camInfo.camera_configuration.resolution.height;
+        float sourceFps = camera.getCameraInformation().camera_configuration.fps;
+        
+        // Get flight folder name from SVO path
+        std::string svoPath = config.svoFilePath;
+        std::replace(svoPath.begin(), svoPath.end(), '\\', '/');
+        
+        size_t lastSlash = svoPath.find_last_of('/');
+        std::string parentFolder = (lastSlash != std::string::npos) ? svoPath.substr(0, lastSlash) : "";
+        
+        std::string flightFolderName = "unknown_flight";
+        if (!parentFolder.empty()) {
+            size_t folderNameStart = parentFolder.find_last_of('/');
+            std::string folderName = (folderNameStart != std::string::npos) 
+                ? parentFolder.substr(folderNameStart + 1) 
+                : parentFolder;
+            
+            if (FileUtils::isFlightFolder(folderName)) {
+                flightFolderName = folderName;
+            }
+        }
+        
+        reportProgress(0.08f, "Detected flight: " + flightFolderName, progressCallback);
+        
+    // Setup output manager
+        OutputManager outputMgr(config.baseOutputPath);
+        if (!prepareStaging(outputMgr, config.scratchPath, config.scratchLimitGB, progressCallback)) {
+            camera.close();
+            isRunning_ = false;
+            return ExtractionResult::Failure("Extraction cancelled by user");
+        }
+    std::string extractionPath = outputMgr.getExtractionPath(flightFolderName, OutputType::DEPTH);
+    lastExtractionPath_ = extractionPath;
+    lastArchivePath_ = outputMgr.isStaging() ? outputMgr.getArchivePath(extractionPath) : "";
+        
+        if (extractionPath.empty()) {
+            camera.close();
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to create extraction directory");
+        }
+        // A staged folder is handed to the migrator exactly once, also on exceptions, so it
+        // is archived and stops counting against the scratch limit
+        bool archived = false;
+        auto archive = [&]() {
+            if (archived) return;
+            archived = true;
+            archiveExtraction(outputMgr, extractionPath);
+        };
+        ScopeExit archiveOnExit(archive);
+        
+    // Create subdirectories
+    std::string depthDir = extractionPath + "/depth_maps";
+    std::string heatmapDir = extractionPath + "/depth_heatmaps";
+    std::string rgbDir = extractionPath + "/left_rgb";
+    std::string confDir = extractionPath + "/confidence_maps";
+        FileUtils::createDirectory(depthDir);
+        FileUtils::createDirectory(heatmapDir);
+    if (config.saveRgbFrames) FileUtils::createDirectory(rgbDir);
+    if (config.saveConfidenceMaps) FileUtils::createDirectory(confDir);
+    // Heatmaps, RGB cache and confidence maps: PNG for interchange, QOI when our own tools read them back
+    std::string imageExt = imageExtension(config.imageFormat);
+    if (imageExt != ".png" && imageExt != ".qoi") {
+        LOG_WARNING("Unsupported image format '" + config.imageFormat + "', using png");
+        imageExt = ".png";
+    }
+
+        // Stream outputs to object storage as they are produced
+        std::unique_ptr<ObjectStoreSink> uploader;
+        if (!config.uploadUrl.empty()) {
+            ObjectStoreConfig storeConfig;
+            ErrorResult parsed = ObjectStoreConfig::fromUrl(config.uploadUrl, storeConfig);
+            if (parsed.isSuccessful) {
+                storeConfig.workers = config.uploadWorkers;
+                uploader = std::make_unique<ObjectStoreSink>();
+                parsed = uploader->open(storeConfig);
+            }
+            if (!parsed.isSuccessful) {
+                camera.close();
+                isRunning_ = false;
+                return ExtractionResult::Failure("Upload sink: " + parsed.message);
+            }
+        }
+        // Any exit from here on (error return, exception) drains the uploads and writes the
+        // manifest of what was committed; the regular paths call finish() themselves first.
+        // Declared after the archive guard, so uploads are drained before the folder moves
+        ScopeExit finishUploads([&]() {
+            if (!uploader || !uploader->isOpen()) return;
+            ErrorResult finished = uploader->finish();
+            if (!finished.isSuccessful) LOG_WARNING("Upload incomplete: " + finished.message);
+        });
+        const bool keepLocal = !uploader || config.uploadKeepLocal;
+        // Keys mirror the local layout: <flight>/<extraction_NNN>/<relative path>
+        const std::string uploadKeyRoot = flightFolderName + "/" +
+            extractionPath.substr(extractionPath.find_last_of("/\\") + 1);
+        auto uploadKey = [&](const std::string& path) {
+            return uploadKeyRoot + path.substr(extractionPath.size());
+        };
+        // Write and/or upload an image product; encodes in memory when no local copy is kept
+        auto storeImage = [&](const std::string& path, const cv::Mat& image) -> bool {
+            if (!keepLocal) {
+                std::vector<uchar> encoded;
+                if (!encodeImage(path.substr(path.find_last_of('.')), image, encoded)) return false;
+                if (throttle) throttle->onBytesWritten(encoded.size());
+                return uploader->enqueueBuffer(uploadKey(path), std::move(encoded));
+            }
+            if (!writeImageFile(path, image)) return false;
+            if (throttle) throttle->onFileWritten(path);
+            if (uploader) uploader->enqueueFile(path, uploadKey(path), false);
+            return true;
+        };
+        // Upload a finished file; the local copy is removed once committed unless kept
+        auto publishFile = [&](const std::string& path) {
+            if (uploader) uploader->enqueueFile(path, uploadKey(path), !keepLocal);
+        };
+        
+        if (config.lazyHeatmaps) {
+            DepthVisualizationConfig viz;
+            viz.minDepth = config.minDepth;
+            viz.maxDepth = config.maxDepth;
+            viz.autoContrast = config.autoContrast;
+            viz.confidenceThreshold = config.confidenceThreshold;
+            viz.logScale = config.logScale;
+            viz.useEdgeBoost = config.useEdgeBoost;
+            viz.edgeBoostFactor = config.edgeBoostFactor;
+            viz.useClahe = config.useClahe;
+            viz.colorMap = config.colorMap;
+            viz.overlayOnRgb = config.overlayOnRgb;
+            viz.overlayStrength = config.overlayStrength;
+            viz.imageFormat = imageExt.substr(1);
+            viz.videoFps = config.outputFps;
+            const std::string vizPath = extractionPath + "/depth_visualization.json";
+            if (viz.saveToJSON(vizPath)) {
+                publishFile(vizPath);
+            } else {
+                LOG_WARNING("Failed to write " + vizPath);
+            }
+        }
+
+        reportProgress(0.1f, "Output directories created", progressCallback);
+        
+        // Calculate frame interval
+        int frameInterval = std::max(1, static_cast<int>(std::round(sourceFps / config.outputFps)));
+
+        // Coarse-to-fine scheduling: seek to each selected frame in hierarchical order
+        bool coarseToFine = (config.frameOrder == "coarse_to_fine");
+        std::vector<int> visitOrder;
+        size_t visitPos = 0;
+        if (coarseToFine) {
+            if (totalFrames <= 1) {
+                LOG_WARNING("SVO frame count unknown; coarse_to_fine order falls back to sequential");
+                coarseToFine = false;
+            } else {
+                int selectedCount = (totalFrames + frameInterval - 1) / frameInterval;
+                visitOrder = buildCoarseToFineOrder(selectedCount);
+                if (config.followMode) {
+                    LOG_WARNING("Follow mode is ignored with coarse_to_fine frame order");
+                }
+                if (config.useTemporalSmooth || config.highlightMotion || config.useBackgroundModel ||
+                    config.enableTracking || config.saveVideo) {
+                    LOG_WARNING("Temporal smoothing, motion highlight, background model, tracking and heatmap video need consecutive frames; disabled for coarse_to_fine order");
+                }
+            }
+        }
+        const bool useTemporalSmooth = config.useTemporalSmooth && !coarseToFine;
+        const bool highlightMotion = config.highlightMotion && !coarseToFine;
+        const bool saveVideo = config.saveVideo && !coarseToFine;
+
+        // Coarse-to-fine seeks: prefetch a GOP-sized run of frames up to each selected frame
+        auto readAhead = makeReadAhead(config.svoFilePath, config.readAheadMB, totalFrames);
+        if (readAhead && coarseToFine) {
+            std::vector<std::pair<int, int>> ranges;
+            ranges.reserve(visitOrder.size());
+            for (int index : visitOrder) {
+                const int frame = index * frameInterval;
+                ranges.emplace_back(std::max(0, frame - kReadAheadLookbehindFrames), frame);
+            }
+            readAhead->setRandomPlan(ranges);
+        }
+
+        // Per-pixel background model (needs consecutive frames like the EMA)
+        std::unique_ptr<DepthBackgroundModel> backgroundModel;
+        if (config.useBackgroundModel && !coarseToFine) {
+            BackgroundModelConfig bgConfig;
+            bgConfig.alpha = config.backgroundAlpha;
+            bgConfig.kSigma = config.backgroundKSigma;
+            backgroundModel = std::make_unique<DepthBackgroundModel>(bgConfig);
+        }
+
+        // Blob detection + tracking on every grabbed frame (needs consecutive frames)
+        std::unique_ptr<DepthBlobDetector> blobDetector;
+        std::unique_ptr<ObjectTracker> tracker;
+        std::ofstream tracksFile;
+        std::string tracksPath;
+        std::vector<DepthDetection> detections;
+        std::vector<TrackerMeasurement> measurements;
+        std::vector<TrackState> trackStates;
+        float detMinDistance = std::numeric_limits<float>::max();
+        float detMaxDistance = 0.0f;
+        double detDistanceSum = 0.0;
+        int detCount = 0;
+        int framesWithDetections = 0;
+        if (config.enableTracking && !coarseToFine) {
+            BlobDetectorConfig detConfig;
+            detConfig.maxRange = config.trackMaxRange;
+            detConfig.minPixels = config.trackMinBlobPixels;
+            blobDetector = std::make_unique<DepthBlobDetector>(detConfig);
+            tracker = std::make_unique<ObjectTracker>();
+            tracksPath = extractionPath + "/tracks.csv";
+            tracksFile.open(tracksPath);
+            if (tracksFile.is_open()) {
+                tracksFile << "frame,timestamp_ns,track_id,x,y,width,height,distance_m,closing_speed_mps\n";
+            } else {
+                LOG_WARNING("Failed to create track file: " + tracksPath);
+                tracksPath.clear();
+            }
+        }
+
+        // Timeline series need increasing frame indices, so coarse-to-fine runs collect none
+        const bool collectStats = config.collectFrameStats && !coarseToFine;
+
+        // Left-camera intrinsics for back-projection (depth is in the left image)
+        CameraIntrinsics intrinsics;
+        {
+            const auto& leftCam = camInfo.camera_configuration.calibration_parameters.left_cam;
+            intrinsics.fx = leftCam.fx;
+            intrinsics.fy = leftCam.fy;
+            intrinsics.cx = leftCam.cx;
+            intrinsics.cy = leftCam.cy;
+        }
+
+        // Ground plane, warm-started frame to frame
+        std::unique_ptr<GroundPlaneEstimator> groundEstimator;
+        GroundPlane groundPlane;
+        int groundPlaneFrames = 0;
+        double cameraHeightSum = 0.0;
+        if (config.useGroundPlane) {
+            GroundPlaneConfig gpConfig;
+            gpConfig.maxRange = std::max(config.maxDepth, config.trackMaxRange);
+            gpConfig.objectMinHeight = config.objectMinHeight;
+            groundEstimator = std::make_unique<GroundPlaneEstimator>(gpConfig);
+        }
+
+        // Sparse flow between consecutive grabbed frames (needs consecutive frames)
+        std::unique_ptr<SparseMotionFlow> sparseFlow;
+        int flowMotionFrames = 0;
+        if (config.useSparseFlow && !coarseToFine) {
+            SparseFlowConfig flowConfig;
+            flowConfig.residualThreshold = config.flowResidualThreshold;
+            sparseFlow = std::make_unique<SparseMotionFlow>(flowConfig);
+        }
+
+        // Bird's-eye grid of exported frames, optionally world-aligned by positional tracking
+        std::unique_ptr<OccupancyGrid> occupancyGrid;
+        std::string gridDir;
+        std::string flightGridPath;
+        bool gridUsePose = false;
+        if (config.saveOccupancyGrid) {
+            OccupancyGridConfig gridConfig;
+            gridConfig.mode = (config.occupancyMode == "height") ? GridMode::HEIGHT : GridMode::OCCUPANCY;
+            gridConfig.cellSize = config.occupancyCellSize;
+            gridConfig.maxRange = config.maxDepth;
+            if (config.occupancyUsePose && !coarseToFine) {
+                // Tracking integrates every grabbed frame, so it cannot follow coarse-to-fine seeks
+                sl::ERROR_CODE ptEc = camera.enablePositionalTracking(sl::PositionalTrackingParameters());
+                if (ptEc == sl::ERROR_CODE::SUCCESS) {
+                    gridUsePose = true;
+                } else {
+                    LOG_WARNING("Positional tracking unavailable, occupancy grid stays in camera frame: " +
+                                std::string(sl::toString(ptEc).c_str()));
+                }
+            }
+            if (gridUsePose) {
+                gridConfig.xMin = -config.occupancyWorldExtent;
+                gridConfig.xMax = config.occupancyWorldExtent;
+                gridConfig.zMin = -config.occupancyWorldExtent;
+                gridConfig.zMax = config.occupancyWorldExtent;
+            } else {
+                gridConfig.xMin = -config.maxDepth * 0.5f;
+                gridConfig.xMax = config.maxDepth * 0.5f;
+                gridConfig.zMin = 0.0f;
+                gridConfig.zMax = config.maxDepth;
+            }
+            occupancyGrid = std::make_unique<OccupancyGrid>(gridConfig);
+            gridDir = extractionPath + "/occupancy_grid";
+            FileUtils::createDirectory(gridDir);
+        }
+        const auto startTime = std::chrono::steady_clock::now();
+        bool budgetExhausted = false;
+        
+        // Prepare video writer if requested
+        cv::VideoWriter videoWriter;
+        if (saveVideo) {
+            std::string videoPath = extractionPath + "/depth_heatmap.avi";
+            int fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+            videoWriter.open(videoPath, fourcc, config.outputFps, cv::Size(width, height), true);
+            
+            if (!videoWriter.isOpened()) {
+                camera.close();
+                isRunning_ = false;
+                return ExtractionResult::Failure("Failed to create depth video writer");
+            }
+        }
+        
+        reportProgress(0.15f, "Starting depth extraction...", progressCallback);
+
+        // Reset stored previews
+        {
+            std::lock_guard<std::mutex> lk(previewMutex_);
+            storedPreviews_.clear();
+            storedFrameIndices_.clear();
+            storedOutputIndices_.clear();
+            lazyPreviews_ = config.lazyHeatmaps;
+            storedPreviewMaxWidth_ = config.previewMaxWidth;
+        }
+        timeline_.clear();
+        
+    // Main extraction loop
+    sl::Mat depthZed;
+    sl::Mat leftImageZed; // for overlay
+    cv::Mat emaDepth;     // temporal smoothing
+        int frameCount = 0;
+        int extractedCount = 0;
+        
+    sl::RuntimeParameters runtime_params;
+    runtime_params.confidence_threshold = config.confidenceThreshold; // drives internal filtering
+    runtime_params.texture_confidence_threshold = 100;
+        
+    cv::Mat prevDepthForMotion; // store previous depth for motion highlighting
+
+    // Follow mode: EOF means "wait for more data"; all loop state above is carried across reopens
+    std::unique_ptr<FileGrowthWatcher> followWatcher;
+    if (config.followMode && !coarseToFine) {
+        followWatcher = std::make_unique<FileGrowthWatcher>(config.svoFilePath, config.followPollMs);
+        LOG_INFO(std::string("Follow mode enabled (") +
+                 (followWatcher->usesNotifications() ? "file notifications" : "polling") + ")");
+    }
+    int lastGrabbedPosition = -1;
+    for (;;) {
+            if (shouldCancel()) {
+                videoWriter.release();
+                if (gridUsePose) camera.disablePositionalTracking();
+                camera.close();
+                if (uploader) uploader->finish();   // Outputs so far stay consistent with the manifest
+                archive();
+                isRunning_ = false;
+                return ExtractionResult::Failure("Extraction cancelled by user");
+            }
+
+            if (config.timeBudgetSec > 0.0f &&
+                std::chrono::duration<float>(std::chrono::steady_clock::now() - startTime).count() >= config.timeBudgetSec) {
+                budgetExhausted = true;
+                LOG_INFO("Time budget of " + std::to_string(config.timeBudgetSec) + "s reached after " +
+                         std::to_string(extractedCount) + " depth maps");
+                break;
+            }
+            if (throttle) throttle->beforeFrame();
+
+            // File index of this frame's outputs; equals the sequential extraction number
+            int outputIndex = extractedCount;
+            if (coarseToFine) {
+                if (visitPos >= visitOrder.size()) break;
+                outputIndex = visitOrder[visitPos++];
+                frameCount = outputIndex * frameInterval;
+                camera.setSVOPosition(frameCount);
+            }
+
+            // Debug: emit a warning if we loop too few times (helps diagnose immediate termination)
+            // We only log the first 3 grab attempts to avoid flooding.
+            if (frameCount < 3) {
+                LOG_INFO("Depth loop iteration (pre-grab) frameCount=" + std::to_string(frameCount));
+            }
+            
+            // Grab frame
+            sl::ERROR_CODE grabEc = camera.grab(runtime_params);
+            if (grabEc == sl::ERROR_CODE::END_OF_SVOFILE_REACHED) {
+                if (coarseToFine) continue; // frame count estimate overshot; try the next one
+                if (followWatcher) {
+                    float denom = (totalFrames > 1 ? static_cast<float>(totalFrames) : static_cast<float>(frameCount + 1));
+                    float progress = std::min(1.0f, 0.15f + (0.85f * (frameCount / denom)));
+                    if (waitForSvoGrowth(*followWatcher, config.followIdleTimeoutSec, progress, progressCallback)) {
+                        // The SDK indexes the file at open, so reopen to see appended frames
+                        camera.close();
+                        sl::ERROR_CODE reopenEc = camera.open(initParams);
+                        if (reopenEc != sl::ERROR_CODE::SUCCESS) {
+                            LOG_WARNING("Follow mode: failed to reopen SVO: " + std::string(sl::toString(reopenEc).c_str()));
+                            break;
+                        }
+                        camera.setSVOPosition(lastGrabbedPosition + 1);
+                        totalFrames = std::max(totalFrames, camera.getSVONumberOfFrames());
+                        if (gridUsePose) {
+                            // Tracking restarts at the reopen; the world grid stays consistent only up to it
+                            camera.enablePositionalTracking(sl::PositionalTrackingParameters());
+                        }
+                        continue;
+                    }
+                    break;
+                }
+                if (frameCount == 0 && extractedCount == 0) {
+                    // Immediate end-of-file on first grab: likely wrong path (opened live camera instead of SVO)
+                    LOG_ERROR("END_OF_SVOFILE_REACHED on first grab. Check that selected path is a valid .svo/.svo2 file: " + config.svoFilePath);
+                }
+                break; // normal termination
+            }
+            if (grabEc != sl::ERROR_CODE::SUCCESS) {
+                // Transient read error: try next iteration
+                if (frameCount < 3) {
+                    LOG_WARNING("Transient grab error: " + std::string(sl::toString(grabEc).c_str()));
+                }
+                continue;
+            }
+            lastGrabbedPosition = camera.getSVOPosition();
+            if (readAhead) readAhead->notifyFrame(lastGrabbedPosition);
+
+            // Per-frame analysis runs on every grabbed frame, exported or not
+            cv::Mat depthFloat;
+            cv::Mat foregroundMask;
+            cv::Mat groundMask, skyMask, objectMask;
+            cv::Mat flowMask;
+            if (sparseFlow) {
+                camera.retrieveImage(leftImageZed, sl::VIEW::LEFT);
+                if (sparseFlow->process(slMat2cvMat(leftImageZed), flowMask) > 0) ++flowMotionFrames;
+            }
+            bool depthRetrieved = false;
+            if (backgroundModel || tracker || groundEstimator) {
+                camera.retrieveMeasure(depthZed, sl::MEASURE::DEPTH);
+                depthFloat = slMat2cvMat(depthZed);
+                depthRetrieved = true;
+                if (!depthFloat.empty()) {
+                    // Ground plane every frame keeps the warm start close to the current pose
+                    if (groundEstimator && groundEstimator->estimate(depthFloat, intrinsics, groundPlane)) {
+                        ++groundPlaneFrames;
+                        cameraHeightSum += groundPlane.d;
+                    }
+                    // Classify against the background model, then learn this frame
+                    if (backgroundModel) {
+                        backgroundModel->update(depthFloat, foregroundMask);
+                    }
+                    if (tracker) {
+                        // With a background model only moving blobs are candidates;
+                        // with a ground plane only blobs standing above the ground
+                        cv::Mat detectMask = foregroundMask;
+                        if (groundPlane.valid) {
+                            groundEstimator->buildMasks(depthFloat, intrinsics, groundPlane, groundMask, skyMask, objectMask);
+                            detectMask = foregroundMask.empty() ? objectMask : (foregroundMask & objectMask);
+                        }
+                        blobDetector->detect(depthFloat, detectMask, detections);
+                        measurements.clear();
+                        for (const auto& d : detections) {
+                            TrackerMeasurement m;
+                            m.u = d.centroid.x; m.v = d.centroid.y; m.z = d.distance;
+                            m.box = { d.bbox.x, d.bbox.y, d.bbox.width, d.bbox.height };
+                            measurements.push_back(m);
+                            // Statistics use the detection distance the tracker sees (blob mean depth)
+                            detMinDistance = std::min(detMinDistance, d.distance);
+                            detMaxDistance = std::max(detMaxDistance, d.distance);
+                            detDistanceSum += d.distance;
+                            ++detCount;
+                        }
+                        if (!detections.empty()) ++framesWithDetections;
+                        uint64_t ts = camera.getTimestamp(sl::TIME_REFERENCE::IMAGE).getNanoseconds();
+                        tracker->update(ts, measurements, trackStates);
+                        for (const auto& t : trackStates) {
+                            tracksFile << lastGrabbedPosition << ',' << ts << ',' << t.id << ','
+                                       << t.box.x << ',' << t.box.y << ',' << t.box.width << ',' << t.box.height << ','
+                                       << t.z << ',' << t.closingSpeed() << '\n';
+                        }
+                    }
+                    // Analysed frames feed the timeline at the full grab rate
+                    if (collectStats) {
+                        recordDepthFrameStats(timeline_, frameCount, depthFloat);
+                        if (tracker) timeline_.detectionCount.append(frameCount, static_cast<float>(detections.size()));
+                    }
+                }
+            }
+            
+            // Only extract at specified interval
+            if (!coarseToFine && frameInterval > 1 && (frameCount % frameInterval) != 0) {
+                frameCount++;
+                continue;
+            }
+            
+            // Retrieve depth and confidence maps
+            if (!depthRetrieved) {
+                camera.retrieveMeasure(depthZed, sl::MEASURE::DEPTH);
+                depthFloat = slMat2cvMat(depthZed);
+            }
+            sl::Mat confidenceZed;
+            camera.retrieveMeasure(confidenceZed, sl::MEASURE::CONFIDENCE);
+            cv::Mat confidenceCv = slMat2cvMat(confidenceZed);
+
+            if (depthFloat.empty()) {
+                frameCount++;
+                continue;
+            }
+            if (collectStats && !depthRetrieved) recordDepthFrameStats(timeline_, frameCount, depthFloat);
+
+            // Masks for the colorizer (built above only if the tracker needed them)
+            cv::Mat heatmapExclude;
+            if (groundPlane.valid && config.maskGroundInHeatmap) {
+                if (groundMask.empty()) {
+                    groundEstimator->buildMasks(depthFloat, intrinsics, groundPlane, groundMask, skyMask, objectMask);
+                }
+                heatmapExclude = groundMask | skyMask;
+            }
+
+            cv::Mat leftBgr;
+            if (config.overlayOnRgb) {
+                camera.retrieveImage(leftImageZed, sl::VIEW::LEFT);
+                cv::Mat leftRaw = slMat2cvMat(leftImageZed);
+                if (!leftRaw.empty()) {
+                    if (leftRaw.channels() == 4) {
+                        cv::cvtColor(leftRaw, leftBgr, cv::COLOR_BGRA2BGR);
+                    } else if (leftRaw.channels() == 3) {
+                        leftBgr = leftRaw;
+                    } else if (leftRaw.channels() == 1) {
+                        cv::cvtColor(leftRaw, leftBgr, cv::COLOR_GRAY2BGR);
+                    }
+                }
+            }
+            
+            // Bird's-eye grid of this frame
+            if (occupancyGrid) {
+                GridPose gridPose;
+                const GridPose* posePtr = nullptr;
+                if (gridUsePose) {
+                    sl::Pose camPose;
+                    if (camera.getPosition(camPose, sl::REFERENCE_FRAME::WORLD) == sl::POSITIONAL_TRACKING_STATE::OK) {
+                        sl::Rotation rot = camPose.getRotationMatrix();
+                        sl::Translation tr = camPose.getTranslation();
+                        for (int k = 0; k < 9; ++k) gridPose.r[k] = rot.r[k];
+                        gridPose.t[0] = tr.x; gridPose.t[1] = tr.y; gridPose.t[2] = tr.z;
+                        posePtr = &gridPose;
+                    }
+                }
+                // Without a pose fix a world grid would smear the frame at the origin; skip it
+                if (!gridUsePose || posePtr) {
+                    occupancyGrid->addFrame(depthFloat, intrinsics, posePtr);
+                    std::ostringstream gridName;
+                    gridName << gridDir << "/grid_" << std::setw(6) << std::setfill('0') << outputIndex << ".png";
+                    if (!storeImage(gridName.str(), occupancyGrid->getFrameGrid())) {
+                        LOG_WARNING("Failed to write occupancy grid: " + gridName.str());
+                    }
+                }
+            }
+
+            // Save raw depth if requested; support multiple formats
+            if (config.saveRawDepth) {
+                static bool s_exrWriteAllowed = true;
+                static bool s_exrWarnedOnce = false;
+                std::string fmt = config.rawDepthFormat;
+                std::transform(fmt.begin(), fmt.end(), fmt.begin(), ::tolower);
+                if (fmt == "auto" || fmt == "exr") {
+                    if (s_exrWriteAllowed) {
+                        std::ostringstream filenameRaw;
+                        filenameRaw << "depth_" << std::setw(6) << std::setfill('0') << outputIndex << ".exr";
+                        std::string rawPath = depthDir + "/" + filenameRaw.str();
+                        try {
+#if CV_VERSION_MAJOR >= 4
+                            if (cv::haveImageWriter(".exr")) {
+                                if (!storeImage(rawPath, depthFloat)) {
+                                    LOG_WARNING("OpenCV failed to write EXR: " + rawPath);
+                                    s_exrWriteAllowed = false;
+                                }
+                            } else {
+                                if (!s_exrWarnedOnce) {
+                                    LOG_WARNING("OpenEXR codec disabled; skipping EXR saves for this run.");
+                                    s_exrWarnedOnce = true;
+                                }
+                                s_exrWriteAllowed = false;
+                            }
+#else
+                            storeImage(rawPath, depthFloat);
+#endif
+                        } catch (const std::exception& e) {
+                            if (!s_exrWarnedOnce) {
+                                LOG_WARNING(std::string("EXR write error; disabling further EXR saves: ") + e.what());
+                                s_exrWarnedOnce = true;
+                            }
+                            s_exrWriteAllowed = false;
+                        }
+                    }
+                } else if (fmt == "tiff32f" || fmt == "tiff") {
+                    std::ostringstream filenameRaw;
+                    filenameRaw << "depth_" << std::setw(6) << std::setfill('0') << outputIndex << ".tiff";
+                    std::string rawPath = depthDir + "/" + filenameRaw.str();
+                    try {
+                        if (!storeImage(rawPath, depthFloat)) {
+                            LOG_WARNING("Failed to write TIFF 32F: " + rawPath);
+                        }
+                    } catch (const std::exception& e) {
+                        LOG_WARNING(std::string("TIFF write error: ") + e.what());
+                    }
+                } else if (fmt == "pfm") {
+                    std::ostringstream filenameRaw;
+                    filenameRaw << "depth_" << std::setw(6) << std::setfill('0') << outputIndex << ".pfm";
+                    std::string rawPath = depthDir + "/" + filenameRaw.str();
+                    if (writePFM(rawPath, depthFloat)) {
+                        if (throttle) throttle->onFileWritten(rawPath);
+                        publishFile(rawPath);
+                    } else {
+                        LOG_WARNING("Failed to write PFM: " + rawPath);
+                    }
+                } else if (fmt == "bin") {
+                    std::ostringstream filenameRaw;
+                    filenameRaw << "depth_" << std::setw(6) << std::setfill('0') << outputIndex << ".bin";
+                    std::string rawPath = depthDir + "/" + filenameRaw.str();
+#ifdef _WIN32
+                    FILE* f = nullptr; fopen_s(&f, rawPath.c_str(), "wb");
+#else
+                    FILE* f = fopen(rawPath.c_str(), "wb");
+#endif
+                    if (f) {
+                        fwrite(depthFloat.ptr<float>(0), sizeof(float), (size_t)depthFloat.total(), f);
+                        fclose(f);
+                        if (throttle) throttle->onFileWritten(rawPath);
+                        publishFile(rawPath);
+                    } else {
+                        LOG_WARNING("Failed to open for BIN write: " + rawPath);
+                    }
+                }
+            }
+
+            // Optionally save left RGB for fast re-render overlay
+            if (config.saveRgbFrames && !leftBgr.empty()) {
+                std::ostringstream lf;
+                lf << rgbDir << "/left_" << std::setw(6) << std::setfill('0') << outputIndex << imageExt;
+                try { storeImage(lf.str(), leftBgr); } catch (...) {}
+            }
+            // Optionally save the confidence map, 8-bit with the fixed scale LazyHeatmapRenderer reads back
+            if (config.saveConfidenceMaps && !confidenceCv.empty()) {
+                cv::Mat conf8;
+                confidenceCv.convertTo(conf8, CV_8UC1, kStoredConfidenceScale);
+                std::ostringstream cf;
+                cf << confDir << "/conf_" << std::setw(6) << std::setfill('0') << outputIndex << imageExt;
+                try { storeImage(cf.str(), conf8); } catch (...) {}
+            }
+            
+            // Render the heatmap only for a consumer: saved heatmaps, stored navigation
+            // previews, or a live preview a subscriber is due for. Temporal smoothing and
+            // depth-difference motion then advance at the rendering rate.
+            PreviewSubscription livePreview;
+            const bool wantLive = livePreviewDue(livePreview);
+            // Lazy runs only record the frame; the navigator renders it on demand (loadLazyPreviewAt)
+            const bool storePreview = config.storePreviews && !config.lazyHeatmaps;
+            if (config.storePreviews && config.lazyHeatmaps) {
+                std::lock_guard<std::mutex> lk(previewMutex_);
+                storedPreviews_.emplace_back();
+                storedFrameIndices_.push_back(frameCount);
+                storedOutputIndices_.push_back(outputIndex);
+            }
+            if (config.saveColorized || storePreview || wantLive) {
+                // Temporal smoothing if enabled
+                cv::Mat depthForViz = depthFloat;
+                if (useTemporalSmooth) {
+                    if (emaDepth.empty()) {
+                        emaDepth = depthFloat.clone();
+                    } else {
+                        emaDepth = config.temporalAlpha * depthFloat + (1.0f - config.temporalAlpha) * emaDepth;
+                    }
+                    depthForViz = emaDepth;
+                }
+                double effA= config.minDepth, effB = config.maxDepth;
+                cv::Mat heatmap = applyDepthHeatmap(
+                    depthForViz,
+                    config.minDepth,
+                    config.maxDepth,
+                    config.autoContrast,
+                    confidenceCv,
+                    config.confidenceThreshold,
+                    config.logScale,
+                    config.useEdgeBoost,
+                    config.edgeBoostFactor,
+                    config.useClahe,
+                    config.colorMap,
+                    &effA,
+                    &effB,
+                    heatmapExclude
+                );
+                // Motion highlight (when enabled): sparse-flow motion, background-model foreground, or depth difference
+                if (highlightMotion) {
+                    cv::Mat motionMask = sparseFlow ? flowMask
+                                       : backgroundModel ? foregroundMask
+                                       : frameDifferenceMask(depthForViz, prevDepthForMotion);
+                    applyMotionHighlight(heatmap, motionMask, config.motionGain);
+                }
+                cv::Mat outputImage = heatmap;
+                if (config.overlayOnRgb && !leftBgr.empty()) {
+                    double alpha = config.overlayStrength / 100.0;
+                    // alpha = fraction of heatmap; (1-alpha) = RGB
+                    cv::Mat blended;
+                    cv::addWeighted(heatmap, alpha, leftBgr, 1.0 - alpha, 0.0, blended);
+                    outputImage = blended;
+                }
+                if (highlightMotion && !backgroundModel && !sparseFlow) prevDepthForMotion = depthForViz.clone();
+                if (tracker && config.drawTracks) drawTrackOverlay(outputImage, trackStates);
+
+                // Downscaled copy (preserves aspect), or a full clone
+                auto fitWidth = [](const cv::Mat& image, int maxWidth) {
+                    if (maxWidth <= 0 || image.cols <= maxWidth) return image.clone();
+                    double scale = static_cast<double>(maxWidth) / static_cast<double>(image.cols);
+                    int newH = static_cast<int>(std::round(image.rows * scale));
+                    cv::Mat resized;
+                    cv::resize(image, resized, cv::Size(maxWidth, newH), 0, 0, cv::INTER_AREA);
+                    return resized;
+                };
+                if (wantLive || storePreview) {
+                    cv::Mat live = wantLive ? fitWidth(outputImage, livePreview.maxWidth) : cv::Mat();
+                    cv::Mat stored = storePreview ? fitWidth(outputImage, config.previewMaxWidth) : cv::Mat();
+                    std::lock_guard<std::mutex> lk(previewMutex_);
+                    // Update live preview (blended or plain heatmap) and legend
+                    if (wantLive) {
+                        latestRawDepth_ = depthFloat.clone();
+                        latestPreview_ = live;
+                        latestPreviewInfo_.minMeters = effA;
+                        latestPreviewInfo_.maxMeters = effB;
+                        latestPreviewInfo_.autoContrast = config.autoContrast;
+                        latestPreviewInfo_.logScale = config.logScale;
+                        latestPreviewInfo_.confidenceThreshold = config.confidenceThreshold;
+                        latestPreviewInfo_.overlayOnRgb = config.overlayOnRgb;
+                        latestPreviewInfo_.overlayStrength = config.overlayStrength;
+                        latestPreviewInfo_.colorMap = config.colorMap;
+                        // Legend colorbar (BGR) only changes with the colormap
+                        if (latestLegend_.empty() || latestLegendColorMap_ != config.colorMap) {
+                            latestLegend_ = buildColorLegend(config.colorMap);
+                            latestLegendColorMap_ = config.colorMap;
+                        }
+                        ++previewVersion_;
+                    }
+
+                    // Store preview if enabled
+                    if (storePreview) {
+                        storedPreviews_.push_back(std::move(stored));
+                        storedFrameIndices_.push_back(frameCount);
+                        storedOutputIndices_.push_back(outputIndex);
+                    }
+                }
+                if (config.saveColorized) {
+                    std::ostringstream filenameHeatmap;
+                    filenameHeatmap << "heatmap_" << std::setw(6) << std::setfill('0') << outputIndex << imageExt;
+                    std::string heatmapPath = heatmapDir + "/" + filenameHeatmap.str();
+                    storeImage(heatmapPath, outputImage);
+                    if (saveVideo && videoWriter.isOpened()) {
+                        videoWriter.write(outputImage);
+                    }
+                }
+            }
+            
+            extractedCount++;
+            frameCount++;
+            
+            // Report progress every N frames
+            if (extractedCount % 5 == 0) {
+                float denom = (totalFrames > 1 ? static_cast<float>(totalFrames) : static_cast<float>(frameCount+1));
+                float progress = 0.15f + (0.85f * (frameCount / denom));
+                if (coarseToFine) {
+                    progress = 0.15f + (0.85f * (visitPos / static_cast<float>(visitOrder.size())));
+                }
+                std::ostringstream msg;
+                msg << "Extracted: " << extractedCount << " depth maps (frame " << frameCount << ")";
+                reportProgress(progress, msg.str(), progressCallback);
+            }
+        }
+        
+        // Release resources
+        videoWriter.release();
+        if (gridUsePose) camera.disablePositionalTracking();
+        camera.close();
+        if (tracksFile.is_open()) tracksFile.close();
+        if (saveVideo) publishFile(extractionPath + "/depth_heatmap.avi");
+        if (!tracksPath.empty()) publishFile(tracksPath);
+
+        // Static-scene variance of the background model
+        if (backgroundModel && config.saveBackgroundVariance && backgroundModel->getUpdateCount() > 0) {
+            std::string varPath = extractionPath + "/background_variance.tiff";
+            try {
+                if (!storeImage(varPath, backgroundModel->getVarianceMap())) {
+                    LOG_WARNING("Failed to write background variance: " + varPath);
+                }
+            } catch (const std::exception& e) {
+                LOG_WARNING(std::string("Background variance write error: ") + e.what());
+            }
+        }
+
+        // Flight-accumulated bird's-eye grid
+        if (occupancyGrid) {
+            if (occupancyGrid->getFrameCount() > 0) {
+                flightGridPath = extractionPath + "/flight_grid.png";
+                if (!storeImage(flightGridPath, occupancyGrid->getAccumulatedGrid())) {
+                    LOG_WARNING("Failed to write flight occupancy grid: " + flightGridPath);
+                    flightGridPath.clear();
+                }
+            }
+        }
+
+        // Per-frame statistics behind the flight timeline
+        std::string frameStatsPath;
+        if (collectStats && !timeline_.validFraction.empty()) {
+            frameStatsPath = extractionPath + "/frame_stats.csv";
+            if (timeline_.writeCsv(frameStatsPath)) {
+                publishFile(frameStatsPath);
+            } else {
+                LOG_WARNING("Failed to write frame statistics: " + frameStatsPath);
+                frameStatsPath.clear();
+            }
+        }
+
+        // Present previews chronologically for the navigator after an out-of-order run
+        if (coarseToFine) {
+            std::lock_guard<std::mutex> lk(previewMutex_);
+            std::vector<size_t> perm(storedPreviews_.size());
+            for (size_t k = 0; k < perm.size(); ++k) perm[k] = k;
+            std::sort(perm.begin(), perm.end(), [&](size_t a, size_t b) {
+                return storedOutputIndices_[a] < storedOutputIndices_[b];
+            });
+            std::vector<cv::Mat> previews; std::vector<int> frames, outputs;
+            for (size_t k : perm) {
+                previews.push_back(storedPreviews_[k]);
+                frames.push_back(storedFrameIndices_[k]);
+                outputs.push_back(storedOutputIndices_[k]);
+            }
+            storedPreviews_.swap(previews);
+            storedFrameIndices_.swap(frames);
+            storedOutputIndices_.swap(outputs);
+        }
+        
+        // Export metadata
+        DepthMetadata metadata;
+        metadata.extractionDateTime = getCurrentDateTime();
+        if (FileUtils::isFlightFolder(flightFolderName)) {
+            FlightInfo fi;
+            fi.folderName = flightFolderName;
+            fi.svoFilePath = config.svoFilePath;
+            fi.parseFromFolder(parentFolder); // parentFolder holds the flight folder path
+            metadata.flightInfo = fi;
+        }
+        metadata.width = width;
+        metadata.height = height;
+        metadata.fps = config.outputFps;
+        metadata.totalFrames = extractedCount;
+        metadata.neuralMode = config.depthMode;
+        metadata.cameraView = "left"; // depth currently from left view by default
+        metadata.minDepthMeters = config.minDepth;
+        metadata.maxDepthMeters = config.maxDepth;
+    metadata.overlayTransparency = config.overlayStrength;
+    metadata.showOverlay = config.overlayOnRgb;
+        metadata.minObjectPixels = 0;
+        metadata.statistics.minDetectedDistance = detCount > 0 ? detMinDistance : 0.0f;
+        metadata.statistics.maxDetectedDistance = detMaxDistance;
+        metadata.statistics.avgDetectedDistance = detCount > 0 ? static_cast<float>(detDistanceSum / detCount) : 0.0f;
+        metadata.statistics.totalObjectsDetected = tracker ? tracker->getConfirmedTrackCount() : 0;
+        metadata.statistics.framesWithDetections = framesWithDetections;
+        metadata.tracksFile = tracksPath;
+        metadata.occupancyGridFile = flightGridPath;
+        metadata.frameStatsFile = frameStatsPath;
+        metadata.flowMotionFrames = flowMotionFrames;
+        metadata.groundPlaneFrames = groundPlaneFrames;
+        metadata.meanCameraHeight = groundPlaneFrames > 0 ? static_cast<float>(cameraHeightSum / groundPlaneFrames) : 0.0f;
+        metadata.outputVideo = (saveVideo ? extractionPath + "/depth_heatmap.avi" : "");
+        metadata.frameOrder = coarseToFine ? "coarse_to_fine" : "sequential";
+        metadata.selectedFrames = coarseToFine ? static_cast<int>(visitOrder.size()) : extractedCount;
+        metadata.timeBudgetExhausted = budgetExhausted;
+        metadata.uploadManifest = uploader ? uploader->getManifestKey() : "";
+        
+        std::string metadataPath = extractionPath + "/depth_metadata.json";
+        metadata.saveToJSON(metadataPath);
+
+        // Drain uploads and publish the manifest
+        if (uploader) {
+            publishFile(metadataPath);
+            reportProgress(0.99f, "Finishing uploads...", progressCallback);
+            ErrorResult uploaded = uploader->finish();
+            if (!uploaded.isSuccessful) {
+                LOG_ERROR("Upload incomplete: " + uploaded.message);
+                if (!keepLocal) {
+                    archive();
+                    isRunning_ = false;
+                    return ExtractionResult::Failure("Upload incomplete (no local copy kept): " + uploaded.message);
+                }
+            }
+        }
+        archive();
+        
+        if (extractedCount == 0) {
+            // Provide actionable failure instead of silent completion
+            isRunning_ = false;
+            std::string msg = "No depth frames extracted. Possible causes: invalid SVO file path, file contains 0 frames, or SDK opened live camera instead of SVO. Path: " + config.svoFilePath;
+            reportProgress(0.0f, msg, progressCallback);
+            return ExtractionResult::Failure(msg);
+        }
+
+        const ThreadPoolStats poolStats = ThreadPool::current().getStats();
+        LOG_INFO("Thread pool: " + std::to_string(poolStats.concurrency) + " threads, " +
+                 std::to_string(poolStats.tasksExecuted) + " tasks, " + std::to_string(poolStats.steals) +
+                 " steals, peak queue " + std::to_string(poolStats.maxQueueDepth));
+        if (readAhead) LOG_INFO(readAhead->describeStats());
+
+        isRunning_ = false;
+        reportProgress(1.0f, "Depth extraction completed", progressCallback);
+        return ExtractionResult::Success(outputMgr.getArchivePath(extractionPath), extractedCount);
+        
+    } catch (const std::exception& e) {
+        isRunning_ = false;
+        return ExtractionResult::Failure(std::string("Exception: ") + e.what());
+    }
+}
+
+// ============================================================================
+// Pre-run estimates
+// ============================================================================
+
+/**
+ * @brief Time writing one sample's encoded products to the output volume
+ *
+ * Goes through the OS cache like the real run, so it reflects what the
+ * extraction loop waits for rather than raw device speed.
+ */
+static double timeProbeWrite(const std::string& dir, const std::vector<std::vector<uchar>>& buffers) {
+    const std::string probePath = dir + "/.zed_estimate_probe.tmp";
+    auto start = std::chrono::steady_clock::now();
+    for (const auto& buffer : buffers) {
+        std::ofstream out(probePath, std::ios::binary | std::ios::trunc);
+        if (!out.is_open()) return 0.0;
+        out.write(reinterpret_cast<const char*>(buffer.data()), static_cast<std::streamsize>(buffer.size()));
+    }
+    double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+    std::remove(probePath.c_str());
+    return ms;
+}
+
+/**
+ * @brief SVO position of sample i of k, centred in its stretch and on the export grid
+ */
+static int estimateSamplePosition(int i, int k, int exportedFrames, int frameInterval) {
+    return static_cast<int>((static_cast<int64_t>(2 * i + 1) * exportedFrames) / (2 * k)) * frameInterval;
+}
+
+static double elapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+ExtractionResult ExtractionEngine::runEstimateFrames(
+    const FrameExtractionConfig& config,
+    ExtractionEstimate& estimate,
+    int samples,
+    ProgressCallback progressCallback
+) {
+    if (isRunning_) {
+        return ExtractionResult::Failure("Extraction already in progress");
+    }
+    isRunning_ = true;
+    cancelRequested_ = false;
+
+    try {
+        reportProgress(0.0f, "Opening SVO file for estimate...", progressCallback);
+        SVOHandler svo(config.svoFilePath);
+        if (!svo.open()) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to open SVO file");
+        }
+        SVOProperties props = svo.getProperties();
+        if (props.totalFrames <= 1) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("SVO frame count unknown; cannot estimate");
+        }
+        const int frameInterval = std::max(1, static_cast<int>(std::round(props.fps / config.fps)));
+        const int exported = (props.totalFrames + frameInterval - 1) / frameInterval;
+        const bool wantLeft = (config.cameraMode == "left" || config.cameraMode == "both");
+        const bool wantRight = (config.cameraMode == "right" || config.cameraMode == "both");
+        const std::string ext = imageExtension(config.format);
+        const std::string probeDir = nearestExistingDirectory(config.baseOutputPath);
+
+        ExtractionEstimator estimator(props.totalFrames, exported);
+        const int k = std::max(1, std::min(samples, exported));
+        sl::Mat imageZed, depthZed;
+        uint64_t ringBytesPerFrame = 0;
+        for (int i = 0; i < k; ++i) {
+            if (shouldCancel()) {
+                isRunning_ = false;
+                return ExtractionResult::Failure("Estimate cancelled by user");
+            }
+            // First grab after a seek decodes from the keyframe; time the next one
+            if (!svo.setFramePosition(estimateSamplePosition(i, k, exported, frameInterval)) || !svo.grab()) continue;
+            EstimatorSample sample;
+            auto t = std::chrono::steady_clock::now();
+            if (!svo.grab()) continue;
+            sample.everyFrameMs["grab"] = elapsedMs(t);
+            if (config.eventTrigger) {
+                t = std::chrono::steady_clock::now();
+                svo.retrieveMeasure(depthZed, sl::MEASURE::DEPTH);
+                sample.everyFrameMs["trigger"] = elapsedMs(t);
+            }
+
+            std::vector<std::vector<uchar>> buffers;
+            for (int view = 0; view < 2; ++view) {
+                if (view == 0 ? !wantLeft : !wantRight) continue;
+                t = std::chrono::steady_clock::now();
+                if (svo.retrieveImage(imageZed, view == 0 ? sl::VIEW::LEFT : sl::VIEW::RIGHT) != sl::ERROR_CODE::SUCCESS) continue;
+                cv::Mat bgr;
+                cv::cvtColor(slMat2cvMat(imageZed), bgr, cv::COLOR_BGRA2BGR);
+                sample.exportMs["retrieve"] += elapsedMs(t);
+                ringBytesPerFrame += bgr.total() * 4;   // Ring slots hold BGRA views
+                t = std::chrono::steady_clock::now();
+                std::vector<uchar> encoded;
+                if (!encodeImage(ext, bgr, encoded)) continue;
+                sample.exportMs["encode"] += elapsedMs(t);
+                sample.productBytes[view == 0 ? "left" : "right"] = encoded.size();
+                buffers.push_back(std::move(encoded));
+            }
+            sample.exportMs["write"] = timeProbeWrite(probeDir, buffers);
+            estimator.addSample(sample);
+            reportProgress(static_cast<float>(i + 1) / k, "Sampled " + std::to_string(i + 1) + "/" + std::to_string(k), progressCallback);
+        }
+        if (estimator.getSampleCount() == 0) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("No frame could be sampled");
+        }
+
+        // Event pre-roll ring buffer is allocated up front
+        uint64_t baseMemory = currentProcessMemoryBytes();
+        if (config.eventTrigger) {
+            float eventFps = config.eventFps > 0.0f ? config.eventFps : props.fps;
+            int eventInterval = std::max(1, static_cast<int>(std::round(props.fps / eventFps)));
+            int ringSlots = static_cast<int>(std::round(config.preEventSec * props.fps)) / eventInterval;
+            baseMemory += ringBytesPerFrame / estimator.getSampleCount() * static_cast<uint64_t>(std::max(0, ringSlots));
+        }
+        estimate = estimator.finish("frames", config.baseOutputPath, baseMemory, 0);
+        if (config.eventTrigger) estimate.notes.push_back("Event windows add frames at the event rate; only the base rate is counted");
+        if (config.keyframeTolerance > 0 && frameInterval > 1) {
+            estimate.notes.push_back("Keyframe snapping seeks instead of decoding every frame; runtime is an upper bound");
+        }
+        if (config.followMode) estimate.notes.push_back("Follow mode: frames recorded after the estimate are not counted");
+
+        isRunning_ = false;
+        reportProgress(1.0f, "Estimate ready", progressCallback);
+        return ExtractionResult::Success(config.baseOutputPath, static_cast<int>(estimator.getSampleCount()));
+    } catch (const std::exception& e) {
+        isRunning_ = false;
+        return ExtractionResult::Failure(std::string("Exception: ") + e.what());
+    }
+}
+
+ExtractionResult ExtractionEngine::runEstimateDepth(
+    const DepthExtractionConfig& config,
+    ExtractionEstimate& estimate,
+    int samples,
+    ProgressCallback progressCallback
+) {
+    if (isRunning_) {
+        return ExtractionResult::Failure("Extraction already in progress");
+    }
+    isRunning_ = true;
+    cancelRequested_ = false;
+
+    try {
+        reportProgress(0.0f, "Opening SVO with depth mode " + config.depthMode + " for estimate...", progressCallback);
+        sl::InitParameters initParams;
+        initParams.input.setFromSVOFile(config.svoFilePath.c_str());
+        initParams.depth_mode = getDepthMode(config.depthMode);
+        initParams.coordinate_units = sl::UNIT::METER;
+        initParams.depth_stabilization = true;
+        initParams.svo_real_time_mode = false;
+        sl::Camera camera;
+        sl::ERROR_CODE err = camera.open(initParams);
+        if (err != sl::ERROR_CODE::SUCCESS) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("Failed to open SVO file with depth mode: " +
+                                           std::string(sl::toString(err).c_str()));
+        }
+        const int totalFrames = camera.getSVONumberOfFrames();
+        if (totalFrames <= 1) {
+            camera.close();
+            isRunning_ = false;
+            return ExtractionResult::Failure("SVO frame count unknown; cannot estimate");
+        }
+        const float sourceFps = camera.getCameraInformation().camera_configuration.fps;
+        const int frameInterval = std::max(1, static_cast<int>(std::round(sourceFps / config.outputFps)));
+        const int exported = (totalFrames + frameInterval - 1) / frameInterval;
+
+        // Same product switches as extractDepth
+        const bool lazy = config.lazyHeatmaps;
+        const bool saveRaw = config.saveRawDepth || lazy;
+        const bool saveHeatmap = config.saveColorized && !lazy;
+        const bool saveVideo = config.saveVideo && !lazy && config.frameOrder != "coarse_to_fine";
+        const bool saveRgb = (config.saveRgbFrames || lazy) && config.overlayOnRgb;
+        const bool render = saveHeatmap || saveVideo || (config.storePreviews && !lazy);
+        std::string imageExt = imageExtension(config.imageFormat);
+        if (imageExt != ".png" && imageExt != ".qoi") imageExt = ".png";
+        std::string rawFmt = config.rawDepthFormat;
+        std::transform(rawFmt.begin(), rawFmt.end(), rawFmt.begin(), ::tolower);
+        if (lazy && rawFmt == "bin") rawFmt = "tiff32f";
+        const std::string probeDir = nearestExistingDirectory(config.baseOutputPath);
+
+        sl::RuntimeParameters runtimeParams;
+        runtimeParams.confidence_threshold = config.confidenceThreshold;
+        runtimeParams.texture_confidence_threshold = 100;
+
+        ExtractionEstimator estimator(totalFrames, exported);
+        const int k = std::max(1, std::min(samples, exported));
+        sl::Mat depthZed, confidenceZed, leftImageZed;
+        uint64_t previewBytes = 0;
+        for (int i = 0; i < k; ++i) {
+            if (shouldCancel()) {
+                camera.close();
+                isRunning_ = false;
+                return ExtractionResult::Failure("Estimate cancelled by user");
+            }
+            // First grab after a seek decodes from the keyframe; time the next one
+            camera.setSVOPosition(estimateSamplePosition(i, k, exported, frameInterval));
+            if (camera.grab(runtimeParams) != sl::ERROR_CODE::SUCCESS) continue;
+            EstimatorSample sample;
+            auto t = std::chrono::steady_clock::now();
+            if (camera.grab(runtimeParams) != sl::ERROR_CODE::SUCCESS) continue;
+            sample.everyFrameMs["grab"] = elapsedMs(t);
+
+            t = std::chrono::steady_clock::now();
+            camera.retrieveMeasure(depthZed, sl::MEASURE::DEPTH);
+            camera.retrieveMeasure(confidenceZed, sl::MEASURE::CONFIDENCE);
+            cv::Mat depthFloat = slMat2cvMat(depthZed);
+            cv::Mat confidenceCv = slMat2cvMat(confidenceZed);
+            cv::Mat leftBgr;
+            if (config.overlayOnRgb) {
+                camera.retrieveImage(leftImageZed, sl::VIEW::LEFT);
+                cv::cvtColor(slMat2cvMat(leftImageZed), leftBgr, cv::COLOR_BGRA2BGR);
+            }
+            sample.exportMs["retrieve"] = elapsedMs(t);
+            if (depthFloat.empty()) continue;
+
+            cv::Mat heatmap;
+            if (render) {
+                t = std::chrono::steady_clock::now();
+                heatmap = applyDepthHeatmap(depthFloat, config.minDepth, config.maxDepth, config.autoContrast,
+                                            confidenceCv, config.confidenceThreshold, config.logScale,
+                                            config.useEdgeBoost, config.edgeBoostFactor, config.useClahe,
+                                            config.colorMap);
+                if (!leftBgr.empty() && leftBgr.size() == heatmap.size()) {
+                    double alpha = config.overlayStrength / 100.0;
+                    cv::addWeighted(heatmap, alpha, leftBgr, 1.0 - alpha, 0.0, heatmap);
+                }
+                sample.exportMs["render"] = elapsedMs(t);
+                if (config.storePreviews) {
+                    int w = heatmap.cols, h = heatmap.rows;
+                    if (config.previewMaxWidth > 0 && w > config.previewMaxWidth) {
+                        h = h * config.previewMaxWidth / w;
+                        w = config.previewMaxWidth;
+                    }
+                    previewBytes = static_cast<uint64_t>(w) * h * 3;
+                }
+            }
+
+            // Encode every product in memory; sizes and encode time per product
+            t = std::chrono::steady_clock::now();
+            std::vector<std::vector<uchar>> buffers;
+            auto addProduct = [&](const char* name, std::vector<uchar>&& encoded) {
+                sample.productBytes[name] = encoded.size();
+                buffers.push_back(std::move(encoded));
+            };
+            if (saveRaw) {
+                std::vector<uchar> encoded;
+                if (rawFmt == "pfm" || rawFmt == "bin") {
+                    const uchar* data = depthFloat.ptr<uchar>(0);
+                    encoded.assign(data, data + depthFloat.total() * sizeof(float));
+                    addProduct("raw_depth", std::move(encoded));
+                } else if (rawFmt == "tiff32f" || rawFmt == "tiff") {
+                    if (encodeImage(".tiff", depthFloat, encoded)) addProduct("raw_depth", std::move(encoded));
+                } else if (cv::haveImageWriter(".exr") && cv::imencode(".exr", depthFloat, encoded)) {
+                    addProduct("raw_depth", std::move(encoded));
+                }
+            }
+            if (saveHeatmap && !heatmap.empty()) {
+                std::vector<uchar> encoded;
+                if (encodeImage(imageExt, heatmap, encoded)) addProduct("heatmap", std::move(encoded));
+            }
+            if (saveVideo && !heatmap.empty()) {
+                // MJPEG frames are JPEGs
+                std::vector<uchar> encoded;
+                if (cv::imencode(".jpg", heatmap, encoded)) addProduct("heatmap_video", std::move(encoded));
+            }
+            if (saveRgb && !leftBgr.empty()) {
+                std::vector<uchar> encoded;
+                if (encodeImage(imageExt, leftBgr, encoded)) addProduct("left_rgb", std::move(encoded));
+            }
+            if (config.saveConfidenceMaps && !confidenceCv.empty()) {
+                cv::Mat conf8;
+                confidenceCv.convertTo(conf8, CV_8UC1, kStoredConfidenceScale);
+                std::vector<uchar> encoded;
+                if (encodeImage(imageExt, conf8, encoded)) addProduct("confidence", std::move(encoded));
+            }
+            sample.exportMs["encode"] = elapsedMs(t);
+            sample.exportMs["write"] = timeProbeWrite(probeDir, buffers);
+            estimator.addSample(sample);
+            reportProgress(static_cast<float>(i + 1) / k, "Sampled " + std::to_string(i + 1) + "/" + std::to_string(k), progressCallback);
+        }
+        // Memory with the depth model loaded and frame buffers allocated
+        const uint64_t baseMemory = currentProcessMemoryBytes();
+        camera.close();
+        if (estimator.getSampleCount() == 0) {
+            isRunning_ = false;
+            return ExtractionResult::Failure("No frame could be sampled");
+        }
+
+        estimate = estimator.finish("depth", config.baseOutputPath, baseMemory, previewBytes);
+        std::vector<std::string> unsampled;
+        if (config.useBackgroundModel) unsampled.push_back("background model");
+        if (config.enableTracking) unsampled.push_back("tracking");
+        if (config.useGroundPlane) unsampled.push_back("ground plane");
+        if (config.useSparseFlow) unsampled.push_back("sparse flow");
+        if (config.saveOccupancyGrid) unsampled.push_back("occupancy grid");
+        if (!unsampled.empty()) {
+            std::string list;
+            for (const auto& name : unsampled) list += (list.empty() ? "" : ", ") + name;
+            estimate.notes.push_back("Not sampled (adds runtime): " + list);
+        }
+        if (config.saveRawDepth && rawFmt == "exr" && !cv::haveImageWriter(".exr")) {
+            estimate.notes.push_back("EXR writer unavailable; raw depth would not be written");
+        }
+        if (config.frameOrder == "coarse_to_fine") {
+            estimate.notes.push_back("coarse_to_fine seeks to every exported frame; grab cost is per exported frame plus GOP decoding");
+        }
+        if (!config.uploadUrl.empty() && !config.uploadKeepLocal) {
+            estimate.notes.push_back("Outputs are uploaded and not kept; local space is only needed transiently");
+        }
+        if (config.timeBudgetSec > 0.0f && estimate.runtimeSec.value > config.timeBudgetSec) {
+            estimate.notes.push_back("Time budget of " + std::to_string(static_cast<int>(config.timeBudgetSec)) +
+                                     "s ends the run before all frames are exported");
+        }
+        if (config.followMode) estimate.notes.push_back("Follow mode: frames recorded after the estimate are not counted");
+
+        isRunning_ = false;
+        reportProgress(1.0f, "Estimate ready", progressCallback);
+        return ExtractionResult::Success(config.baseOutputPath, static_cast<int>(estimator.getSampleCount()));
+    } catch (const std::exception& e) {
+        isRunning_ = false;
+        return ExtractionResult::Failure(std::string("Exception: ") + e.what());
+    }
+}
+
+/**
+ * @brief SdkBackend implementation exported by the plugin
+ */
+class ZedSdkBackend : public SdkBackend {
+public:
+    std::string getSdkVersion() const override {
+        return std::string(sl::Camera::getSDKVersion().c_str());
+    }
+
+    ExtractionResult extractFrames(ExtractionEngine& engine, const FrameExtractionConfig& config,
+                                   ProgressCallback progressCallback) override {
+        return engine.runExtractFrames(config, progressCallback);
+    }
+
+    ExtractionResult extractVideo(ExtractionEngine& engine, const VideoExtractionConfig& config,
+                                  ProgressCallback progressCallback) override {
+        return engine.runExtractVideo(config, progressCallback);
+    }
+
+    ExtractionResult extractDepth(ExtractionEngine& engine, const DepthExtractionConfig& config,
+                                  ProgressCallback progressCallback) override {
+        return engine.runExtractDepth(config, progressCallback);
+    }
+
+    ExtractionResult estimateFrames(ExtractionEngine& engine, const FrameExtractionConfig& config,
+                                    ExtractionEstimate& estimate, int samples,
+                                    ProgressCallback progressCallback) override {
+        return engine.runEstimateFrames(config, estimate, samples, progressCallback);
+    }
+
+    ExtractionResult estimateDepth(ExtractionEngine& engine, const DepthExtractionConfig& config,
+                                   ExtractionEstimate& estimate, int samples,
+                                   ProgressCallback progressCallback) override {
+        return engine.runEstimateDepth(config, estimate, samples, progressCallback);
+    }
+
+    bool retrieveFrame(const DepthExtractionConfig& cfg, int framePos,
+                       bool wantDepth, bool wantLeft, SvoFrameData& out) override {
+        try {
+            sl::InitParameters initParams;
+            initParams.input.setFromSVOFile(cfg.svoFilePath.c_str());
+            initParams.depth_mode = wantDepth ? getDepthMode(cfg.depthMode) : sl::DEPTH_MODE::NONE;
+            initParams.coordinate_units = sl::UNIT::METER;
+            initParams.svo_real_time_mode = false;
+            sl::Camera cam;
+            if (cam.open(initParams) != sl::ERROR_CODE::SUCCESS) return false;
+            if (framePos >= 0) cam.setSVOPosition(framePos);
+            sl::RuntimeParameters rp;
+            rp.confidence_threshold = cfg.confidenceThreshold;
+            rp.texture_confidence_threshold = 100;
+            if (cam.grab(rp) != sl::ERROR_CODE::SUCCESS) { cam.close(); return false; }
+            if (wantDepth) {
+                sl::Mat depthZed, confZ;
+                cam.retrieveMeasure(depthZed, sl::MEASURE::DEPTH);
+                out.depth = slMat2cvMat(depthZed).clone();
+                cam.retrieveMeasure(confZ, sl::MEASURE::CONFIDENCE);
+                out.confidence = slMat2cvMat(confZ).clone();
+            }
+            if (wantLeft) {
+                sl::Mat leftZ;
+                cam.retrieveImage(leftZ, sl::VIEW::LEFT);
+                cv::Mat leftRaw = slMat2cvMat(leftZ);
+                if (leftRaw.channels() == 4) cv::cvtColor(leftRaw, out.leftBgr, cv::COLOR_BGRA2BGR);
+                else if (leftRaw.channels() == 3) out.leftBgr = leftRaw.clone();
+                else if (leftRaw.channels() == 1) cv::cvtColor(leftRaw, out.leftBgr, cv::COLOR_GRAY2BGR);
+            }
+            cam.close();
+            return !(wantDepth && out.depth.empty());
+        } catch (...) {
+            return false;
+        }
+    }
+
+    bool getGpuMemory(uint64_t& freeBytes, uint64_t& totalBytes) override {
+#ifdef ZED_BACKEND_HAS_CUDART
+        size_t freeMem = 0, totalMem = 0;
+        if (cudaMemGetInfo(&freeMem, &totalMem) != cudaSuccess) return false;
+        freeBytes = static_cast<uint64_t>(freeMem);
+        totalBytes = static_cast<uint64_t>(totalMem);
+        return totalBytes > 0;
+#else
+        (void)freeBytes;
+        (void)totalBytes;
+        return false;
+#endif
+    }
+};
+
+} // namespace zed_extractor
+
+ZED_SDK_BACKEND_EXPORT int zed_sdk_backend_abi() {
+    return zed_extractor::kSdkBackendAbiVersion;
+}
+
+ZED_SDK_BACKEND_EXPORT zed_extractor::SdkBackend* zed_sdk_backend_create() {
+    static zed_extractor::ZedSdkBackend backend;
+    return &backend;
+}
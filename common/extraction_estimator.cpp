@@ -0,0 +1,262 @@
+/**
+ * @file extraction_estimator.cpp
+ * @brief Implementation of the pre-run extraction estimator
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "extraction_estimator.hpp"
+#include "metadata.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#include <psapi.h>
+#elif defined(__linux__)
+#include <unistd.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace zed_extractor {
+
+namespace {
+
+/**
+ * @brief Two-sided 95% Student t quantile for dof degrees of freedom
+ */
+double tQuantile95(int dof) {
+    static const double table[] = {
+        12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+        2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+        2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+    };
+    if (dof < 1) return 0.0;
+    if (dof <= 30) return table[dof - 1];
+    return 1.96;
+}
+
+std::string formatDuration(double seconds) {
+    char buf[32];
+    long s = static_cast<long>(std::llround(std::max(0.0, seconds)));
+    if (s >= 3600) std::snprintf(buf, sizeof(buf), "%ldh %02ldm", s / 3600, (s % 3600) / 60);
+    else if (s >= 60) std::snprintf(buf, sizeof(buf), "%ldm %02lds", s / 60, s % 60);
+    else std::snprintf(buf, sizeof(buf), "%lds", s);
+    return buf;
+}
+
+std::string formatBytes(double bytes) {
+    const char* units[] = {"B", "KB", "MB", "GB", "TB"};
+    int unit = 0;
+    while (bytes >= 1024.0 && unit < 4) {
+        bytes /= 1024.0;
+        ++unit;
+    }
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), unit == 0 ? "%.0f %s" : "%.1f %s", bytes, units[unit]);
+    return buf;
+}
+
+void addRange(zed_tools::JSONBuilder& json, const std::string& key, const EstimateRange& r) {
+    json.addNumber(key, r.value);
+    json.addNumber(key + "_low", r.low);
+    json.addNumber(key + "_high", r.high);
+}
+
+} // namespace
+
+ExtractionEstimator::ExtractionEstimator(int totalFrames, int exportedFrames)
+    : totalFrames_(std::max(0, totalFrames))
+    , exportedFrames_(std::max(0, exportedFrames))
+{
+}
+
+void ExtractionEstimator::addSample(const EstimatorSample& sample) {
+    samples_.push_back(sample);
+}
+
+EstimateRange ExtractionEstimator::summarize(const std::vector<double>& values) const {
+    EstimateRange r;
+    if (values.empty()) return r;
+    const double n = static_cast<double>(values.size());
+    double mean = 0.0;
+    for (double v : values) mean += v;
+    mean /= n;
+    double var = 0.0;
+    for (double v : values) var += (v - mean) * (v - mean);
+    const double half = values.size() > 1
+        ? tQuantile95(static_cast<int>(values.size()) - 1) * std::sqrt(var / (n - 1.0)) / std::sqrt(n)
+        : 0.0;
+    r.value = mean;
+    r.low = std::max(0.0, mean - half);
+    r.high = mean + half;
+    return r;
+}
+
+ExtractionEstimate ExtractionEstimator::finish(const std::string& kind,
+                                               const std::string& outputPath,
+                                               uint64_t baseMemoryBytes,
+                                               uint64_t growthBytesPerExport) const {
+    ExtractionEstimate e;
+    e.kind = kind;
+    e.totalFrames = totalFrames_;
+    e.exportedFrames = exportedFrames_;
+    e.samples = static_cast<int>(samples_.size());
+    e.outputPath = outputPath;
+
+    const double decoded = static_cast<double>(totalFrames_);
+    const double exported = static_cast<double>(exportedFrames_);
+
+    // Extrapolate each sample to a whole run, then take the spread across samples
+    std::vector<double> runtime, output;
+    std::map<std::string, std::vector<double>> stages, products;
+    for (const auto& s : samples_) {
+        double sec = 0.0;
+        std::map<std::string, double> stageSec;
+        for (const auto& kv : s.everyFrameMs) stageSec[kv.first] += decoded * kv.second / 1000.0;
+        for (const auto& kv : s.exportMs) stageSec[kv.first] += exported * kv.second / 1000.0;
+        for (const auto& kv : stageSec) {
+            stages[kv.first].push_back(kv.second);
+            sec += kv.second;
+        }
+        runtime.push_back(sec);
+
+        double bytes = 0.0;
+        for (const auto& kv : s.productBytes) {
+            products[kv.first].push_back(exported * static_cast<double>(kv.second));
+            bytes += exported * static_cast<double>(kv.second);
+        }
+        output.push_back(bytes);
+    }
+    e.runtimeSec = summarize(runtime);
+    e.outputBytes = summarize(output);
+    for (const auto& kv : stages) e.stageSec[kv.first] = summarize(kv.second);
+    for (const auto& kv : products) e.productBytes[kv.first] = summarize(kv.second);
+    e.peakMemoryBytes = baseMemoryBytes + growthBytesPerExport * static_cast<uint64_t>(exportedFrames_);
+    if (samples_.size() < 2) e.notes.push_back("Only one sample; no confidence bounds");
+
+    if (queryFreeSpace(outputPath, e.freeBytes)) {
+        const double free = static_cast<double>(e.freeBytes);
+        if (free < e.outputBytes.value) e.space = SpaceVerdict::Insufficient;
+        else if (free < e.outputBytes.high) e.space = SpaceVerdict::Tight;
+        else e.space = SpaceVerdict::Ok;
+    }
+    return e;
+}
+
+const char* spaceVerdictName(SpaceVerdict verdict) {
+    switch (verdict) {
+        case SpaceVerdict::Ok: return "ok";
+        case SpaceVerdict::Tight: return "tight";
+        case SpaceVerdict::Insufficient: return "insufficient";
+        default: return "unknown";
+    }
+}
+
+std::string formatEstimate(const ExtractionEstimate& e) {
+    std::ostringstream out;
+    char line[160];
+    out << "Estimate (" << e.kind << "): " << e.samples << " samples, " << e.totalFrames
+        << " SVO frames, " << e.exportedFrames << " exported\n";
+    std::snprintf(line, sizeof(line), "  %-14s %12s   (95%%: %s - %s)\n", "Runtime",
+                  formatDuration(e.runtimeSec.value).c_str(),
+                  formatDuration(e.runtimeSec.low).c_str(), formatDuration(e.runtimeSec.high).c_str());
+    out << line;
+    for (const auto& kv : e.stageSec) {
+        std::snprintf(line, sizeof(line), "    %-12s %12s\n", kv.first.c_str(), formatDuration(kv.second.value).c_str());
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "  %-14s %12s   (95%%: %s - %s)\n", "Output",
+                  formatBytes(e.outputBytes.value).c_str(),
+                  formatBytes(e.outputBytes.low).c_str(), formatBytes(e.outputBytes.high).c_str());
+    out << line;
+    for (const auto& kv : e.productBytes) {
+        std::snprintf(line, sizeof(line), "    %-12s %12s   (95%%: %s - %s)\n", kv.first.c_str(),
+                      formatBytes(kv.second.value).c_str(),
+                      formatBytes(kv.second.low).c_str(), formatBytes(kv.second.high).c_str());
+        out << line;
+    }
+    std::snprintf(line, sizeof(line), "  %-14s %12s\n", "Peak memory",
+                  formatBytes(static_cast<double>(e.peakMemoryBytes)).c_str());
+    out << line;
+    if (e.space == SpaceVerdict::Unknown) {
+        out << "  Free space     unknown (" << e.outputPath << ")\n";
+    } else {
+        std::snprintf(line, sizeof(line), "  %-14s %12s   -> %s\n", "Free space",
+                      formatBytes(static_cast<double>(e.freeBytes)).c_str(), spaceVerdictName(e.space));
+        out << line;
+    }
+    for (const auto& note : e.notes) out << "  Note: " << note << "\n";
+    return out.str();
+}
+
+std::string estimateToJson(const ExtractionEstimate& e) {
+    zed_tools::JSONBuilder json;
+    json.beginObject();
+    json.addString("type", "extraction_estimate");
+    json.addString("kind", e.kind);
+    json.addNumber("samples", e.samples);
+    json.addNumber("total_frames", e.totalFrames);
+    json.addNumber("exported_frames", e.exportedFrames);
+    addRange(json, "runtime_sec", e.runtimeSec);
+    for (const auto& kv : e.stageSec) addRange(json, "stage_" + kv.first + "_sec", kv.second);
+    addRange(json, "output_bytes", e.outputBytes);
+    for (const auto& kv : e.productBytes) addRange(json, "product_" + kv.first + "_bytes", kv.second);
+    json.addNumber("peak_memory_bytes", static_cast<double>(e.peakMemoryBytes));
+    json.addString("output_path", e.outputPath);
+    json.addNumber("free_bytes", static_cast<double>(e.freeBytes));
+    json.addString("space", spaceVerdictName(e.space));
+    json.beginArray("notes");
+    for (const auto& note : e.notes) json.addArrayString(note);
+    json.endArray();
+    json.endObject();
+    return json.toString();
+}
+
+uint64_t currentProcessMemoryBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return static_cast<uint64_t>(counters.WorkingSetSize);
+    }
+    return 0;
+#elif defined(__linux__)
+    // statm: size resident shared ... (pages)
+    std::ifstream statm("/proc/self/statm");
+    uint64_t size = 0, resident = 0;
+    if (!(statm >> size >> resident)) return 0;
+    return resident * static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+#else
+    return 0;
+#endif
+}
+
+bool queryFreeSpace(const std::string& path, uint64_t& freeBytes) {
+    std::error_code ec;
+    fs::space_info info = fs::space(nearestExistingDirectory(path), ec);
+    if (ec) return false;
+    freeBytes = static_cast<uint64_t>(info.available);
+    return true;
+}
+
+std::string nearestExistingDirectory(const std::string& path) {
+    std::error_code ec;
+    fs::path probe = fs::absolute(path.empty() ? fs::path(".") : fs::path(path), ec);
+    while (!probe.empty() && !fs::is_directory(probe, ec)) {
+        fs::path parent = probe.parent_path();
+        if (parent == probe) break;
+        probe = parent;
+    }
+    return probe.empty() ? std::string(".") : probe.string();
+}
+
+} // namespace zed_extractor
@@ -0,0 +1,139 @@
+/**
+ * @file extraction_estimator.hpp
+ * @brief Pre-run estimate of extraction runtime, output size and memory from a few sampled frames
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ *
+ * The engine runs the real per-frame stages (grab, retrieve, render, encode,
+ * write) on a handful of frames spread across the SVO and feeds the timings
+ * and encoded sizes in here. Totals are extrapolated per sample, so the
+ * spread between parts of the recording becomes a 95% confidence interval
+ * (Student t over the samples).
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace zed_extractor {
+
+/**
+ * @brief Estimate with 95% confidence bounds
+ */
+struct EstimateRange {
+    double value = 0.0;
+    double low = 0.0;
+    double high = 0.0;
+};
+
+/**
+ * @brief Measurements of one sampled frame
+ */
+struct EstimatorSample {
+    std::map<std::string, double> everyFrameMs;   // Stages run on every decoded SVO frame (e.g. grab)
+    std::map<std::string, double> exportMs;       // Stages run per exported frame (retrieve, render, encode, write)
+    std::map<std::string, uint64_t> productBytes; // Encoded bytes per product of one exported frame
+};
+
+/**
+ * @brief Free space in the output location compared with the estimate
+ */
+enum class SpaceVerdict {
+    Unknown,        ///< Free space could not be queried
+    Ok,             ///< Upper bound fits
+    Tight,          ///< Expected size fits, upper bound does not (warn)
+    Insufficient    ///< Expected size does not fit (refuse)
+};
+
+/**
+ * @brief Extrapolated totals of a run
+ */
+struct ExtractionEstimate {
+    std::string kind;                              // "frames" or "depth"
+    int totalFrames = 0;                           // SVO frames decoded by the run
+    int exportedFrames = 0;                        // Frames written
+    int samples = 0;
+    EstimateRange runtimeSec;
+    std::map<std::string, EstimateRange> stageSec; // Total time per stage
+    std::map<std::string, EstimateRange> productBytes;
+    EstimateRange outputBytes;
+    uint64_t peakMemoryBytes = 0;                  // Process after sampling + per-export growth
+    std::string outputPath;
+    uint64_t freeBytes = 0;
+    SpaceVerdict space = SpaceVerdict::Unknown;
+    std::vector<std::string> notes;                // Options whose cost is not sampled, etc.
+};
+
+/**
+ * @brief Collects samples and extrapolates them to a full run
+ *
+ * Example usage:
+ * @code
+ * ExtractionEstimator estimator(totalFrames, exportedFrames);
+ * estimator.addSample(sample);   // once per sampled frame
+ * ExtractionEstimate e = estimator.finish("depth", outputPath, currentProcessMemoryBytes(), 0);
+ * std::cout << formatEstimate(e);
+ * @endcode
+ */
+class ExtractionEstimator {
+public:
+    ExtractionEstimator(int totalFrames, int exportedFrames);
+
+    void addSample(const EstimatorSample& sample);
+    size_t getSampleCount() const { return samples_.size(); }
+
+    /**
+     * @brief Extrapolate and check free space in outputPath
+     * @param baseMemoryBytes Process memory with the pipeline running
+     * @param growthBytesPerExport Memory kept per exported frame (e.g. stored previews)
+     */
+    ExtractionEstimate finish(const std::string& kind,
+                              const std::string& outputPath,
+                              uint64_t baseMemoryBytes,
+                              uint64_t growthBytesPerExport) const;
+
+private:
+    int totalFrames_;
+    int exportedFrames_;
+    std::vector<EstimatorSample> samples_;
+
+    /**
+     * @brief Mean and 95% interval of per-sample totals
+     */
+    EstimateRange summarize(const std::vector<double>& values) const;
+};
+
+/**
+ * @brief Human-readable report (runtime, sizes per product, memory, free space)
+ */
+std::string formatEstimate(const ExtractionEstimate& estimate);
+
+/**
+ * @brief Estimate as JSON
+ */
+std::string estimateToJson(const ExtractionEstimate& estimate);
+
+/**
+ * @brief Readable name of a verdict ("ok", "tight", ...)
+ */
+const char* spaceVerdictName(SpaceVerdict verdict);
+
+/**
+ * @brief Resident memory of this process in bytes (0 if unavailable)
+ */
+uint64_t currentProcessMemoryBytes();
+
+/**
+ * @brief Free bytes on the volume holding path (or its nearest existing parent)
+ */
+bool queryFreeSpace(const std::string& path, uint64_t& freeBytes);
+
+/**
+ * @brief path itself or its nearest existing parent (output folders may not exist yet)
+ */
+std::string nearestExistingDirectory(const std::string& path);
+
+} // namespace zed_extractor
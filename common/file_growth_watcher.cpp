@@ -0,0 +1,101 @@
+/**
+ * @file file_growth_watcher.cpp
+ * @brief Implementation of FileGrowthWatcher
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "file_growth_watcher.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <filesystem>
+#include <thread>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+namespace zed_tools {
+
+FileGrowthWatcher::FileGrowthWatcher(const std::string& filePath, int pollIntervalMs)
+    : filePath_(filePath)
+    , pollIntervalMs_(std::max(10, pollIntervalMs))
+{
+    int64_t size = currentSize();
+    baselineSize_ = size > 0 ? static_cast<uint64_t>(size) : 0;
+#ifdef __linux__
+    notifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (notifyFd_ >= 0) {
+        watchFd_ = inotify_add_watch(notifyFd_, filePath_.c_str(),
+                                     IN_MODIFY | IN_CLOSE_WRITE | IN_DELETE_SELF | IN_MOVE_SELF);
+        if (watchFd_ < 0) {
+            // Fall back to polling (e.g., network filesystems)
+            close(notifyFd_);
+            notifyFd_ = -1;
+        }
+    }
+#endif
+}
+
+FileGrowthWatcher::~FileGrowthWatcher() {
+#ifdef __linux__
+    if (notifyFd_ >= 0) {
+        close(notifyFd_);
+    }
+#endif
+}
+
+int64_t FileGrowthWatcher::currentSize() const {
+    std::error_code ec;
+    auto size = std::filesystem::file_size(filePath_, ec);
+    if (ec) return -1;
+    return static_cast<int64_t>(size);
+}
+
+void FileGrowthWatcher::waitForEvent(int timeoutMs) {
+#ifdef __linux__
+    if (notifyFd_ >= 0) {
+        pollfd pfd{ notifyFd_, POLLIN, 0 };
+        if (poll(&pfd, 1, timeoutMs) > 0) {
+            // Drain pending events; we only care that something happened
+            char buf[4096];
+            while (read(notifyFd_, buf, sizeof(buf)) > 0) {}
+        }
+        return;
+    }
+#endif
+    std::this_thread::sleep_for(std::chrono::milliseconds(timeoutMs));
+}
+
+FileGrowthWatcher::WaitResult FileGrowthWatcher::waitForGrowth(double idleTimeoutSec,
+                                                               const std::function<bool()>& shouldCancel) {
+    auto start = std::chrono::steady_clock::now();
+    for (;;) {
+        if (shouldCancel && shouldCancel()) {
+            return WaitResult::CANCELLED;
+        }
+
+        int64_t size = currentSize();
+        if (size < 0) {
+            return WaitResult::FILE_MISSING;
+        }
+        if (static_cast<uint64_t>(size) > baselineSize_) {
+            baselineSize_ = static_cast<uint64_t>(size);
+            return WaitResult::GREW;
+        }
+
+        if (idleTimeoutSec > 0.0) {
+            double waited = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+            if (waited >= idleTimeoutSec) {
+                return WaitResult::IDLE_TIMEOUT;
+            }
+        }
+
+        waitForEvent(pollIntervalMs_);
+    }
+}
+
+} // namespace zed_tools
@@ -0,0 +1,97 @@
+/**
+ * @file file_growth_watcher.hpp
+ * @brief Wait for a file that is still being written to grow
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Used by follow mode to extract from an SVO2 file while the recorder is
+ * still appending to it. On Linux the watcher wakes up on inotify
+ * IN_MODIFY events; elsewhere it falls back to polling the file size.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <string>
+
+namespace zed_tools {
+
+/**
+ * @brief Blocks until a file grows, an idle timeout expires, or the caller cancels
+ *
+ * Example usage:
+ * @code
+ * FileGrowthWatcher watcher(svoPath, 500);
+ * // ... read until EOF ...
+ * auto r = watcher.waitForGrowth(30.0, [&]{ return cancelRequested; });
+ * if (r == FileGrowthWatcher::WaitResult::GREW) {
+ *     // reopen source and continue
+ * }
+ * @endcode
+ */
+class FileGrowthWatcher {
+public:
+    /**
+     * @brief Outcome of waitForGrowth()
+     */
+    enum class WaitResult {
+        GREW,           ///< File size increased since the last baseline
+        IDLE_TIMEOUT,   ///< No growth within the idle timeout
+        CANCELLED,      ///< Cancel predicate returned true
+        FILE_MISSING    ///< File disappeared (moved or deleted)
+    };
+
+    /**
+     * @brief Construct watcher and take the current size as baseline
+     * @param filePath File to watch
+     * @param pollIntervalMs Maximum time between size checks / cancel checks
+     */
+    explicit FileGrowthWatcher(const std::string& filePath, int pollIntervalMs = 500);
+
+    /**
+     * @brief Destructor - releases the notification handle
+     */
+    ~FileGrowthWatcher();
+
+    // Disable copy (owns notification handle)
+    FileGrowthWatcher(const FileGrowthWatcher&) = delete;
+    FileGrowthWatcher& operator=(const FileGrowthWatcher&) = delete;
+
+    /**
+     * @brief Wait until the file is larger than the baseline
+     * @param idleTimeoutSec Give up after this many seconds without growth (<= 0 = wait forever)
+     * @param shouldCancel Optional predicate checked every poll interval
+     * @return Wait result; on GREW the baseline is updated to the new size
+     */
+    WaitResult waitForGrowth(double idleTimeoutSec, const std::function<bool()>& shouldCancel = nullptr);
+
+    /**
+     * @brief Size recorded at the last baseline update
+     */
+    uint64_t getBaselineSize() const { return baselineSize_; }
+
+    /**
+     * @brief Check whether kernel notifications are used (false = polling)
+     */
+    bool usesNotifications() const { return notifyFd_ >= 0; }
+
+private:
+    std::string filePath_;      ///< Watched file
+    int pollIntervalMs_;        ///< Poll / cancel-check interval
+    uint64_t baselineSize_ = 0; ///< Size at last baseline
+    int notifyFd_ = -1;         ///< inotify descriptor (-1 = polling)
+    int watchFd_ = -1;          ///< inotify watch descriptor
+
+    /**
+     * @brief Current file size, or -1 if the file cannot be stat'ed
+     */
+    int64_t currentSize() const;
+
+    /**
+     * @brief Sleep up to timeoutMs, returning early on a file notification
+     */
+    void waitForEvent(int timeoutMs);
+};
+
+} // namespace zed_tools
@@ -0,0 +1,277 @@
+/**
+ * @file frame_pipe_writer.cpp
+ * @brief Implementation of the raw frame pipe writer
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "frame_pipe_writer.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <algorithm>
+#include <cerrno>
+#include <cmath>
+#include <cstring>
+#include <sstream>
+
+#ifdef _WIN32
+#include <windows.h>
+#include <fcntl.h>
+#include <io.h>
+#else
+#include <csignal>
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace zed_tools {
+
+namespace {
+
+constexpr size_t kStreamBufferSize = 4 * 1024 * 1024;   // stdio buffer in front of the pipe
+
+/**
+ * @brief Express fps as a Y4M rational (e.g. 29.97 -> 30000:1001)
+ */
+std::string y4mRate(double fps) {
+    std::ostringstream r;
+    double rounded = std::round(fps);
+    if (std::fabs(fps - rounded) < 1e-3) {
+        r << static_cast<long>(rounded) << ":1";
+    } else if (std::fabs(fps * 1001.0 / 1000.0 - std::round(fps * 1001.0 / 1000.0)) < 1e-2) {
+        r << static_cast<long>(std::round(fps * 1001.0)) << ":1001";
+    } else {
+        r << static_cast<long>(std::round(fps * 1000.0)) << ":1000";
+    }
+    return r.str();
+}
+
+} // namespace
+
+FramePipeWriter::~FramePipeWriter() {
+    close();
+}
+
+bool FramePipeWriter::parseFormat(const std::string& name, PipeFormat& format) {
+    if (name == "y4m") { format = PipeFormat::Y4M; return true; }
+    if (name == "bgr24" || name == "bgr") { format = PipeFormat::BGR24; return true; }
+    if (name == "nv12") { format = PipeFormat::NV12; return true; }
+    return false;
+}
+
+ErrorResult FramePipeWriter::open(const std::string& target, PipeFormat format, int width, int height,
+                                  double fps, size_t queueDepth) {
+    if (out_) return ErrorResult::failure("Pipe already open");
+    if (width <= 0 || height <= 0 || fps <= 0.0) {
+        return ErrorResult::failure("Invalid pipe geometry or frame rate");
+    }
+    if (format != PipeFormat::BGR24 && ((width | height) & 1)) {
+        return ErrorResult::failure("4:2:0 pipe formats need even width and height");
+    }
+
+    if (target == "-") {
+#ifdef _WIN32
+        _setmode(_fileno(stdout), _O_BINARY);
+#endif
+        out_ = stdout;
+        ownsStream_ = false;
+    }
+#ifdef _WIN32
+    else if (target.rfind("\\\\.\\pipe\\", 0) == 0) {
+        // Server end of a Windows named pipe; the encoder connects as a client
+        HANDLE h = CreateNamedPipeA(target.c_str(), PIPE_ACCESS_OUTBOUND,
+                                    PIPE_TYPE_BYTE | PIPE_WAIT, 1,
+                                    static_cast<DWORD>(kStreamBufferSize), 0, 0, nullptr);
+        if (h == INVALID_HANDLE_VALUE) {
+            return ErrorResult::failure("Failed to create named pipe: " + target);
+        }
+        LOG_INFO("Waiting for a reader on " + target);
+        if (!ConnectNamedPipe(h, nullptr) && GetLastError() != ERROR_PIPE_CONNECTED) {
+            CloseHandle(h);
+            return ErrorResult::failure("No reader connected to named pipe: " + target);
+        }
+        int fd = _open_osfhandle(reinterpret_cast<intptr_t>(h), _O_WRONLY | _O_BINARY);
+        out_ = (fd >= 0) ? _fdopen(fd, "wb") : nullptr;
+        if (!out_) {
+            CloseHandle(h);
+            return ErrorResult::failure("Failed to attach to named pipe: " + target);
+        }
+        ownsStream_ = true;
+    }
+#endif
+    else {
+#ifndef _WIN32
+        struct stat st;
+        if (::stat(target.c_str(), &st) != 0) {
+            if (::mkfifo(target.c_str(), 0644) != 0) {
+                return ErrorResult::failure("Failed to create FIFO: " + target);
+            }
+            LOG_INFO("Created FIFO " + target + "; waiting for a reader");
+        }
+#endif
+        // Opening a FIFO blocks until the consumer opens the read end
+        out_ = std::fopen(target.c_str(), "wb");
+        if (!out_) return ErrorResult::failure("Failed to open pipe target: " + target);
+        ownsStream_ = true;
+    }
+
+#ifndef _WIN32
+    // A consumer that exits must surface as EPIPE, not kill the process
+    std::signal(SIGPIPE, SIG_IGN);
+#ifdef F_SETPIPE_SZ
+    ::fcntl(fileno(out_), F_SETPIPE_SZ, 1024 * 1024);   // Best effort; ignored for non-pipes
+#endif
+#endif
+    std::setvbuf(out_, nullptr, _IOFBF, kStreamBufferSize);
+
+    format_ = format;
+    width_ = width;
+    height_ = height;
+    queueDepth_ = std::max<size_t>(1, queueDepth);
+    stopping_ = false;
+    failed_ = false;
+    error_.clear();
+    framesWritten_ = 0;
+    bytesWritten_ = 0;
+
+    if (format_ == PipeFormat::Y4M) {
+        std::ostringstream header;
+        header << "YUV4MPEG2 W" << width_ << " H" << height_ << " F" << y4mRate(fps)
+               << " Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n";
+        std::string h = header.str();
+        if (!writeBytes(h.data(), h.size())) {
+            close();
+            return ErrorResult::failure("Failed to write Y4M header");
+        }
+    } else {
+        LOG_INFO(std::string("Raw pipe: -f rawvideo -pix_fmt ") +
+                 (format_ == PipeFormat::BGR24 ? "bgr24" : "nv12") +
+                 " -s " + std::to_string(width_) + "x" + std::to_string(height_) +
+                 " -r " + std::to_string(fps));
+    }
+
+    thread_ = std::thread(&FramePipeWriter::writerLoop, this);
+    return ErrorResult::success();
+}
+
+bool FramePipeWriter::write(const cv::Mat& frame) {
+    if (!out_ || frame.empty() || frame.cols != width_ || frame.rows != height_) return false;
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock, [this] { return queue_.size() < queueDepth_ || failed_; });
+    if (failed_) return false;
+    cv::Mat slot;
+    if (!pool_.empty()) {
+        slot = pool_.back();
+        pool_.pop_back();
+    }
+    lock.unlock();
+
+    // Copy (and drop alpha) outside the lock; the caller's buffer is reused by the SDK
+    if (frame.channels() == 4) {
+        cv::cvtColor(frame, slot, cv::COLOR_BGRA2BGR);
+    } else {
+        frame.copyTo(slot);
+    }
+
+    lock.lock();
+    queue_.push_back(slot);
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+void FramePipeWriter::writerLoop() {
+    cv::Mat yuv;
+    std::vector<uint8_t> packed;
+    for (;;) {
+        cv::Mat frame;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !queue_.empty() || stopping_; });
+            if (queue_.empty()) break;   // stopping and drained
+            frame = queue_.front();
+            queue_.pop_front();
+        }
+        cv_.notify_all();
+
+        bool ok = writeFrame(frame, yuv, packed);
+
+        std::lock_guard<std::mutex> lock(mutex_);
+        pool_.push_back(frame);
+        if (!ok) {
+            failed_ = true;
+            error_ = std::string("Pipe write failed: ") + std::strerror(errno);
+            queue_.clear();
+            cv_.notify_all();
+            break;
+        }
+    }
+}
+
+bool FramePipeWriter::writeBytes(const void* data, size_t size) {
+    if (std::fwrite(data, 1, size, out_) != size) return false;
+    bytesWritten_ += size;
+    return true;
+}
+
+bool FramePipeWriter::writeFrame(const cv::Mat& bgr, cv::Mat& yuv, std::vector<uint8_t>& packed) {
+    static const char kFrameTag[] = "FRAME\n";
+    const size_t lumaSize = static_cast<size_t>(width_) * height_;
+
+    switch (format_) {
+        case PipeFormat::BGR24: {
+            for (int y = 0; y < bgr.rows; ++y) {
+                if (!writeBytes(bgr.ptr<uint8_t>(y), static_cast<size_t>(width_) * 3)) return false;
+            }
+            break;
+        }
+        case PipeFormat::Y4M: {
+            cv::cvtColor(bgr, yuv, cv::COLOR_BGR2YUV_I420);   // Contiguous Y, U, V planes
+            if (!writeBytes(kFrameTag, sizeof(kFrameTag) - 1)) return false;
+            if (!writeBytes(yuv.data, lumaSize * 3 / 2)) return false;
+            break;
+        }
+        case PipeFormat::NV12: {
+            cv::cvtColor(bgr, yuv, cv::COLOR_BGR2YUV_I420);
+            const size_t chromaSize = lumaSize / 4;
+            const uint8_t* u = yuv.data + lumaSize;
+            const uint8_t* v = u + chromaSize;
+            packed.resize(chromaSize * 2);
+            for (size_t i = 0; i < chromaSize; ++i) {
+                packed[2 * i] = u[i];
+                packed[2 * i + 1] = v[i];
+            }
+            if (!writeBytes(yuv.data, lumaSize)) return false;
+            if (!writeBytes(packed.data(), packed.size())) return false;
+            break;
+        }
+    }
+    ++framesWritten_;
+    return true;
+}
+
+ErrorResult FramePipeWriter::close() {
+    if (!out_) return ErrorResult::success();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    if (thread_.joinable()) thread_.join();
+
+    bool flushed = (std::fflush(out_) == 0);
+    if (ownsStream_) {
+        flushed = (std::fclose(out_) == 0) && flushed;
+    }
+    out_ = nullptr;
+    queue_.clear();
+    pool_.clear();
+
+    if (failed_) return ErrorResult::failure(error_);
+    if (!flushed) return ErrorResult::failure("Failed to flush pipe");
+    return ErrorResult::success();
+}
+
+} // namespace zed_tools
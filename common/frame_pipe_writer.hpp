@@ -0,0 +1,119 @@
+/**
+ * @file frame_pipe_writer.hpp
+ * @brief Streams raw video frames to stdout or a named pipe for external encoders
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Lets ffmpeg/gstreamer run concurrently with SVO decoding, with no
+ * intermediate file and no lossy double encode:
+ * @code
+ * video_extractor_cli flight.svo2 --pipe - | ffmpeg -i - -c:v libx265 -crf 22 out.mkv
+ * video_extractor_cli flight.svo2 --pipe - --pipe-format bgr24 | \
+ *     ffmpeg -f rawvideo -pix_fmt bgr24 -s 1920x1080 -r 30 -i - ...
+ * @endcode
+ *
+ * Formats:
+ * - y4m:   YUV4MPEG2 stream (self-describing header, 4:2:0 planar, BT.601)
+ * - bgr24: packed BGR rows (rawvideo; geometry/rate are logged for the consumer)
+ * - nv12:  Y plane + interleaved UV plane (rawvideo)
+ *
+ * Frames are copied into a small pool on the caller's thread. A writer thread
+ * converts and writes them, so encoding downstream overlaps with decoding
+ * here. When the consumer falls behind, write() blocks once the queue is full.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include <opencv2/core.hpp>
+#include "error_handler.hpp"
+
+namespace zed_tools {
+
+/**
+ * @brief Pixel layout on the pipe
+ */
+enum class PipeFormat {
+    Y4M,        ///< YUV4MPEG2 with 4:2:0 planar frames
+    BGR24,      ///< Raw packed BGR
+    NV12        ///< Raw NV12 (Y plane, then interleaved UV)
+};
+
+/**
+ * @brief Threaded raw-frame writer to stdout, a FIFO, or a Windows named pipe
+ */
+class FramePipeWriter {
+public:
+    FramePipeWriter() = default;
+    ~FramePipeWriter();
+
+    FramePipeWriter(const FramePipeWriter&) = delete;
+    FramePipeWriter& operator=(const FramePipeWriter&) = delete;
+
+    /**
+     * @brief Parse "y4m", "bgr24" or "nv12"
+     * @return false for unknown names
+     */
+    static bool parseFormat(const std::string& name, PipeFormat& format);
+
+    /**
+     * @brief Open the pipe and start the writer thread
+     * @param target "-" for stdout; a path for a FIFO (created on POSIX if missing);
+     *        "\\\\.\\pipe\\name" for a Windows named pipe (waits for the reader)
+     * @param format Pixel layout
+     * @param width Frame width (must be even for y4m/nv12)
+     * @param height Frame height (must be even for y4m/nv12)
+     * @param fps Frame rate (written to the Y4M header)
+     * @param queueDepth Frames buffered between caller and writer thread
+     */
+    ErrorResult open(const std::string& target, PipeFormat format, int width, int height,
+                     double fps, size_t queueDepth = 8);
+
+    /**
+     * @brief Queue one BGR (CV_8UC3) or BGRA (CV_8UC4) frame; blocks while the queue is full
+     * @return false if the pipe failed (e.g., consumer exited)
+     */
+    bool write(const cv::Mat& frame);
+
+    /**
+     * @brief Drain the queue, stop the thread and close the pipe
+     */
+    ErrorResult close();
+
+    bool isOpen() const { return out_ != nullptr; }
+    uint64_t getFramesWritten() const { return framesWritten_; }
+    uint64_t getBytesWritten() const { return bytesWritten_; }
+
+private:
+    FILE* out_ = nullptr;
+    bool ownsStream_ = false;         ///< false for stdout
+    PipeFormat format_ = PipeFormat::Y4M;
+    int width_ = 0;
+    int height_ = 0;
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<cv::Mat> queue_;       ///< Frames waiting for the writer
+    std::vector<cv::Mat> pool_;       ///< Recycled frame buffers
+    size_t queueDepth_ = 8;
+    bool stopping_ = false;
+    bool failed_ = false;
+    std::string error_;
+    std::atomic<uint64_t> framesWritten_{0};
+    std::atomic<uint64_t> bytesWritten_{0};
+
+    void writerLoop();
+    bool writeBytes(const void* data, size_t size);
+    bool writeFrame(const cv::Mat& bgr, cv::Mat& yuv, std::vector<uint8_t>& packed);
+};
+
+} // namespace zed_tools
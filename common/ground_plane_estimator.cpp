@@ -0,0 +1,201 @@
+/**
+ * @file ground_plane_estimator.cpp
+ * @brief Implementation of the ground-plane estimator
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "ground_plane_estimator.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace zed_extractor {
+
+GroundPlaneEstimator::GroundPlaneEstimator(const GroundPlaneConfig& config)
+    : config_(config)
+{
+}
+
+void GroundPlaneEstimator::reset() {
+    last_ = GroundPlane();
+}
+
+uint32_t GroundPlaneEstimator::nextRandom() {
+    rng_ ^= rng_ << 13;
+    rng_ ^= rng_ >> 17;
+    rng_ ^= rng_ << 5;
+    return rng_;
+}
+
+int GroundPlaneEstimator::countInliers(const GroundPlane& p) const {
+    int count = 0;
+    for (const Point3& s : samples_) {
+        float dist = std::fabs(p.nx * s.x + p.ny * s.y + p.nz * s.z + p.d);
+        float band = config_.inlierBand + config_.inlierBandPerMeter * s.z;
+        count += (dist <= band) ? 1 : 0;
+    }
+    return count;
+}
+
+bool GroundPlaneEstimator::acceptable(const GroundPlane& p) const {
+    // Camera "up" is -y; the normal must point roughly up and the camera must be above ground
+    float cosTilt = -p.ny;
+    return p.d > 0.0f && cosTilt >= std::cos(config_.maxTiltDeg * static_cast<float>(CV_PI) / 180.0f);
+}
+
+bool GroundPlaneEstimator::refine(GroundPlane& p) const {
+    // Least-squares plane through the inliers: normal = smallest eigenvector of the covariance
+    double sx = 0, sy = 0, sz = 0;
+    int n = 0;
+    for (const Point3& s : samples_) {
+        float dist = std::fabs(p.nx * s.x + p.ny * s.y + p.nz * s.z + p.d);
+        if (dist > config_.inlierBand + config_.inlierBandPerMeter * s.z) continue;
+        sx += s.x; sy += s.y; sz += s.z; ++n;
+    }
+    if (n < 3) return false;
+    double mx = sx / n, my = sy / n, mz = sz / n;
+    double cxx = 0, cxy = 0, cxz = 0, cyy = 0, cyz = 0, czz = 0;
+    for (const Point3& s : samples_) {
+        float dist = std::fabs(p.nx * s.x + p.ny * s.y + p.nz * s.z + p.d);
+        if (dist > config_.inlierBand + config_.inlierBandPerMeter * s.z) continue;
+        double dx = s.x - mx, dy = s.y - my, dz = s.z - mz;
+        cxx += dx * dx; cxy += dx * dy; cxz += dx * dz;
+        cyy += dy * dy; cyz += dy * dz; czz += dz * dz;
+    }
+    cv::Matx33d cov(cxx, cxy, cxz, cxy, cyy, cyz, cxz, cyz, czz);
+    cv::Mat evals, evecs;
+    if (!cv::eigen(cov, evals, evecs)) return false;
+    // Eigenvalues are sorted descending; last row is the normal
+    GroundPlane r;
+    r.nx = static_cast<float>(evecs.at<double>(2, 0));
+    r.ny = static_cast<float>(evecs.at<double>(2, 1));
+    r.nz = static_cast<float>(evecs.at<double>(2, 2));
+    r.d = static_cast<float>(-(r.nx * mx + r.ny * my + r.nz * mz));
+    if (r.d < 0.0f) { r.nx = -r.nx; r.ny = -r.ny; r.nz = -r.nz; r.d = -r.d; }
+    if (!acceptable(r)) return false;
+    r.valid = true;
+    p = r;
+    return true;
+}
+
+bool GroundPlaneEstimator::estimate(const cv::Mat& depth, const CameraIntrinsics& K, GroundPlane& out) {
+    out = GroundPlane();
+    if (depth.empty() || depth.type() != CV_32FC1 || K.fx <= 0.0f || K.fy <= 0.0f) return false;
+
+    // Strided sample sized so that roughly maxSamples pixels are visited
+    int stride = std::max(1, static_cast<int>(std::sqrt(static_cast<double>(depth.total()) / config_.maxSamples)));
+    samples_.clear();
+    const float ifx = 1.0f / K.fx, ify = 1.0f / K.fy;
+    for (int v = stride / 2; v < depth.rows; v += stride) {
+        const float* row = depth.ptr<float>(v);
+        float ry = (v - K.cy) * ify;
+        for (int u = stride / 2; u < depth.cols; u += stride) {
+            float z = row[u];
+            if (!(z > 0.0f && z <= config_.maxRange)) continue;
+            samples_.push_back({ (u - K.cx) * ifx * z, ry * z, z });
+        }
+    }
+    const int n = static_cast<int>(samples_.size());
+    if (n < 16) {
+        last_.valid = false;
+        return false;
+    }
+    const int minInliers = static_cast<int>(config_.minInlierFraction * n);
+
+    GroundPlane best;
+    int bestCount = -1;
+    int iterations = config_.iterations;
+    if (last_.valid) {
+        int warm = countInliers(last_);
+        if (warm >= minInliers) {
+            best = last_;
+            bestCount = warm;
+            iterations = config_.warmIterations;
+        }
+    }
+
+    for (int it = 0; it < iterations; ++it) {
+        const Point3& a = samples_[nextRandom() % n];
+        const Point3& b = samples_[nextRandom() % n];
+        const Point3& c = samples_[nextRandom() % n];
+        float ux = b.x - a.x, uy = b.y - a.y, uz = b.z - a.z;
+        float vx = c.x - a.x, vy = c.y - a.y, vz = c.z - a.z;
+        GroundPlane h;
+        h.nx = uy * vz - uz * vy;
+        h.ny = uz * vx - ux * vz;
+        h.nz = ux * vy - uy * vx;
+        float len = std::sqrt(h.nx * h.nx + h.ny * h.ny + h.nz * h.nz);
+        if (len < 1e-6f) continue;
+        h.nx /= len; h.ny /= len; h.nz /= len;
+        h.d = -(h.nx * a.x + h.ny * a.y + h.nz * a.z);
+        if (h.d < 0.0f) { h.nx = -h.nx; h.ny = -h.ny; h.nz = -h.nz; h.d = -h.d; }
+        if (!acceptable(h)) continue;
+        int count = countInliers(h);
+        if (count > bestCount) {
+            best = h;
+            bestCount = count;
+        }
+    }
+
+    if (bestCount < minInliers || bestCount <= 0) {
+        last_.valid = false;
+        return false;
+    }
+    if (!refine(best)) {
+        best.valid = acceptable(best);
+        if (!best.valid) { last_.valid = false; return false; }
+    }
+    best.inlierFraction = static_cast<float>(countInliers(best)) / n;
+    best.valid = true;
+    last_ = best;
+    out = best;
+    return true;
+}
+
+void GroundPlaneEstimator::buildMasks(const cv::Mat& depth, const CameraIntrinsics& K, const GroundPlane& plane,
+                                      cv::Mat& ground, cv::Mat& sky, cv::Mat& objects) const {
+    ground.create(depth.size(), CV_8UC1);
+    sky.create(depth.size(), CV_8UC1);
+    objects.create(depth.size(), CV_8UC1);
+    if (!plane.valid || K.fx <= 0.0f || K.fy <= 0.0f) {
+        ground.setTo(0);
+        sky.setTo(0);
+        objects.setTo(0);
+        return;
+    }
+
+    // n.r(u,v) is affine in u and v, so height = (a*u + rowTerm) * z + d per pixel
+    const float a = plane.nx / K.fx;
+    const float b = plane.ny / K.fy;
+    const float c = plane.nz - plane.nx * K.cx / K.fx - plane.ny * K.cy / K.fy;
+    const float d = plane.d;
+    const float band0 = config_.inlierBand;
+    const float bandZ = config_.inlierBandPerMeter;
+    const float objH = config_.objectMinHeight;
+    const float maxRange = config_.maxRange;
+
+    zed_tools::parallelFor(0, depth.rows, [&](int rowBegin, int rowEnd) {
+        for (int v = rowBegin; v < rowEnd; ++v) {
+            const float* z = depth.ptr<float>(v);
+            uchar* g = ground.ptr<uchar>(v);
+            uchar* s = sky.ptr<uchar>(v);
+            uchar* o = objects.ptr<uchar>(v);
+            float rowTerm = b * v + c;
+            for (int u = 0; u < depth.cols; ++u) {
+                float nr = a * u + rowTerm;       // n . ray; >= 0 means the ray never meets the ground
+                float zz = z[u];
+                bool valid = (zz > 0.0f) && (zz <= maxRange);
+                float zs = valid ? zz : 0.0f;
+                float h = nr * zs + d;
+                float band = band0 + bandZ * zs;
+                g[u] = (valid && std::fabs(h) <= band) ? 255 : 0;
+                o[u] = (valid && h >= objH) ? 255 : 0;
+                s[u] = (!valid && nr >= 0.0f) ? 255 : 0;
+            }
+        }
+    }, 16);
+}
+
+} // namespace zed_extractor
@@ -0,0 +1,70 @@
+/**
+ * @file hash_utils.hpp
+ * @brief SHA-256 and HMAC-SHA256 (no external crypto dependency)
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Used for object-store request signing (AWS SigV4) and for checksums of
+ * output products. Streaming interface so large files never have to be
+ * held in memory.
+ */
+
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace zed_tools {
+
+/**
+ * @brief Incremental SHA-256 (FIPS 180-4)
+ */
+class Sha256 {
+public:
+    using Digest = std::array<uint8_t, 32>;
+
+    Sha256();
+
+    void update(const void* data, size_t size);
+    void update(const std::string& data) { update(data.data(), data.size()); }
+
+    /**
+     * @brief Finish and return the digest (the object must be reset() before reuse)
+     */
+    Digest finish();
+
+    void reset();
+
+    /// One-shot helpers
+    static Digest hash(const void* data, size_t size);
+    static std::string hashHex(const void* data, size_t size);
+    static std::string hashHex(const std::string& data) { return hashHex(data.data(), data.size()); }
+
+private:
+    uint32_t state_[8];
+    uint8_t buffer_[64];
+    uint64_t totalBytes_ = 0;
+    size_t bufferLen_ = 0;
+
+    void transform(const uint8_t* block);
+};
+
+/**
+ * @brief HMAC-SHA256 of data under key
+ */
+Sha256::Digest hmacSha256(const void* key, size_t keySize, const void* data, size_t dataSize);
+
+/**
+ * @brief Lowercase hex of a byte range
+ */
+std::string toHex(const uint8_t* data, size_t size);
+
+/**
+ * @brief SHA-256 of a file's contents as lowercase hex
+ * @return Empty string if the file cannot be read
+ */
+std::string sha256FileHex(const std::string& path);
+
+} // namespace zed_tools
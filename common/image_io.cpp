@@ -0,0 +1,97 @@
+/**
+ * @file image_io.cpp
+ * @brief Implementation of extension-dispatched image I/O
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "image_io.hpp"
+#include "qoi_codec.hpp"
+
+#include <algorithm>
+#include <cctype>
+#include <filesystem>
+
+namespace zed_tools {
+
+namespace {
+
+std::string lowerExtension(const std::string& path) {
+    size_t dot = path.find_last_of('.');
+    if (dot == std::string::npos) return "";
+    std::string ext = path.substr(dot);
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    return ext;
+}
+
+/**
+ * @brief QOI holds 8-bit gray/BGR/BGRA only; 16-bit products (occupancy grids) stay PNG
+ */
+bool isQoiCompatible(const cv::Mat& image) {
+    return !image.empty() && image.depth() == CV_8U && image.channels() != 2;
+}
+
+} // namespace
+
+std::string imageExtension(const std::string& format) {
+    std::string ext = format;
+    std::transform(ext.begin(), ext.end(), ext.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+    if (ext == "jpeg") ext = "jpg";
+    return "." + ext;
+}
+
+bool encodeImage(const std::string& ext, const cv::Mat& image, std::vector<uchar>& out, int pngCompression) {
+    if (lowerExtension(ext) == ".qoi") {
+        if (!isQoiCompatible(image)) return false;
+        return qoiEncode(image.data, image.cols, image.rows, image.channels(), image.step[0], out);
+    }
+    std::vector<int> params;
+    if (pngCompression >= 0 && lowerExtension(ext) == ".png") {
+        params = {cv::IMWRITE_PNG_COMPRESSION, pngCompression};
+    }
+    return cv::imencode(ext, image, out, params);
+}
+
+bool writeImageFile(const std::string& path, const cv::Mat& image, int pngCompression) {
+    const std::string ext = lowerExtension(path);
+    if (ext == ".qoi") {
+        if (!isQoiCompatible(image)) return false;
+        return qoiWriteFile(path, image.data, image.cols, image.rows, image.channels(), image.step[0]);
+    }
+    std::vector<int> params;
+    if (pngCompression >= 0 && ext == ".png") params = {cv::IMWRITE_PNG_COMPRESSION, pngCompression};
+    return cv::imwrite(path, image, params);
+}
+
+cv::Mat readImageFile(const std::string& path, int flags) {
+    if (lowerExtension(path) != ".qoi") return cv::imread(path, flags);
+
+    int channels = 0;   // As stored
+    if (flags == cv::IMREAD_GRAYSCALE) channels = 1;
+    else if (flags == cv::IMREAD_COLOR) channels = 3;
+    QoiImage decoded;
+    if (!qoiReadFile(path, decoded, channels)) return cv::Mat();
+    const int type = CV_MAKETYPE(CV_8U, decoded.channels);
+    cv::Mat image = cv::Mat(decoded.height, decoded.width, type, decoded.pixels.data()).clone();
+
+    // Gray sources are stored as r == g == b; give them back as one channel like PNG would
+    if (flags == cv::IMREAD_UNCHANGED && image.channels() == 3) {
+        std::vector<cv::Mat> planes;
+        cv::split(image, planes);
+        if (cv::countNonZero(planes[0] != planes[1]) == 0 && cv::countNonZero(planes[1] != planes[2]) == 0) {
+            return planes[1];
+        }
+    }
+    return image;
+}
+
+std::string findImageFile(const std::string& stem) {
+    std::error_code ec;
+    for (const char* ext : {".qoi", ".png", ".jpg"}) {
+        std::string path = stem + ext;
+        if (std::filesystem::exists(path, ec)) return path;
+    }
+    return "";
+}
+
+} // namespace zed_tools
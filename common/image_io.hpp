@@ -0,0 +1,47 @@
+/**
+ * @file image_io.hpp
+ * @brief Image read/write that dispatches on the extension (.qoi in-tree, the rest via OpenCV)
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/imgcodecs.hpp>
+
+namespace zed_tools {
+
+/**
+ * @brief Lower-case extension including the dot for a format name ("png" -> ".png")
+ */
+std::string imageExtension(const std::string& format);
+
+/**
+ * @brief Write an 8-bit image; ".qoi" uses the in-tree codec, anything else cv::imwrite
+ * @param pngCompression PNG zlib level 0-9 (-1 = OpenCV default)
+ */
+bool writeImageFile(const std::string& path, const cv::Mat& image, int pngCompression = -1);
+
+/**
+ * @brief Encode into memory; `ext` as for cv::imencode (".png", ".qoi", ...)
+ */
+bool encodeImage(const std::string& ext, const cv::Mat& image, std::vector<uchar>& out, int pngCompression = -1);
+
+/**
+ * @brief Read an image; flags as for cv::imread (IMREAD_COLOR, IMREAD_GRAYSCALE, IMREAD_UNCHANGED)
+ *
+ * QOI files stored from a gray image come back gray under IMREAD_UNCHANGED.
+ */
+cv::Mat readImageFile(const std::string& path, int flags = cv::IMREAD_COLOR);
+
+/**
+ * @brief First existing "<stem><ext>" among .qoi, .png and .jpg (empty if none)
+ *
+ * Lets readers find products regardless of the format they were written in.
+ */
+std::string findImageFile(const std::string& stem);
+
+} // namespace zed_tools
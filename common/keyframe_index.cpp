@@ -0,0 +1,236 @@
+/**
+ * @file keyframe_index.cpp
+ * @brief Implementation of the keyframe index and sample planner
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "keyframe_index.hpp"
+#include "svo_container_reader.hpp"
+
+#include <algorithm>
+#include <cstdlib>
+#include <map>
+
+namespace zed_tools {
+
+namespace {
+
+enum class VideoCodec { Unknown, H264, H265 };
+
+enum FrameClass : uint8_t { kUnclassified = 0, kKey = 1, kDelta = 2 };
+
+// Keyframes carry parameter sets and the first slice early; no need to scan whole frames
+const size_t kScanBytes = 4096;
+
+// Size heuristic: a frame this many times the recent median is taken as a keyframe
+const double kSizeOutlierFactor = 2.5;
+const size_t kSizeWindow = 31;
+
+/**
+ * @brief Classify one Annex-B access unit by its first slice NAL unit
+ * @param codec Detected from parameter sets / delimiters on first use, then kept
+ */
+FrameClass classifyAnnexB(const uint8_t* data, size_t size, VideoCodec& codec) {
+    const size_t end = std::min(size, kScanBytes);
+    for (size_t i = 0; i + 3 < end; ++i) {
+        if (data[i] != 0 || data[i + 1] != 0 || data[i + 2] != 1) continue;
+        const uint8_t h = data[i + 3];
+        i += 3;
+        if (h & 0x80) continue;   // forbidden_zero_bit set: not a NAL header
+
+        if (codec == VideoCodec::Unknown) {
+            const int hevcType = (h >> 1) & 0x3f;
+            if (hevcType >= 32 && hevcType <= 35) codec = VideoCodec::H265;        // VPS/SPS/PPS/AUD
+            else if ((h & 0x1f) == 7 || (h & 0x1f) == 9) codec = VideoCodec::H264; // SPS/AUD
+            else continue;
+        }
+        if (codec == VideoCodec::H264) {
+            const int type = h & 0x1f;
+            if (type == 5) return kKey;     // IDR slice
+            if (type == 1) return kDelta;   // Non-IDR slice
+        } else {
+            const int type = (h >> 1) & 0x3f;
+            if (type >= 16 && type <= 21) return kKey;  // BLA/IDR/CRA
+            if (type <= 9) return kDelta;               // Trailing/leading pictures
+        }
+    }
+    return kUnclassified;
+}
+
+/**
+ * @brief Per-channel scan state
+ */
+struct ChannelScan {
+    uint64_t bytes = 0;
+    std::vector<uint32_t> sizes;
+    std::vector<uint8_t> classes;
+    std::vector<uint64_t> offsets;
+    VideoCodec codec = VideoCodec::Unknown;
+};
+
+} // namespace
+
+const char* keyframeSourceName(KeyframeSource source) {
+    switch (source) {
+        case KeyframeSource::Bitstream: return "bitstream";
+        case KeyframeSource::FrameSize: return "frame_size";
+        case KeyframeSource::IntraOnly: return "intra_only";
+        default: return "none";
+    }
+}
+
+bool KeyframeIndex::build(const std::string& svoFilePath) {
+    *this = KeyframeIndex();
+
+    SvoContainerReader reader(svoFilePath);
+    if (!reader.open()) {
+        lastError_ = reader.getLastError();
+        return false;
+    }
+
+    std::map<uint16_t, ChannelScan> scans;
+    bool ok = reader.readMessages([&](const ContainerChannel& ch, const ContainerMessage& msg) {
+        ChannelScan& scan = scans[ch.id];
+        scan.bytes += msg.size;
+        scan.sizes.push_back(static_cast<uint32_t>(std::min<size_t>(msg.size, UINT32_MAX)));
+        scan.classes.push_back(classifyAnnexB(msg.data, msg.size, scan.codec));
+        scan.offsets.push_back(msg.fileOffset);
+        return true;
+    });
+    if (!ok) {
+        lastError_ = reader.getLastError();
+        return false;
+    }
+
+    // The video channel dwarfs every sensor channel in payload bytes
+    auto best = scans.end();
+    for (auto it = scans.begin(); it != scans.end(); ++it) {
+        if (it->second.sizes.size() < 2) continue;
+        if (best == scans.end() || it->second.bytes > best->second.bytes) best = it;
+    }
+    if (best == scans.end()) {
+        lastError_ = "No video channel found in container";
+        return false;
+    }
+    const auto channelIt = reader.getChannels().find(best->first);
+    if (channelIt != reader.getChannels().end()) videoTopic_ = channelIt->second.topic;
+
+    const ChannelScan& scan = best->second;
+    const int frames = static_cast<int>(scan.sizes.size());
+    const size_t classified = static_cast<size_t>(
+        std::count_if(scan.classes.begin(), scan.classes.end(), [](uint8_t c) { return c != kUnclassified; }));
+
+    std::vector<int> keyframes;
+    KeyframeSource source;
+    if (classified * 10 >= scan.classes.size() * 9) {
+        source = KeyframeSource::Bitstream;
+        for (int i = 0; i < frames; ++i) {
+            if (scan.classes[i] == kKey) keyframes.push_back(i);
+        }
+    } else {
+        source = KeyframeSource::FrameSize;
+        std::vector<uint32_t> window;
+        for (int i = 0; i < frames; ++i) {
+            const int from = std::max(0, i - static_cast<int>(kSizeWindow));
+            window.assign(scan.sizes.begin() + from, scan.sizes.begin() + i);
+            if (window.empty()) continue;
+            std::nth_element(window.begin(), window.begin() + window.size() / 2, window.end());
+            const double median = window[window.size() / 2];
+            if (median > 0.0 && scan.sizes[i] > kSizeOutlierFactor * median) keyframes.push_back(i);
+        }
+    }
+    // Nothing but the first frame stands out: no GOP structure to exploit
+    const bool intraOnly = (source == KeyframeSource::Bitstream && static_cast<int>(keyframes.size()) == frames) ||
+                           (source == KeyframeSource::FrameSize && keyframes.empty());
+    assign(frames, intraOnly ? std::vector<int>() : std::move(keyframes),
+           intraOnly ? KeyframeSource::IntraOnly : source);
+    frameOffsets_ = scan.offsets;
+    return true;
+}
+
+void KeyframeIndex::assign(int frameCount, std::vector<int> keyframes, KeyframeSource source) {
+    frameCount_ = std::max(0, frameCount);
+    frameOffsets_.clear();
+    keyframes_ = std::move(keyframes);
+    std::sort(keyframes_.begin(), keyframes_.end());
+    keyframes_.erase(std::unique(keyframes_.begin(), keyframes_.end()), keyframes_.end());
+    // Decoding always starts at a keyframe
+    if (source != KeyframeSource::IntraOnly && (keyframes_.empty() || keyframes_.front() != 0)) {
+        keyframes_.insert(keyframes_.begin(), 0);
+    }
+    source_ = source;
+}
+
+double KeyframeIndex::getMeanGop() const {
+    if (source_ == KeyframeSource::IntraOnly) return 1.0;
+    if (keyframes_.empty()) return 0.0;
+    return static_cast<double>(frameCount_) / keyframes_.size();
+}
+
+bool KeyframeIndex::isKeyframe(int frame) const {
+    if (source_ == KeyframeSource::IntraOnly) return true;
+    return std::binary_search(keyframes_.begin(), keyframes_.end(), frame);
+}
+
+int KeyframeIndex::previousKeyframe(int frame) const {
+    if (source_ == KeyframeSource::IntraOnly) return frame;
+    auto it = std::upper_bound(keyframes_.begin(), keyframes_.end(), frame);
+    return (it == keyframes_.begin()) ? 0 : *(it - 1);
+}
+
+int KeyframeIndex::decodeDistance(int frame) const {
+    return frame - previousKeyframe(frame);
+}
+
+int KeyframeIndex::reachCost(int frame, int lastDecoded) const {
+    const int key = previousKeyframe(frame);
+    int cost = frame - key;
+    // Same GOP and ahead of the decoder: keep decoding forward instead of seeking back
+    if (lastDecoded >= 0 && lastDecoded < frame && key <= lastDecoded) {
+        cost = std::min(cost, frame - lastDecoded - 1);
+    }
+    return cost;
+}
+
+int KeyframeIndex::snap(int target, int tolerance, int lastDecoded) const {
+    int lo = std::max(target - std::max(0, tolerance), lastDecoded + 1);
+    int hi = target + std::max(0, tolerance);
+    if (frameCount_ > 0) hi = std::min(hi, frameCount_ - 1);
+    lo = std::max(lo, 0);
+    if (lo > hi) return -1;
+    if (source_ == KeyframeSource::None) return std::max(target, lo);
+
+    // Same measure as the plan reports: continuing forward costs the frames grabbed on
+    // the way, a seek costs the frames from the previous keyframe
+    int bestFrame = -1;
+    int bestCost = 0;
+    for (int f = lo; f <= hi; ++f) {
+        const int cost = reachCost(f, lastDecoded);
+        if (bestFrame < 0 || cost < bestCost ||
+            (cost == bestCost && std::abs(f - target) < std::abs(bestFrame - target))) {
+            bestFrame = f;
+            bestCost = cost;
+        }
+    }
+    return bestFrame;
+}
+
+std::vector<KeyframeSample> KeyframeIndex::planSamples(int firstFrame, int endFrame, int interval, int tolerance) const {
+    std::vector<KeyframeSample> plan;
+    interval = std::max(1, interval);
+    int last = -1;
+    for (int target = std::max(0, firstFrame); target < endFrame; target += interval) {
+        int actual = snap(target, tolerance, last);
+        if (actual < 0 || actual >= endFrame) continue;
+        KeyframeSample sample;
+        sample.requestedFrame = target;
+        sample.actualFrame = actual;
+        sample.decodeDistance = reachCost(actual, last);
+        plan.push_back(sample);
+        last = actual;
+    }
+    return plan;
+}
+
+} // namespace zed_tools
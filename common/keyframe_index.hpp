@@ -0,0 +1,137 @@
+/**
+ * @file keyframe_index.hpp
+ * @brief Keyframe positions of the SVO2 video stream and keyframe-aware sample planning
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Seeking an H.264/H.265 SVO to an arbitrary frame makes the SDK decode
+ * everything from the previous keyframe. For sparse sampling (e.g. 1 frame
+ * per second) this index lets each sample move by a few frames to the one
+ * that is cheapest to reach, so a seek costs a handful of decodes instead
+ * of most of a GOP.
+ *
+ * The index is built from the container without the SDK: the video channel
+ * is the one with the most payload bytes, its n-th message is SVO frame n,
+ * and keyframes are found by scanning the Annex-B NAL units at the start of
+ * each payload. When the payload is not Annex-B, frames much larger than
+ * their neighbours are taken as keyframes.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace zed_tools {
+
+/**
+ * @brief How keyframes were identified
+ */
+enum class KeyframeSource {
+    None,        ///< Index not built
+    Bitstream,   ///< IDR/IRAP NAL units in the payload
+    FrameSize,   ///< Payload size outliers (non Annex-B payloads)
+    IntraOnly    ///< No GOP structure found; every frame decodes on its own
+};
+
+/**
+ * @brief One planned sample
+ */
+struct KeyframeSample {
+    int requestedFrame = 0;    ///< Frame on the regular sampling grid
+    int actualFrame = 0;       ///< Frame to extract after snapping
+    int decodeDistance = 0;    ///< Frames decoded before actualFrame when seeking to it
+};
+
+/**
+ * @brief Keyframe index of one SVO2 file
+ *
+ * Example usage:
+ * @code
+ * KeyframeIndex index;
+ * if (index.build("flight.svo2")) {
+ *     for (const auto& s : index.planSamples(0, totalFrames, 30, 3)) {
+ *         // seek to s.actualFrame
+ *     }
+ * }
+ * @endcode
+ */
+class KeyframeIndex {
+public:
+    /**
+     * @brief Read the container and locate keyframes of the video channel
+     * @return false if the file cannot be read or has no video-like channel
+     */
+    bool build(const std::string& svoFilePath);
+
+    /**
+     * @brief Set the index directly (sorted or unsorted keyframe list)
+     */
+    void assign(int frameCount, std::vector<int> keyframes, KeyframeSource source);
+
+    int getFrameCount() const { return frameCount_; }
+    size_t getKeyframeCount() const { return keyframes_.size(); }
+    KeyframeSource getSource() const { return source_; }
+    const std::string& getVideoTopic() const { return videoTopic_; }
+    std::string getLastError() const { return lastError_; }
+
+    /**
+     * @brief File offset of every video frame (filled by build(), empty after assign())
+     */
+    const std::vector<uint64_t>& getFrameOffsets() const { return frameOffsets_; }
+
+    /**
+     * @brief Mean distance between keyframes (frames per GOP)
+     */
+    double getMeanGop() const;
+
+    bool isKeyframe(int frame) const;
+
+    /**
+     * @brief Last keyframe at or before frame (0 if none is known)
+     */
+    int previousKeyframe(int frame) const;
+
+    /**
+     * @brief Frames decoded before `frame` when seeking to it
+     */
+    int decodeDistance(int frame) const;
+
+    /**
+     * @brief Cheapest frame to reach within target +- tolerance
+     * @param lastDecoded Frame the decoder is positioned on (-1 = none); frames
+     *        after it in the same GOP may be reached by decoding forward instead,
+     *        which is chosen only when fewer frames are decoded than by seeking
+     * @return Chosen frame after lastDecoded (ties go to the frame closest to
+     *         target), or -1 if the window holds no such frame
+     */
+    int snap(int target, int tolerance, int lastDecoded = -1) const;
+
+    /**
+     * @brief Plan samples every `interval` frames in [firstFrame, endFrame)
+     *
+     * Samples stay strictly increasing, so two requests never snap to the same frame.
+     */
+    std::vector<KeyframeSample> planSamples(int firstFrame, int endFrame, int interval, int tolerance) const;
+
+private:
+    int frameCount_ = 0;
+    std::vector<int> keyframes_;        ///< Sorted keyframe positions
+    std::vector<uint64_t> frameOffsets_;
+    KeyframeSource source_ = KeyframeSource::None;
+    std::string videoTopic_;
+    std::string lastError_;
+
+    /**
+     * @brief Cost of reaching frame from lastDecoded (frames decoded before it)
+     */
+    int reachCost(int frame, int lastDecoded) const;
+};
+
+/**
+ * @brief Readable name of a keyframe source ("bitstream", "frame_size", ...)
+ */
+const char* keyframeSourceName(KeyframeSource source);
+
+} // namespace zed_tools
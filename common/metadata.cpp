@@ -132,6 +132,12 @@ void JSONBuilder::addArrayString(const std::string& value) {
     ss << "\"" << value << "\"";
 }
 
+void JSONBuilder::addArrayNumber(int value) {
+    addCommaIfNeeded();
+    addIndent();
+    ss << value;
+}
+
 // ============================================================================
 // VideoMetadata Implementation
 // ============================================================================
@@ -160,6 +166,9 @@ bool VideoMetadata::saveToJSON(const std::string& outputPath) const {
     json.addString("camera_mode", cameraMode);
     json.addString("video_codec", videoCodec);
     json.addString("output_format", outputFormat);
+    if (segmentSeconds > 0.0) {
+        json.addNumber("segment_seconds", segmentSeconds);
+    }
     
     // Output files
     json.beginArray("output_files");
@@ -215,6 +224,15 @@ bool FrameMetadata::saveToJSON(const std::string& outputPath) const {
     json.addNumber("ending_frame_number", endingFrameNumber);
     json.addString("output_directory", outputDirectory);
     
+    // Keyframe-aware sampling
+    if (!keyframeSource.empty()) {
+        json.addNumber("keyframe_tolerance", keyframeTolerance);
+        json.addString("keyframe_source", keyframeSource);
+        json.beginArray("source_frames");
+        for (int frame : sourceFrames) json.addArrayNumber(frame);
+        json.endArray();
+    }
+    
     json.endObject();
     
     // Write to file
@@ -299,6 +317,18 @@ bool DepthMetadata::saveToJSON(const std::string& outputPath) const {
     
     // Output
     json.addString("output_video", outputVideo);
+    json.addString("tracks_file", tracksFile);
+    json.addNumber("flow_motion_frames", flowMotionFrames);
+    json.addString("occupancy_grid_file", occupancyGridFile);
+    json.addString("frame_stats_file", frameStatsFile);
+    json.addNumber("ground_plane_frames", groundPlaneFrames);
+    json.addNumber("mean_camera_height_m", static_cast<double>(meanCameraHeight));
+    
+    // Scheduling
+    json.addString("frame_order", frameOrder);
+    json.addNumber("selected_frames", selectedFrames);
+    json.addBool("time_budget_exhausted", timeBudgetExhausted);
+    json.addString("upload_manifest", uploadManifest);
     
     json.endObject();
     
@@ -366,6 +396,17 @@ bool saveFrameMetadataList(
         file << "  \"source_fps\": " << meta.sourceFps << ",\n";
         file << "  \"output_directory\": \"" << meta.outputDirectory << "\"";
         
+        // Keyframe-aware sampling: actual SVO frame of every file
+        if (!meta.keyframeSource.empty()) {
+            file << ",\n  \"keyframe_tolerance\": " << meta.keyframeTolerance;
+            file << ",\n  \"keyframe_source\": \"" << meta.keyframeSource << "\"";
+            file << ",\n  \"source_frames\": [";
+            for (size_t i = 0; i < meta.sourceFrames.size(); ++i) {
+                file << (i ? ", " : "") << meta.sourceFrames[i];
+            }
+            file << "]";
+        }
+        
         // Add flight info if available
         if (!meta.flightInfo.folderName.empty()) {
             file << ",\n  \"flight_info\": {\n";
@@ -52,9 +52,10 @@ struct VideoMetadata {
     std::string cameraMode;           ///< "left", "right", "both_separate", "both_sidebyside"
     std::string videoCodec;           ///< Video codec used (H.264/H.265)
     std::string outputFormat;         ///< Output format (mp4)
+    double segmentSeconds = 0.0;      ///< Segment length (0 = one file per stream)
     
     // Output files
-    std::vector<std::string> outputFiles;  ///< List of created video files
+    std::vector<std::string> outputFiles;  ///< List of created video files (segment manifests when segmented)
     
     /**
      * @brief Save metadata to JSON file
@@ -89,6 +90,11 @@ struct FrameMetadata {
     int endingFrameNumber;            ///< Last frame number used
     std::string outputDirectory;      ///< Where frames were saved
     
+    // Keyframe-aware sampling
+    int keyframeTolerance = 0;        ///< +- frames a sample could move to a cheaper frame (0 = exact grid)
+    std::string keyframeSource;       ///< How keyframes were found ("bitstream", "frame_size", ...; empty = not used)
+    std::vector<int> sourceFrames;    ///< SVO frame of each extracted file, in file number order
+    
     /**
      * @brief Save metadata to JSON file
      * @param outputPath Path where to save the JSON file
@@ -128,14 +134,26 @@ struct DepthMetadata {
     
     // Analysis results
     struct DepthStatistics {
-        float minDetectedDistance;    ///< Minimum distance detected
-        float maxDetectedDistance;    ///< Maximum distance detected
-        float avgDetectedDistance;    ///< Average distance detected
+        float minDetectedDistance;    ///< Minimum detection distance (blob mean depth, meters)
+        float maxDetectedDistance;    ///< Maximum detection distance (blob mean depth, meters)
+        float avgDetectedDistance;    ///< Average detection distance (blob mean depth, meters)
         int totalObjectsDetected;     ///< Total objects detected across all frames
         int framesWithDetections;     ///< Frames that had detections
     } statistics;
     
     std::string outputVideo;          ///< Path to output heatmap video
+    std::string tracksFile;           ///< Path to per-flight track file (empty if tracking disabled)
+    int flowMotionFrames = 0;         ///< Frames where sparse flow flagged independent motion
+    std::string occupancyGridFile;    ///< Flight-accumulated bird's-eye grid (empty if disabled)
+    std::string frameStatsFile;       ///< Per-frame statistics CSV (empty if not collected)
+    int groundPlaneFrames = 0;        ///< Frames with a ground-plane estimate
+    float meanCameraHeight = 0.0f;    ///< Mean camera height above the ground plane (meters)
+    
+    // Scheduling
+    std::string frameOrder = "sequential"; ///< "sequential" or "coarse_to_fine"
+    int selectedFrames = 0;           ///< Frames selected by the output FPS (totalFrames = processed)
+    bool timeBudgetExhausted = false; ///< Run stopped at its time budget
+    std::string uploadManifest;       ///< Object key of the upload manifest (empty if not uploading)
     
     /**
      * @brief Save metadata to JSON file
@@ -161,6 +179,7 @@ public:
     void addNumber(const std::string& key, int value);
     void addBool(const std::string& key, bool value);
     void addArrayString(const std::string& value);
+    void addArrayNumber(int value);
     
     std::string toString() const { return ss.str(); }
     
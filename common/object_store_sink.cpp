@@ -0,0 +1,691 @@
+/**
+ * @file object_store_sink.cpp
+ * @brief Implementation of the S3-compatible upload sink
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "object_store_sink.hpp"
+#include "hash_utils.hpp"
+#include "metadata.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <ctime>
+#include <filesystem>
+#include <fstream>
+#include <map>
+#include <sstream>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+using SocketHandle = SOCKET;
+#define ZED_INVALID_SOCKET INVALID_SOCKET
+#define zed_close_socket closesocket
+#else
+#include <netdb.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+using SocketHandle = int;
+#define ZED_INVALID_SOCKET (-1)
+#define zed_close_socket ::close
+#endif
+
+namespace fs = std::filesystem;
+
+namespace zed_tools {
+
+namespace {
+
+constexpr int kSocketTimeoutSec = 60;
+constexpr size_t kMinPartSize = 5 * 1024 * 1024;      // S3 lower limit (except the last part)
+
+/**
+ * @brief RFC 3986 encoding as required by SigV4 (optionally keeping '/')
+ */
+std::string uriEncode(const std::string& in, bool encodeSlash) {
+    static const char digits[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(in.size() * 3);
+    for (unsigned char c : in) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~' || (c == '/' && !encodeSlash)) {
+            out.push_back(static_cast<char>(c));
+        } else {
+            out.push_back('%');
+            out.push_back(digits[c >> 4]);
+            out.push_back(digits[c & 0x0f]);
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Text of the first <tag>...</tag> in an XML body
+ */
+std::string xmlValue(const std::string& xml, const std::string& tag) {
+    const std::string open = "<" + tag + ">";
+    size_t begin = xml.find(open);
+    if (begin == std::string::npos) return "";
+    begin += open.size();
+    size_t end = xml.find("</" + tag + ">", begin);
+    if (end == std::string::npos) return "";
+    return xml.substr(begin, end - begin);
+}
+
+std::string stripQuotes(std::string s) {
+    const std::string entity = "&quot;";
+    for (size_t p; (p = s.find(entity)) != std::string::npos;) s.erase(p, entity.size());
+    s.erase(std::remove(s.begin(), s.end(), '"'), s.end());
+    return s;
+}
+
+std::string hmacBytes(const std::string& key, const std::string& data) {
+    Sha256::Digest d = hmacSha256(key.data(), key.size(), data.data(), data.size());
+    return std::string(reinterpret_cast<const char*>(d.data()), d.size());
+}
+
+void utcStamps(std::string& amzDate, std::string& dateStamp) {
+    std::time_t now = std::time(nullptr);
+    std::tm tm{};
+#ifdef _WIN32
+    gmtime_s(&tm, &now);
+#else
+    gmtime_r(&now, &tm);
+#endif
+    char buf[32];
+    std::strftime(buf, sizeof(buf), "%Y%m%dT%H%M%SZ", &tm);
+    amzDate = buf;
+    dateStamp = amzDate.substr(0, 8);
+}
+
+bool sendAll(SocketHandle s, const char* data, size_t size) {
+    while (size > 0) {
+        int chunk = static_cast<int>(std::min<size_t>(size, 1 << 20));
+#if defined(MSG_NOSIGNAL)
+        int n = ::send(s, data, chunk, MSG_NOSIGNAL);
+#else
+        int n = ::send(s, data, chunk, 0);
+#endif
+        if (n <= 0) return false;
+        data += n;
+        size -= static_cast<size_t>(n);
+    }
+    return true;
+}
+
+void initSockets() {
+#ifdef _WIN32
+    static std::once_flag once;
+    std::call_once(once, [] {
+        WSADATA wsa;
+        WSAStartup(MAKEWORD(2, 2), &wsa);
+    });
+#endif
+}
+
+} // namespace
+
+// ============================================================================
+// Internal types
+// ============================================================================
+
+struct ObjectStoreSink::HttpResponse {
+    int status = 0;
+    std::map<std::string, std::string> headers;   ///< Lowercase names
+    std::string body;
+};
+
+struct ObjectStoreSink::Upload {
+    std::string key;                  ///< Full object key (prefix applied)
+    std::string path;                 ///< Source file (empty for in-memory payloads)
+    std::vector<uint8_t> data;        ///< In-memory payload
+    bool deleteAfter = false;
+    uint64_t size = 0;
+    std::string sha256;
+    std::string uploadId;
+    int partCount = 1;
+    std::vector<std::string> etags;   ///< Per part, indexed by partNumber - 1
+    std::atomic<int> partsRemaining{0};
+    std::atomic<bool> failed{false};
+    std::mutex errorMutex;
+    std::string error;
+
+    bool inMemory() const { return path.empty(); }
+    void fail(const std::string& message) {
+        std::lock_guard<std::mutex> lock(errorMutex);
+        if (!failed.exchange(true)) error = message;
+    }
+};
+
+// ============================================================================
+// ObjectStoreConfig
+// ============================================================================
+
+ErrorResult ObjectStoreConfig::fromUrl(const std::string& url, ObjectStoreConfig& config) {
+    const std::string scheme = "http://";
+    if (url.rfind("https://", 0) == 0) {
+        return ErrorResult::failure("https endpoints need a TLS-terminating proxy; use an http:// URL");
+    }
+    if (url.rfind(scheme, 0) != 0) {
+        return ErrorResult::failure("Upload URL must look like http://host[:port]/bucket[/prefix]");
+    }
+    std::string rest = url.substr(scheme.size());
+    size_t slash = rest.find('/');
+    std::string authority = rest.substr(0, slash);
+    std::string path = (slash == std::string::npos) ? "" : rest.substr(slash + 1);
+
+    size_t colon = authority.rfind(':');
+    if (colon != std::string::npos) {
+        config.host = authority.substr(0, colon);
+        try {
+            config.port = std::stoi(authority.substr(colon + 1));
+        } catch (...) {
+            return ErrorResult::failure("Invalid port in upload URL: " + url);
+        }
+    } else {
+        config.host = authority;
+        config.port = 80;
+    }
+
+    while (!path.empty() && path.back() == '/') path.pop_back();
+    size_t bucketEnd = path.find('/');
+    config.bucket = path.substr(0, bucketEnd);
+    config.prefix = (bucketEnd == std::string::npos) ? "" : path.substr(bucketEnd + 1);
+    if (config.host.empty() || config.bucket.empty()) {
+        return ErrorResult::failure("Upload URL needs a host and a bucket: " + url);
+    }
+
+    if (const char* v = std::getenv("AWS_ACCESS_KEY_ID")) config.accessKey = v;
+    if (const char* v = std::getenv("AWS_SECRET_ACCESS_KEY")) config.secretKey = v;
+    if (const char* v = std::getenv("AWS_REGION")) config.region = v;
+    return ErrorResult::success();
+}
+
+// ============================================================================
+// ObjectStoreSink
+// ============================================================================
+
+ObjectStoreSink::~ObjectStoreSink() {
+    if (workers_.empty()) return;
+    // Abandon queued work; finish() is the orderly path
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        tasks_.clear();
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+}
+
+ErrorResult ObjectStoreSink::open(const ObjectStoreConfig& config) {
+    if (!workers_.empty()) return ErrorResult::failure("Upload sink already open");
+    config_ = config;
+    config_.partSize = std::max(config_.partSize, kMinPartSize);
+    config_.workers = std::max(1, config_.workers);
+    config_.maxRetries = std::max(0, config_.maxRetries);
+    initSockets();
+
+    stopping_ = false;
+    completed_.clear();
+    failedKeys_.clear();
+    uploadedBytes_ = 0;
+    uploadedObjects_ = 0;
+    failedObjects_ = 0;
+    for (int i = 0; i < config_.workers; ++i) {
+        workers_.emplace_back(&ObjectStoreSink::workerLoop, this);
+    }
+    LOG_INFO("Uploading to " + config_.host + ":" + std::to_string(config_.port) + "/" +
+             config_.bucket + "/" + config_.prefix + " (" + std::to_string(config_.workers) + " workers)");
+    return ErrorResult::success();
+}
+
+std::string ObjectStoreSink::fullKey(const std::string& key) const {
+    return config_.prefix.empty() ? key : config_.prefix + "/" + key;
+}
+
+bool ObjectStoreSink::enqueueBuffer(const std::string& key, std::vector<uint8_t>&& data) {
+    if (workers_.empty()) return false;
+    auto up = std::make_shared<Upload>();
+    up->key = fullKey(key);
+    up->size = data.size();
+    up->data = std::move(data);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    // Always admit one payload so oversize objects cannot deadlock
+    cv_.wait(lock, [&] {
+        return bufferedBytes_ == 0 || bufferedBytes_ + up->size <= config_.maxBufferedBytes;
+    });
+    bufferedBytes_ += up->size;
+    tasks_.push_back({up->size > config_.partSize ? Task::Kind::CREATE : Task::Kind::PUT, up, 0});
+    lock.unlock();
+    cv_.notify_all();
+    return true;
+}
+
+bool ObjectStoreSink::enqueueFile(const std::string& path, const std::string& key, bool deleteAfterUpload) {
+    if (workers_.empty()) return false;
+    std::error_code ec;
+    uint64_t size = fs::file_size(path, ec);
+    if (ec) {
+        LOG_WARNING("Upload skipped, cannot stat " + path);
+        return false;
+    }
+    auto up = std::make_shared<Upload>();
+    up->key = fullKey(key);
+    up->path = path;
+    up->size = size;
+    up->deleteAfter = deleteAfterUpload;
+    pushTask({size > config_.partSize ? Task::Kind::CREATE : Task::Kind::PUT, up, 0});
+    return true;
+}
+
+void ObjectStoreSink::pushTask(Task task) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (stopping_) return;        // Sink is being torn down
+        // Completions go first so finished uploads release their resources early
+        if (task.kind == Task::Kind::COMPLETE) tasks_.push_front(std::move(task));
+        else tasks_.push_back(std::move(task));
+    }
+    cv_.notify_all();
+}
+
+void ObjectStoreSink::workerLoop() {
+    for (;;) {
+        Task task;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            cv_.wait(lock, [this] { return !tasks_.empty() || stopping_; });
+            if (tasks_.empty()) return;
+            task = std::move(tasks_.front());
+            tasks_.pop_front();
+            ++activeTasks_;
+        }
+        runTask(task);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            --activeTasks_;
+        }
+        cv_.notify_all();
+    }
+}
+
+void ObjectStoreSink::runTask(const Task& task) {
+    switch (task.kind) {
+        case Task::Kind::PUT:      runPut(task.upload); break;
+        case Task::Kind::CREATE:   runCreate(task.upload); break;
+        case Task::Kind::PART:     runPart(task.upload, task.partNumber); break;
+        case Task::Kind::COMPLETE: runComplete(task.upload); break;
+    }
+}
+
+bool ObjectStoreSink::readRange(const Upload& up, uint64_t offset, size_t size, std::vector<uint8_t>& out) const {
+    out.resize(size);
+    std::ifstream in(up.path, std::ios::binary);
+    if (!in) return false;
+    in.seekg(static_cast<std::streamoff>(offset));
+    in.read(reinterpret_cast<char*>(out.data()), static_cast<std::streamsize>(size));
+    return static_cast<size_t>(in.gcount()) == size;
+}
+
+void ObjectStoreSink::runPut(const std::shared_ptr<Upload>& up) {
+    std::vector<uint8_t> fileData;
+    const std::vector<uint8_t>* body = &up->data;
+    if (!up->inMemory()) {
+        if (!readRange(*up, 0, static_cast<size_t>(up->size), fileData)) {
+            finishUpload(up, false, "cannot read " + up->path);
+            return;
+        }
+        body = &fileData;
+    }
+    up->sha256 = Sha256::hashHex(body->data(), body->size());
+
+    HttpResponse resp;
+    if (!request("PUT", up->key, "", body->data(), body->size(), resp)) {
+        finishUpload(up, false, "PUT failed (HTTP " + std::to_string(resp.status) + ")");
+        return;
+    }
+    up->etags.assign(1, stripQuotes(resp.headers["etag"]));
+    finishUpload(up, true, "");
+}
+
+void ObjectStoreSink::runCreate(const std::shared_ptr<Upload>& up) {
+    up->sha256 = up->inMemory() ? Sha256::hashHex(up->data.data(), up->data.size())
+                                : sha256FileHex(up->path);
+    if (up->sha256.empty()) {
+        finishUpload(up, false, "cannot read " + up->path);
+        return;
+    }
+
+    HttpResponse resp;
+    if (!request("POST", up->key, "uploads=", nullptr, 0, resp)) {
+        finishUpload(up, false, "CreateMultipartUpload failed (HTTP " + std::to_string(resp.status) + ")");
+        return;
+    }
+    up->uploadId = xmlValue(resp.body, "UploadId");
+    if (up->uploadId.empty()) {
+        finishUpload(up, false, "CreateMultipartUpload returned no UploadId");
+        return;
+    }
+
+    up->partCount = static_cast<int>((up->size + config_.partSize - 1) / config_.partSize);
+    up->etags.assign(static_cast<size_t>(up->partCount), "");
+    up->partsRemaining = up->partCount;
+    for (int part = 1; part <= up->partCount; ++part) {
+        pushTask({Task::Kind::PART, up, part});
+    }
+}
+
+void ObjectStoreSink::runPart(const std::shared_ptr<Upload>& up, int partNumber) {
+    if (!up->failed) {
+        const uint64_t offset = static_cast<uint64_t>(partNumber - 1) * config_.partSize;
+        const size_t size = static_cast<size_t>(std::min<uint64_t>(config_.partSize, up->size - offset));
+
+        std::vector<uint8_t> fileData;
+        const uint8_t* body = nullptr;
+        if (up->inMemory()) {
+            body = up->data.data() + offset;
+        } else if (readRange(*up, offset, size, fileData)) {
+            body = fileData.data();
+        } else {
+            up->fail("cannot read " + up->path);
+        }
+
+        if (body) {
+            // Re-sending a part number replaces that part, so retries are idempotent
+            HttpResponse resp;
+            const std::string query = "partNumber=" + std::to_string(partNumber) +
+                                      "&uploadId=" + uriEncode(up->uploadId, true);
+            if (request("PUT", up->key, query, body, size, resp)) {
+                up->etags[static_cast<size_t>(partNumber - 1)] = resp.headers["etag"];
+            } else {
+                up->fail("part " + std::to_string(partNumber) + " failed (HTTP " +
+                         std::to_string(resp.status) + ")");
+            }
+        }
+    }
+    if (--up->partsRemaining == 0) {
+        pushTask({Task::Kind::COMPLETE, up, 0});
+    }
+}
+
+void ObjectStoreSink::runComplete(const std::shared_ptr<Upload>& up) {
+    const std::string idQuery = "uploadId=" + uriEncode(up->uploadId, true);
+    HttpResponse resp;
+    if (up->failed) {
+        // Abort so the store discards the uploaded parts
+        request("DELETE", up->key, idQuery, nullptr, 0, resp);
+        finishUpload(up, false, up->error);
+        return;
+    }
+
+    std::ostringstream xml;
+    xml << "<CompleteMultipartUpload>";
+    for (int part = 1; part <= up->partCount; ++part) {
+        xml << "<Part><PartNumber>" << part << "</PartNumber><ETag>"
+            << up->etags[static_cast<size_t>(part - 1)] << "</ETag></Part>";
+    }
+    xml << "</CompleteMultipartUpload>";
+    const std::string body = xml.str();
+
+    bool ok = request("POST", up->key, idQuery, reinterpret_cast<const uint8_t*>(body.data()),
+                      body.size(), resp);
+    // Completion can fail inside a 200 response
+    if (ok && resp.body.find("<Error>") != std::string::npos) ok = false;
+    if (!ok && resp.status == 404) {
+        // A retried completion whose first attempt succeeded sees NoSuchUpload; check the object
+        HttpResponse head;
+        if (request("HEAD", up->key, "", nullptr, 0, head) &&
+            head.headers["content-length"] == std::to_string(up->size)) {
+            resp.body = "<ETag>" + head.headers["etag"] + "</ETag>";
+            ok = true;
+        }
+    }
+    if (!ok) {
+        HttpResponse abortResp;
+        request("DELETE", up->key, idQuery, nullptr, 0, abortResp);
+        finishUpload(up, false, "CompleteMultipartUpload failed (HTTP " + std::to_string(resp.status) + ")");
+        return;
+    }
+    up->etags.assign(1, stripQuotes(xmlValue(resp.body, "ETag")));
+    finishUpload(up, true, "");
+}
+
+void ObjectStoreSink::finishUpload(const std::shared_ptr<Upload>& up, bool ok, const std::string& error) {
+    if (ok) {
+        UploadedObject obj;
+        obj.key = up->key;
+        obj.size = up->size;
+        obj.sha256 = up->sha256;
+        obj.etag = up->etags.empty() ? "" : up->etags.front();
+        obj.parts = up->partCount;
+        uploadedBytes_ += up->size;
+        ++uploadedObjects_;
+        if (up->deleteAfter && std::remove(up->path.c_str()) != 0) {
+            LOG_WARNING("Uploaded but could not delete " + up->path);
+        }
+        std::lock_guard<std::mutex> lock(mutex_);
+        completed_.push_back(std::move(obj));
+    } else {
+        ++failedObjects_;
+        LOG_ERROR("Upload of " + up->key + " failed: " + error);
+        std::lock_guard<std::mutex> lock(mutex_);
+        failedKeys_.push_back(up->key);
+    }
+
+    if (up->inMemory()) {
+        const size_t released = up->data.size();
+        std::vector<uint8_t>().swap(up->data);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            bufferedBytes_ -= released;
+        }
+        cv_.notify_all();
+    }
+}
+
+ErrorResult ObjectStoreSink::finish() {
+    if (workers_.empty()) return ErrorResult::failure("Upload sink not open");
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        cv_.wait(lock, [this] { return tasks_.empty() && activeTasks_ == 0; });
+        stopping_ = true;
+    }
+    cv_.notify_all();
+    for (auto& t : workers_) t.join();
+    workers_.clear();
+
+    std::sort(completed_.begin(), completed_.end(),
+              [](const UploadedObject& a, const UploadedObject& b) { return a.key < b.key; });
+
+    JSONBuilder json;
+    json.beginObject();
+    json.addString("type", "upload_manifest");
+    json.addString("created", getCurrentDateTime());
+    json.addString("bucket", config_.bucket);
+    json.addString("prefix", config_.prefix);
+    json.addNumber("object_count", static_cast<int>(completed_.size()));
+    json.addNumber("total_bytes", static_cast<double>(uploadedBytes_));
+    json.beginArray("objects");
+    for (const auto& obj : completed_) {
+        json.beginObject();
+        json.addString("key", obj.key);
+        json.addNumber("size", static_cast<double>(obj.size));
+        json.addString("sha256", obj.sha256);
+        json.addString("etag", obj.etag);
+        json.addNumber("parts", obj.parts);
+        json.endObject();
+    }
+    json.endArray();
+    json.beginArray("failed");
+    for (const auto& key : failedKeys_) json.addArrayString(key);
+    json.endArray();
+    json.endObject();
+
+    const std::string manifest = json.toString();
+    HttpResponse resp;
+    bool manifestOk = request("PUT", getManifestKey(), "",
+                              reinterpret_cast<const uint8_t*>(manifest.data()), manifest.size(), resp);
+
+    std::ostringstream summary;
+    summary << "Uploaded " << uploadedObjects_ << " objects (" << (uploadedBytes_ / (1024 * 1024)) << " MiB)";
+    if (failedObjects_ > 0) summary << ", " << failedObjects_ << " failed";
+    LOG_INFO(summary.str());
+
+    if (!manifestOk) return ErrorResult::failure("Failed to upload manifest " + getManifestKey());
+    if (failedObjects_ > 0) {
+        return ErrorResult::failure(std::to_string(failedObjects_) + " objects failed to upload");
+    }
+    return ErrorResult::success();
+}
+
+// ============================================================================
+// HTTP + SigV4
+// ============================================================================
+
+bool ObjectStoreSink::request(const std::string& method, const std::string& key, const std::string& query,
+                              const uint8_t* body, size_t bodySize, HttpResponse& response) const {
+    for (int attempt = 0; ; ++attempt) {
+        response = HttpResponse();
+        bool sent = sendOnce(method, key, query, body, bodySize, response);
+        if (sent && response.status >= 200 && response.status < 300) return true;
+        const bool retryable = !sent || response.status >= 500 ||
+                               response.status == 408 || response.status == 429;
+        if (!retryable || attempt >= config_.maxRetries) return false;
+        int delayMs = std::min(8000, 250 << attempt);
+        LOG_DEBUG(method + " " + key + " attempt " + std::to_string(attempt + 1) + " failed (HTTP " +
+                  std::to_string(response.status) + "), retrying in " + std::to_string(delayMs) + " ms");
+        std::this_thread::sleep_for(std::chrono::milliseconds(delayMs));
+    }
+}
+
+bool ObjectStoreSink::sendOnce(const std::string& method, const std::string& key, const std::string& query,
+                               const uint8_t* body, size_t bodySize, HttpResponse& response) const {
+    const std::string uri = "/" + uriEncode(config_.bucket, true) + "/" + uriEncode(key, false);
+    const std::string hostHeader = (config_.port == 80) ? config_.host
+                                                        : config_.host + ":" + std::to_string(config_.port);
+    std::string amzDate, dateStamp;
+    utcStamps(amzDate, dateStamp);
+
+    const bool sign = !config_.accessKey.empty();
+    const std::string payloadHash = sign ? Sha256::hashHex(body, bodySize) : "UNSIGNED-PAYLOAD";
+
+    std::ostringstream req;
+    req << method << " " << uri << (query.empty() ? "" : "?" + query) << " HTTP/1.1\r\n"
+        << "Host: " << hostHeader << "\r\n"
+        << "x-amz-content-sha256: " << payloadHash << "\r\n"
+        << "x-amz-date: " << amzDate << "\r\n";
+    if (sign) {
+        // Query strings are built already sorted and encoded, so they are canonical as-is
+        const std::string signedHeaders = "host;x-amz-content-sha256;x-amz-date";
+        const std::string canonical = method + "\n" + uri + "\n" + query + "\n" +
+                                      "host:" + hostHeader + "\n" +
+                                      "x-amz-content-sha256:" + payloadHash + "\n" +
+                                      "x-amz-date:" + amzDate + "\n\n" +
+                                      signedHeaders + "\n" + payloadHash;
+        const std::string scope = dateStamp + "/" + config_.region + "/s3/aws4_request";
+        const std::string stringToSign = "AWS4-HMAC-SHA256\n" + amzDate + "\n" + scope + "\n" +
+                                         Sha256::hashHex(canonical);
+        std::string signingKey = hmacBytes("AWS4" + config_.secretKey, dateStamp);
+        signingKey = hmacBytes(signingKey, config_.region);
+        signingKey = hmacBytes(signingKey, "s3");
+        signingKey = hmacBytes(signingKey, "aws4_request");
+        Sha256::Digest sig = hmacSha256(signingKey.data(), signingKey.size(),
+                                        stringToSign.data(), stringToSign.size());
+        req << "Authorization: AWS4-HMAC-SHA256 Credential=" << config_.accessKey << "/" << scope
+            << ", SignedHeaders=" << signedHeaders << ", Signature=" << toHex(sig.data(), sig.size()) << "\r\n";
+    }
+    req << "Content-Length: " << bodySize << "\r\n"
+        << "Connection: close\r\n\r\n";
+    const std::string head = req.str();
+
+    addrinfo hints{};
+    hints.ai_family = AF_UNSPEC;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* addrs = nullptr;
+    if (getaddrinfo(config_.host.c_str(), std::to_string(config_.port).c_str(), &hints, &addrs) != 0) {
+        return false;
+    }
+    SocketHandle s = ZED_INVALID_SOCKET;
+    for (addrinfo* a = addrs; a; a = a->ai_next) {
+        s = ::socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+        if (s == ZED_INVALID_SOCKET) continue;
+        if (::connect(s, a->ai_addr, static_cast<int>(a->ai_addrlen)) == 0) break;
+        zed_close_socket(s);
+        s = ZED_INVALID_SOCKET;
+    }
+    freeaddrinfo(addrs);
+    if (s == ZED_INVALID_SOCKET) return false;
+
+#ifdef _WIN32
+    DWORD timeoutMs = kSocketTimeoutSec * 1000;
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, reinterpret_cast<const char*>(&timeoutMs), sizeof(timeoutMs));
+#else
+    timeval tv{kSocketTimeoutSec, 0};
+    setsockopt(s, SOL_SOCKET, SO_RCVTIMEO, &tv, sizeof(tv));
+    setsockopt(s, SOL_SOCKET, SO_SNDTIMEO, &tv, sizeof(tv));
+#endif
+
+    bool ok = sendAll(s, head.data(), head.size()) &&
+              (bodySize == 0 || sendAll(s, reinterpret_cast<const char*>(body), bodySize));
+    std::string raw;
+    if (ok) {
+        char buf[16384];
+        for (;;) {
+            int n = ::recv(s, buf, sizeof(buf), 0);
+            if (n <= 0) break;
+            raw.append(buf, static_cast<size_t>(n));
+        }
+    }
+    zed_close_socket(s);
+    if (!ok) return false;
+
+    // Status line and headers
+    size_t headerEnd = raw.find("\r\n\r\n");
+    if (headerEnd == std::string::npos || raw.compare(0, 5, "HTTP/") != 0) return false;
+    size_t sp = raw.find(' ');
+    response.status = std::atoi(raw.c_str() + sp + 1);
+    size_t lineStart = raw.find("\r\n") + 2;
+    while (lineStart < headerEnd) {
+        size_t lineEnd = raw.find("\r\n", lineStart);
+        std::string line = raw.substr(lineStart, lineEnd - lineStart);
+        size_t colon = line.find(':');
+        if (colon != std::string::npos) {
+            std::string name = line.substr(0, colon);
+            std::transform(name.begin(), name.end(), name.begin(), ::tolower);
+            size_t v = line.find_first_not_of(' ', colon + 1);
+            response.headers[name] = (v == std::string::npos) ? "" : line.substr(v);
+        }
+        lineStart = lineEnd + 2;
+    }
+
+    // Body: the connection is closed by the server, so everything after the headers
+    std::string payload = raw.substr(headerEnd + 4);
+    if (response.headers["transfer-encoding"] == "chunked") {
+        std::string decoded;
+        size_t pos = 0;
+        while (pos < payload.size()) {
+            size_t eol = payload.find("\r\n", pos);
+            if (eol == std::string::npos) break;
+            size_t len = std::strtoul(payload.c_str() + pos, nullptr, 16);
+            if (len == 0) break;
+            decoded.append(payload, eol + 2, len);
+            pos = eol + 2 + len + 2;
+        }
+        payload.swap(decoded);
+    }
+    response.body.swap(payload);
+    return true;
+}
+
+} // namespace zed_tools
@@ -0,0 +1,160 @@
+/**
+ * @file object_store_sink.hpp
+ * @brief Streams extraction outputs to S3-compatible object storage
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Products are uploaded while the extraction is still running instead of
+ * being synced after the fact:
+ * - Small objects go up with one PUT, larger ones as concurrent multipart
+ *   uploads (parts are read from the file or sliced from the buffer on the
+ *   worker, so memory stays at about workers x partSize plus the queue limit)
+ * - Every request is retried with backoff; a retried part reuses its part
+ *   number, which S3 treats as an overwrite, so retries are idempotent
+ * - finish() writes manifest.json (key, size, SHA-256, ETag per object)
+ *   next to the products
+ *
+ * Requests are signed with AWS Signature V4 (or sent unsigned when no
+ * credentials are set, for fake-S3 stand-ins). Transport is plain HTTP;
+ * use a TLS-terminating proxy for https endpoints. Tested layout:
+ * @code
+ * minio server /data &
+ * AWS_ACCESS_KEY_ID=minioadmin AWS_SECRET_ACCESS_KEY=minioadmin ...
+ * upload URL: http://127.0.0.1:9000/flights/extractions
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "error_handler.hpp"
+
+namespace zed_tools {
+
+/**
+ * @brief Object store endpoint and upload tuning
+ */
+struct ObjectStoreConfig {
+    std::string host;                 ///< Endpoint host (e.g., 127.0.0.1)
+    int port = 80;                    ///< Endpoint port (MinIO default 9000)
+    std::string bucket;               ///< Target bucket (path-style addressing)
+    std::string prefix;               ///< Key prefix without trailing slash (may be empty)
+    std::string region = "us-east-1"; ///< SigV4 region
+    std::string accessKey;            ///< Empty = unsigned requests
+    std::string secretKey;
+    size_t partSize = 8 * 1024 * 1024;           ///< Multipart part size (S3 minimum 5 MiB)
+    int workers = 4;                  ///< Concurrent requests
+    int maxRetries = 5;               ///< Attempts per request after the first
+    size_t maxBufferedBytes = 256 * 1024 * 1024; ///< In-memory payloads queued before enqueue blocks
+
+    /**
+     * @brief Parse "http://host[:port]/bucket[/prefix]"; credentials and region
+     *        come from AWS_ACCESS_KEY_ID, AWS_SECRET_ACCESS_KEY and AWS_REGION
+     */
+    static ErrorResult fromUrl(const std::string& url, ObjectStoreConfig& config);
+};
+
+/**
+ * @brief One uploaded object as recorded in the manifest
+ */
+struct UploadedObject {
+    std::string key;
+    uint64_t size = 0;
+    std::string sha256;               ///< Hex digest of the object body
+    std::string etag;                 ///< ETag returned by the store (quotes stripped)
+    int parts = 1;                    ///< 1 for single PUT
+};
+
+/**
+ * @brief Background uploader with a bounded queue
+ */
+class ObjectStoreSink {
+public:
+    ObjectStoreSink() = default;
+    ~ObjectStoreSink();
+
+    ObjectStoreSink(const ObjectStoreSink&) = delete;
+    ObjectStoreSink& operator=(const ObjectStoreSink&) = delete;
+
+    /**
+     * @brief Start the worker threads (the bucket must already exist)
+     */
+    ErrorResult open(const ObjectStoreConfig& config);
+
+    /**
+     * @brief Upload an in-memory payload; blocks while the queued bytes exceed the limit
+     * @param key Object key relative to the configured prefix
+     */
+    bool enqueueBuffer(const std::string& key, std::vector<uint8_t>&& data);
+
+    /**
+     * @brief Upload a finished file; the file is read on the workers
+     * @param deleteAfterUpload Remove the local file once the object is committed
+     */
+    bool enqueueFile(const std::string& path, const std::string& key, bool deleteAfterUpload);
+
+    /**
+     * @brief Wait for all uploads, write and upload manifest.json, stop the workers
+     * @return Failure if any object could not be uploaded
+     */
+    ErrorResult finish();
+
+    bool isOpen() const { return !workers_.empty(); }
+    std::string getManifestKey() const { return fullKey("manifest.json"); }
+    uint64_t getUploadedBytes() const { return uploadedBytes_; }
+    int getUploadedObjects() const { return uploadedObjects_; }
+    int getFailedObjects() const { return failedObjects_; }
+
+private:
+    struct Upload;
+    struct Task {
+        enum class Kind { PUT, CREATE, PART, COMPLETE } kind;
+        std::shared_ptr<Upload> upload;
+        int partNumber = 0;
+    };
+    struct HttpResponse;
+
+    ObjectStoreConfig config_;
+    std::vector<std::thread> workers_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    std::deque<Task> tasks_;
+    int activeTasks_ = 0;             ///< Tasks currently executing
+    size_t bufferedBytes_ = 0;        ///< Bytes held by queued in-memory payloads
+    bool stopping_ = false;
+    std::vector<UploadedObject> completed_;
+    std::vector<std::string> failedKeys_;
+    std::atomic<uint64_t> uploadedBytes_{0};
+    std::atomic<int> uploadedObjects_{0};
+    std::atomic<int> failedObjects_{0};
+
+    void workerLoop();
+    void pushTask(Task task);
+    void runTask(const Task& task);
+    void runPut(const std::shared_ptr<Upload>& up);
+    void runCreate(const std::shared_ptr<Upload>& up);
+    void runPart(const std::shared_ptr<Upload>& up, int partNumber);
+    void runComplete(const std::shared_ptr<Upload>& up);
+    void finishUpload(const std::shared_ptr<Upload>& up, bool ok, const std::string& error);
+
+    bool readRange(const Upload& up, uint64_t offset, size_t size, std::vector<uint8_t>& out) const;
+    std::string fullKey(const std::string& key) const;
+
+    /**
+     * @brief Signed request with retries; retries on transport errors, 5xx, 408 and 429
+     */
+    bool request(const std::string& method, const std::string& key, const std::string& query,
+                 const uint8_t* body, size_t bodySize, HttpResponse& response) const;
+    bool sendOnce(const std::string& method, const std::string& key, const std::string& query,
+                  const uint8_t* body, size_t bodySize, HttpResponse& response) const;
+};
+
+} // namespace zed_tools
@@ -0,0 +1,151 @@
+/**
+ * @file object_tracker.cpp
+ * @brief Implementation of the multi-object tracker
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "object_tracker.hpp"
+
+#include <algorithm>
+
+namespace zed_extractor {
+
+void ObjectTracker::Axis::predict(float dt, float q) {
+    // x' = F x, P' = F P F^T + Q with white-noise acceleration
+    p += vel * dt;
+    float dt2 = dt * dt;
+    float na = a + 2.0f * dt * b + dt2 * c;
+    float nb = b + dt * c;
+    a = na + q * dt2 * dt2 * 0.25f;
+    b = nb + q * dt2 * dt * 0.5f;
+    c = c + q * dt2;
+}
+
+void ObjectTracker::Axis::correct(float meas, float r) {
+    float s = a + r;
+    float k0 = a / s;
+    float k1 = b / s;
+    float y = meas - p;
+    p += k0 * y;
+    vel += k1 * y;
+    float na = (1.0f - k0) * a;
+    float nb = (1.0f - k0) * b;
+    c = c - k1 * b;
+    a = na;
+    b = nb;
+}
+
+ObjectTracker::ObjectTracker(const TrackerConfig& config)
+    : config_(config)
+{
+}
+
+void ObjectTracker::reset() {
+    tracks_.clear();
+    lastTimestampNs_ = 0;
+    nextId_ = 1;
+    confirmedCount_ = 0;
+}
+
+void ObjectTracker::update(uint64_t timestampNs, const std::vector<TrackerMeasurement>& measurements,
+                           std::vector<TrackState>& updated) {
+    updated.clear();
+    float dt = 0.0f;
+    if (lastTimestampNs_ != 0 && timestampNs > lastTimestampNs_) {
+        dt = static_cast<float>(timestampNs - lastTimestampNs_) * 1e-9f;
+    }
+    lastTimestampNs_ = timestampNs;
+
+    const float qPix = config_.pixelAccelNoise * config_.pixelAccelNoise;
+    const float qDepth = config_.depthAccelNoise * config_.depthAccelNoise;
+    const float rPix = config_.pixelMeasNoise * config_.pixelMeasNoise;
+    const float rDepth = config_.depthMeasNoise * config_.depthMeasNoise;
+
+    // Predict
+    for (auto& t : tracks_) {
+        t.u.predict(dt, qPix);
+        t.v.predict(dt, qPix);
+        t.z.predict(dt, qDepth);
+    }
+
+    // Gated candidate pairs, cheapest first
+    pairs_.clear();
+    for (int ti = 0; ti < static_cast<int>(tracks_.size()); ++ti) {
+        const Track& t = tracks_[ti];
+        float su = t.u.innovationVar(rPix), sv = t.v.innovationVar(rPix), sz = t.z.innovationVar(rDepth);
+        for (int mi = 0; mi < static_cast<int>(measurements.size()); ++mi) {
+            const TrackerMeasurement& m = measurements[mi];
+            float du = m.u - t.u.p, dv = m.v - t.v.p, dz = m.z - t.z.p;
+            float cost = du * du / su + dv * dv / sv + dz * dz / sz;
+            if (cost <= config_.gate) pairs_.push_back({ cost, ti, mi });
+        }
+    }
+    std::sort(pairs_.begin(), pairs_.end(), [](const Pair& a, const Pair& b) { return a.cost < b.cost; });
+
+    trackUsed_.assign(tracks_.size(), 0);
+    measUsed_.assign(measurements.size(), 0);
+    for (const Pair& pr : pairs_) {
+        if (trackUsed_[pr.track] || measUsed_[pr.meas]) continue;
+        trackUsed_[pr.track] = 1;
+        measUsed_[pr.meas] = 1;
+        Track& t = tracks_[pr.track];
+        const TrackerMeasurement& m = measurements[pr.meas];
+        t.u.correct(m.u, rPix);
+        t.v.correct(m.v, rPix);
+        t.z.correct(m.z, rDepth);
+        t.state.box = m.box;
+        t.state.hits++;
+        t.state.misses = 0;
+        if (!t.state.confirmed && t.state.hits >= config_.confirmHits) {
+            t.state.confirmed = true;
+            ++confirmedCount_;
+        }
+    }
+
+    // Age unmatched tracks, drop stale ones
+    for (size_t ti = 0; ti < tracks_.size(); ++ti) {
+        if (!trackUsed_[ti]) tracks_[ti].state.misses++;
+    }
+    size_t keep = 0;
+    for (size_t ti = 0; ti < tracks_.size(); ++ti) {
+        if (tracks_[ti].state.misses > config_.maxMisses) continue;
+        if (keep != ti) {
+            tracks_[keep] = tracks_[ti];
+            trackUsed_[keep] = trackUsed_[ti];
+        }
+        ++keep;
+    }
+    tracks_.resize(keep);
+    trackUsed_.resize(keep);
+
+    // Report confirmed tracks matched this frame
+    for (size_t ti = 0; ti < tracks_.size(); ++ti) {
+        Track& t = tracks_[ti];
+        t.state.u = t.u.p; t.state.v = t.v.p; t.state.z = t.z.p;
+        t.state.du = t.u.vel; t.state.dv = t.v.vel; t.state.dz = t.z.vel;
+        if (trackUsed_[ti] && t.state.confirmed) updated.push_back(t.state);
+    }
+
+    // Unmatched detections start tentative tracks
+    for (size_t mi = 0; mi < measurements.size(); ++mi) {
+        if (measUsed_[mi]) continue;
+        const TrackerMeasurement& m = measurements[mi];
+        Track t;
+        t.state.id = nextId_++;
+        t.state.box = m.box;
+        t.state.hits = 1;
+        t.u.init(m.u, rPix, qPix);
+        t.v.init(m.v, rPix, qPix);
+        t.z.init(m.z, rDepth, qDepth);
+        t.state.u = m.u; t.state.v = m.v; t.state.z = m.z;
+        t.state.confirmed = (config_.confirmHits <= 1);
+        if (t.state.confirmed) {
+            ++confirmedCount_;
+            updated.push_back(t.state);
+        }
+        tracks_.push_back(t);
+    }
+}
+
+} // namespace zed_extractor
@@ -0,0 +1,147 @@
+/**
+ * @file occupancy_grid.cpp
+ * @brief Implementation of the bird's-eye occupancy grid
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "occupancy_grid.hpp"
+#include "thread_pool.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace zed_extractor {
+
+static constexpr float kNoHeight = -std::numeric_limits<float>::infinity();
+static constexpr uint32_t kNoCell = std::numeric_limits<uint32_t>::max();   // Sample outside the grid or invalid
+
+OccupancyGrid::OccupancyGrid(const OccupancyGridConfig& config)
+    : config_(config)
+{
+    config_.cellSize = std::max(0.01f, config_.cellSize);
+    config_.pixelStride = std::max(1, config_.pixelStride);
+    cols_ = std::max(1, static_cast<int>(std::ceil((config_.xMax - config_.xMin) / config_.cellSize)));
+    rows_ = std::max(1, static_cast<int>(std::ceil((config_.zMax - config_.zMin) / config_.cellSize)));
+    reset();
+}
+
+void OccupancyGrid::reset() {
+    const size_t cells = static_cast<size_t>(rows_) * cols_;
+    accCount_.assign(cells, 0);
+    accHeight_.assign(cells, kNoHeight);
+    frameCount32_.assign(cells, 0);
+    frameHeight_.assign(cells, kNoHeight);
+    frameGrid_ = cv::Mat::zeros(rows_, cols_, CV_16UC1);
+    frameCount_ = 0;
+}
+
+uint16_t OccupancyGrid::encodeHeight(float h) const {
+    if (h == kNoHeight) return 0;
+    float v = (h - config_.heightFloor) / config_.heightResolution + 1.0f;
+    return static_cast<uint16_t>(std::min(65535.0f, std::max(1.0f, v)));
+}
+
+void OccupancyGrid::addFrame(const cv::Mat& depth, const CameraIntrinsics& K, const GridPose* pose) {
+    if (depth.empty() || depth.type() != CV_32FC1 || K.fx <= 0.0f || K.fy <= 0.0f) return;
+
+    const int stride = config_.pixelStride;
+    const int sampledCols = (depth.cols + stride - 1) / stride;
+    rayX_.resize(sampledCols);
+    for (int i = 0; i < sampledCols; ++i) rayX_[i] = (i * stride - K.cx) / K.fx;
+
+    const int sampledRows = (depth.rows + stride - 1) / stride;
+    const int nBands = std::max(1, std::min(zed_tools::ThreadPool::current().getConcurrency(), sampledRows / 8));
+    if (static_cast<int>(bands_.size()) != nBands) bands_.resize(nBands);
+    const bool heightMode = (config_.mode == GridMode::HEIGHT);
+
+    // Camera frame unless a pose is given
+    GridPose identity;
+    const GridPose& P = pose ? *pose : identity;
+    const float inv = 1.0f / config_.cellSize;
+    const float xMin = config_.xMin, zMax = config_.zMax, maxRange = config_.maxRange;
+    const int cols = cols_;
+    const float colsF = static_cast<float>(cols_), rowsF = static_cast<float>(rows_);
+
+    // Bands write one cell index (kNoCell if rejected) and height per sample into a fixed
+    // buffer, so the inner loop has no branches or appends; binning is a serial scatter
+    zed_tools::parallelFor(0, nBands, [&](int bandBegin, int bandEnd) {
+        for (int b = bandBegin; b < bandEnd; ++b) {
+            Band& band = bands_[b];
+            const int r0 = sampledRows * b / nBands;
+            const int r1 = sampledRows * (b + 1) / nBands;
+            band.cells.resize(static_cast<size_t>(r1 - r0) * sampledCols);
+            band.heights.resize(band.cells.size());
+            for (int sr = r0; sr < r1; ++sr) {
+                const int v = sr * stride;
+                const float* zrow = depth.ptr<float>(v);
+                const float ry = (v - K.cy) / K.fy;
+                // Row-constant parts of R * (rx*z, ry*z, z)
+                const float ax = P.r[1] * ry + P.r[2], ay = P.r[4] * ry + P.r[5], az = P.r[7] * ry + P.r[8];
+                uint32_t* cellOut = band.cells.data() + static_cast<size_t>(sr - r0) * sampledCols;
+                float* heightOut = band.heights.data() + static_cast<size_t>(sr - r0) * sampledCols;
+                for (int i = 0; i < sampledCols; ++i) {
+                    const float zr = zrow[i * stride];
+                    const bool valid = (zr > 0.0f) & (zr <= maxRange);   // false for NaN/inf
+                    const float z = valid ? zr : 0.0f;
+                    const float rx = rayX_[i];
+                    const float wx = (P.r[0] * rx + ax) * z + P.t[0];
+                    const float wy = (P.r[3] * rx + ay) * z + P.t[1];
+                    const float wz = (P.r[6] * rx + az) * z + P.t[2];
+                    // Range test in float; clamping before the conversion keeps rejected samples
+                    // well defined, and truncation equals floor on the accepted (>= 0) range
+                    const float fx = (wx - xMin) * inv;
+                    const float fz = (zMax - wz) * inv;
+                    const bool ok = valid & (fx >= 0.0f) & (fx < colsF) & (fz >= 0.0f) & (fz < rowsF);
+                    const uint32_t gx = static_cast<uint32_t>(std::min(std::max(fx, 0.0f), colsF - 1.0f));
+                    const uint32_t gz = static_cast<uint32_t>(std::min(std::max(fz, 0.0f), rowsF - 1.0f));
+                    cellOut[i] = ok ? gz * static_cast<uint32_t>(cols) + gx : kNoCell;
+                    heightOut[i] = -wy;
+                }
+            }
+        }
+    });
+
+    // Scatter into this frame's grid and the flight accumulation
+    std::fill(frameCount32_.begin(), frameCount32_.end(), 0u);
+    if (heightMode) std::fill(frameHeight_.begin(), frameHeight_.end(), kNoHeight);
+    for (const Band& band : bands_) {
+        const size_t n = band.cells.size();
+        for (size_t k = 0; k < n; ++k) {
+            const uint32_t c = band.cells[k];
+            if (c == kNoCell) continue;
+            frameCount32_[c]++;
+            if (heightMode) frameHeight_[c] = std::max(frameHeight_[c], band.heights[k]);
+        }
+    }
+    frameGrid_.create(rows_, cols_, CV_16UC1);
+    uint16_t* out = frameGrid_.ptr<uint16_t>(0);
+    const size_t cells = frameCount32_.size();
+    for (size_t c = 0; c < cells; ++c) {
+        const uint32_t n = frameCount32_[c];
+        accCount_[c] = (accCount_[c] > std::numeric_limits<uint32_t>::max() - n)
+                     ? std::numeric_limits<uint32_t>::max() : accCount_[c] + n;
+        if (heightMode) {
+            accHeight_[c] = std::max(accHeight_[c], frameHeight_[c]);
+            out[c] = encodeHeight(frameHeight_[c]);
+        } else {
+            out[c] = static_cast<uint16_t>(std::min<uint32_t>(n, 65535u));
+        }
+    }
+    ++frameCount_;
+}
+
+cv::Mat OccupancyGrid::getAccumulatedGrid() const {
+    cv::Mat grid(rows_, cols_, CV_16UC1);
+    uint16_t* out = grid.ptr<uint16_t>(0);
+    const size_t cells = static_cast<size_t>(rows_) * cols_;
+    for (size_t c = 0; c < cells; ++c) {
+        out[c] = (config_.mode == GridMode::HEIGHT)
+               ? encodeHeight(accHeight_[c])
+               : static_cast<uint16_t>(std::min<uint32_t>(accCount_[c], 65535u));
+    }
+    return grid;
+}
+
+} // namespace zed_extractor
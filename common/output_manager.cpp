@@ -70,56 +70,86 @@ bool OutputManager::ensureDirectoryExists(const std::string& path) {
     }
 }
 
-int OutputManager::getNextExtractionNumber(const std::string& flightFolderName) {
-    std::string flightPath = extractionsPath_ + "/" + flightFolderName;
-    
-    if (!fs::exists(flightPath)) {
-        return 1; // First extraction
+void OutputManager::setScratchPath(const std::string& scratchPath) {
+    if (scratchPath.empty()) {
+        scratchExtractionsPath_.clear();
+        return;
     }
-    
+    std::string root = scratchPath;
+    std::replace(root.begin(), root.end(), '\\', '/');
+    scratchExtractionsPath_ = root + "/Extractions";
+}
+
+std::string OutputManager::getArchivePath(const std::string& extractionPath) const {
+    if (!isStaging() || extractionPath.compare(0, scratchExtractionsPath_.size(), scratchExtractionsPath_) != 0) {
+        return extractionPath;
+    }
+    return extractionsPath_ + extractionPath.substr(scratchExtractionsPath_.size());
+}
+
+int OutputManager::getNextExtractionNumber(const std::string& flightFolderName) {
     int maxNumber = 0;
-    std::regex pattern(R"(extraction_(\d{3}))");
+    // extraction_NNN.partial is an archive copy still being migrated
+    std::regex pattern(R"(extraction_(\d{3})(\.partial)?)");
     
-    try {
-        for (const auto& entry : fs::directory_iterator(flightPath)) {
-            if (entry.is_directory()) {
-                std::string folderName = entry.path().filename().string();
-                std::smatch matches;
-                if (std::regex_match(folderName, matches, pattern)) {
-                    int number = std::stoi(matches[1].str());
-                    if (number > maxNumber) {
-                        maxNumber = number;
+    // Staged folders are not in the archive yet; numbers must not collide with them
+    std::vector<std::string> roots = { extractionsPath_ };
+    if (isStaging()) roots.push_back(scratchExtractionsPath_);
+    
+    for (const auto& root : roots) {
+        std::string flightPath = root + "/" + flightFolderName;
+        if (!fs::exists(flightPath)) continue;
+        try {
+            for (const auto& entry : fs::directory_iterator(flightPath)) {
+                if (entry.is_directory()) {
+                    std::string folderName = entry.path().filename().string();
+                    std::smatch matches;
+                    if (std::regex_match(folderName, matches, pattern)) {
+                        int number = std::stoi(matches[1].str());
+                        if (number > maxNumber) {
+                            maxNumber = number;
+                        }
                     }
                 }
             }
+        } catch (const std::exception& e) {
+            LOG_WARNING("Error scanning extraction folders: " + std::string(e.what()));
         }
-    } catch (const std::exception& e) {
-        LOG_WARNING("Error scanning extraction folders: " + std::string(e.what()));
     }
     
     return maxNumber + 1;
 }
 
 std::string OutputManager::getExtractionPath(const std::string& flightFolderName, OutputType type) {
-    // Get next extraction number
-    int extractionNum = getNextExtractionNumber(flightFolderName);
-    
-    // Format extraction folder name: extraction_001, extraction_002, etc.
-    std::ostringstream oss;
-    oss << "extraction_" << std::setw(3) << std::setfill('0') << extractionNum;
-    std::string extractionFolder = oss.str();
-    
-    // Build full path
-    std::string fullPath = extractionsPath_ + "/" + flightFolderName + "/" + extractionFolder;
-    
-    // Create directory structure
-    if (!ensureDirectoryExists(fullPath)) {
-        LOG_ERROR("Failed to create extraction directory: " + fullPath);
+    // Build full path (on the scratch tier when staging)
+    std::string flightPath = (isStaging() ? scratchExtractionsPath_ : extractionsPath_) + "/" + flightFolderName;
+    if (!ensureDirectoryExists(flightPath)) {
+        LOG_ERROR("Failed to create flight directory: " + flightPath);
         return "";
     }
     
-    LOG_INFO("Created extraction path: " + fullPath);
-    return fullPath;
+    // Claim the folder with create_directory, which fails if it exists: concurrent
+    // extractions of the same flight (batch runs, several processes) get distinct numbers
+    int extractionNum = getNextExtractionNumber(flightFolderName);
+    for (int attempt = 0; attempt < 1000; ++attempt, ++extractionNum) {
+        // Format extraction folder name: extraction_001, extraction_002, etc.
+        std::ostringstream oss;
+        oss << "extraction_" << std::setw(3) << std::setfill('0') << extractionNum;
+        std::string fullPath = flightPath + "/" + oss.str();
+        
+        std::error_code ec;
+        if (fs::create_directory(fullPath, ec)) {
+            LOG_INFO("Created extraction path: " + fullPath);
+            return fullPath;
+        }
+        if (ec) {
+            LOG_ERROR("Failed to create extraction directory: " + fullPath + " - " + ec.message());
+            return "";
+        }
+    }
+    
+    LOG_ERROR("No free extraction number in " + flightPath);
+    return "";
 }
 
 std::string OutputManager::getYoloFramesPath(const std::string& flightFolderName) {
@@ -7,6 +7,10 @@
  * Manages output folder structure:
  * - Extractions/flight_XXX/extraction_NNN/ for videos and depth
  * - Yolo_Training/Unfiltered_Images/flight_XXX/ for frames with global numbering
+ *
+ * With a scratch path set, extraction folders are created under
+ * scratchPath/Extractions/ instead and moved to the base path by an
+ * ArchiveMigrator once the job completes.
  */
 
 #pragma once
@@ -25,7 +29,8 @@ namespace zed_tools {
 enum class OutputType {
     VIDEO,      ///< Video extraction (mp4 files)
     FRAMES,     ///< Frame extraction for YOLO training
-    DEPTH       ///< Depth analysis heatmap
+    DEPTH,      ///< Depth analysis heatmap
+    TELEMETRY   ///< IMU/sensor telemetry export
 };
 
 /**
@@ -39,13 +44,37 @@ public:
      */
     explicit OutputManager(const std::string& baseOutputPath);
     
+    /**
+     * @brief Stage extraction folders on a fast local tier
+     * @param scratchPath Scratch root (e.g., a local SSD); empty disables staging
+     */
+    void setScratchPath(const std::string& scratchPath);
+
+    /**
+     * @brief True if extraction folders are created on the scratch tier
+     */
+    bool isStaging() const { return !scratchExtractionsPath_.empty(); }
+
+    /**
+     * @brief Final archive location of a staged extraction folder
+     * @param extractionPath Path returned by getExtractionPath()
+     * @return Same path under baseOutputPath/Extractions (unchanged when not staging)
+     */
+    std::string getArchivePath(const std::string& extractionPath) const;
+
+    /// baseOutputPath/Extractions
+    const std::string& getExtractionsRoot() const { return extractionsPath_; }
+    /// scratchPath/Extractions (empty when not staging)
+    const std::string& getScratchExtractionsRoot() const { return scratchExtractionsPath_; }
+
     /**
      * @brief Get output path for video/depth extraction
      * @param flightFolderName Flight folder name (e.g., "flight_20251105_205224")
      * @param type Output type (VIDEO or DEPTH)
-     * @return Path to extraction folder (auto-incremented)
+     * @return Path to extraction folder (auto-incremented; safe against concurrent callers)
      * 
      * Returns: baseOutputPath/Extractions/flight_XXX/extraction_NNN/
+     * (scratchPath/Extractions/... when staging)
      */
     std::string getExtractionPath(const std::string& flightFolderName, OutputType type);
     
@@ -77,6 +106,8 @@ public:
      * @brief Get next extraction number for a flight
      * @param flightFolderName Flight folder name
      * @return Next extraction number (e.g., 1, 2, 3...)
+     *
+     * Considers the archive, staged folders and in-flight .partial copies.
      */
     int getNextExtractionNumber(const std::string& flightFolderName);
     
@@ -96,6 +127,7 @@ public:
 private:
     std::string baseOutputPath_;
     std::string extractionsPath_;
+    std::string scratchExtractionsPath_;  ///< Empty unless staging
     std::string yoloTrainingPath_;
     std::string frameCounterFile_;
     
@@ -0,0 +1,277 @@
+/**
+ * @file qoi_codec.cpp
+ * @brief Implementation of the QOI codec
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "qoi_codec.hpp"
+
+#include <cstring>
+#include <fstream>
+
+namespace zed_tools {
+
+namespace {
+
+constexpr uint8_t kOpIndex = 0x00;   // 00xxxxxx
+constexpr uint8_t kOpDiff = 0x40;    // 01xxxxxx
+constexpr uint8_t kOpLuma = 0x80;    // 10xxxxxx
+constexpr uint8_t kOpRun = 0xc0;     // 11xxxxxx
+constexpr uint8_t kOpRgb = 0xfe;
+constexpr uint8_t kOpRgba = 0xff;
+constexpr uint8_t kMask2 = 0xc0;
+constexpr size_t kHeaderSize = 14;
+constexpr uint8_t kPadding[8] = {0, 0, 0, 0, 0, 0, 0, 1};
+constexpr uint64_t kMaxPixels = 400000000ull;   // Same guard as the reference implementation
+
+// Packed pixel: r | g << 8 | b << 16 | a << 24
+inline uint32_t pack(uint32_t r, uint32_t g, uint32_t b, uint32_t a) {
+    return r | (g << 8) | (b << 16) | (a << 24);
+}
+inline uint8_t red(uint32_t px) { return static_cast<uint8_t>(px); }
+inline uint8_t green(uint32_t px) { return static_cast<uint8_t>(px >> 8); }
+inline uint8_t blue(uint32_t px) { return static_cast<uint8_t>(px >> 16); }
+inline uint8_t alpha(uint32_t px) { return static_cast<uint8_t>(px >> 24); }
+
+inline uint32_t hashIndex(uint32_t px) {
+    return (red(px) * 3u + green(px) * 5u + blue(px) * 7u + alpha(px) * 11u) & 63u;
+}
+
+// Load one pixel from an OpenCV-ordered row (channel swap fused here)
+template <int C>
+inline uint32_t load(const uint8_t* p) {
+    if (C == 1) return pack(p[0], p[0], p[0], 255);
+    if (C == 3) return pack(p[2], p[1], p[0], 255);
+    return pack(p[2], p[1], p[0], p[3]);
+}
+
+template <int C>
+inline void store(uint8_t* p, uint32_t px) {
+    if (C == 1) {
+        // Gray images round-trip exactly (r == g == b); color falls back to integer luma
+        uint8_t r = red(px), g = green(px), b = blue(px);
+        p[0] = (r == g && g == b) ? g : static_cast<uint8_t>((r * 77u + g * 150u + b * 29u) >> 8);
+    } else {
+        p[0] = blue(px);
+        p[1] = green(px);
+        p[2] = red(px);
+        if (C == 4) p[3] = alpha(px);
+    }
+}
+
+inline void write32(uint8_t*& o, uint32_t v) {
+    o[0] = static_cast<uint8_t>(v >> 24);
+    o[1] = static_cast<uint8_t>(v >> 16);
+    o[2] = static_cast<uint8_t>(v >> 8);
+    o[3] = static_cast<uint8_t>(v);
+    o += 4;
+}
+
+inline uint32_t read32(const uint8_t* p) {
+    return (static_cast<uint32_t>(p[0]) << 24) | (static_cast<uint32_t>(p[1]) << 16) |
+           (static_cast<uint32_t>(p[2]) << 8) | p[3];
+}
+
+template <int C>
+uint8_t* encodePixels(const uint8_t* pixels, int width, int height, size_t stride, uint8_t* o) {
+    uint32_t index[64] = {};
+    uint32_t prev = pack(0, 0, 0, 255);
+    int run = 0;
+
+    for (int y = 0; y < height; ++y) {
+        const uint8_t* row = pixels + static_cast<size_t>(y) * stride;
+        int x = 0;
+        while (x < width) {
+            uint32_t px = load<C>(row + static_cast<size_t>(x) * C);
+            if (px == prev) {
+                // Extend the run with plain word compares
+                ++run;
+                ++x;
+                while (x < width && run < 62 && load<C>(row + static_cast<size_t>(x) * C) == prev) {
+                    ++run;
+                    ++x;
+                }
+                if (run == 62) {
+                    *o++ = static_cast<uint8_t>(kOpRun | (run - 1));
+                    run = 0;
+                }
+                continue;
+            }
+            if (run > 0) {
+                *o++ = static_cast<uint8_t>(kOpRun | (run - 1));
+                run = 0;
+            }
+
+            const uint32_t h = hashIndex(px);
+            if (index[h] == px) {
+                *o++ = static_cast<uint8_t>(kOpIndex | h);
+            } else {
+                index[h] = px;
+                if (alpha(px) == alpha(prev)) {
+                    const int8_t vr = static_cast<int8_t>(red(px) - red(prev));
+                    const int8_t vg = static_cast<int8_t>(green(px) - green(prev));
+                    const int8_t vb = static_cast<int8_t>(blue(px) - blue(prev));
+                    const int8_t vgr = static_cast<int8_t>(vr - vg);
+                    const int8_t vgb = static_cast<int8_t>(vb - vg);
+                    if (vr > -3 && vr < 2 && vg > -3 && vg < 2 && vb > -3 && vb < 2) {
+                        *o++ = static_cast<uint8_t>(kOpDiff | ((vr + 2) << 4) | ((vg + 2) << 2) | (vb + 2));
+                    } else if (vgr > -9 && vgr < 8 && vg > -33 && vg < 32 && vgb > -9 && vgb < 8) {
+                        *o++ = static_cast<uint8_t>(kOpLuma | (vg + 32));
+                        *o++ = static_cast<uint8_t>(((vgr + 8) << 4) | (vgb + 8));
+                    } else {
+                        *o++ = kOpRgb;
+                        *o++ = red(px);
+                        *o++ = green(px);
+                        *o++ = blue(px);
+                    }
+                } else {
+                    *o++ = kOpRgba;
+                    *o++ = red(px);
+                    *o++ = green(px);
+                    *o++ = blue(px);
+                    *o++ = alpha(px);
+                }
+            }
+            prev = px;
+            ++x;
+        }
+    }
+    if (run > 0) *o++ = static_cast<uint8_t>(kOpRun | (run - 1));
+    return o;
+}
+
+template <int C>
+bool decodePixels(const uint8_t* data, size_t size, size_t pixelCount, uint8_t* out) {
+    uint32_t index[64] = {};
+    uint32_t px = pack(0, 0, 0, 255);
+    const size_t chunksEnd = size - sizeof(kPadding);
+    size_t p = kHeaderSize;
+    size_t written = 0;
+
+    while (written < pixelCount) {
+        if (p >= chunksEnd) return false;
+        const uint8_t b1 = data[p++];
+        if (b1 == kOpRgb) {
+            if (p + 3 > chunksEnd) return false;
+            px = pack(data[p], data[p + 1], data[p + 2], alpha(px));
+            p += 3;
+        } else if (b1 == kOpRgba) {
+            if (p + 4 > chunksEnd) return false;
+            px = pack(data[p], data[p + 1], data[p + 2], data[p + 3]);
+            p += 4;
+        } else if ((b1 & kMask2) == kOpIndex) {
+            px = index[b1];
+        } else if ((b1 & kMask2) == kOpDiff) {
+            px = pack(static_cast<uint8_t>(red(px) + ((b1 >> 4) & 3) - 2),
+                      static_cast<uint8_t>(green(px) + ((b1 >> 2) & 3) - 2),
+                      static_cast<uint8_t>(blue(px) + (b1 & 3) - 2), alpha(px));
+        } else if ((b1 & kMask2) == kOpLuma) {
+            if (p >= chunksEnd) return false;
+            const uint8_t b2 = data[p++];
+            const int vg = (b1 & 0x3f) - 32;
+            px = pack(static_cast<uint8_t>(red(px) + vg - 8 + ((b2 >> 4) & 0x0f)),
+                      static_cast<uint8_t>(green(px) + vg),
+                      static_cast<uint8_t>(blue(px) + vg - 8 + (b2 & 0x0f)), alpha(px));
+        } else {
+            // Run: fill directly (index update kept for parity with the reference decoder)
+            size_t run = static_cast<size_t>(b1 & 0x3f) + 1;
+            if (run > pixelCount - written) return false;
+            index[hashIndex(px)] = px;
+            for (size_t i = 0; i < run; ++i) store<C>(out + (written + i) * C, px);
+            written += run;
+            continue;
+        }
+        index[hashIndex(px)] = px;
+        store<C>(out + written * C, px);
+        ++written;
+    }
+    return true;
+}
+
+} // namespace
+
+bool qoiEncode(const uint8_t* pixels, int width, int height, int channels, size_t stride,
+               std::vector<uint8_t>& out) {
+    if (!pixels || width <= 0 || height <= 0 ||
+        static_cast<uint64_t>(width) * static_cast<uint64_t>(height) > kMaxPixels) {
+        return false;
+    }
+    if (channels != 1 && channels != 3 && channels != 4) return false;
+    const int stored = (channels == 4) ? 4 : 3;
+
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    out.resize(kHeaderSize + pixelCount * (stored + 1) + sizeof(kPadding));
+    uint8_t* o = out.data();
+    *o++ = 'q'; *o++ = 'o'; *o++ = 'i'; *o++ = 'f';
+    write32(o, static_cast<uint32_t>(width));
+    write32(o, static_cast<uint32_t>(height));
+    *o++ = static_cast<uint8_t>(stored);
+    *o++ = 0;   // sRGB with linear alpha
+
+    if (channels == 1) o = encodePixels<1>(pixels, width, height, stride, o);
+    else if (channels == 3) o = encodePixels<3>(pixels, width, height, stride, o);
+    else o = encodePixels<4>(pixels, width, height, stride, o);
+
+    std::memcpy(o, kPadding, sizeof(kPadding));
+    o += sizeof(kPadding);
+    out.resize(static_cast<size_t>(o - out.data()));
+    return true;
+}
+
+bool qoiReadHeader(const uint8_t* data, size_t size, int& width, int& height, int& channels) {
+    if (!data || size < kHeaderSize + sizeof(kPadding) || std::memcmp(data, "qoif", 4) != 0) return false;
+    const uint32_t w = read32(data + 4);
+    const uint32_t h = read32(data + 8);
+    const uint8_t c = data[12];
+    if (w == 0 || h == 0 || (c != 3 && c != 4) ||
+        static_cast<uint64_t>(w) * h > kMaxPixels) {
+        return false;
+    }
+    width = static_cast<int>(w);
+    height = static_cast<int>(h);
+    channels = c;
+    return true;
+}
+
+bool qoiDecode(const uint8_t* data, size_t size, QoiImage& image, int desiredChannels) {
+    int width = 0, height = 0, stored = 0;
+    if (!qoiReadHeader(data, size, width, height, stored)) return false;
+    const int channels = (desiredChannels == 0) ? stored : desiredChannels;
+    if (channels != 1 && channels != 3 && channels != 4) return false;
+
+    const size_t pixelCount = static_cast<size_t>(width) * height;
+    image.width = width;
+    image.height = height;
+    image.channels = channels;
+    image.pixels.resize(pixelCount * channels);
+
+    bool ok;
+    if (channels == 1) ok = decodePixels<1>(data, size, pixelCount, image.pixels.data());
+    else if (channels == 3) ok = decodePixels<3>(data, size, pixelCount, image.pixels.data());
+    else ok = decodePixels<4>(data, size, pixelCount, image.pixels.data());
+    if (!ok) image = QoiImage();
+    return ok;
+}
+
+bool qoiWriteFile(const std::string& path, const uint8_t* pixels, int width, int height, int channels,
+                  size_t stride) {
+    std::vector<uint8_t> encoded;
+    if (!qoiEncode(pixels, width, height, channels, stride, encoded)) return false;
+    std::ofstream file(path, std::ios::binary | std::ios::trunc);
+    file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+    return static_cast<bool>(file);
+}
+
+bool qoiReadFile(const std::string& path, QoiImage& image, int desiredChannels) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file) return false;
+    const std::streamsize size = file.tellg();
+    if (size <= 0) return false;
+    std::vector<uint8_t> data(static_cast<size_t>(size));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), size)) return false;
+    return qoiDecode(data.data(), data.size(), image, desiredChannels);
+}
+
+} // namespace zed_tools
@@ -0,0 +1,73 @@
+/**
+ * @file qoi_codec.hpp
+ * @brief In-tree QOI ("Quite OK Image") lossless codec
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Fast lossless format for intermediate products that are mostly read back
+ * by our own tools (heatmaps, left_rgb cache, confidence maps, previews).
+ * Output follows the QOI 1.0 specification, so standard viewers open it.
+ *
+ * - Pixels are passed in OpenCV order (BGR/BGRA); the channel swap is fused
+ *   into the per-pixel load/store instead of a separate pass
+ * - Pixels are compared as packed 32-bit words; runs are extended with a
+ *   tight word-compare loop, so flat regions cost about one compare per pixel
+ * - Single-channel images are stored as gray RGB and can be decoded back to
+ *   one channel (QOI itself has no gray mode)
+ * - Stateless free functions: safe to call from any number of threads
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace zed_tools {
+
+/**
+ * @brief Decoded image (interleaved, tightly packed, BGR/BGRA/gray)
+ */
+struct QoiImage {
+    int width = 0;
+    int height = 0;
+    int channels = 0;
+    std::vector<uint8_t> pixels;
+};
+
+/**
+ * @brief Encode an 8-bit image
+ * @param pixels First row; rows are `stride` bytes apart
+ * @param channels 1 (gray), 3 (BGR) or 4 (BGRA)
+ * @param out Receives the complete file contents
+ * @return false for unsupported dimensions or channel counts
+ */
+bool qoiEncode(const uint8_t* pixels, int width, int height, int channels, size_t stride,
+               std::vector<uint8_t>& out);
+
+/**
+ * @brief Decode a QOI buffer
+ * @param desiredChannels 0 = as stored (3 or 4), or force 1, 3 or 4
+ * @return false on a malformed buffer
+ */
+bool qoiDecode(const uint8_t* data, size_t size, QoiImage& image, int desiredChannels = 0);
+
+/**
+ * @brief Read only the header
+ * @param channels Stored channel count (3 or 4)
+ */
+bool qoiReadHeader(const uint8_t* data, size_t size, int& width, int& height, int& channels);
+
+/**
+ * @brief Encode and write a file
+ */
+bool qoiWriteFile(const std::string& path, const uint8_t* pixels, int width, int height, int channels,
+                  size_t stride);
+
+/**
+ * @brief Read and decode a file
+ */
+bool qoiReadFile(const std::string& path, QoiImage& image, int desiredChannels = 0);
+
+} // namespace zed_tools
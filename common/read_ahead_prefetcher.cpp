@@ -0,0 +1,317 @@
+/**
+ * @file read_ahead_prefetcher.cpp
+ * @brief Implementation of the SVO read-ahead prefetcher
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "read_ahead_prefetcher.hpp"
+
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace zed_tools {
+
+namespace {
+
+#ifdef __linux__
+/**
+ * @brief fadvise for the access hint, readahead() to populate the page cache
+ */
+class FadvisePrefetchBackend : public PrefetchBackend {
+public:
+    ~FadvisePrefetchBackend() override { close(); }
+
+    bool open(const std::string& path, uint64_t& fileSize) override {
+        fd_ = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd_ < 0) return false;
+        off_t end = ::lseek(fd_, 0, SEEK_END);
+        if (end < 0) {
+            close();
+            return false;
+        }
+        fileSize = static_cast<uint64_t>(end);
+        return true;
+    }
+
+    void setPattern(AccessPattern pattern) override {
+        if (fd_ < 0) return;
+        posix_fadvise(fd_, 0, 0, pattern == AccessPattern::Sequential ? POSIX_FADV_SEQUENTIAL : POSIX_FADV_RANDOM);
+    }
+
+    bool prefetch(uint64_t offset, uint64_t length) override {
+        if (fd_ < 0) return false;
+        // readahead() blocks until the range is cached; fall back to the async hint
+        if (::readahead(fd_, static_cast<off64_t>(offset), static_cast<size_t>(length)) == 0) return true;
+        return posix_fadvise(fd_, static_cast<off_t>(offset), static_cast<off_t>(length), POSIX_FADV_WILLNEED) == 0;
+    }
+
+    void close() override {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+private:
+    int fd_ = -1;
+};
+#endif
+
+/**
+ * @brief Reads the range into a scratch buffer; the OS keeps it cached for the SDK
+ */
+class BufferedPrefetchBackend : public PrefetchBackend {
+public:
+    bool open(const std::string& path, uint64_t& fileSize) override {
+        file_.open(path, std::ios::binary);
+        if (!file_.is_open()) return false;
+        file_.seekg(0, std::ios::end);
+        fileSize = static_cast<uint64_t>(file_.tellg());
+        return true;
+    }
+
+    void setPattern(AccessPattern) override {}
+
+    bool prefetch(uint64_t offset, uint64_t length) override {
+        if (!file_.is_open()) return false;
+        scratch_.resize(static_cast<size_t>(std::min<uint64_t>(length, 1u << 20)));
+        file_.clear();
+        file_.seekg(static_cast<std::streamoff>(offset));
+        while (length > 0 && file_) {
+            const std::streamsize n = static_cast<std::streamsize>(std::min<uint64_t>(length, scratch_.size()));
+            file_.read(scratch_.data(), n);
+            length -= static_cast<uint64_t>(n);
+        }
+        return static_cast<bool>(file_) || file_.eof();
+    }
+
+    void close() override {
+        if (file_.is_open()) file_.close();
+    }
+
+private:
+    std::ifstream file_;
+    std::vector<char> scratch_;
+};
+
+std::string formatMB(uint64_t bytes) {
+    char buf[32];
+    std::snprintf(buf, sizeof(buf), "%.1f MB", static_cast<double>(bytes) / (1024.0 * 1024.0));
+    return buf;
+}
+
+} // namespace
+
+std::unique_ptr<PrefetchBackend> createDefaultPrefetchBackend() {
+#ifdef __linux__
+    return std::make_unique<FadvisePrefetchBackend>();
+#else
+    return std::make_unique<BufferedPrefetchBackend>();
+#endif
+}
+
+ReadAheadPrefetcher::ReadAheadPrefetcher(const ReadAheadConfig& config, std::unique_ptr<PrefetchBackend> backend)
+    : config_(config)
+    , backend_(backend ? std::move(backend) : createDefaultPrefetchBackend())
+{
+    config_.chunkBytes = std::max<uint64_t>(config_.chunkBytes, 64u << 10);
+    config_.windowBytes = std::max(config_.windowBytes, config_.chunkBytes);
+}
+
+ReadAheadPrefetcher::~ReadAheadPrefetcher() {
+    stop();
+}
+
+bool ReadAheadPrefetcher::start(const std::string& path, int totalFrames) {
+    stop();
+    uint64_t size = 0;
+    if (!backend_->open(path, size)) {
+        lastError_ = "Cannot open for read-ahead: " + path;
+        return false;
+    }
+    std::lock_guard<std::mutex> lock(mutex_);
+    fileSize_ = size;
+    totalFrames_ = std::max(0, totalFrames);
+    pattern_ = AccessPattern::Sequential;
+    plan_.assign(1, {0, fileSize_});
+    consumer_ = cursor_ = 0;
+    hasPosition_ = false;
+    stats_ = ReadAheadStats();
+    backend_->setPattern(pattern_);
+    running_ = true;
+    worker_ = std::thread(&ReadAheadPrefetcher::run, this);
+    return true;
+}
+
+void ReadAheadPrefetcher::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (!running_ && !worker_.joinable()) return;
+        running_ = false;
+    }
+    wake_.notify_all();
+    if (worker_.joinable()) worker_.join();
+    backend_->close();
+}
+
+void ReadAheadPrefetcher::setFrameOffsets(std::vector<uint64_t> offsets) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    frameOffsets_ = std::move(offsets);
+}
+
+void ReadAheadPrefetcher::setSequential() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        pattern_ = AccessPattern::Sequential;
+        plan_.assign(1, {0, fileSize_});
+        cursor_ = consumer_;
+        ++generation_;
+        backend_->setPattern(pattern_);
+    }
+    wake_.notify_all();
+}
+
+void ReadAheadPrefetcher::setRandomPlan(const std::vector<std::pair<int, int>>& frameRanges) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<std::pair<uint64_t, uint64_t>> ranges;
+        ranges.reserve(frameRanges.size());
+        for (const auto& r : frameRanges) {
+            uint64_t begin = frameToOffset(std::min(r.first, r.second));
+            uint64_t end = frameToOffset(std::max(r.first, r.second) + 1);
+            if (end > begin) ranges.emplace_back(begin, end);
+        }
+        std::sort(ranges.begin(), ranges.end());
+        plan_.clear();
+        for (const auto& r : ranges) {
+            if (!plan_.empty() && r.first <= plan_.back().second) {
+                plan_.back().second = std::max(plan_.back().second, r.second);
+            } else {
+                plan_.push_back(r);
+            }
+        }
+        pattern_ = AccessPattern::Random;
+        cursor_ = consumer_;
+        ++generation_;
+        backend_->setPattern(pattern_);
+    }
+    wake_.notify_all();
+}
+
+uint64_t ReadAheadPrefetcher::frameToOffset(int frame) const {
+    if (frame <= 0) return 0;
+    if (!frameOffsets_.empty()) {
+        if (static_cast<size_t>(frame) < frameOffsets_.size()) return frameOffsets_[frame];
+        return fileSize_;
+    }
+    if (totalFrames_ <= 0) return 0;
+    if (frame >= totalFrames_) return fileSize_;
+    return static_cast<uint64_t>(static_cast<double>(fileSize_) * frame / totalFrames_);
+}
+
+void ReadAheadPrefetcher::notifyFrame(int frame) {
+    uint64_t offset;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        offset = frameToOffset(frame);
+    }
+    notifyOffset(offset);
+}
+
+void ReadAheadPrefetcher::notifyOffset(uint64_t offset) {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++stats_.positionUpdates;
+        if (hasPosition_ && (offset < consumer_ || offset > consumer_ + config_.windowBytes)) ++stats_.seeks;
+        // Data at the new position was not prefetched yet: the decoder had to read it itself
+        if (offset >= cursor_) {
+            ++stats_.ioWaits;
+            cursor_ = offset;
+            ++generation_;
+        } else if (offset < consumer_) {
+            cursor_ = offset;   // Seek back; restart the window here
+            ++generation_;
+        }
+        consumer_ = offset;
+        hasPosition_ = true;
+    }
+    wake_.notify_all();
+}
+
+uint64_t ReadAheadPrefetcher::aheadBytes() const {
+    uint64_t total = 0;
+    for (const auto& r : plan_) {
+        const uint64_t begin = std::max(r.first, consumer_);
+        const uint64_t end = std::min(r.second, cursor_);
+        if (end > begin) total += end - begin;
+    }
+    return total;
+}
+
+bool ReadAheadPrefetcher::nextChunk(uint64_t& offset, uint64_t& length) const {
+    if (aheadBytes() >= config_.windowBytes) return false;
+    const uint64_t from = std::max(cursor_, consumer_);
+    for (const auto& r : plan_) {
+        if (r.second <= from) continue;
+        offset = std::max(r.first, from);
+        length = std::min(config_.chunkBytes, r.second - offset);
+        return length > 0;
+    }
+    return false;
+}
+
+void ReadAheadPrefetcher::run() {
+    std::unique_lock<std::mutex> lock(mutex_);
+    while (running_) {
+        uint64_t offset = 0, length = 0;
+        if (!nextChunk(offset, length)) {
+            wake_.wait(lock);
+            continue;
+        }
+        const uint64_t generation = generation_;
+        lock.unlock();
+        const bool ok = backend_->prefetch(offset, length);
+        lock.lock();
+        if (!ok) {
+            lastError_ = "Prefetch failed at offset " + std::to_string(offset);
+            wake_.wait(lock);   // Retry once the consumer moves
+            continue;
+        }
+        ++stats_.prefetchRequests;
+        stats_.bytesPrefetched += length;
+        // If the consumer jumped while this chunk was read, the window restarts at its new position
+        if (generation == generation_) cursor_ = std::max(cursor_, offset + length);
+    }
+}
+
+AccessPattern ReadAheadPrefetcher::getPattern() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return pattern_;
+}
+
+ReadAheadStats ReadAheadPrefetcher::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return stats_;
+}
+
+std::string ReadAheadPrefetcher::getLastError() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return lastError_;
+}
+
+std::string ReadAheadPrefetcher::describeStats() const {
+    const ReadAheadStats s = getStats();
+    std::ostringstream out;
+    out << "Read-ahead: " << formatMB(s.bytesPrefetched) << " prefetched in " << s.prefetchRequests
+        << " requests; decode waited on I/O for " << s.ioWaits << "/" << s.positionUpdates << " frames ("
+        << static_cast<int>(s.waitRatio() * 100.0 + 0.5) << "%), " << s.seeks << " seeks";
+    return out.str();
+}
+
+} // namespace zed_tools
@@ -0,0 +1,196 @@
+/**
+ * @file read_ahead_prefetcher.hpp
+ * @brief Keeps the SVO bytes just ahead of the decoder in the page cache
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * On USB SSDs and network mounts the SDK decoder stalls on read latency.
+ * The prefetcher follows the consumer's position (SVO frame or container
+ * offset) and, on a background thread, reads a configurable window ahead
+ * of it into the page cache, so decode runs at CPU speed.
+ *
+ * Sequential mode covers everything after the consumer. Random mode (seek-
+ * heavy sampling) covers only the planned frame ranges, e.g. the GOP
+ * leading up to each keyframe-snapped sample.
+ *
+ * On Linux prefetching uses posix_fadvise(SEQUENTIAL/RANDOM) and
+ * readahead(); elsewhere the window is read into a scratch buffer, which
+ * fills the OS cache the same way.
+ */
+
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+namespace zed_tools {
+
+/**
+ * @brief How the consumer moves through the file
+ */
+enum class AccessPattern {
+    Sequential,   ///< Decode every frame in order
+    Random        ///< Seek between planned frame ranges
+};
+
+/**
+ * @brief Prefetch window settings
+ */
+struct ReadAheadConfig {
+    uint64_t windowBytes = 256ull << 20;  ///< Bytes kept prefetched ahead of the consumer
+    uint64_t chunkBytes = 4ull << 20;     ///< Size of one prefetch request
+};
+
+/**
+ * @brief Prefetch counters
+ */
+struct ReadAheadStats {
+    uint64_t positionUpdates = 0;   ///< Consumer positions reported
+    uint64_t ioWaits = 0;           ///< Positions the consumer reached before the prefetcher (decode waited on I/O)
+    uint64_t seeks = 0;             ///< Backward jumps or jumps past the window
+    uint64_t bytesPrefetched = 0;
+    uint64_t prefetchRequests = 0;
+
+    double waitRatio() const {
+        return positionUpdates > 0 ? static_cast<double>(ioWaits) / positionUpdates : 0.0;
+    }
+};
+
+/**
+ * @brief File access used by the prefetcher (replaceable for tests)
+ */
+class PrefetchBackend {
+public:
+    virtual ~PrefetchBackend() = default;
+
+    /**
+     * @brief Open the file and report its size
+     */
+    virtual bool open(const std::string& path, uint64_t& fileSize) = 0;
+
+    /**
+     * @brief Access hint for the whole file
+     */
+    virtual void setPattern(AccessPattern pattern) = 0;
+
+    /**
+     * @brief Bring [offset, offset + length) into the page cache; returns when done
+     */
+    virtual bool prefetch(uint64_t offset, uint64_t length) = 0;
+
+    virtual void close() = 0;
+};
+
+/**
+ * @brief Platform backend (fadvise + readahead on Linux, buffered reads elsewhere)
+ */
+std::unique_ptr<PrefetchBackend> createDefaultPrefetchBackend();
+
+/**
+ * @brief Background read-ahead that follows the decoder
+ *
+ * Example usage:
+ * @code
+ * ReadAheadConfig cfg;
+ * cfg.windowBytes = 512ull << 20;
+ * ReadAheadPrefetcher prefetcher(cfg);
+ * prefetcher.start("flight.svo2", totalFrames);
+ * while (camera.grab() == sl::ERROR_CODE::SUCCESS) {
+ *     prefetcher.notifyFrame(camera.getSVOPosition());
+ *     ...
+ * }
+ * LOG_INFO(prefetcher.describeStats());
+ * @endcode
+ */
+class ReadAheadPrefetcher {
+public:
+    explicit ReadAheadPrefetcher(const ReadAheadConfig& config = ReadAheadConfig(),
+                                 std::unique_ptr<PrefetchBackend> backend = nullptr);
+    ~ReadAheadPrefetcher();
+
+    ReadAheadPrefetcher(const ReadAheadPrefetcher&) = delete;
+    ReadAheadPrefetcher& operator=(const ReadAheadPrefetcher&) = delete;
+
+    /**
+     * @brief Open the file and start the worker in sequential mode
+     * @param totalFrames Frame count for the frame -> offset estimate (0 = offsets only)
+     */
+    bool start(const std::string& path, int totalFrames = 0);
+
+    /**
+     * @brief Stop the worker and close the file (idempotent)
+     */
+    void stop();
+
+    /**
+     * @brief Exact start offset of every frame (e.g. from KeyframeIndex); otherwise frames
+     *        are assumed to be spread evenly over the file
+     */
+    void setFrameOffsets(std::vector<uint64_t> offsets);
+
+    /**
+     * @brief Switch to sequential mode (window after the consumer)
+     */
+    void setSequential();
+
+    /**
+     * @brief Switch to random mode: prefetch only these inclusive frame ranges
+     *
+     * Ranges are fetched in file order from the consumer onward; a seek back
+     * (e.g. the next coarse-to-fine pass) restarts the window there.
+     */
+    void setRandomPlan(const std::vector<std::pair<int, int>>& frameRanges);
+
+    /**
+     * @brief Consumer is about to decode / has just decoded this frame
+     */
+    void notifyFrame(int frame);
+
+    /**
+     * @brief Consumer position as a file offset
+     */
+    void notifyOffset(uint64_t offset);
+
+    AccessPattern getPattern() const;
+    ReadAheadStats getStats() const;
+    std::string getLastError() const;
+
+    /**
+     * @brief One-line summary ("Read-ahead: 1.2 GB prefetched, decode waited on I/O for 3/900 frames ...")
+     */
+    std::string describeStats() const;
+
+private:
+    ReadAheadConfig config_;
+    std::unique_ptr<PrefetchBackend> backend_;
+
+    mutable std::mutex mutex_;
+    std::condition_variable wake_;
+    std::thread worker_;
+    bool running_ = false;
+
+    uint64_t fileSize_ = 0;
+    int totalFrames_ = 0;
+    std::vector<uint64_t> frameOffsets_;
+    AccessPattern pattern_ = AccessPattern::Sequential;
+    std::vector<std::pair<uint64_t, uint64_t>> plan_;   ///< Sorted, merged [begin, end) byte ranges
+    uint64_t consumer_ = 0;                             ///< Consumer offset
+    uint64_t cursor_ = 0;                               ///< Everything in plan_ within [consumer_, cursor_) is cached
+    uint64_t generation_ = 0;                           ///< Bumped whenever cursor_ is reset
+    bool hasPosition_ = false;
+    ReadAheadStats stats_;
+    std::string lastError_;
+
+    void run();
+    uint64_t frameToOffset(int frame) const;   // Caller holds mutex_
+    uint64_t aheadBytes() const;               // Planned bytes in [consumer_, cursor_)
+    bool nextChunk(uint64_t& offset, uint64_t& length) const;
+};
+
+} // namespace zed_tools
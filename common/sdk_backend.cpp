@@ -0,0 +1,146 @@
+/**
+ * @file sdk_backend.cpp
+ * @brief On-demand loader of the ZED SDK plugin
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "sdk_backend.hpp"
+#include "error_handler.hpp"
+
+#include <cstdlib>
+#include <filesystem>
+#include <mutex>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <dlfcn.h>
+#endif
+
+namespace fs = std::filesystem;
+
+namespace zed_extractor {
+
+namespace {
+
+#ifdef _WIN32
+const char* kPluginFileName = "zed_sdk_backend.dll";
+#else
+const char* kPluginFileName = "libzed_sdk_backend.so";
+#endif
+
+using AbiFn = int (*)();
+using CreateFn = SdkBackend* (*)();
+
+/**
+ * @brief Directory of the running executable (empty if unknown)
+ */
+fs::path executableDirectory() {
+#ifdef _WIN32
+    char buf[MAX_PATH];
+    DWORD n = GetModuleFileNameA(nullptr, buf, MAX_PATH);
+    if (n == 0 || n >= MAX_PATH) return fs::path();
+    return fs::path(buf).parent_path();
+#elif defined(__linux__)
+    std::error_code ec;
+    fs::path exe = fs::read_symlink("/proc/self/exe", ec);
+    return ec ? fs::path() : exe.parent_path();
+#else
+    return fs::path();
+#endif
+}
+
+std::vector<std::string> candidatePaths() {
+    std::vector<std::string> paths;
+    if (const char* env = std::getenv("ZED_EXTRACTOR_SDK_BACKEND")) {
+        if (*env) paths.push_back(env);
+    }
+    fs::path exeDir = executableDirectory();
+    if (!exeDir.empty()) {
+        paths.push_back((exeDir / kPluginFileName).string());
+        paths.push_back((exeDir.parent_path() / "lib" / kPluginFileName).string());
+    }
+    paths.push_back(kPluginFileName);   // Platform search path
+    return paths;
+}
+
+/**
+ * @brief Open a library and resolve the entry points; the handle stays open for the process lifetime
+ */
+bool loadPlugin(const std::string& path, AbiFn& abi, CreateFn& create, std::string& error) {
+#ifdef _WIN32
+    HMODULE handle = LoadLibraryA(path.c_str());
+    if (!handle) {
+        error = path + ": LoadLibrary failed (error " + std::to_string(GetLastError()) + ")";
+        return false;
+    }
+    abi = reinterpret_cast<AbiFn>(GetProcAddress(handle, ZED_SDK_BACKEND_ABI_SYMBOL));
+    create = reinterpret_cast<CreateFn>(GetProcAddress(handle, ZED_SDK_BACKEND_CREATE_SYMBOL));
+#else
+    void* handle = dlopen(path.c_str(), RTLD_NOW | RTLD_LOCAL);
+    if (!handle) {
+        const char* msg = dlerror();
+        error = msg ? msg : (path + ": dlopen failed");
+        return false;
+    }
+    abi = reinterpret_cast<AbiFn>(dlsym(handle, ZED_SDK_BACKEND_ABI_SYMBOL));
+    create = reinterpret_cast<CreateFn>(dlsym(handle, ZED_SDK_BACKEND_CREATE_SYMBOL));
+#endif
+    if (!abi || !create) {
+        error = path + ": not a ZED SDK backend (entry points missing)";
+        return false;
+    }
+    return true;
+}
+
+std::mutex loadMutex;
+bool loadAttempted = false;
+SdkBackend* loadedBackend = nullptr;
+std::string loadError;
+
+} // namespace
+
+SdkBackend* getSdkBackend(std::string* error) {
+    std::lock_guard<std::mutex> lock(loadMutex);
+    if (!loadAttempted) {
+        loadAttempted = true;
+        std::string reasons;
+        for (const std::string& path : candidatePaths()) {
+            AbiFn abi = nullptr;
+            CreateFn create = nullptr;
+            std::string why;
+            if (!loadPlugin(path, abi, create, why)) {
+                reasons += "\n  " + why;
+                continue;
+            }
+            if (abi() != kSdkBackendAbiVersion) {
+                reasons += "\n  " + path + ": interface version " + std::to_string(abi()) +
+                           ", expected " + std::to_string(kSdkBackendAbiVersion);
+                continue;
+            }
+            loadedBackend = create();
+            if (loadedBackend) {
+                LOG_INFO("ZED SDK backend loaded from " + path + " (SDK " + loadedBackend->getSdkVersion() + ")");
+                break;
+            }
+            reasons += "\n  " + path + ": backend creation failed";
+        }
+        if (!loadedBackend) {
+            loadError = "ZED SDK backend unavailable (is the ZED SDK installed?):" + reasons;
+            LOG_WARNING(loadError);
+        }
+    }
+    if (!loadedBackend && error) *error = loadError;
+    return loadedBackend;
+}
+
+bool isSdkBackendAvailable() {
+    return getSdkBackend() != nullptr;
+}
+
+} // namespace zed_extractor
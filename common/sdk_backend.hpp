@@ -0,0 +1,104 @@
+/**
+ * @file sdk_backend.hpp
+ * @brief Interface of the ZED SDK plugin and its on-demand loader
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ *
+ * zed_common_core has no link dependency on the ZED SDK or CUDA. All SVO
+ * decoding lives in the zed_sdk_backend shared library, which is loaded with
+ * dlopen/LoadLibrary the first time an extraction needs it. Tools that only
+ * scan folders, read outputs or re-render from disk never load it, start
+ * without the SDK runtime and run on hosts where it is not installed.
+ *
+ * Lookup order for the plugin:
+ *   1. ZED_EXTRACTOR_SDK_BACKEND (full path to the library)
+ *   2. Next to the executable, then ../lib relative to it
+ *   3. The platform's library search path
+ */
+
+#pragma once
+
+#include "extraction_engine.hpp"
+
+#include <opencv2/core.hpp>
+#include <cstdint>
+#include <string>
+
+namespace zed_extractor {
+
+/**
+ * @brief Version of the SdkBackend interface; plugins built for another version are rejected
+ */
+constexpr int kSdkBackendAbiVersion = 2;
+
+/**
+ * @brief Single decoded frame
+ */
+struct SvoFrameData {
+    cv::Mat depth;        ///< CV_32FC1 meters (empty unless requested)
+    cv::Mat confidence;   ///< CV_32FC1 SDK confidence (with depth)
+    cv::Mat leftBgr;      ///< CV_8UC3 left image (empty unless requested)
+};
+
+/**
+ * @brief SDK-dependent operations, implemented by the plugin
+ */
+class SdkBackend {
+public:
+    virtual ~SdkBackend() = default;
+
+    /**
+     * @brief ZED SDK version the plugin runs against
+     */
+    virtual std::string getSdkVersion() const = 0;
+
+    virtual ExtractionResult extractFrames(ExtractionEngine& engine, const FrameExtractionConfig& config,
+                                           ProgressCallback progressCallback) = 0;
+    virtual ExtractionResult extractVideo(ExtractionEngine& engine, const VideoExtractionConfig& config,
+                                          ProgressCallback progressCallback) = 0;
+    virtual ExtractionResult extractDepth(ExtractionEngine& engine, const DepthExtractionConfig& config,
+                                          ProgressCallback progressCallback) = 0;
+    virtual ExtractionResult estimateFrames(ExtractionEngine& engine, const FrameExtractionConfig& config,
+                                            ExtractionEstimate& estimate, int samples,
+                                            ProgressCallback progressCallback) = 0;
+    virtual ExtractionResult estimateDepth(ExtractionEngine& engine, const DepthExtractionConfig& config,
+                                           ExtractionEstimate& estimate, int samples,
+                                           ProgressCallback progressCallback) = 0;
+
+    /**
+     * @brief Decode one frame of cfg.svoFilePath with cfg's depth mode and confidence threshold
+     * @param framePos SVO frame (<0 = first frame)
+     */
+    virtual bool retrieveFrame(const DepthExtractionConfig& cfg, int framePos,
+                               bool wantDepth, bool wantLeft, SvoFrameData& out) = 0;
+
+    /**
+     * @brief Free and total memory of the CUDA device the SDK runs on
+     * @return false if the plugin was built without the CUDA runtime or no device is present
+     */
+    virtual bool getGpuMemory(uint64_t& freeBytes, uint64_t& totalBytes) = 0;
+};
+
+/**
+ * @brief Load the plugin on first call (thread-safe; later calls return the same instance)
+ * @param error Receives the reason when the plugin is unavailable
+ * @return nullptr if the library, the SDK runtime or a matching entry point is missing
+ */
+SdkBackend* getSdkBackend(std::string* error = nullptr);
+
+/**
+ * @brief Whether the plugin can be loaded (loads it if not done yet)
+ */
+bool isSdkBackendAvailable();
+
+} // namespace zed_extractor
+
+// Entry points exported by the plugin
+#ifdef _WIN32
+#define ZED_SDK_BACKEND_EXPORT extern "C" __declspec(dllexport)
+#else
+#define ZED_SDK_BACKEND_EXPORT extern "C" __attribute__((visibility("default")))
+#endif
+
+#define ZED_SDK_BACKEND_ABI_SYMBOL "zed_sdk_backend_abi"
+#define ZED_SDK_BACKEND_CREATE_SYMBOL "zed_sdk_backend_create"
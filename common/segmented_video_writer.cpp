@@ -0,0 +1,346 @@
+/**
+ * @file segmented_video_writer.cpp
+ * @brief Implementation of the segmented video writer
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "segmented_video_writer.hpp"
+#include "metadata.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+
+namespace fs = std::filesystem;
+
+namespace zed_tools {
+
+namespace {
+
+/**
+ * @brief Write to a temporary file, then replace the target (readers never see a partial file)
+ */
+bool writeFileAtomic(const std::string& path, const std::string& content) {
+    const std::string tmp = path + ".tmp";
+    {
+        std::ofstream out(tmp, std::ios::binary | std::ios::trunc);
+        if (!out) return false;
+        out << content;
+        if (!out) return false;
+    }
+    std::error_code ec;
+    fs::rename(tmp, path, ec);
+    if (ec) {
+        fs::remove(tmp, ec);
+        return false;
+    }
+    return true;
+}
+
+} // namespace
+
+const char* segmentStateName(SegmentState state) {
+    switch (state) {
+        case SegmentState::Writing: return "writing";
+        case SegmentState::Finalizing: return "finalizing";
+        case SegmentState::Complete: return "complete";
+        case SegmentState::Failed: return "failed";
+    }
+    return "unknown";
+}
+
+SegmentedVideoWriter::SegmentedVideoWriter() = default;
+
+SegmentedVideoWriter::~SegmentedVideoWriter() {
+    if (current_ || finalizers_) close();
+}
+
+ErrorResult SegmentedVideoWriter::open(const SegmentedVideoConfig& config, SegmentCallback onSegmentDone) {
+    if (current_) close();
+    if (config.fps <= 0.0 || config.segmentSec <= 0.0) {
+        return ErrorResult::failure("Segment length and FPS must be positive");
+    }
+    config_ = config;
+    onSegmentDone_ = std::move(onSegmentDone);
+    framesPerSegment_ = std::max(1, static_cast<int>(std::lround(config_.segmentSec * config_.fps)));
+    frameCount_ = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_.clear();
+        finished_ = false;
+    }
+    finalizers_ = std::make_unique<TaskGroup>();
+
+    if (!openSegment()) {
+        finalizers_.reset();
+        return ErrorResult::failure("Failed to create video segment: " + partPath(0));
+    }
+    writeManifest();
+    return ErrorResult::success();
+}
+
+std::string SegmentedVideoWriter::partPath(int index) const {
+    std::ostringstream oss;
+    oss << config_.directory << "/" << config_.stem << "_" << std::setw(3) << std::setfill('0') << index
+        << ".part" << config_.extension;
+    return oss.str();
+}
+
+std::string SegmentedVideoWriter::finalPath(int index) const {
+    std::ostringstream oss;
+    oss << config_.directory << "/" << config_.stem << "_" << std::setw(3) << std::setfill('0') << index
+        << config_.extension;
+    return oss.str();
+}
+
+std::string SegmentedVideoWriter::getManifestPath() const {
+    return config_.directory + "/" + config_.stem + "_segments.json";
+}
+
+std::string SegmentedVideoWriter::getConcatListPath() const {
+    return config_.directory + "/" + config_.stem + ".ffconcat";
+}
+
+bool SegmentedVideoWriter::openSegment() {
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index = static_cast<int>(segments_.size());
+    }
+    auto writer = std::make_shared<cv::VideoWriter>();
+    writer->open(partPath(index), config_.fourcc, config_.fps, config_.frameSize, config_.isColor);
+    if (!writer->isOpened()) return false;
+
+    VideoSegment segment;
+    segment.index = index;
+    segment.fileName = fs::path(finalPath(index)).filename().string();
+    segment.startFrame = frameCount_;
+    segment.startSec = frameCount_ / config_.fps;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_.push_back(segment);
+    }
+    current_ = std::move(writer);
+    return true;
+}
+
+bool SegmentedVideoWriter::write(const cv::Mat& frame) {
+    if (!current_) return false;
+    current_->write(frame);
+    ++frameCount_;
+
+    int inSegment;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        VideoSegment& segment = segments_.back();
+        segment.frameCount++;
+        segment.durationSec = segment.frameCount / config_.fps;
+        inSegment = segment.frameCount;
+    }
+    if (inSegment >= framesPerSegment_) {
+        finalizeCurrent();
+        if (!openSegment()) {
+            LOG_ERROR("Failed to create video segment: " + partPath(static_cast<int>(getSegments().size())));
+            return false;
+        }
+    }
+    return true;
+}
+
+void SegmentedVideoWriter::finalizeCurrent() {
+    if (!current_) return;
+    int index;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        index = segments_.back().index;
+        segments_.back().state = SegmentState::Finalizing;
+    }
+    std::shared_ptr<cv::VideoWriter> writer = std::move(current_);
+    current_.reset();
+    // Releasing writes the container index; the next segment is already being written meanwhile
+    finalizers_->run([this, index, writer]() { finalizeSegment(index, writer); });
+}
+
+void SegmentedVideoWriter::finalizeSegment(int index, std::shared_ptr<cv::VideoWriter> writer) {
+    bool ok = true;
+    try {
+        writer->release();
+    } catch (const std::exception& e) {
+        LOG_ERROR("Failed to finalise " + partPath(index) + ": " + e.what());
+        ok = false;
+    }
+
+    std::error_code ec;
+    uint64_t bytes = 0;
+    if (ok) {
+        fs::rename(partPath(index), finalPath(index), ec);
+        if (ec) {
+            LOG_ERROR("Failed to rename " + partPath(index) + ": " + ec.message());
+            ok = false;
+        } else {
+            bytes = static_cast<uint64_t>(fs::file_size(finalPath(index), ec));
+        }
+    }
+
+    VideoSegment done;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        VideoSegment& segment = segments_[index];
+        segment.state = ok ? SegmentState::Complete : SegmentState::Failed;
+        segment.bytes = bytes;
+        done = segment;
+    }
+    writeManifest();
+    if (onSegmentDone_) onSegmentDone_(done);
+}
+
+void SegmentedVideoWriter::writeManifest() {
+    std::vector<VideoSegment> segments;
+    bool finished;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments = segments_;
+        finished = finished_;
+    }
+
+    JSONBuilder json;
+    json.beginObject();
+    json.addString("type", "video_segments");
+    json.addString("stem", config_.stem);
+    json.addNumber("fps", config_.fps);
+    json.addNumber("width", config_.frameSize.width);
+    json.addNumber("height", config_.frameSize.height);
+    json.addNumber("segment_sec", config_.segmentSec);
+    json.addBool("finished", finished);
+    json.beginArray("segments");
+    for (const VideoSegment& s : segments) {
+        json.beginObject();
+        json.addNumber("index", s.index);
+        json.addString("file", s.fileName);
+        json.addString("state", segmentStateName(s.state));
+        json.addNumber("start_frame", s.startFrame);
+        json.addNumber("frames", s.frameCount);
+        json.addNumber("start_sec", s.startSec);
+        json.addNumber("duration_sec", s.durationSec);
+        json.addNumber("bytes", static_cast<double>(s.bytes));
+        json.endObject();
+    }
+    json.endArray();
+    json.endObject();
+
+    // Concat list: complete segments up to the first one that is not (no gaps in the timeline)
+    std::ostringstream concat;
+    concat << "ffconcat version 1.0\n";
+    for (const VideoSegment& s : segments) {
+        if (s.state != SegmentState::Complete) break;
+        char duration[32];
+        std::snprintf(duration, sizeof(duration), "%.6f", s.durationSec);
+        concat << "file '" << s.fileName << "'\nduration " << duration << "\n";
+    }
+
+    std::lock_guard<std::mutex> lock(manifestMutex_);
+    if (!writeFileAtomic(getManifestPath(), json.toString() + "\n")) {
+        LOG_WARNING("Failed to write segment manifest: " + getManifestPath());
+    }
+    if (!writeFileAtomic(getConcatListPath(), concat.str())) {
+        LOG_WARNING("Failed to write concat list: " + getConcatListPath());
+    }
+}
+
+ErrorResult SegmentedVideoWriter::close() {
+    if (!finalizers_) return ErrorResult::success();
+
+    // An empty last segment (stream ended right after a roll) is dropped
+    bool emptyTail = false;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        emptyTail = current_ && !segments_.empty() && segments_.back().frameCount == 0 && segments_.size() > 1;
+    }
+    if (emptyTail) {
+        const int index = static_cast<int>(getSegments().size()) - 1;
+        current_->release();
+        current_.reset();
+        std::error_code ec;
+        fs::remove(partPath(index), ec);
+        std::lock_guard<std::mutex> lock(mutex_);
+        segments_.pop_back();
+    }
+    finalizeCurrent();
+
+    try {
+        finalizers_->wait();
+    } catch (const std::exception& e) {
+        LOG_ERROR(std::string("Segment finalisation failed: ") + e.what());
+    }
+    finalizers_.reset();
+
+    int failed = 0;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        finished_ = true;
+        for (const VideoSegment& s : segments_) {
+            if (s.state != SegmentState::Complete) ++failed;
+        }
+    }
+    writeManifest();
+
+    if (failed > 0) {
+        return ErrorResult::failure(std::to_string(failed) + " video segment(s) of " + config_.stem +
+                                    " could not be finalised");
+    }
+    return ErrorResult::success();
+}
+
+std::vector<VideoSegment> SegmentedVideoWriter::getSegments() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return segments_;
+}
+
+ErrorResult VideoStreamWriter::open(const SegmentedVideoConfig& config,
+                                    SegmentedVideoWriter::SegmentCallback onSegmentDone) {
+    release();
+    if (config.segmentSec > 0.0) {
+        segmented_ = std::make_unique<SegmentedVideoWriter>();
+        ErrorResult result = segmented_->open(config, std::move(onSegmentDone));
+        if (result.isFailure()) {
+            segmented_.reset();
+            return result;
+        }
+        outputPath_ = segmented_->getManifestPath();
+        return ErrorResult::success();
+    }
+    outputPath_ = config.directory + "/" + config.stem + config.extension;
+    single_.open(outputPath_, config.fourcc, config.fps, config.frameSize, config.isColor);
+    if (!single_.isOpened()) {
+        return ErrorResult::failure("Failed to create video writer: " + outputPath_);
+    }
+    return ErrorResult::success();
+}
+
+bool VideoStreamWriter::write(const cv::Mat& frame) {
+    if (segmented_) return segmented_->write(frame);
+    if (!single_.isOpened()) return false;
+    single_.write(frame);
+    return true;
+}
+
+ErrorResult VideoStreamWriter::release() {
+    if (segmented_) {
+        ErrorResult result = segmented_->close();
+        segmented_.reset();
+        return result;
+    }
+    if (single_.isOpened()) single_.release();
+    return ErrorResult::success();
+}
+
+bool VideoStreamWriter::isOpened() const {
+    return segmented_ ? segmented_->isOpened() : single_.isOpened();
+}
+
+} // namespace zed_tools
@@ -0,0 +1,202 @@
+/**
+ * @file segmented_video_writer.hpp
+ * @brief Rolls video output into fixed-duration segments with a live manifest
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * One huge file per stream means a corrupt tail loses the whole flight and
+ * nothing downstream can start before the extraction ends. This writer cuts
+ * the stream every N seconds:
+ * - the current segment is written as <stem>_NNN.part<ext>
+ * - when it is full, the next one opens at once and the finished writer is
+ *   released (index/trailer written) on the shared thread pool, then renamed
+ *   to <stem>_NNN<ext>, so a file without ".part" is always complete
+ * - after every finalised segment <stem>_segments.json (all segments with
+ *   state, frame range and size) and <stem>.ffconcat (complete segments in
+ *   order) are rewritten atomically
+ *
+ * Downstream tools poll the manifest or play the concat list while the flight
+ * is still extracting:
+ * @code
+ * ffmpeg -f concat -safe 0 -i video_left.ffconcat -c copy video_left.avi
+ * @endcode
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <opencv2/core.hpp>
+#include <opencv2/videoio.hpp>
+#include "error_handler.hpp"
+#include "thread_pool.hpp"
+
+namespace zed_tools {
+
+/**
+ * @brief Segment settings of one stream
+ */
+struct SegmentedVideoConfig {
+    std::string directory;            ///< Output folder
+    std::string stem;                 ///< File name stem, e.g. "video_left" -> video_left_000.avi
+    std::string extension = ".avi";   ///< Container (selects the OpenCV backend)
+    int fourcc = 0;
+    double fps = 30.0;
+    cv::Size frameSize;
+    bool isColor = true;
+    double segmentSec = 60.0;         ///< Segment length in seconds of video
+};
+
+/**
+ * @brief Lifecycle of a segment
+ */
+enum class SegmentState {
+    Writing,      ///< Frames are still added (<stem>_NNN.part<ext>)
+    Finalizing,   ///< Full; writer is being released on a pool thread
+    Complete,     ///< Released and renamed; safe to read
+    Failed        ///< Could not be finalised or renamed
+};
+
+/**
+ * @brief One segment file
+ */
+struct VideoSegment {
+    int index = 0;
+    std::string fileName;             ///< Final name (without ".part")
+    int startFrame = 0;               ///< First frame of the stream in this segment
+    int frameCount = 0;
+    double startSec = 0.0;
+    double durationSec = 0.0;
+    uint64_t bytes = 0;               ///< File size once complete
+    SegmentState state = SegmentState::Writing;
+};
+
+/**
+ * @brief Name of a segment state in the manifest ("writing", "finalizing", "complete", "failed")
+ */
+const char* segmentStateName(SegmentState state);
+
+/**
+ * @brief Video writer that rolls into segments and finalises them in the background
+ *
+ * Example usage:
+ * @code
+ * SegmentedVideoConfig cfg;
+ * cfg.directory = extractionPath;
+ * cfg.stem = "video_left";
+ * cfg.fourcc = cv::VideoWriter::fourcc('M', 'J', 'P', 'G');
+ * cfg.fps = 30.0;
+ * cfg.frameSize = cv::Size(1920, 1080);
+ * cfg.segmentSec = 60.0;
+ * SegmentedVideoWriter writer;
+ * if (writer.open(cfg).isSuccess()) {
+ *     while (...) writer.write(frame);
+ *     writer.close();
+ * }
+ * @endcode
+ */
+class SegmentedVideoWriter {
+public:
+    using SegmentCallback = std::function<void(const VideoSegment&)>;
+
+    SegmentedVideoWriter();
+
+    /**
+     * @brief Closes the writer (waits for pending finalisation)
+     */
+    ~SegmentedVideoWriter();
+
+    SegmentedVideoWriter(const SegmentedVideoWriter&) = delete;
+    SegmentedVideoWriter& operator=(const SegmentedVideoWriter&) = delete;
+
+    /**
+     * @brief Open the first segment
+     * @param onSegmentDone Called on a pool thread after each segment is complete (or failed)
+     *        and the manifest lists it
+     */
+    ErrorResult open(const SegmentedVideoConfig& config, SegmentCallback onSegmentDone = nullptr);
+
+    /**
+     * @brief Append a frame; rolls to the next segment when the current one is full
+     * @return false if no segment writer is open
+     */
+    bool write(const cv::Mat& frame);
+
+    /**
+     * @brief Finalise the last segment, wait for all segments and mark the manifest finished
+     * @return Failure if a segment could not be finalised (the others stay usable)
+     */
+    ErrorResult close();
+
+    bool isOpened() const { return current_ != nullptr; }
+    int getFrameCount() const { return frameCount_; }
+    std::string getManifestPath() const;
+    std::string getConcatListPath() const;
+
+    /**
+     * @brief Snapshot of all segments so far
+     */
+    std::vector<VideoSegment> getSegments() const;
+
+private:
+    SegmentedVideoConfig config_;
+    SegmentCallback onSegmentDone_;
+    int framesPerSegment_ = 0;
+    int frameCount_ = 0;
+    bool finished_ = false;
+    std::shared_ptr<cv::VideoWriter> current_;
+
+    mutable std::mutex mutex_;       // segments_, finished_
+    std::vector<VideoSegment> segments_;
+    std::mutex manifestMutex_;       // Serializes manifest rewrites
+    std::unique_ptr<TaskGroup> finalizers_;
+
+    std::string partPath(int index) const;
+    std::string finalPath(int index) const;
+    bool openSegment();
+    void finalizeCurrent();
+    void finalizeSegment(int index, std::shared_ptr<cv::VideoWriter> writer);
+    void writeManifest();
+};
+
+/**
+ * @brief One output stream: a single <stem><ext> file, or rolling segments when segmentSec > 0
+ */
+class VideoStreamWriter {
+public:
+    /**
+     * @param config Stream settings; config.segmentSec <= 0 writes one file
+     */
+    ErrorResult open(const SegmentedVideoConfig& config,
+                     SegmentedVideoWriter::SegmentCallback onSegmentDone = nullptr);
+
+    /**
+     * @brief Append a frame
+     * @return false if the stream is not open or the next segment could not be created
+     *         (later frames would be lost, so the caller should stop)
+     */
+    bool write(const cv::Mat& frame);
+
+    /**
+     * @brief Close the file, or finalise all segments
+     */
+    ErrorResult release();
+
+    bool isOpened() const;
+
+    /**
+     * @brief The video file, or the segment manifest
+     */
+    const std::string& getOutputPath() const { return outputPath_; }
+
+private:
+    cv::VideoWriter single_;
+    std::unique_ptr<SegmentedVideoWriter> segmented_;
+    std::string outputPath_;
+};
+
+} // namespace zed_tools
@@ -0,0 +1,104 @@
+/**
+ * @file sparse_motion_flow.cpp
+ * @brief Implementation of the sparse motion flow stage
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#include "sparse_motion_flow.hpp"
+
+#include <opencv2/imgproc.hpp>
+#include <opencv2/video/tracking.hpp>
+#include <opencv2/calib3d.hpp>
+#include <algorithm>
+#include <cmath>
+
+namespace zed_extractor {
+
+SparseMotionFlow::SparseMotionFlow(const SparseFlowConfig& config)
+    : config_(config)
+{
+    config_.scale = std::min(1.0f, std::max(0.05f, config_.scale));
+    config_.gridStep = std::max(2, config_.gridStep);
+}
+
+void SparseMotionFlow::reset() {
+    prevGray_.release();
+    egoMotion_.release();
+    grid_.clear();
+    trackedCount_ = 0;
+}
+
+int SparseMotionFlow::process(const cv::Mat& image, cv::Mat& motionMask) {
+    motionMask.release();
+    egoMotion_.release();
+    trackedCount_ = 0;
+    if (image.empty()) return 0;
+
+    cv::Mat small;
+    cv::resize(image, small, cv::Size(), config_.scale, config_.scale, cv::INTER_AREA);
+    if (small.channels() == 4) cv::cvtColor(small, gray_, cv::COLOR_BGRA2GRAY);
+    else if (small.channels() == 3) cv::cvtColor(small, gray_, cv::COLOR_BGR2GRAY);
+    else gray_ = small;
+
+    if (prevGray_.empty() || prevGray_.size() != gray_.size()) {
+        gray_.copyTo(prevGray_);
+        return 0;
+    }
+
+    // Fixed grid: no feature detection cost; untextured points fail the LK eigenvalue test
+    const int step = config_.gridStep;
+    if (grid_.empty() || gridSize_ != gray_.size()) {
+        gridSize_ = gray_.size();
+        grid_.clear();
+        for (int y = step / 2; y < gray_.rows; y += step) {
+            for (int x = step / 2; x < gray_.cols; x += step) {
+                grid_.emplace_back(static_cast<float>(x), static_cast<float>(y));
+            }
+        }
+    }
+
+    cv::calcOpticalFlowPyrLK(prevGray_, gray_, grid_, next_, status_, err_,
+                             cv::Size(config_.winSize, config_.winSize), config_.pyrLevels,
+                             cv::TermCriteria(cv::TermCriteria::COUNT | cv::TermCriteria::EPS, 10, 0.03),
+                             0, 1e-3);
+    std::swap(prevGray_, gray_);
+
+    from_.clear();
+    to_.clear();
+    for (size_t i = 0; i < grid_.size(); ++i) {
+        if (!status_[i]) continue;
+        from_.push_back(grid_[i]);
+        to_.push_back(next_[i]);
+    }
+    trackedCount_ = static_cast<int>(from_.size());
+    if (trackedCount_ < 6) return 0;
+
+    // Ego-motion: dominant similarity transform of the tracked grid
+    std::vector<uchar> inliers;
+    egoMotion_ = cv::estimateAffinePartial2D(from_, to_, inliers, cv::RANSAC, config_.ransacThreshold);
+    if (egoMotion_.empty()) return 0;
+    const double* A = egoMotion_.ptr<double>(0);
+
+    cv::Mat smallMask = cv::Mat::zeros(prevGray_.size(), CV_8UC1);
+    const float thr2 = config_.residualThreshold * config_.residualThreshold;
+    const int half = step / 2;
+    int moving = 0;
+    for (size_t i = 0; i < from_.size(); ++i) {
+        const cv::Point2f& p = from_[i];
+        float px = static_cast<float>(A[0] * p.x + A[1] * p.y + A[2]);
+        float py = static_cast<float>(A[3] * p.x + A[4] * p.y + A[5]);
+        float rx = to_[i].x - px, ry = to_[i].y - py;
+        if (rx * rx + ry * ry <= thr2) continue;
+        ++moving;
+        // Flag the cell around the point's current position
+        cv::Rect cell(static_cast<int>(to_[i].x) - half, static_cast<int>(to_[i].y) - half, step, step);
+        smallMask(cell & cv::Rect(0, 0, smallMask.cols, smallMask.rows)).setTo(255);
+    }
+    if (moving < config_.minMovingPoints) return 0;
+
+    cv::resize(smallMask, motionMask, image.size(), 0, 0, cv::INTER_NEAREST);
+    return moving;
+}
+
+} // namespace zed_extractor
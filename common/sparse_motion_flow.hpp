@@ -0,0 +1,80 @@
+/**
+ * @file sparse_motion_flow.hpp
+ * @brief Sparse pyramidal Lucas-Kanade flow with ego-motion compensation
+ * @author ZED SVO2 Extractor Team
+ * @date 2026-10-18
+ */
+
+#pragma once
+
+#include <vector>
+#include <opencv2/core.hpp>
+
+namespace zed_extractor {
+
+/**
+ * @brief Flow stage parameters (pixel values refer to the downscaled image)
+ */
+struct SparseFlowConfig {
+    float scale = 0.25f;              // Downscale of the grayscale left image
+    int gridStep = 12;                // Feature grid spacing (px)
+    int winSize = 15;                 // LK window (px)
+    int pyrLevels = 2;                // Extra pyramid levels
+    float ransacThreshold = 1.0f;     // Ego-motion inlier threshold (px)
+    float residualThreshold = 1.5f;   // Residual flow that counts as independent motion (px)
+    int minMovingPoints = 2;          // Fewer flagged points than this is treated as noise
+};
+
+/**
+ * @brief Sparse flow and independent-motion mask for consecutive frames
+ *
+ * A fixed grid of points on the downscaled image is tracked with pyramidal LK.
+ * A partial affine model (rotation, uniform scale, translation) fitted with
+ * RANSAC absorbs the camera's own motion. Points whose flow still deviates
+ * from the model by more than residualThreshold are moving independently.
+ * Their grid cells form the motion mask. At 1/4 scale with a 12 px grid
+ * (~1300 points at HD1080) this costs a few ms per frame.
+ */
+class SparseMotionFlow {
+public:
+    explicit SparseMotionFlow(const SparseFlowConfig& config = SparseFlowConfig());
+
+    /**
+     * @brief Forget the previous frame
+     */
+    void reset();
+
+    /**
+     * @brief Process the next frame
+     * @param image Left image (BGR, BGRA or gray), full resolution
+     * @param motionMask Full-resolution CV_8UC1 mask of independently moving cells
+     *        (empty on the first frame or when the ego-motion fit fails)
+     * @return Number of points flagged as moving
+     */
+    int process(const cv::Mat& image, cv::Mat& motionMask);
+
+    /**
+     * @brief Ego-motion model of the last frame pair (2x3, CV_64F; empty if none)
+     */
+    const cv::Mat& getEgoMotion() const { return egoMotion_; }
+
+    /**
+     * @brief Points tracked successfully in the last frame pair
+     */
+    int getTrackedCount() const { return trackedCount_; }
+
+private:
+    SparseFlowConfig config_;
+    cv::Mat prevGray_;
+    cv::Mat gray_;
+    cv::Mat egoMotion_;
+    std::vector<cv::Point2f> grid_;
+    cv::Size gridSize_;               // Image size the grid was built for
+    std::vector<cv::Point2f> next_;
+    std::vector<uchar> status_;
+    std::vector<float> err_;
+    std::vector<cv::Point2f> from_, to_;
+    int trackedCount_ = 0;
+};
+
+} // namespace zed_extractor
@@ -0,0 +1,302 @@
+/**
+ * @file svo_container_reader.cpp
+ * @brief Implementation of the SDK-free SVO2 (MCAP) container reader
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "svo_container_reader.hpp"
+#include "error_handler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace zed_tools {
+
+namespace {
+
+// MCAP magic: 0x89 'M' 'C' 'A' 'P' '0' '\r' '\n'
+const uint8_t kMagic[8] = { 0x89, 'M', 'C', 'A', 'P', '0', '\r', '\n' };
+
+// Record opcodes used by this reader
+enum : uint8_t {
+    OP_HEADER   = 0x01,
+    OP_FOOTER   = 0x02,
+    OP_SCHEMA   = 0x03,
+    OP_CHANNEL  = 0x04,
+    OP_MESSAGE  = 0x05,
+    OP_CHUNK    = 0x06,
+    OP_MESSAGE_INDEX = 0x07,
+    OP_DATA_END = 0x0F
+};
+
+// Records larger than this are treated as corruption rather than allocated
+const uint64_t kMaxRecordBytes = 1ull << 32;
+
+// Little-endian field readers (container is always little-endian)
+inline uint16_t readU16(const uint8_t* p) { uint16_t v; std::memcpy(&v, p, 2); return v; }
+inline uint32_t readU32(const uint8_t* p) { uint32_t v; std::memcpy(&v, p, 4); return v; }
+inline uint64_t readU64(const uint8_t* p) { uint64_t v; std::memcpy(&v, p, 8); return v; }
+
+/**
+ * @brief Bounds-checked cursor over a record body
+ */
+struct Cursor {
+    const uint8_t* p;
+    const uint8_t* end;
+
+    bool has(uint64_t n) const { return static_cast<uint64_t>(end - p) >= n; }
+    bool u16(uint16_t& v) { if (!has(2)) return false; v = readU16(p); p += 2; return true; }
+    bool u32(uint32_t& v) { if (!has(4)) return false; v = readU32(p); p += 4; return true; }
+    bool u64(uint64_t& v) { if (!has(8)) return false; v = readU64(p); p += 8; return true; }
+    bool str(std::string& s) {
+        uint32_t len = 0;
+        if (!u32(len) || !has(len)) return false;
+        s.assign(reinterpret_cast<const char*>(p), len);
+        p += len;
+        return true;
+    }
+    bool skipPrefixed32() {
+        uint32_t len = 0;
+        if (!u32(len) || !has(len)) return false;
+        p += len;
+        return true;
+    }
+};
+
+} // namespace
+
+SvoContainerReader::SvoContainerReader(const std::string& filePath, size_t readBlockBytes)
+    : filePath_(filePath)
+    , blockBytes_(std::max<size_t>(readBlockBytes, 64u * 1024u))
+{
+}
+
+SvoContainerReader::~SvoContainerReader() {
+    close();
+}
+
+bool SvoContainerReader::open() {
+    if (file_) {
+        lastError_ = "Container is already open";
+        return false;
+    }
+#ifdef _WIN32
+    fopen_s(&file_, filePath_.c_str(), "rb");
+#else
+    file_ = fopen(filePath_.c_str(), "rb");
+#endif
+    if (!file_) {
+        lastError_ = "Failed to open container: " + filePath_;
+        return false;
+    }
+    // We do our own buffering with large blocks
+    setvbuf(file_, nullptr, _IONBF, 0);
+
+    uint8_t magic[8] = {0};
+    if (fread(magic, 1, sizeof(magic), file_) != sizeof(magic) ||
+        std::memcmp(magic, kMagic, sizeof(kMagic)) != 0) {
+        lastError_ = "Not an SVO2/MCAP container (bad magic): " + filePath_;
+        close();
+        return false;
+    }
+
+    buffer_.resize(blockBytes_);
+    lastError_.clear();
+    return true;
+}
+
+void SvoContainerReader::close() {
+    if (file_) {
+        fclose(file_);
+        file_ = nullptr;
+    }
+}
+
+bool SvoContainerReader::isOpen() const {
+    return file_ != nullptr;
+}
+
+const ContainerSchema* SvoContainerReader::getSchemaForChannel(const ContainerChannel& channel) const {
+    if (channel.schemaId == 0) return nullptr;
+    auto it = schemas_.find(channel.schemaId);
+    return (it != schemas_.end()) ? &it->second : nullptr;
+}
+
+bool SvoContainerReader::ensureAvailable(size_t n) {
+    size_t avail = bufEnd_ - bufBegin_;
+    if (avail >= n) return true;
+    if (eof_) return false;
+
+    // Compact unconsumed bytes to the front of the buffer
+    if (bufBegin_ > 0) {
+        if (avail > 0) std::memmove(buffer_.data(), buffer_.data() + bufBegin_, avail);
+        bufFileOffset_ += bufBegin_;
+        bufBegin_ = 0;
+        bufEnd_ = avail;
+    }
+    // Grow only for records larger than one block (rare: big chunks)
+    if (buffer_.size() < n) {
+        buffer_.resize(std::max(n, blockBytes_));
+    }
+
+    while (bufEnd_ < n && !eof_) {
+        size_t want = buffer_.size() - bufEnd_;
+        size_t got = fread(buffer_.data() + bufEnd_, 1, want, file_);
+        stats_.bytesRead += got;
+        bufEnd_ += got;
+        if (got < want) eof_ = true;
+    }
+    return bufEnd_ >= n;
+}
+
+bool SvoContainerReader::readMessages(const MessageHandler& handler) {
+    if (!file_) {
+        lastError_ = "Cannot read: container is not open";
+        return false;
+    }
+
+    // Always start right after the leading magic
+    if (fseek(file_, static_cast<long>(sizeof(kMagic)), SEEK_SET) != 0) {
+        lastError_ = "Failed to seek container: " + filePath_;
+        return false;
+    }
+    bufBegin_ = bufEnd_ = 0;
+    bufFileOffset_ = sizeof(kMagic);
+    eof_ = false;
+    stats_ = ContainerReadStats();
+    skippedChunkPending_ = false;
+
+    bool stop = false;
+    while (!stop) {
+        // Record prefix: opcode (1) + length (8)
+        if (!ensureAvailable(9)) break;
+        const uint8_t* rec = buffer_.data() + bufBegin_;
+        uint8_t opcode = rec[0];
+        uint64_t length = readU64(rec + 1);
+        if (length > kMaxRecordBytes) {
+            lastError_ = "Corrupt record length at offset " + std::to_string(bufFileOffset_ + bufBegin_);
+            return false;
+        }
+        if (!ensureAvailable(9 + static_cast<size_t>(length))) {
+            // Truncated tail (e.g., recording still in progress): report what we have
+            lastError_ = "Truncated record at end of container";
+            LOG_WARNING(lastError_ + ": " + filePath_);
+            break;
+        }
+        rec = buffer_.data() + bufBegin_; // buffer may have moved
+        uint64_t recOffset = bufFileOffset_ + bufBegin_;
+        bufBegin_ += 9 + static_cast<size_t>(length);
+
+        if (opcode != OP_MESSAGE_INDEX) closeSkippedChunk();
+        if (opcode == OP_DATA_END || opcode == OP_FOOTER) break;
+        if (!parseRecord(opcode, rec + 9, length, recOffset, handler, stop)) {
+            if (stop) break;
+            lastError_ = "Malformed record (opcode " + std::to_string(opcode) +
+                         ") at offset " + std::to_string(recOffset);
+            return false;
+        }
+    }
+    closeSkippedChunk();
+    return true;
+}
+
+void SvoContainerReader::closeSkippedChunk() {
+    if (!skippedChunkPending_) return;
+    if (!skippedChunkIndexed_) stats_.unindexedChunksSkipped++;
+    skippedChunkPending_ = false;
+}
+
+bool SvoContainerReader::parseRecord(uint8_t opcode, const uint8_t* body, uint64_t length,
+                                     uint64_t fileOffset, const MessageHandler& handler, bool& stop) {
+    stats_.recordsParsed++;
+    Cursor c{ body, body + length };
+
+    switch (opcode) {
+        case OP_HEADER: {
+            std::string library;
+            return c.str(profile_) && c.str(library);
+        }
+        case OP_SCHEMA: {
+            ContainerSchema schema;
+            if (!c.u16(schema.id) || !c.str(schema.name) || !c.str(schema.encoding)) return false;
+            // Schema data itself is not needed for telemetry export
+            if (!c.skipPrefixed32()) return false;
+            schemas_[schema.id] = std::move(schema);
+            return true;
+        }
+        case OP_CHANNEL: {
+            ContainerChannel channel;
+            if (!c.u16(channel.id) || !c.u16(channel.schemaId) ||
+                !c.str(channel.topic) || !c.str(channel.messageEncoding)) return false;
+            // Metadata map (u32 byte length + entries) is ignored
+            channels_[channel.id] = std::move(channel);
+            return true;
+        }
+        case OP_MESSAGE: {
+            ContainerMessage msg;
+            if (!c.u16(msg.channelId) || !c.u32(msg.sequence) ||
+                !c.u64(msg.logTimeNs) || !c.u64(msg.publishTimeNs)) return false;
+            msg.fileOffset = fileOffset;
+            msg.data = c.p;
+            msg.size = static_cast<size_t>(c.end - c.p);
+            auto it = channels_.find(msg.channelId);
+            if (it == channels_.end()) return true; // message before its channel: skip
+            stats_.messagesDelivered++;
+            if (handler && !handler(it->second, msg)) {
+                stop = true;
+                return false;
+            }
+            return true;
+        }
+        case OP_CHUNK:
+            return parseChunk(body, length, fileOffset, handler, stop);
+        case OP_MESSAGE_INDEX: {
+            // Written after each chunk, one per channel in it; only needed to name what a skipped chunk held
+            if (!skippedChunkPending_) return true;
+            uint16_t channelId = 0;
+            if (!c.u16(channelId)) return false;
+            stats_.skippedChannelIds.insert(channelId);
+            skippedChunkIndexed_ = true;
+            return true;
+        }
+        default:
+            // Index, statistics, attachment and metadata records are not needed here
+            return true;
+    }
+}
+
+bool SvoContainerReader::parseChunk(const uint8_t* body, uint64_t length, uint64_t fileOffset,
+                                    const MessageHandler& handler, bool& stop) {
+    Cursor c{ body, body + length };
+    uint64_t startTime = 0, endTime = 0, uncompressedSize = 0, recordsLen = 0;
+    uint32_t crc = 0;
+    std::string compression;
+    if (!c.u64(startTime) || !c.u64(endTime) || !c.u64(uncompressedSize) ||
+        !c.u32(crc) || !c.str(compression) || !c.u64(recordsLen) || !c.has(recordsLen)) {
+        return false;
+    }
+    if (!compression.empty()) {
+        if (stats_.compressedChunksSkipped == 0) {
+            LOG_WARNING("Skipping " + compression + "-compressed chunks (not supported by in-tree reader)");
+        }
+        stats_.compressedChunksSkipped++;
+        skippedChunkPending_ = true;
+        skippedChunkIndexed_ = false;
+        return true;
+    }
+
+    const uint8_t* p = c.p;
+    const uint8_t* end = c.p + recordsLen;
+    while (end - p >= 9) {
+        uint8_t opcode = p[0];
+        uint64_t len = readU64(p + 1);
+        if (static_cast<uint64_t>(end - p - 9) < len) return false;
+        // Offsets of chunked records are reported as the chunk's offset
+        if (!parseRecord(opcode, p + 9, len, fileOffset, handler, stop)) return false;
+        p += 9 + len;
+    }
+    return true;
+}
+
+} // namespace zed_tools
@@ -0,0 +1,215 @@
+/**
+ * @file svo_container_reader.hpp
+ * @brief SDK-free streaming reader for the SVO2 (MCAP) container
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * SVO2 recordings are stored in the MCAP container format. This reader walks
+ * the container records directly, without the ZED SDK, so that non-video
+ * channels (IMU, magnetometer, barometer, timestamps, ...) can be consumed
+ * without decoding a single image.
+ *
+ * Design notes:
+ * - Large sequential reads into one reusable block buffer
+ * - Message payloads are handed out as views into that buffer (no per-record allocation)
+ * - Uncompressed chunks are parsed in place; compressed chunks are skipped and counted,
+ *   with the channels their message index records name
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <cstdio>
+#include <functional>
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace zed_tools {
+
+/**
+ * @brief Schema record (describes the encoding of messages on a channel)
+ */
+struct ContainerSchema {
+    uint16_t id = 0;                    ///< Schema ID (0 = no schema)
+    std::string name;                   ///< Schema name (e.g., "sl.SensorsData")
+    std::string encoding;               ///< Schema encoding (e.g., "jsonschema", "protobuf")
+};
+
+/**
+ * @brief Channel record (one logical stream inside the container)
+ */
+struct ContainerChannel {
+    uint16_t id = 0;                    ///< Channel ID referenced by messages
+    uint16_t schemaId = 0;              ///< Schema ID (0 = schemaless)
+    std::string topic;                  ///< Topic name (e.g., "imu", "sensors/barometer")
+    std::string messageEncoding;        ///< Message encoding (e.g., "json", "cdr", "raw")
+};
+
+/**
+ * @brief Single message view
+ *
+ * @warning data points into the reader's internal buffer and is only valid
+ *          for the duration of the handler call.
+ */
+struct ContainerMessage {
+    uint16_t channelId = 0;             ///< Owning channel
+    uint32_t sequence = 0;              ///< Per-channel sequence number
+    uint64_t logTimeNs = 0;             ///< Time the message was recorded (ns)
+    uint64_t publishTimeNs = 0;         ///< Time the message was published (ns)
+    uint64_t fileOffset = 0;            ///< Offset of the record in the file
+    const uint8_t* data = nullptr;      ///< Payload (view into reader buffer)
+    size_t size = 0;                    ///< Payload size in bytes
+};
+
+/**
+ * @brief Reader statistics for diagnostics and throughput reporting
+ */
+struct ContainerReadStats {
+    uint64_t bytesRead = 0;             ///< Bytes read from disk
+    uint64_t recordsParsed = 0;         ///< Top-level and chunked records parsed
+    uint64_t messagesDelivered = 0;     ///< Messages handed to the handler
+    uint64_t compressedChunksSkipped = 0; ///< Chunks skipped (lz4/zstd not supported in-tree)
+    uint64_t unindexedChunksSkipped = 0;  ///< Skipped chunks without message indexes (channels unknown)
+    std::set<uint16_t> skippedChannelIds; ///< Channels with messages in skipped chunks
+};
+
+/**
+ * @brief Streaming reader for the SVO2 (MCAP) container
+ *
+ * Example usage:
+ * @code
+ * SvoContainerReader reader("flight.svo2");
+ * if (reader.open()) {
+ *     reader.readMessages([](const ContainerChannel& ch, const ContainerMessage& msg) {
+ *         // Inspect ch.topic, msg.logTimeNs, msg.data/msg.size ...
+ *         return true; // keep reading
+ *     });
+ * }
+ * @endcode
+ */
+class SvoContainerReader {
+public:
+    /**
+     * @brief Message handler; return false to stop reading
+     */
+    using MessageHandler = std::function<bool(const ContainerChannel&, const ContainerMessage&)>;
+
+    /**
+     * @brief Construct reader
+     * @param filePath Path to the .svo2 file
+     * @param readBlockBytes Size of each sequential read (default 8 MiB)
+     */
+    explicit SvoContainerReader(const std::string& filePath, size_t readBlockBytes = 8u << 20);
+
+    /**
+     * @brief Destructor - closes the file
+     */
+    ~SvoContainerReader();
+
+    // Disable copy (owns FILE handle and buffer)
+    SvoContainerReader(const SvoContainerReader&) = delete;
+    SvoContainerReader& operator=(const SvoContainerReader&) = delete;
+
+    /**
+     * @brief Open the file and validate the container magic
+     * @return true if the file is a readable MCAP/SVO2 container
+     */
+    bool open();
+
+    /**
+     * @brief Close the file
+     */
+    void close();
+
+    /**
+     * @brief Check if the reader is open
+     */
+    bool isOpen() const;
+
+    /**
+     * @brief Stream all messages from the data section
+     * @param handler Called for every message in file order
+     * @return true if the data section was read to the end (or the handler stopped it)
+     *
+     * Schemas and channels are registered as they are encountered, so they are
+     * always known by the time a message referencing them is delivered.
+     */
+    bool readMessages(const MessageHandler& handler);
+
+    /**
+     * @brief Channels seen so far (keyed by channel ID)
+     */
+    const std::map<uint16_t, ContainerChannel>& getChannels() const { return channels_; }
+
+    /**
+     * @brief Schemas seen so far (keyed by schema ID)
+     */
+    const std::map<uint16_t, ContainerSchema>& getSchemas() const { return schemas_; }
+
+    /**
+     * @brief Look up the schema of a channel
+     * @return Pointer to schema, or nullptr if schemaless/unknown
+     */
+    const ContainerSchema* getSchemaForChannel(const ContainerChannel& channel) const;
+
+    /**
+     * @brief Profile string from the container header (e.g., "ros1", "" for SVO2)
+     */
+    const std::string& getProfile() const { return profile_; }
+
+    /**
+     * @brief Read statistics of the last readMessages() call
+     */
+    const ContainerReadStats& getStats() const { return stats_; }
+
+    /**
+     * @brief Get last error message
+     */
+    std::string getLastError() const { return lastError_; }
+
+private:
+    std::string filePath_;              ///< Path to container
+    FILE* file_ = nullptr;              ///< File handle
+    size_t blockBytes_;                 ///< Sequential read size
+    std::vector<uint8_t> buffer_;       ///< Reusable read buffer
+    size_t bufBegin_ = 0;               ///< First unconsumed byte in buffer_
+    size_t bufEnd_ = 0;                 ///< One past last valid byte in buffer_
+    uint64_t bufFileOffset_ = 0;        ///< File offset of buffer_[0]
+    bool eof_ = false;                  ///< Underlying file exhausted
+
+    std::map<uint16_t, ContainerChannel> channels_;
+    std::map<uint16_t, ContainerSchema> schemas_;
+    std::string profile_;
+    ContainerReadStats stats_;
+    std::string lastError_;
+    bool skippedChunkPending_ = false;  ///< Last chunk was skipped; its message indexes follow
+    bool skippedChunkIndexed_ = false;  ///< A message index named a channel of that chunk
+
+    /**
+     * @brief Account for the last skipped chunk once its message indexes have passed
+     */
+    void closeSkippedChunk();
+
+    /**
+     * @brief Ensure at least n unconsumed bytes are buffered
+     * @return false if the file ends before n bytes are available
+     */
+    bool ensureAvailable(size_t n);
+
+    /**
+     * @brief Parse one record body
+     * @return false if the handler requested a stop or the record is malformed
+     */
+    bool parseRecord(uint8_t opcode, const uint8_t* body, uint64_t length,
+                     uint64_t fileOffset, const MessageHandler& handler, bool& stop);
+
+    /**
+     * @brief Parse the records contained in an uncompressed chunk
+     */
+    bool parseChunk(const uint8_t* body, uint64_t length, uint64_t fileOffset,
+                    const MessageHandler& handler, bool& stop);
+};
+
+} // namespace zed_tools
@@ -0,0 +1,458 @@
+/**
+ * @file telemetry_exporter.cpp
+ * @brief Implementation of SDK-free telemetry export
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "telemetry_exporter.hpp"
+#include "svo_container_reader.hpp"
+#include "file_utils.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <limits>
+#include <memory>
+
+namespace zed_tools {
+
+namespace {
+
+const char kFileMagic[4] = { 'Z', 'T', 'L', 'M' };
+const uint32_t kFileVersion = 1;
+const double kNaN = std::numeric_limits<double>::quiet_NaN();
+
+std::string toLower(std::string s) {
+    std::transform(s.begin(), s.end(), s.begin(),
+        [](unsigned char c) -> char { return static_cast<char>(std::tolower(c)); });
+    return s;
+}
+
+void writeU32(FILE* f, uint32_t v) { fwrite(&v, sizeof(v), 1, f); }
+void writeU64(FILE* f, uint64_t v) { fwrite(&v, sizeof(v), 1, f); }
+void writeStr(FILE* f, const std::string& s) {
+    writeU32(f, static_cast<uint32_t>(s.size()));
+    if (!s.empty()) fwrite(s.data(), 1, s.size(), f);
+}
+
+/**
+ * @brief Minimal JSON walker that reports numeric leaves as flattened paths
+ *
+ * Paths use '.' for object members and "[i]" for array elements
+ * (e.g., "imu.linear_acceleration.x", "orientation[3]"). Booleans are
+ * reported as 0/1; strings and nulls are ignored. The path buffer is reused,
+ * so steady-state scanning does not allocate.
+ */
+template <typename OnNumber>
+class JsonNumberScanner {
+public:
+    JsonNumberScanner(const char* begin, const char* end, std::string& path, OnNumber& onNumber)
+        : p_(begin), end_(end), path_(path), onNumber_(onNumber) {}
+
+    bool run() {
+        path_.clear();
+        return value(0);
+    }
+
+private:
+    const char* p_;
+    const char* end_;
+    std::string& path_;
+    OnNumber& onNumber_;
+
+    void ws() { while (p_ < end_ && (*p_ == ' ' || *p_ == '\n' || *p_ == '\r' || *p_ == '\t')) ++p_; }
+
+    bool skipString(std::string* out) {
+        if (p_ >= end_ || *p_ != '"') return false;
+        ++p_;
+        while (p_ < end_ && *p_ != '"') {
+            if (*p_ == '\\') { ++p_; if (p_ >= end_) return false; }
+            if (out) out->push_back(*p_);
+            ++p_;
+        }
+        if (p_ >= end_) return false;
+        ++p_;
+        return true;
+    }
+
+    bool value(int depth) {
+        if (depth > 32) return false;
+        ws();
+        if (p_ >= end_) return false;
+        char c = *p_;
+        if (c == '{') {
+            ++p_;
+            ws();
+            if (p_ < end_ && *p_ == '}') { ++p_; return true; }
+            for (;;) {
+                ws();
+                size_t mark = path_.size();
+                if (!path_.empty()) path_.push_back('.');
+                if (!skipString(&path_)) return false;
+                ws();
+                if (p_ >= end_ || *p_ != ':') return false;
+                ++p_;
+                if (!value(depth + 1)) return false;
+                path_.resize(mark);
+                ws();
+                if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+                if (p_ < end_ && *p_ == '}') { ++p_; return true; }
+                return false;
+            }
+        }
+        if (c == '[') {
+            ++p_;
+            ws();
+            if (p_ < end_ && *p_ == ']') { ++p_; return true; }
+            for (int idx = 0;; ++idx) {
+                size_t mark = path_.size();
+                char num[16];
+                int n = std::snprintf(num, sizeof(num), "[%d]", idx);
+                path_.append(num, static_cast<size_t>(n));
+                if (!value(depth + 1)) return false;
+                path_.resize(mark);
+                ws();
+                if (p_ < end_ && *p_ == ',') { ++p_; continue; }
+                if (p_ < end_ && *p_ == ']') { ++p_; return true; }
+                return false;
+            }
+        }
+        if (c == '"') return skipString(nullptr);
+        if (c == 't' && end_ - p_ >= 4) { p_ += 4; onNumber_(path_, 1.0); return true; }
+        if (c == 'f' && end_ - p_ >= 5) { p_ += 5; onNumber_(path_, 0.0); return true; }
+        if (c == 'n' && end_ - p_ >= 4) { p_ += 4; return true; }
+
+        // Number: copy into a small stack buffer so strtod has a terminator
+        char buf[64];
+        size_t len = 0;
+        while (p_ < end_ && len < sizeof(buf) - 1 &&
+               (std::isdigit(static_cast<unsigned char>(*p_)) || *p_ == '-' || *p_ == '+' ||
+                *p_ == '.' || *p_ == 'e' || *p_ == 'E')) {
+            buf[len++] = *p_++;
+        }
+        if (len == 0) return false;
+        buf[len] = '\0';
+        onNumber_(path_, std::strtod(buf, nullptr));
+        return true;
+    }
+};
+
+/**
+ * @brief Per-channel column buffer and output state
+ */
+struct ChannelSink {
+    enum class Kind { UNDECIDED, JSON, BINARY, SKIP };
+
+    uint32_t index = 0;
+    std::string topic;
+    std::string schemaName;
+    Kind kind = Kind::UNDECIDED;
+    const TelemetryLayout* layout = nullptr;
+    std::vector<std::string> columns;   ///< Value column names (time column is implicit)
+    std::vector<int64_t> timeColumn;    ///< blockRows entries
+    std::vector<double> values;         ///< Column-major, columns.size() * blockRows
+    std::vector<double> row;            ///< Scratch row for decoding
+    size_t rows = 0;                    ///< Rows in current block
+    uint64_t totalRows = 0;
+    size_t jsonCursor = 0;              ///< Expected next column during JSON scan
+    FILE* csv = nullptr;
+
+    ~ChannelSink() { if (csv) fclose(csv); }
+};
+
+} // namespace
+
+ErrorResult exportTelemetry(const TelemetryExportConfig& config, TelemetryExportStats& stats) {
+    auto t0 = std::chrono::steady_clock::now();
+    stats = TelemetryExportStats();
+
+    if (config.outputDirectory.empty()) {
+        return ErrorResult::failure("Telemetry output directory is empty");
+    }
+    if (!FileUtils::createDirectory(config.outputDirectory)) {
+        return ErrorResult::failure("Failed to create telemetry directory: " + config.outputDirectory);
+    }
+
+    SvoContainerReader reader(config.svoFilePath, config.readBlockBytes);
+    if (!reader.open()) {
+        return ErrorResult::failure(reader.getLastError());
+    }
+
+    const size_t blockRows = std::max<size_t>(config.blockRows, 1);
+    std::vector<std::string> filters;
+    for (const auto& f : config.topicFilters) filters.push_back(toLower(f));
+
+    stats.outputFile = config.outputDirectory + "/telemetry.ztlm";
+#ifdef _WIN32
+    FILE* rawOut = nullptr;
+    fopen_s(&rawOut, stats.outputFile.c_str(), "wb");
+#else
+    FILE* rawOut = fopen(stats.outputFile.c_str(), "wb");
+#endif
+    if (!rawOut) {
+        return ErrorResult::failure("Failed to create telemetry file: " + stats.outputFile);
+    }
+    // The stream buffer must outlive the stream: declared first, destroyed after fclose
+    std::vector<char> outBuffer(4u << 20);
+    std::unique_ptr<FILE, int(*)(FILE*)> out(rawOut, &fclose);
+    setvbuf(out.get(), outBuffer.data(), _IOFBF, outBuffer.size());
+    fwrite(kFileMagic, 1, sizeof(kFileMagic), out.get());
+    writeU32(out.get(), kFileVersion);
+
+    // Channel ID -> sink (null entry = channel not exported)
+    std::vector<std::unique_ptr<ChannelSink>> sinks;
+    std::vector<ChannelSink*> byChannelId(65536, nullptr);
+
+    // Close and delete partial outputs so a failed export leaves nothing that looks complete
+    auto fail = [&](const std::string& message) {
+        byChannelId.assign(byChannelId.size(), nullptr);
+        sinks.clear();
+        out.reset();
+        std::remove(stats.outputFile.c_str());
+        for (const auto& csvPath : stats.csvFiles) std::remove(csvPath.c_str());
+        stats.csvFiles.clear();
+        return ErrorResult::failure(message);
+    };
+    auto matchesFilters = [&](const std::string& topic) {
+        const std::string topicLower = toLower(topic);
+        if (filters.empty()) return true;
+        for (const auto& f : filters) {
+            if (topicLower.find(f) != std::string::npos) return true;
+        }
+        return false;
+    };
+    std::vector<bool> channelSeen(65536, false);
+    std::string jsonPath;
+    jsonPath.reserve(256);
+    char csvLine[64];
+
+    auto flushBlock = [&](ChannelSink& s) {
+        if (s.rows == 0) return;
+        writeU32(out.get(), s.index);
+        writeU32(out.get(), static_cast<uint32_t>(s.rows));
+        fwrite(s.timeColumn.data(), sizeof(int64_t), s.rows, out.get());
+        for (size_t c = 0; c < s.columns.size(); ++c) {
+            fwrite(s.values.data() + c * blockRows, sizeof(double), s.rows, out.get());
+        }
+        s.rows = 0;
+    };
+
+    auto openSink = [&](ChannelSink& s) {
+        s.timeColumn.resize(blockRows);
+        s.values.assign(s.columns.size() * blockRows, kNaN);
+        s.row.assign(s.columns.size(), kNaN);
+        if (config.writeCsv) {
+            std::string csvPath = config.outputDirectory + "/telemetry_" +
+                                  FileUtils::sanitizeFilename(s.topic) + ".csv";
+#ifdef _WIN32
+            fopen_s(&s.csv, csvPath.c_str(), "wb");
+#else
+            s.csv = fopen(csvPath.c_str(), "wb");
+#endif
+            if (s.csv) {
+                setvbuf(s.csv, nullptr, _IOFBF, 1u << 20);
+                fputs("log_time_ns", s.csv);
+                for (const auto& name : s.columns) { fputc(',', s.csv); fputs(name.c_str(), s.csv); }
+                fputc('\n', s.csv);
+                stats.csvFiles.push_back(csvPath);
+            } else {
+                LOG_WARNING("Failed to create telemetry CSV: " + csvPath);
+            }
+        }
+    };
+
+    auto appendRow = [&](ChannelSink& s, uint64_t logTimeNs) {
+        s.timeColumn[s.rows] = static_cast<int64_t>(logTimeNs);
+        for (size_t c = 0; c < s.columns.size(); ++c) {
+            s.values[c * blockRows + s.rows] = s.row[c];
+        }
+        if (s.csv) {
+            int n = std::snprintf(csvLine, sizeof(csvLine), "%llu", static_cast<unsigned long long>(logTimeNs));
+            fwrite(csvLine, 1, static_cast<size_t>(n), s.csv);
+            for (double v : s.row) {
+                n = std::snprintf(csvLine, sizeof(csvLine), ",%.9g", v);
+                fwrite(csvLine, 1, static_cast<size_t>(n), s.csv);
+            }
+            fputc('\n', s.csv);
+        }
+        ++s.rows;
+        ++s.totalRows;
+        ++stats.rowsExported;
+        if (s.rows == blockRows) flushBlock(s);
+    };
+
+    bool ok = reader.readMessages([&](const ContainerChannel& ch, const ContainerMessage& msg) {
+        ChannelSink* sink = byChannelId[ch.id];
+        if (!sink) {
+            if (channelSeen[ch.id]) return true; // filtered out earlier
+            channelSeen[ch.id] = true;
+            if (!matchesFilters(ch.topic)) return true;
+
+            auto s = std::make_unique<ChannelSink>();
+            s->index = static_cast<uint32_t>(sinks.size());
+            s->topic = ch.topic;
+            const ContainerSchema* schema = reader.getSchemaForChannel(ch);
+            s->schemaName = schema ? schema->name : "";
+            if (toLower(ch.messageEncoding) == "json") {
+                s->kind = ChannelSink::Kind::JSON;
+            } else {
+                for (const auto& layout : config.layouts) {
+                    if (layout.schemaName == s->schemaName) { s->layout = &layout; break; }
+                }
+                if (s->layout) {
+                    s->kind = ChannelSink::Kind::BINARY;
+                    for (const auto& field : s->layout->fields) s->columns.push_back(field.name);
+                    openSink(*s);
+                } else {
+                    s->kind = ChannelSink::Kind::SKIP;
+                    LOG_WARNING("No decoder for telemetry channel '" + ch.topic + "' (encoding '" +
+                                ch.messageEncoding + "', schema '" + s->schemaName + "'); skipping");
+                }
+            }
+            sink = s.get();
+            byChannelId[ch.id] = sink;
+            sinks.push_back(std::move(s));
+        }
+
+        ChannelSink& s = *sink;
+        if (s.kind == ChannelSink::Kind::SKIP) {
+            stats.messagesSkipped++;
+            return true;
+        }
+
+        if (s.kind == ChannelSink::Kind::JSON) {
+            const char* begin = reinterpret_cast<const char*>(msg.data);
+            const char* end = begin + msg.size;
+            if (s.columns.empty()) {
+                // First message defines the column set
+                auto discover = [&](const std::string& path, double) { s.columns.push_back(path); };
+                JsonNumberScanner<decltype(discover)> scan(begin, end, jsonPath, discover);
+                if (!scan.run() || s.columns.empty()) {
+                    s.columns.clear();
+                    stats.messagesSkipped++;
+                    return true;
+                }
+                openSink(s);
+            }
+            std::fill(s.row.begin(), s.row.end(), kNaN);
+            s.jsonCursor = 0;
+            auto assign = [&](const std::string& path, double v) {
+                // Fields normally arrive in the same order; fall back to a search otherwise
+                if (s.jsonCursor < s.columns.size() && s.columns[s.jsonCursor] == path) {
+                    s.row[s.jsonCursor++] = v;
+                    return;
+                }
+                auto it = std::find(s.columns.begin(), s.columns.end(), path);
+                if (it != s.columns.end()) {
+                    s.jsonCursor = static_cast<size_t>(it - s.columns.begin());
+                    s.row[s.jsonCursor++] = v;
+                }
+            };
+            JsonNumberScanner<decltype(assign)> scan(begin, end, jsonPath, assign);
+            if (!scan.run()) {
+                stats.messagesSkipped++;
+                return true;
+            }
+        } else {
+            const auto& fields = s.layout->fields;
+            for (size_t c = 0; c < fields.size(); ++c) {
+                const TelemetryField& f = fields[c];
+                const uint8_t* p = msg.data + f.offset;
+                double v = kNaN;
+                switch (f.type) {
+                    case TelemetryFieldType::F32:
+                        if (f.offset + 4 <= msg.size) { float x; std::memcpy(&x, p, 4); v = x; }
+                        break;
+                    case TelemetryFieldType::F64:
+                        if (f.offset + 8 <= msg.size) { std::memcpy(&v, p, 8); }
+                        break;
+                    case TelemetryFieldType::I32:
+                        if (f.offset + 4 <= msg.size) { int32_t x; std::memcpy(&x, p, 4); v = x; }
+                        break;
+                    case TelemetryFieldType::U64:
+                        if (f.offset + 8 <= msg.size) { uint64_t x; std::memcpy(&x, p, 8); v = static_cast<double>(x); }
+                        break;
+                }
+                s.row[c] = v;
+            }
+        }
+        appendRow(s, msg.logTimeNs);
+        return true;
+    });
+
+    if (!ok) {
+        return fail("Telemetry export failed: " + reader.getLastError());
+    }
+
+    // Skipped compressed chunks are only harmless if they held none of the selected channels
+    const ContainerReadStats& readStats = reader.getStats();
+    if (readStats.compressedChunksSkipped > 0) {
+        std::string missing;
+        for (uint16_t id : readStats.skippedChannelIds) {
+            auto it = reader.getChannels().find(id);
+            if (it != reader.getChannels().end() && !matchesFilters(it->second.topic)) continue;
+            // Unknown channels were declared inside a skipped chunk; they may be selected
+            missing += (missing.empty() ? "" : ", ") +
+                       (it != reader.getChannels().end() ? it->second.topic : "channel " + std::to_string(id));
+        }
+        if (readStats.unindexedChunksSkipped > 0) {
+            missing += (missing.empty() ? "" : ", ") + std::to_string(readStats.unindexedChunksSkipped) +
+                       " chunks without message index";
+        }
+        if (!missing.empty()) {
+            return fail("Telemetry export incomplete: " + std::to_string(readStats.compressedChunksSkipped) +
+                        " compressed chunks (not supported) hold selected data (" + missing + ")");
+        }
+    }
+
+    // Flush remaining rows and write the channel table + trailer
+    for (auto& s : sinks) {
+        if (s->kind == ChannelSink::Kind::JSON || s->kind == ChannelSink::Kind::BINARY) flushBlock(*s);
+    }
+    fflush(out.get());
+#ifdef _WIN32
+    const int64_t tablePos = _ftelli64(out.get());
+#else
+    const int64_t tablePos = static_cast<int64_t>(ftello(out.get()));
+#endif
+    if (tablePos < 0) {
+        return fail("Failed to write telemetry file: " + stats.outputFile);
+    }
+    const uint64_t tableOffset = static_cast<uint64_t>(tablePos);
+    uint32_t exported = 0;
+    for (const auto& s : sinks) if (s->totalRows > 0) ++exported;
+    writeU32(out.get(), exported);
+    for (const auto& s : sinks) {
+        if (s->totalRows == 0) continue;
+        writeU32(out.get(), s->index);
+        writeStr(out.get(), s->topic);
+        writeStr(out.get(), s->schemaName);
+        writeU32(out.get(), static_cast<uint32_t>(s->columns.size()));
+        for (const auto& name : s->columns) writeStr(out.get(), name);
+    }
+    writeU64(out.get(), tableOffset);
+    fwrite(kFileMagic, 1, sizeof(kFileMagic), out.get());
+    if (fflush(out.get()) != 0 || fclose(out.release()) != 0) {
+        return fail("Failed to write telemetry file: " + stats.outputFile);
+    }
+
+    stats.channelsExported = static_cast<int>(exported);
+    stats.bytesRead = reader.getStats().bytesRead;
+    stats.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+    LOG_INFO("Telemetry export: " + std::to_string(stats.rowsExported) + " rows from " +
+             std::to_string(stats.channelsExported) + " channels in " +
+             std::to_string(stats.seconds) + "s");
+    if (readStats.compressedChunksSkipped > 0) {
+        LOG_WARNING("Telemetry export skipped " + std::to_string(readStats.compressedChunksSkipped) +
+                    " compressed chunks without selected channels");
+    }
+    return ErrorResult::success();
+}
+
+} // namespace zed_tools
@@ -0,0 +1,106 @@
+/**
+ * @file telemetry_exporter.hpp
+ * @brief SDK-free export of IMU/pose/telemetry channels from SVO2 files
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * Streams every sensor channel of an SVO2 recording into a compact columnar
+ * file (plus optional per-channel CSV) using SvoContainerReader. No image is
+ * decoded and the ZED SDK is not required.
+ *
+ * Output file layout (telemetry.ztlm, all integers little-endian):
+ * @code
+ * Header : "ZTLM" | u32 version (1)
+ * Block* : u32 channelIndex | u32 rowCount
+ *          | i64 log_time_ns[rowCount] | f64 column_k[rowCount] for each value column
+ * Table  : u32 channelCount, then per channel:
+ *          u32 index | str topic | str schema | u32 columnCount | str name[columnCount]
+ * Trailer: u64 tableOffset | "ZTLM"
+ * (str = u32 length + bytes)
+ * @endcode
+ * Blocks are column-major, so a reader can mmap a block and use each column directly.
+ */
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "error_handler.hpp"
+
+namespace zed_tools {
+
+/**
+ * @brief Field type for fixed binary payload layouts
+ */
+enum class TelemetryFieldType {
+    F32,        ///< 32-bit float
+    F64,        ///< 64-bit float
+    I32,        ///< 32-bit signed integer
+    U64         ///< 64-bit unsigned integer (e.g., timestamps)
+};
+
+/**
+ * @brief One field of a fixed binary payload layout
+ */
+struct TelemetryField {
+    std::string name;                   ///< Column name (e.g., "accel_x")
+    size_t offset;                      ///< Byte offset in payload
+    TelemetryFieldType type;            ///< Stored type
+};
+
+/**
+ * @brief Fixed binary layout for a schema (used for non-JSON channels)
+ */
+struct TelemetryLayout {
+    std::string schemaName;             ///< Schema name this layout applies to
+    std::vector<TelemetryField> fields; ///< Fields exported as columns
+};
+
+/**
+ * @brief Telemetry export configuration
+ */
+struct TelemetryExportConfig {
+    std::string svoFilePath;            ///< Input SVO2 file
+    std::string outputDirectory;        ///< Directory for telemetry.ztlm (and CSVs)
+    /// Case-insensitive topic substrings to export; empty = every non-image channel
+    std::vector<std::string> topicFilters = { "imu", "sensor", "magnetometer", "barometer",
+                                              "temperature", "pose", "timestamp" };
+    bool writeCsv = false;              ///< Also write one CSV per channel
+    size_t blockRows = 4096;            ///< Rows buffered per channel before a block is flushed
+    size_t readBlockBytes = 8u << 20;   ///< Sequential read size for the container
+    std::vector<TelemetryLayout> layouts; ///< Extra binary layouts (by schema name)
+};
+
+/**
+ * @brief Telemetry export statistics
+ */
+struct TelemetryExportStats {
+    std::string outputFile;             ///< Path of the written .ztlm file
+    std::vector<std::string> csvFiles;  ///< Paths of written CSV files
+    int channelsExported = 0;           ///< Channels with at least one exported row
+    uint64_t rowsExported = 0;          ///< Total rows written
+    uint64_t messagesSkipped = 0;       ///< Messages on matching channels that could not be decoded
+    uint64_t bytesRead = 0;             ///< Container bytes read
+    double seconds = 0.0;               ///< Wall time of the export
+};
+
+/**
+ * @brief Export telemetry channels of an SVO2 file
+ * @param config Export configuration
+ * @param stats Filled with export statistics
+ * @return ErrorResult indicating success or failure
+ *
+ * Example usage:
+ * @code
+ * TelemetryExportConfig cfg;
+ * cfg.svoFilePath = "flight.svo2";
+ * cfg.outputDirectory = extractionPath;
+ * cfg.writeCsv = true;
+ * TelemetryExportStats stats;
+ * auto result = exportTelemetry(cfg, stats);
+ * @endcode
+ */
+ErrorResult exportTelemetry(const TelemetryExportConfig& config, TelemetryExportStats& stats);
+
+} // namespace zed_tools
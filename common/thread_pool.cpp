@@ -0,0 +1,275 @@
+/**
+ * @file thread_pool.cpp
+ * @brief Implementation of the shared work-stealing thread pool
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "thread_pool.hpp"
+#include "error_handler.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+
+namespace zed_tools {
+
+namespace {
+
+// Worker identity, so submissions from inside a task stay on the local deque
+thread_local ThreadPool* tlsPool = nullptr;
+thread_local int tlsWorker = -1;
+// Pool for work submitted by a non-worker thread (nullptr = global)
+thread_local ThreadPool* tlsDefault = nullptr;
+
+std::mutex globalMutex;
+std::atomic<bool> globalStarted{false};
+int globalConcurrency = 0;
+
+int envConcurrency() {
+    const char* v = std::getenv("ZED_EXTRACTOR_THREADS");
+    return v ? std::max(0, std::atoi(v)) : 0;
+}
+
+} // namespace
+
+// ============================================================================
+// ThreadPool
+// ============================================================================
+
+ThreadPool::ThreadPool(int concurrency, std::function<void()> workerInit)
+    : workerInit_(std::move(workerInit)) {
+    if (concurrency <= 0) concurrency = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    // The thread waiting on a group makes up the last slot; keep at least one worker
+    const int workers = std::max(1, concurrency - 1);
+    for (int i = 0; i < workers; ++i) queues_.push_back(std::make_unique<WorkerQueue>());
+    for (int i = 0; i < workers; ++i) workers_.emplace_back(&ThreadPool::workerLoop, this, i);
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(sleepMutex_);
+        stopping_ = true;
+    }
+    sleepCv_.notify_all();
+    for (auto& t : workers_) {
+        if (t.joinable()) t.join();
+    }
+}
+
+ThreadPool& ThreadPool::global() {
+    // Never destroyed: tasks may still log while other statics are torn down
+    static ThreadPool* pool = [] {
+        std::lock_guard<std::mutex> lock(globalMutex);
+        int n = envConcurrency();
+        if (n == 0) n = globalConcurrency;
+        globalStarted = true;
+        auto* p = new ThreadPool(n);
+        LOG_INFO("Thread pool: " + std::to_string(p->getConcurrency()) + " threads");
+        return p;
+    }();
+    return *pool;
+}
+
+ThreadPool& ThreadPool::current() {
+    if (tlsPool) return *tlsPool;
+    if (tlsDefault) return *tlsDefault;
+    return global();
+}
+
+void ThreadPool::setThreadDefault(ThreadPool* pool) {
+    tlsDefault = pool;
+}
+
+bool ThreadPool::configureGlobal(int concurrency) {
+    std::lock_guard<std::mutex> lock(globalMutex);
+    if (globalStarted || envConcurrency() > 0) return false;
+    globalConcurrency = concurrency;
+    return true;
+}
+
+void ThreadPool::submit(Task task) {
+    const size_t index = (tlsPool == this) ? static_cast<size_t>(tlsWorker)
+                                           : nextQueue_.fetch_add(1) % queues_.size();
+    size_t depth;
+    {
+        // Counted under the deque lock so a concurrent pop can never drive it below zero
+        std::lock_guard<std::mutex> lock(queues_[index]->mutex);
+        queues_[index]->tasks.push_back(std::move(task));
+        depth = ++queued_;
+    }
+    size_t peak = maxQueued_.load();
+    while (depth > peak && !maxQueued_.compare_exchange_weak(peak, depth)) {}
+
+    // Taking the lock orders this notify after a worker's predicate check
+    { std::lock_guard<std::mutex> lock(sleepMutex_); }
+    sleepCv_.notify_one();
+}
+
+bool ThreadPool::popTask(int self, Task& task) {
+    if (queued_ == 0) return false;
+    const int n = static_cast<int>(queues_.size());
+
+    // Own deque: newest first
+    if (self >= 0) {
+        WorkerQueue& q = *queues_[self];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.back());
+            q.tasks.pop_back();
+            --queued_;
+            return true;
+        }
+    }
+    // Steal: oldest task of the next non-empty deque
+    const int start = (self >= 0) ? self + 1 : static_cast<int>(nextQueue_.load() % n);
+    for (int k = 0; k < n; ++k) {
+        int victim = (start + k) % n;
+        if (victim == self) continue;
+        WorkerQueue& q = *queues_[victim];
+        std::lock_guard<std::mutex> lock(q.mutex);
+        if (!q.tasks.empty()) {
+            task = std::move(q.tasks.front());
+            q.tasks.pop_front();
+            --queued_;
+            ++steals_;
+            return true;
+        }
+    }
+    return false;
+}
+
+void ThreadPool::execute(Task& task) {
+    try {
+        task();
+    } catch (const std::exception& e) {
+        LOG_ERROR(std::string("Thread pool task failed: ") + e.what());
+    } catch (...) {
+        LOG_ERROR("Thread pool task failed with an unknown exception");
+    }
+    ++executed_;
+}
+
+bool ThreadPool::runPendingTask() {
+    Task task;
+    if (!popTask(tlsPool == this ? tlsWorker : -1, task)) return false;
+    execute(task);
+    return true;
+}
+
+void ThreadPool::workerLoop(int index) {
+    tlsPool = this;
+    tlsWorker = index;
+    if (workerInit_) workerInit_();
+    for (;;) {
+        Task task;
+        if (popTask(index, task)) {
+            execute(task);
+            continue;
+        }
+        std::unique_lock<std::mutex> lock(sleepMutex_);
+        sleepCv_.wait(lock, [this] { return stopping_ || queued_ > 0; });
+        if (stopping_ && queued_ == 0) return;
+    }
+}
+
+ThreadPoolStats ThreadPool::getStats() const {
+    ThreadPoolStats s;
+    s.concurrency = getConcurrency();
+    s.tasksExecuted = executed_;
+    s.steals = steals_;
+    s.queuedTasks = queued_;
+    s.maxQueueDepth = maxQueued_;
+    return s;
+}
+
+// ============================================================================
+// TaskGroup
+// ============================================================================
+
+TaskGroup::TaskGroup(ThreadPool& pool)
+    : pool_(pool)
+    , state_(std::make_shared<State>())
+{
+}
+
+TaskGroup::~TaskGroup() {
+    try {
+        wait();
+    } catch (...) {
+    }
+}
+
+void TaskGroup::run(std::function<void()> task) {
+    ++state_->pending;
+    std::shared_ptr<State> state = state_;
+    pool_.submit([state, task = std::move(task)] {
+        if (!state->cancelled) {
+            try {
+                task();
+            } catch (...) {
+                std::lock_guard<std::mutex> lock(state->mutex);
+                if (!state->error) state->error = std::current_exception();
+                state->cancelled = true;
+            }
+        }
+        if (--state->pending == 0) {
+            std::lock_guard<std::mutex> lock(state->mutex);
+            state->done.notify_all();
+        }
+    });
+}
+
+void TaskGroup::wait() {
+    while (state_->pending > 0) {
+        // Help instead of blocking; this is what makes nested groups safe
+        if (pool_.runPendingTask()) continue;
+        std::unique_lock<std::mutex> lock(state_->mutex);
+        // Short timeout: running tasks may still queue subtasks this thread could take
+        state_->done.wait_for(lock, std::chrono::milliseconds(1), [this] { return state_->pending == 0; });
+    }
+    std::exception_ptr error;
+    {
+        std::lock_guard<std::mutex> lock(state_->mutex);
+        std::swap(error, state_->error);
+    }
+    if (error) std::rethrow_exception(error);
+}
+
+void TaskGroup::cancel() {
+    state_->cancelled = true;
+}
+
+// ============================================================================
+// parallelFor
+// ============================================================================
+
+void parallelFor(int begin, int end, const std::function<void(int, int)>& body, int grain, ThreadPool& pool) {
+    const int count = end - begin;
+    if (count <= 0) return;
+    grain = std::max(1, grain);
+    // A few chunks per thread so stealing can even out uneven rows/frames
+    const int chunks = std::min((count + grain - 1) / grain, pool.getConcurrency() * 4);
+    if (chunks <= 1) {
+        body(begin, end);
+        return;
+    }
+
+    TaskGroup group(pool);
+    for (int c = 1; c < chunks; ++c) {
+        const int b = begin + static_cast<int>(static_cast<int64_t>(count) * c / chunks);
+        const int e = begin + static_cast<int>(static_cast<int64_t>(count) * (c + 1) / chunks);
+        group.run([&body, b, e] { body(b, e); });
+    }
+    // First chunk on the calling thread
+    try {
+        body(begin, begin + count / chunks);
+    } catch (...) {
+        group.cancel();
+        try { group.wait(); } catch (...) {}
+        throw;
+    }
+    group.wait();
+}
+
+} // namespace zed_tools
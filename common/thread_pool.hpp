@@ -0,0 +1,200 @@
+/**
+ * @file thread_pool.hpp
+ * @brief Shared work-stealing thread pool, task groups and parallelFor
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * One process-wide executor for CPU-parallel work in the common library, so
+ * features do not each bring their own threads and concurrent jobs never
+ * oversubscribe the machine:
+ * - every worker owns a deque; it pushes and pops its own tasks LIFO (cache
+ *   warm) while idle workers steal from the other end (oldest, largest work)
+ * - threads waiting on a TaskGroup run queued tasks instead of blocking, so
+ *   nested parallelFor calls cannot deadlock and the caller counts as a worker
+ * - TaskGroup::cancel() skips tasks that have not started yet; the first
+ *   exception thrown by a task cancels the group and is rethrown by wait()
+ *
+ * Size: ZED_EXTRACTOR_THREADS, else ThreadPool::configureGlobal(), else the
+ * hardware thread count. The pool starts on first use and keeps its size.
+ *
+ * TaskGroup and parallelFor default to ThreadPool::current(): the pool of the
+ * worker they are called from, else the calling thread's default (set by
+ * background mode to a low-priority pool, see background_priority.hpp), else
+ * the global pool.
+ *
+ * @code
+ * parallelFor(0, image.rows, [&](int r0, int r1) {
+ *     for (int y = r0; y < r1; ++y) processRow(y);
+ * }, 16);
+ * @endcode
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace zed_tools {
+
+/**
+ * @brief Pool counters for logging and tuning
+ */
+struct ThreadPoolStats {
+    int concurrency = 0;          ///< Workers plus the waiting caller
+    uint64_t tasksExecuted = 0;
+    uint64_t steals = 0;          ///< Tasks taken from another thread's deque
+    size_t queuedTasks = 0;       ///< Currently waiting in all deques
+    size_t maxQueueDepth = 0;     ///< Peak of queuedTasks
+};
+
+/**
+ * @brief Work-stealing executor with one deque per worker
+ */
+class ThreadPool {
+public:
+    using Task = std::function<void()>;
+
+    /**
+     * @param concurrency Threads doing work, counting the caller that waits (<= 0 = hardware threads)
+     * @param workerInit Run by each worker before it takes tasks (e.g., to lower its priority)
+     */
+    explicit ThreadPool(int concurrency = 0, std::function<void()> workerInit = nullptr);
+
+    /**
+     * @brief Joins the workers; tasks still queued are run first
+     */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /**
+     * @brief The process-wide pool (created on first call)
+     */
+    static ThreadPool& global();
+
+    /**
+     * @brief Set the global pool size before its first use
+     * @return false if the pool already runs (its size is kept) or ZED_EXTRACTOR_THREADS overrides it
+     */
+    static bool configureGlobal(int concurrency);
+
+    /**
+     * @brief Pool for work submitted from the calling thread
+     *
+     * A worker's own pool, else the thread default, else global().
+     */
+    static ThreadPool& current();
+
+    /**
+     * @brief Route this thread's pool work (current()) to pool; nullptr restores global()
+     */
+    static void setThreadDefault(ThreadPool* pool);
+
+    /**
+     * @brief Queue a task (fire and forget; use TaskGroup to wait for results)
+     *
+     * From a worker the task goes onto that worker's own deque, otherwise
+     * onto the deques round-robin.
+     */
+    void submit(Task task);
+
+    /**
+     * @brief Run one queued task on the calling thread
+     * @return false if no task was available
+     */
+    bool runPendingTask();
+
+    int getConcurrency() const { return static_cast<int>(queues_.size()) + 1; }
+    ThreadPoolStats getStats() const;
+
+private:
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues_;
+    std::vector<std::thread> workers_;
+    std::mutex sleepMutex_;
+    std::condition_variable sleepCv_;
+    std::atomic<size_t> queued_{0};
+    std::atomic<size_t> maxQueued_{0};
+    std::atomic<uint64_t> executed_{0};
+    std::atomic<uint64_t> steals_{0};
+    std::atomic<unsigned> nextQueue_{0};
+    bool stopping_ = false;
+
+    std::function<void()> workerInit_;
+
+    void workerLoop(int index);
+    bool popTask(int self, Task& task);
+    void execute(Task& task);
+};
+
+/**
+ * @brief Set of tasks that can be waited on and cancelled together
+ */
+class TaskGroup {
+public:
+    explicit TaskGroup(ThreadPool& pool = ThreadPool::current());
+
+    /**
+     * @brief Waits for outstanding tasks (exceptions are dropped here; call wait() to see them)
+     */
+    ~TaskGroup();
+
+    TaskGroup(const TaskGroup&) = delete;
+    TaskGroup& operator=(const TaskGroup&) = delete;
+
+    /**
+     * @brief Queue a task in this group
+     */
+    void run(std::function<void()> task);
+
+    /**
+     * @brief Run queued work until every task of the group has finished
+     * @throws The first exception thrown by a task
+     */
+    void wait();
+
+    /**
+     * @brief Skip tasks of this group that have not started yet
+     */
+    void cancel();
+
+    bool isCancelled() const { return state_->cancelled; }
+
+private:
+    struct State {
+        std::atomic<int> pending{0};
+        std::atomic<bool> cancelled{false};
+        std::mutex mutex;
+        std::condition_variable done;
+        std::exception_ptr error;
+    };
+
+    ThreadPool& pool_;
+    std::shared_ptr<State> state_;
+};
+
+/**
+ * @brief Split [begin, end) into chunks and run body(chunkBegin, chunkEnd) on the pool
+ *
+ * Works for frame ranges and image row bands alike. The calling thread runs
+ * chunks too and returns once all are done.
+ * @param grain Minimum chunk size; ranges this small run inline
+ * @throws The first exception thrown by body
+ */
+void parallelFor(int begin, int end, const std::function<void(int, int)>& body, int grain = 1,
+                 ThreadPool& pool = ThreadPool::current());
+
+} // namespace zed_tools
@@ -0,0 +1,207 @@
+/**
+ * @file timeline_series.cpp
+ * @brief Implementation of the decimated timeline series
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ */
+
+#include "timeline_series.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace zed_tools {
+
+TimelineSeries::TimelineSeries(std::string name, std::string unit)
+    : name_(std::move(name))
+    , unit_(std::move(unit)) {
+}
+
+TimelineSeries::Bucket TimelineSeries::merge(const Bucket& a, const Bucket& b) {
+    Bucket merged;
+    // Ties keep the earlier sample, so flat stretches stay anchored at their start
+    if (b.minY < a.minY) { merged.minX = b.minX; merged.minY = b.minY; }
+    else { merged.minX = a.minX; merged.minY = a.minY; }
+    if (b.maxY > a.maxY) { merged.maxX = b.maxX; merged.maxY = b.maxY; }
+    else { merged.maxX = a.maxX; merged.maxY = a.maxY; }
+    return merged;
+}
+
+bool TimelineSeries::append(double x, float y) {
+    if (!std::isfinite(y) || !std::isfinite(x)) return false;
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!x_.empty() && x <= x_.back()) return false;
+    x_.push_back(x);
+    y_.push_back(y);
+
+    // Every second sample completes a level-0 bucket; every second bucket of a level completes one above
+    const size_t n = x_.size();
+    if (n % 2 != 0) return true;
+    Bucket bucket = merge(Bucket{ x_[n - 2], x_[n - 2], y_[n - 2], y_[n - 2] },
+                          Bucket{ x_[n - 1], x_[n - 1], y_[n - 1], y_[n - 1] });
+    for (size_t level = 0;; ++level) {
+        if (levels_.size() <= level) levels_.emplace_back();
+        std::vector<Bucket>& buckets = levels_[level];
+        buckets.push_back(bucket);
+        if (buckets.size() % 2 != 0) break;
+        bucket = merge(buckets[buckets.size() - 2], buckets.back());
+    }
+    return true;
+}
+
+void TimelineSeries::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    x_.clear();
+    y_.clear();
+    levels_.clear();
+}
+
+size_t TimelineSeries::size() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return x_.size();
+}
+
+bool TimelineSeries::getRange(double& xMin, double& xMax) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (x_.empty()) return false;
+    xMin = x_.front();
+    xMax = x_.back();
+    return true;
+}
+
+size_t TimelineSeries::decimate(double xMin, double xMax, int maxPoints,
+                                std::vector<double>& xs, std::vector<double>& ys) const {
+    xs.clear();
+    ys.clear();
+    maxPoints = std::max(maxPoints, 3);
+
+    std::vector<double> candX, candY;
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (x_.empty() || xMax < xMin) return 0;
+
+        // Visible samples plus one neighbour on each side
+        size_t first = static_cast<size_t>(std::lower_bound(x_.begin(), x_.end(), xMin) - x_.begin());
+        size_t last = static_cast<size_t>(std::upper_bound(x_.begin(), x_.end(), xMax) - x_.begin());
+        if (first > 0) --first;
+        if (last < x_.size()) ++last;
+        const size_t count = last - first;
+
+        auto appendRaw = [&](size_t from, size_t to, std::vector<double>& outX, std::vector<double>& outY) {
+            for (size_t i = from; i < to; ++i) {
+                outX.push_back(x_[i]);
+                outY.push_back(y_[i]);
+            }
+        };
+        if (count <= static_cast<size_t>(maxPoints)) {
+            xs.reserve(count);
+            ys.reserve(count);
+            appendRaw(first, last, xs, ys);
+            return xs.size();
+        }
+
+        // Coarsest level that still has maxPoints buckets in range (at most ~2x maxPoints then)
+        int level = -1;
+        for (size_t k = 0; k < levels_.size(); ++k) {
+            if (count / (size_t(2) << k) < static_cast<size_t>(maxPoints)) break;
+            level = static_cast<int>(k);
+        }
+
+        candX.reserve(4 * static_cast<size_t>(maxPoints));
+        candY.reserve(4 * static_cast<size_t>(maxPoints));
+        if (level < 0) {
+            appendRaw(first, last, candX, candY);
+        } else {
+            // Complete buckets inside [first, last); partial spans at both ends come from the raw samples
+            const size_t span = size_t(2) << level;
+            const std::vector<Bucket>& buckets = levels_[static_cast<size_t>(level)];
+            const size_t firstBucket = (first + span - 1) / span;
+            const size_t endBucket = std::max(firstBucket, std::min(last / span, buckets.size()));
+            const size_t headEnd = std::min(firstBucket * span, last);
+            appendRaw(first, headEnd, candX, candY);
+            for (size_t b = firstBucket; b < endBucket; ++b) {
+                const Bucket& bucket = buckets[b];
+                const bool minFirst = bucket.minX <= bucket.maxX;
+                candX.push_back(minFirst ? bucket.minX : bucket.maxX);
+                candY.push_back(minFirst ? bucket.minY : bucket.maxY);
+                if (bucket.minX != bucket.maxX) {
+                    candX.push_back(minFirst ? bucket.maxX : bucket.minX);
+                    candY.push_back(minFirst ? bucket.maxY : bucket.minY);
+                }
+            }
+            appendRaw(std::max(endBucket * span, headEnd), last, candX, candY);
+        }
+    }
+
+    largestTriangleThreeBuckets(candX, candY, maxPoints, xs, ys);
+    return xs.size();
+}
+
+void TimelineSeries::largestTriangleThreeBuckets(const std::vector<double>& inX, const std::vector<double>& inY,
+                                                 int maxPoints, std::vector<double>& outX, std::vector<double>& outY) {
+    const size_t n = inX.size();
+    const size_t threshold = static_cast<size_t>(maxPoints);
+    if (n <= threshold) {
+        outX = inX;
+        outY = inY;
+        return;
+    }
+    outX.reserve(threshold);
+    outY.reserve(threshold);
+
+    // First and last points are kept; the rest is split into threshold - 2 buckets and each
+    // bucket keeps the point spanning the largest triangle with the previous pick and the
+    // average of the next bucket
+    const double every = static_cast<double>(n - 2) / static_cast<double>(threshold - 2);
+    size_t a = 0;
+    outX.push_back(inX[0]);
+    outY.push_back(inY[0]);
+    for (size_t i = 0; i + 2 < threshold; ++i) {
+        size_t avgStart = static_cast<size_t>(std::floor((i + 1) * every)) + 1;
+        size_t avgEnd = std::min(static_cast<size_t>(std::floor((i + 2) * every)) + 1, n);
+        if (avgStart >= avgEnd) avgStart = avgEnd - 1;
+        double avgX = 0.0, avgY = 0.0;
+        for (size_t j = avgStart; j < avgEnd; ++j) {
+            avgX += inX[j];
+            avgY += inY[j];
+        }
+        avgX /= static_cast<double>(avgEnd - avgStart);
+        avgY /= static_cast<double>(avgEnd - avgStart);
+
+        const size_t rangeStart = static_cast<size_t>(std::floor(i * every)) + 1;
+        const size_t rangeEnd = std::min(static_cast<size_t>(std::floor((i + 1) * every)) + 1, n - 1);
+        double maxArea = -1.0;
+        size_t picked = rangeStart;
+        for (size_t j = rangeStart; j < rangeEnd; ++j) {
+            const double area = std::fabs((inX[a] - avgX) * (inY[j] - inY[a]) -
+                                          (inX[a] - inX[j]) * (avgY - inY[a]));
+            if (area > maxArea) {
+                maxArea = area;
+                picked = j;
+            }
+        }
+        outX.push_back(inX[picked]);
+        outY.push_back(inY[picked]);
+        a = picked;
+    }
+    outX.push_back(inX[n - 1]);
+    outY.push_back(inY[n - 1]);
+}
+
+bool TimelineSeries::nearestSample(double x, double& sampleX, float& sampleY) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (x_.empty()) return false;
+    size_t i = static_cast<size_t>(std::lower_bound(x_.begin(), x_.end(), x) - x_.begin());
+    if (i == x_.size() || (i > 0 && x - x_[i - 1] <= x_[i] - x)) --i;
+    sampleX = x_[i];
+    sampleY = y_[i];
+    return true;
+}
+
+void TimelineSeries::getSamples(std::vector<double>& xs, std::vector<float>& ys) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    xs = x_;
+    ys = y_;
+}
+
+} // namespace zed_tools
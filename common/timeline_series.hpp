@@ -0,0 +1,108 @@
+/**
+ * @file timeline_series.hpp
+ * @brief Per-frame signal over a flight with multi-level decimation for plotting
+ * @author Angelo Amon (xX2Angelo8Xx)
+ * @date October 18, 2026
+ *
+ * A flight has 10^5 frames or more; drawing every sample each GUI frame is
+ * too slow, and naive striding hides short events (a nearest-distance dip
+ * of three frames disappears). The series keeps a min/max pyramid that is
+ * extended as samples are appended:
+ * - level k holds one bucket per 2^(k+1) samples with the lowest and the
+ *   highest sample of that span (both kept, so peaks survive any zoom)
+ * - a query picks the coarsest level that still has at least maxPoints
+ *   buckets in the visible range and reduces those candidates to maxPoints
+ *   with largest-triangle-three-buckets (LTTB)
+ *
+ * A query therefore touches O(maxPoints) values whatever the zoom and the
+ * series length. Appending is amortised O(1), so the engine can fill a
+ * series while the GUI plots it.
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace zed_tools {
+
+/**
+ * @brief Thread-safe (x, y) series with increasing x, e.g. SVO frame index -> value
+ *
+ * Example usage:
+ * @code
+ * TimelineSeries nearest("Nearest distance", "m");
+ * nearest.append(frame, minDepth);               // engine thread
+ * std::vector<double> xs, ys;
+ * nearest.decimate(viewMin, viewMax, 800, xs, ys); // GUI thread, every frame
+ * @endcode
+ */
+class TimelineSeries {
+public:
+    explicit TimelineSeries(std::string name = "", std::string unit = "");
+
+    TimelineSeries(const TimelineSeries&) = delete;
+    TimelineSeries& operator=(const TimelineSeries&) = delete;
+
+    /**
+     * @brief Add a sample
+     * @return false if y is not finite or x does not increase (sample dropped)
+     */
+    bool append(double x, float y);
+
+    void clear();
+
+    size_t size() const;
+    bool empty() const { return size() == 0; }
+    const std::string& getName() const { return name_; }
+    const std::string& getUnit() const { return unit_; }
+
+    /**
+     * @brief x of the first and last sample
+     * @return false if the series is empty
+     */
+    bool getRange(double& xMin, double& xMax) const;
+
+    /**
+     * @brief At most maxPoints samples representing [xMin, xMax] for drawing
+     *
+     * The neighbours just outside the range are included so lines reach the
+     * plot edges. Ranges with no more than maxPoints samples are returned as is.
+     * @return Number of points written to xs/ys
+     */
+    size_t decimate(double xMin, double xMax, int maxPoints,
+                    std::vector<double>& xs, std::vector<double>& ys) const;
+
+    /**
+     * @brief Sample closest to x (for hover readout and click-to-frame)
+     * @return false if the series is empty
+     */
+    bool nearestSample(double x, double& sampleX, float& sampleY) const;
+
+    /// Copy of all raw samples (for export; not meant for per-frame drawing)
+    void getSamples(std::vector<double>& xs, std::vector<float>& ys) const;
+
+private:
+    /// Lowest and highest sample of a span of 2^(level+1) samples
+    struct Bucket {
+        double minX;
+        double maxX;
+        float minY;
+        float maxY;
+    };
+
+    std::string name_;
+    std::string unit_;
+    mutable std::mutex mutex_;
+    std::vector<double> x_;
+    std::vector<float> y_;
+    std::vector<std::vector<Bucket>> levels_;
+
+    static Bucket merge(const Bucket& a, const Bucket& b);
+    static void largestTriangleThreeBuckets(const std::vector<double>& inX, const std::vector<double>& inY,
+                                            int maxPoints, std::vector<double>& outX, std::vector<double>& outY);
+};
+
+} // namespace zed_tools